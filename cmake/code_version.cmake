@@ -0,0 +1,38 @@
+# Writes OUTPUT with the code version render cache keys hash. Run as a
+# script on every build, so edits made without reconfiguring still change
+# the version; the header is only rewritten when the version changes.
+#
+# Expects SOURCE_DIR, OUTPUT and PROJECT_VERSION.
+
+execute_process(COMMAND git describe --always --dirty --abbrev=12
+                WORKING_DIRECTORY ${SOURCE_DIR}
+                OUTPUT_VARIABLE REVISION
+                OUTPUT_STRIP_TRAILING_WHITESPACE
+                ERROR_QUIET)
+if(NOT REVISION)
+    set(REVISION "unknown")
+endif()
+
+# A dirty tree keeps the same describe output across further edits, so the
+# uncommitted changes themselves go into the version
+if(REVISION MATCHES "-dirty$")
+    execute_process(COMMAND git diff HEAD
+                    WORKING_DIRECTORY ${SOURCE_DIR}
+                    OUTPUT_VARIABLE DIFF
+                    ERROR_QUIET)
+    string(SHA1 DIFF_HASH "${DIFF}")
+    string(SUBSTRING "${DIFF_HASH}" 0 12 DIFF_HASH)
+    set(REVISION "${REVISION}-${DIFF_HASH}")
+endif()
+
+set(CONTENT "// Generated by cmake/code_version.cmake; do not edit
+#pragma once
+#define PATHTRACER_CODE_VERSION \"${PROJECT_VERSION}-${REVISION}\"
+")
+
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} PREVIOUS)
+endif()
+if(NOT CONTENT STREQUAL PREVIOUS)
+    file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
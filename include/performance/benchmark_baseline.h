@@ -0,0 +1,72 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Persisted benchmark baselines and the statistics to compare against them.
+// A baseline only means something on the machine and build it came from,
+// so files are keyed by a fingerprint of both and a mismatch is refused.
+
+struct SampleStats {
+    int count = 0;
+    double mean = 0.0;
+    double stddev = 0.0;     // Sample standard deviation
+    double median = 0.0;
+    double ciLow = 0.0;      // Confidence interval of the mean
+    double ciHigh = 0.0;
+};
+
+SampleStats computeSampleStats(const std::vector<double>& samples, double confidence = 0.95);
+
+// One-sided Welch t-test of "current is larger than baseline"; lower is
+// better for every metric compared this way (times, ns/ray)
+struct RegressionCheck {
+    std::string name;
+    SampleStats baseline;
+    SampleStats current;
+    double relativeChange = 0.0;   // (current - baseline) / baseline of the means
+    double pValue = 1.0;           // Probability of a slowdown this large by chance
+    bool regression = false;       // Significant and larger than the noise floor
+    bool improvement = false;
+};
+
+RegressionCheck compareSamples(const std::string& name, const std::vector<double>& baseline,
+                               const std::vector<double>& current,
+                               double alpha = 0.01, double minRelativeChange = 0.03);
+
+// Upper tail of Student's t distribution, P(T > t)
+double studentTUpperTail(double t, double degreesOfFreedom);
+
+struct MachineFingerprint {
+    std::string cpuModel;
+    int logicalCores = 0;
+    std::string compiler;
+    std::string buildConfig;   // Optimization and feature macros of this build
+    std::string key;           // Short hash of the fields above
+
+    std::string description() const;
+    static MachineFingerprint current();
+};
+
+class BenchmarkBaseline {
+public:
+    std::string suite;
+    MachineFingerprint fingerprint;
+    std::string created;
+    // Raw samples per metric, e.g. "simple.wall_ms"
+    std::map<std::string, std::vector<double>> samples;
+
+    static std::string defaultPath(const std::string& directory, const std::string& suite,
+                                   const MachineFingerprint& fingerprint);
+
+    bool save(const std::string& filename) const;
+    static bool load(const std::string& filename, BenchmarkBaseline& baseline);
+
+    // Checks every metric present in both; metrics missing from either side are skipped
+    std::vector<RegressionCheck> compare(const std::map<std::string, std::vector<double>>& current,
+                                         double alpha = 0.01, double minRelativeChange = 0.03) const;
+};
+
+void printRegressionReport(std::ostream& out, const std::vector<RegressionCheck>& checks);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/common.h"
+#include "performance/cpu_benchmark.h"
+
+// Error against a high-spp reference as a function of render time. Sampler,
+// denoiser and caching changes trade speed for noise, so they are judged by
+// how long they take to reach a given error rather than by rays per second.
+// References are rendered once per scene and resolution and cached as PFM.
+class ConvergenceBenchmark {
+public:
+    enum class Technique {
+        PATH,               // trace(): plain path tracing
+        PATH_DENOISED,      // trace() followed by the denoiser
+        PROGRESSIVE,        // trace_progressive(), measured at every update
+        PREVIEW,            // trace_preview() with resampled direct light and the irradiance cache
+        PREVIEW_NO_CACHE    // trace_preview() with resampling only
+    };
+
+    enum class ErrorMetric {
+        RMSE,
+        REL_MSE,            // Squared error over squared reference, robust to bright pixels
+        DSSIM               // 1 - SSIM
+    };
+
+    struct ImageError {
+        double rmse = 0.0;
+        double relMSE = 0.0;
+        double ssim = 1.0;
+
+        double value(ErrorMetric metric) const;
+    };
+
+    struct CurvePoint {
+        int samplesPerPixel = 0;
+        double seconds = 0.0;
+        ImageError error;
+    };
+
+    struct Curve {
+        std::string scenarioName;
+        std::string technique;
+        int imageWidth = 0;
+        int imageHeight = 0;
+        std::vector<CurvePoint> points;   // In increasing render time
+
+        // Render time until the metric first reaches target, interpolated
+        // log-log between points; negative when it never does
+        double timeToError(double target, ErrorMetric metric) const;
+    };
+
+    struct Configuration {
+        double resolutionScale = 0.5;
+        int referenceSamples = 1024;
+        int maxSamples = 64;            // Sample counts double from 1 up to this
+        int threadCount = 0;            // Rendering and error kernels; 0 = hardware concurrency
+        std::string referenceDir = "benchmark_references";
+        bool refreshReferences = false;
+        std::vector<Technique> techniques = {Technique::PATH, Technique::PATH_DENOISED, Technique::PROGRESSIVE,
+                                             Technique::PREVIEW, Technique::PREVIEW_NO_CACHE};
+        ErrorMetric reportMetric = ErrorMetric::REL_MSE;
+        std::vector<double> targets = {0.1, 0.03, 0.01};
+    };
+
+    ConvergenceBenchmark() = default;
+
+    static const char* techniqueName(Technique technique);
+    static const char* metricName(ErrorMetric metric);
+
+    // Images are the tonemapped renderer output; RMSE and relMSE are taken
+    // on linear values, SSIM on display luminance over 8x8 windows
+    static ImageError measureError(const std::vector<Color>& image, const std::vector<Color>& reference,
+                                   int width, int height, int threadCount = 0);
+
+    // Cached reference for a scenario at this configuration's resolution, rendered when missing
+    std::vector<Color> reference(const CPUBenchmarkSuite::Scenario& scenario, int& width, int& height) const;
+    std::string referencePath(const CPUBenchmarkSuite::Scenario& scenario, int width, int height) const;
+
+    Curve runTechnique(const CPUBenchmarkSuite::Scenario& scenario, Technique technique,
+                       const std::vector<Color>& reference, int width, int height) const;
+    // Every configured technique on the named CPU benchmark scenarios, or all of them
+    std::vector<Curve> runScenarios(const std::vector<std::string>& names = {}) const;
+
+    void setConfiguration(const Configuration& config) { config_ = config; }
+    Configuration getConfiguration() const { return config_; }
+
+    void printReport(std::ostream& out, const std::vector<Curve>& curves) const;
+    // One row per curve point, for error-versus-time plots
+    void writeCSV(std::ostream& out, const std::vector<Curve>& curves) const;
+    void writeJSON(std::ostream& out, const std::vector<Curve>& curves) const;
+    bool writeFile(const std::string& filename, const std::vector<Curve>& curves, bool csv) const;
+
+private:
+    Configuration config_;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class SceneManager;
+struct Color;
+
+// End-to-end CPU renders of a fixed set of scenes at fixed seeds. Unlike
+// GPUBenchmarkSuite this needs no GL context, so it runs in CI and on
+// headless machines and serves as the baseline for CPU optimisations.
+class CPUBenchmarkSuite {
+public:
+    struct Scenario {
+        std::string name;
+        int width = 320;
+        int height = 240;
+        int samplesPerPixel = 4;
+        int maxDepth = 4;
+        uint64_t seed = 1;
+        // Fills an initialized SceneManager and positions its camera
+        std::function<void(SceneManager&)> buildScene;
+    };
+
+    struct Result {
+        std::string scenarioName;
+        int imageWidth = 0;
+        int imageHeight = 0;
+        int samplesPerPixel = 0;
+        int maxDepth = 0;
+        int primitiveCount = 0;
+        int iterations = 0;
+        double wallTimeMs = 0.0;        // Median over iterations
+        double minWallTimeMs = 0.0;
+        double maxWallTimeMs = 0.0;
+        double wallTimeCi95Ms = 0.0;    // Half-width of the 95% confidence interval of the mean
+        std::vector<double> wallTimeSamplesMs;  // Every timed iteration, in run order
+        uint64_t rays = 0;              // Per iteration
+        double mraysPerSecond = 0.0;
+        double samplesPerSecond = 0.0;
+        double peakMemoryMB = 0.0;      // Resident set high-water mark
+        double ipc = 0.0;               // 0 when hardware counters are unavailable
+        double cacheMissesPerRay = 0.0;
+        double branchMissesPerRay = 0.0;
+        uint64_t imageChecksum = 0;     // Hash of the 8-bit output, equal across runs at a fixed seed
+    };
+
+    struct Configuration {
+        int warmupIterations = 1;
+        int iterations = 5;             // Enough samples for a confidence interval
+        int threadCount = 0;            // 0 = hardware concurrency
+        double resolutionScale = 1.0;   // Shrinks every scenario, for smoke runs
+        bool enableHardwareCounters = true;
+    };
+
+    CPUBenchmarkSuite() = default;
+
+    static std::vector<Scenario> standardScenarios();
+
+    Result runScenario(const Scenario& scenario);
+    // Runs the named scenarios, or all of them when names is empty
+    std::vector<Result> runScenarios(const std::vector<std::string>& names = {});
+
+    void setConfiguration(const Configuration& config) { config_ = config; }
+    Configuration getConfiguration() const { return config_; }
+
+    void printReport(std::ostream& out, const std::vector<Result>& results) const;
+    void writeJSON(std::ostream& out, const std::vector<Result>& results) const;
+    bool writeJSON(const std::string& filename, const std::vector<Result>& results) const;
+
+    // Hash of the 8-bit display values; equal images give equal checksums
+    static uint64_t imageChecksum(const std::vector<Color>& image);
+
+    // Per-iteration wall times keyed "<scenario>.wall_ms", the samples stored in a BenchmarkBaseline
+    static std::map<std::string, std::vector<double>> baselineMetrics(const std::vector<Result>& results);
+
+private:
+    Configuration config_;
+};
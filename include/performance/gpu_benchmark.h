@@ -4,6 +4,7 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include "performance/hw_counters.h"
 
 // Forward declarations
 class PathTracer;
@@ -24,6 +25,10 @@ public:
         double speedupRatio = 0.0;      // GPU vs CPU speedup
         double memoryTransferTime = 0.0; // Memory transfer overhead (ms)
         double memoryUsage = 0.0;       // GPU memory usage (MB)
+        double cpuMraysPerSecond = 0.0; // CPU ray throughput
+        double cpuIPC = 0.0;            // Instructions per cycle, 0 without counters
+        double cpuCacheMissesPerRay = 0.0;
+        double cpuBranchMissesPerRay = 0.0;
         bool meetsPerformanceTarget = false;
         std::string errorMessage;
         std::chrono::system_clock::time_point timestamp;
@@ -33,6 +38,7 @@ public:
         bool enableCPUComparison = true;
         bool enableMemoryProfiling = true;
         bool enableRegressionDetection = true;
+        bool enableHardwareCounters = true;  // perf_event counters around CPU renders when permitted
         int warmupIterations = 2;
         int benchmarkIterations = 5;
         double targetSpeedupMinimum = 5.0;
@@ -93,6 +99,13 @@ private:
     std::vector<BenchmarkResult> baselineResults_;
     std::vector<BenchmarkResult> benchmarkHistory_;
     
+    // CPU counters summed over the current scenario's measurements; the
+    // hardware counters and their ray count cover the trace stage only
+    HwCounterValues cpuCounters_;
+    uint64_t cpuCounterRays_ = 0;
+    uint64_t cpuRays_ = 0;
+    double cpuSeconds_ = 0.0;
+    
     // Internal benchmark execution (now moved to public)
     void setupBenchmarkScene(int primitiveCount);
     void validateBenchmarkAccuracy(const BenchmarkResult& result);
@@ -101,6 +114,7 @@ private:
     double measureCPUPerformance(int width, int height, int samples);
     double measureGPUPerformance(int width, int height, int samples);
     double measureMemoryTransferOverhead(int width, int height);
+    void applyCPUCounters(BenchmarkResult& result) const;
     
     // Analysis and validation
     bool isResultValid(const BenchmarkResult& result) const;
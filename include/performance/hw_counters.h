@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Hardware performance counters read through perf_event_open on Linux.
+// Sampling is off until hw_counters_set_enabled(true) and every call is a
+// no-op when the kernel refuses access (perf_event_paranoid, containers,
+// missing PMU) or on other platforms; hw_counters_status() says why.
+
+enum class HwCounter : int {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    COUNT
+};
+
+constexpr int HW_COUNTER_COUNT = static_cast<int>(HwCounter::COUNT);
+
+const char* hw_counter_name(HwCounter counter);
+
+struct HwCounterValues {
+    uint64_t values[HW_COUNTER_COUNT] = {};
+    uint32_t available = 0;   // Bit per HwCounter the PMU actually counted
+
+    uint64_t operator[](HwCounter counter) const { return values[static_cast<int>(counter)]; }
+    bool has(HwCounter counter) const { return (available >> static_cast<int>(counter)) & 1u; }
+
+    // Instructions per cycle; 0 without both counters
+    double ipc() const;
+    // Events per ray; 0 when the counter is missing or rays is 0
+    double per_ray(HwCounter counter, uint64_t rays) const;
+
+    HwCounterValues& operator+=(const HwCounterValues& other);
+    HwCounterValues operator-(const HwCounterValues& other) const;
+};
+
+// Probes once whether this process may open counters
+bool hw_counters_supported();
+const std::string& hw_counters_status();
+
+void hw_counters_set_enabled(bool enabled);
+bool hw_counters_enabled();
+
+// Counters of the calling thread since it first sampled, multiplex-scaled.
+// The thread's counter group is opened on first use and closed at exit.
+bool hw_counters_read_thread(HwCounterValues& values);
+
+// Totals for one named stage on one worker thread
+struct HwStageStats {
+    std::string stage;
+    int thread_index = 0;
+    uint64_t calls = 0;
+    uint64_t rays = 0;        // Rays traced inside the stage's scopes; 0 for stages that trace none
+    HwCounterValues values;
+
+    // Events per ray of this stage alone
+    double per_ray(HwCounter counter) const { return values.per_ray(counter, rays); }
+};
+
+// Merged totals. Each thread's scopes accumulate privately until it calls
+// hw_stage_flush(); reading flushes the calling thread first.
+std::vector<HwStageStats> hw_stage_stats();
+HwCounterValues hw_stage_total();                          // All stages and threads
+HwCounterValues hw_stage_total(const std::string& stage);  // One stage, all threads
+uint64_t hw_stage_rays(const std::string& stage);          // Rays of one stage, all threads
+void hw_stage_stats_reset();
+
+// Merges the calling thread's pending stage totals into the shared table.
+// Called once at the end of a stage, e.g. when a tile worker runs out of tiles.
+void hw_stage_flush();
+
+// Per-stage and per-thread table with IPC and each stage's misses per ray
+void hw_counters_report(std::ostream& out);
+
+// Adds the calling thread's counter and ray deltas over the scope to a
+// thread-local stage total, without locking; see hw_stage_flush().
+// Scopes must not nest on one thread or the inner work is counted twice.
+class HwStageScope {
+public:
+    explicit HwStageScope(const char* stage, int thread_index = 0);
+    ~HwStageScope();
+
+    HwStageScope(const HwStageScope&) = delete;
+    HwStageScope& operator=(const HwStageScope&) = delete;
+
+private:
+    const char* stage_;
+    int thread_index_;
+    bool active_;
+    uint64_t start_rays_;
+    HwCounterValues start_;
+};
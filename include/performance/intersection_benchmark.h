@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/common.h"
+
+class Primitive;
+class SceneManager;
+
+// Microbenchmarks for Primitive::hit and SceneManager::hit_scene over
+// pre-generated ray batches. Every batch is timed repeatedly and reported
+// as median ns/ray with its spread, so kernel changes of a few percent are
+// visible above the noise.
+class IntersectionBenchmark {
+public:
+    enum class RayBatchKind {
+        COHERENT_HIT,     // Narrow bundle from one eye point into the target
+        COHERENT_MISS,    // Same bundle aimed beside the target
+        INCOHERENT_HIT,   // Random origins around the target, aimed inside it
+        INCOHERENT_MISS   // Random origins and directions that avoid its bounds
+    };
+
+    struct Result {
+        std::string kernel;             // "sphere", ..., or "hit_scene"
+        std::string batch;
+        int primitiveCount = 1;
+        int raysPerBatch = 0;
+        int repetitions = 0;
+        double nsPerRay = 0.0;          // Median over repetitions
+        double nsPerRayMin = 0.0;
+        double nsPerRayStdDev = 0.0;
+        double raysPerSecond = 0.0;     // From the median
+        double hitRate = 0.0;
+    };
+
+    struct Configuration {
+        int raysPerBatch = 4096;
+        int warmupRepetitions = 3;
+        int repetitions = 15;
+        double minRepetitionMs = 2.0;   // Each repetition loops the batch at least this long
+        uint64_t seed = 42;
+        std::vector<int> sceneSizes = {8, 64, 512};
+    };
+
+    IntersectionBenchmark() = default;
+
+    static const char* batchName(RayBatchKind kind);
+    static std::vector<Ray> generateRays(const AABB& bounds, RayBatchKind kind, int count, uint64_t seed);
+    // Random mix of all four primitive types inside a fixed volume
+    static std::shared_ptr<SceneManager> buildScene(int primitives, uint64_t seed);
+
+    Result benchmarkPrimitive(const std::string& name, const Primitive& primitive, RayBatchKind kind) const;
+    Result benchmarkScene(const SceneManager& scene, RayBatchKind kind) const;
+
+    // Every primitive type and scene size against every batch kind
+    std::vector<Result> runAll() const;
+
+    void setConfiguration(const Configuration& config) { config_ = config; }
+    Configuration getConfiguration() const { return config_; }
+
+    void printReport(std::ostream& out, const std::vector<Result>& results) const;
+    void writeJSON(std::ostream& out, const std::vector<Result>& results) const;
+    bool writeJSON(const std::string& filename, const std::vector<Result>& results) const;
+
+private:
+    template <typename Kernel>
+    Result measure(const std::vector<Ray>& rays, Kernel&& kernel) const;
+
+    Configuration config_;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "performance/cpu_benchmark.h"
+
+// Runs the tiled CPU renderer at increasing thread counts to find where it
+// stops scaling. Strong scaling keeps the image fixed; weak scaling grows
+// the pixel count with the threads so each one has the same work. Per-worker
+// busy and idle time separate load imbalance (some workers idle) from
+// memory-bound or false-sharing slowdowns (all workers busy, but longer).
+class ThreadScalingBenchmark {
+public:
+    enum class Mode {
+        STRONG,
+        WEAK
+    };
+
+    struct Point {
+        std::string scenarioName;
+        std::string mode;               // "strong" or "weak"
+        int threads = 1;
+        int imageWidth = 0;
+        int imageHeight = 0;
+        int samplesPerPixel = 0;
+        int iterations = 0;
+        double wallTimeMs = 0.0;        // Median over iterations
+        double speedup = 1.0;           // Against the smallest thread count, scaled to one thread
+        double efficiency = 1.0;        // speedup / threads
+        double mraysPerSecond = 0.0;
+        double serialMs = 0.0;          // Frame time outside the tiled pass (denoise, tonemap)
+        double meanBusyMs = 0.0;        // Per worker, inside tile callbacks
+        double meanIdleMs = 0.0;        // Per worker, tiled pass time not spent on tiles
+        double tileImbalance = 1.0;     // Slowest worker's busy time over the mean
+        double tileTimeCV = 0.0;        // Coefficient of variation of tile times
+        std::vector<double> threadBusyMs;
+        std::vector<double> threadIdleMs;
+        std::vector<int> threadTiles;
+        uint64_t imageChecksum = 0;     // Strong scaling must not change the image
+    };
+
+    struct Configuration {
+        std::vector<int> threadCounts;  // Empty = powers of two up to maxThreads, plus maxThreads
+        int maxThreads = 0;             // 0 = hardware concurrency
+        int warmupIterations = 1;
+        int iterations = 3;
+        double resolutionScale = 1.0;
+        bool strongScaling = true;
+        bool weakScaling = true;
+    };
+
+    ThreadScalingBenchmark() = default;
+
+    static const char* modeName(Mode mode);
+    std::vector<int> threadCounts() const;
+
+    // One scenario at every thread count; speedup and efficiency are filled in
+    std::vector<Point> runScenario(const CPUBenchmarkSuite::Scenario& scenario, Mode mode) const;
+    // Named CPU benchmark scenarios, or all of them when names is empty
+    std::vector<Point> runScenarios(const std::vector<std::string>& names = {}) const;
+
+    void setConfiguration(const Configuration& config) { config_ = config; }
+    Configuration getConfiguration() const { return config_; }
+
+    void printReport(std::ostream& out, const std::vector<Point>& points) const;
+    // One row per point, ready for plotting efficiency against threads
+    void writeCSV(std::ostream& out, const std::vector<Point>& points) const;
+    // Includes the per-thread busy and idle breakdown
+    void writeJSON(std::ostream& out, const std::vector<Point>& points) const;
+    bool writeFile(const std::string& filename, const std::vector<Point>& points, bool csv) const;
+
+private:
+    Point measure(const CPUBenchmarkSuite::Scenario& scenario, Mode mode, int threads, int baseThreads) const;
+
+    Configuration config_;
+};
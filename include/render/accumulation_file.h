@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/common.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Passes [first, first + count) of a progressive sample sequence. Pass p
+// of tile t seeds from mix_seed(mix_seed(seed, p), t), so jobs rendering
+// disjoint ranges with one seed draw disjoint random sequences.
+struct SampleRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+
+    uint32_t end() const { return first + count; }
+};
+
+// What a set of sample ranges depends on; files merge only when all of it matches
+struct AccumulationHeader {
+    static constexpr uint32_t VERSION = 1;
+
+    int width = 0;
+    int height = 0;
+    int max_depth = 0;
+    uint64_t seed = 0;
+    Vector3 camera_position;
+    Vector3 camera_target;
+    Vector3 camera_up;
+    float camera_fov = 0.0f;
+    float camera_aspect = 0.0f;
+    uint64_t scene_hash = 0;
+    bool has_variance = false;          // Luminance moments follow the counts
+    std::vector<SampleRange> ranges;    // Sorted and disjoint
+
+    bool same_render(const AccumulationHeader& other) const;
+    size_t pixel_count() const { return static_cast<size_t>(width) * height; }
+    uint64_t pass_count() const;
+};
+
+// Unnormalized output of a sample-range render: linear RGB sums, samples
+// per pixel and optionally per-pixel luminance moments, so any number of
+// files over disjoint ranges add up to the render of their union.
+//
+// On disk: magic, the header with its range list, then planar sections
+// (RGB sums, counts, luminance sums, luminance squared sums) at fixed
+// offsets so a merge can stream row bands without loading whole files.
+// Host byte order, like render checkpoints.
+struct AccumulationFile {
+    AccumulationHeader header;
+    std::vector<Color> sums;
+    std::vector<uint32_t> sample_counts;
+    std::vector<float> luminance_sum;       // Empty unless header.has_variance
+    std::vector<float> luminance_sq_sum;
+
+    bool save(const std::string& filename) const;
+    // False on a missing, truncated or malformed file
+    static bool load(const std::string& filename, AccumulationFile& file);
+    static bool read_header(const std::string& filename, AccumulationHeader& header);
+};
+
+struct AccumulationMergeOptions {
+    int threads = 0;                // 0 = hardware concurrency
+    int band_rows = 16;             // Rows each worker reads from every input at a time
+    std::string output;             // Merged accumulation file, optional
+    std::string image;              // Averaged linear image as PFM, optional
+};
+
+// Adds N accumulation files of the same render into a merged file and/or
+// the final image. Inputs are checked for matching headers and disjoint
+// sample ranges up front, then workers stream row bands from every input,
+// so memory grows with threads x band size rather than with N.
+// Outputs are renamed into place when complete; on mismatched inputs or
+// an I/O failure nothing is written and error says why.
+bool merge_accumulation_files(const std::vector<std::string>& inputs, const AccumulationMergeOptions& options,
+                              AccumulationHeader* merged = nullptr, std::string* error = nullptr);
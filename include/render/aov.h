@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/common.h"
+#include <cstdint>
+#include <vector>
+
+// Arbitrary output variables written from the first camera hit. Each type
+// is one bit so callers can request any combination.
+enum class AOVType : uint32_t {
+    DEPTH        = 1u << 0,   // Ray distance to the first hit, 0 for background
+    NORMAL       = 1u << 1,   // World-space shading normal, zero for background
+    ALBEDO       = 1u << 2,   // Material albedo, white for background
+    PRIMITIVE_ID = 1u << 3,   // SceneManager PrimitiveID, 0 for background
+    MATERIAL_ID  = 1u << 4,   // 24-bit hash of the material parameters, 0 for background
+    SAMPLE_COUNT = 1u << 5    // Camera samples accumulated into the pixel
+};
+
+using AOVMask = uint32_t;
+
+constexpr AOVMask AOV_NONE = 0;
+constexpr AOVMask aov_bit(AOVType type) { return static_cast<AOVMask>(type); }
+constexpr AOVMask AOV_ALL = (1u << 6) - 1;
+// Buffers the denoiser needs as edge-stopping features
+constexpr AOVMask AOV_DENOISE_FEATURES =
+    aov_bit(AOVType::DEPTH) | aov_bit(AOVType::NORMAL) | aov_bit(AOVType::ALBEDO);
+
+const char* aov_name(AOVType type);
+
+// Per-pixel AOV storage. Only the buffers in mask are allocated; the others
+// stay empty.
+struct AOVBuffers {
+    int width = 0;
+    int height = 0;
+    AOVMask mask = AOV_NONE;
+
+    std::vector<float> depth;
+    std::vector<Vector3> normal;
+    std::vector<Color> albedo;
+    std::vector<uint32_t> primitive_id;
+    std::vector<uint32_t> material_id;
+    std::vector<uint32_t> sample_count;
+
+    // Allocate the requested buffers with background values, free the rest
+    void allocate(AOVMask requested, int w, int h);
+    bool has(AOVType type) const { return (mask & aov_bit(type)) != 0; }
+    bool has_all(AOVMask required) const { return (mask & required) == required; }
+    bool matches(int w, int h) const { return width == w && height == h; }
+
+    // Store the first-hit attributes of one pixel
+    void write_hit(size_t index, const HitRecord& hit, uint32_t primitive_id);
+    // Back to the background values allocate() starts from
+    void clear_pixel(size_t index);
+    void fill_sample_count(uint32_t samples);
+
+    // Stable identifier shared by every surface with the same material
+    static uint32_t material_id_for(const Material& material);
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/ray_stats.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+enum class HeatmapMetric {
+    CYCLES,              // Elapsed CPU cycles (nanoseconds where no cycle counter exists)
+    INTERSECTION_TESTS,  // Primitive intersection tests
+    BOUNCES              // Scattered path segments
+};
+
+const char* heatmap_metric_name(HeatmapMetric metric);
+
+inline uint64_t read_cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Per-pixel render cost, summed over every sample and pass that touched the
+// pixel. A pixel is only ever written by the thread that owns its tile, so
+// recording needs no synchronisation.
+class CostHeatmap {
+public:
+    CostHeatmap();
+
+    void allocate(int width, int height);
+    void clear();
+    bool empty() const { return cycles_.empty(); }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    void add(int index, uint64_t cycles, uint64_t intersection_tests, uint64_t bounces);
+
+    float value(HeatmapMetric metric, int index) const;
+    const std::vector<float>& values(HeatmapMetric metric) const;
+    double total(HeatmapMetric metric) const;
+
+    // False-colour view of one metric, normalised to its 99th percentile
+    std::vector<Color> false_color(HeatmapMetric metric) const;
+    // Blend the false-colour view over a display image in place
+    void overlay(std::vector<Color>& image, HeatmapMetric metric, float opacity = 0.7f) const;
+
+    // Raw per-pixel values as a single-channel-replicated PFM
+    bool save(const std::string& filename, HeatmapMetric metric) const;
+
+private:
+    int width_;
+    int height_;
+    std::vector<float> cycles_;
+    std::vector<float> intersection_tests_;
+    std::vector<float> bounces_;
+};
+
+// Measures one pixel's work on the current thread and adds it to a heatmap.
+// A null heatmap makes the scope free apart from the pointer test.
+class PixelCostScope {
+public:
+    PixelCostScope(CostHeatmap* heatmap, int index)
+        : heatmap_(heatmap), index_(index), start_cycles_(0), start_tests_(0), start_bounces_(0) {
+        if (heatmap_) {
+            const RayStatsSlot& stats = thread_ray_stats();
+            start_tests_ = stats.intersection_tests();
+            start_bounces_ = stats.get(RayCounter::SECONDARY_RAYS);
+            start_cycles_ = read_cycle_counter();
+        }
+    }
+
+    ~PixelCostScope() {
+        if (heatmap_) {
+            uint64_t cycles = read_cycle_counter() - start_cycles_;
+            const RayStatsSlot& stats = thread_ray_stats();
+            heatmap_->add(index_, cycles, stats.intersection_tests() - start_tests_,
+                          stats.get(RayCounter::SECONDARY_RAYS) - start_bounces_);
+        }
+    }
+
+    PixelCostScope(const PixelCostScope&) = delete;
+    PixelCostScope& operator=(const PixelCostScope&) = delete;
+
+private:
+    CostHeatmap* heatmap_;
+    int index_;
+    uint64_t start_cycles_;
+    uint64_t start_tests_;
+    uint64_t start_bounces_;
+};
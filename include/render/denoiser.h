@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/common.h"
+#include "render/tile_scheduler.h"
+#include "render/aov.h"
+#include <vector>
+
+struct DenoiserConfig {
+    int iterations = 5;              // À-trous passes; the footprint doubles each pass
+    float sigma_luminance = 4.0f;    // Luminance edge stop in standard deviations
+    float sigma_normal = 128.0f;     // Exponent applied to the normal cosine
+    float sigma_depth = 1.0f;        // Relative depth edge stop
+    bool demodulate_albedo = true;   // Filter illumination only, keep texture detail
+};
+
+// Edge-avoiding à-trous wavelet filter guided by per-pixel luminance
+// variance (SVGF spatial filter). Colour is divided by albedo before
+// filtering and multiplied back afterwards so texture detail survives.
+//
+// Buffers are converted to planar float arrays and each pass walks rows of
+// a tile tap by tap, so the inner loops are straight-line float code the
+// compiler can vectorise. Tiles are spread over the TileScheduler workers.
+class Denoiser {
+public:
+    explicit Denoiser(const DenoiserConfig& config = DenoiserConfig());
+
+    void set_config(const DenoiserConfig& config) { config_ = config; }
+    const DenoiserConfig& config() const { return config_; }
+    void set_thread_count(int threads) { scheduler_.set_thread_count(threads); }
+
+    // Filter linear radiance in place. features must hold the depth, normal
+    // and albedo AOVs (AOV_DENOISE_FEATURES). variance holds the luminance
+    // variance of each pixel mean; when empty it is estimated from a 3x3
+    // neighbourhood. Returns false if a buffer is missing or the wrong size.
+    bool denoise(std::vector<Color>& color, int width, int height, const AOVBuffers& features,
+                 const std::vector<float>& variance = std::vector<float>()) const;
+
+private:
+    struct Planes;
+
+    void estimate_variance(Planes& planes) const;
+    void filter_pass(const Planes& planes, int step, const float* in_r, const float* in_g, const float* in_b,
+                     const float* in_var, float* out_r, float* out_g, float* out_b, float* out_var) const;
+
+    DenoiserConfig config_;
+    TileScheduler scheduler_;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/camera.h"
+#include "core/resource_monitor.h"
+#include "render/tile_scheduler.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SceneManager;
+
+// A point on an emissive sphere. The point is stored relative to its light
+// (index + unit offset from the centre) so a reservoir kept across frames
+// follows the light when it moves and is dropped when the light disappears.
+struct LightSample {
+    int light_index = -1;
+    Vector3 local_direction;
+
+    // Resolved against the current light list
+    Vector3 position;
+    Vector3 normal;
+    Color radiance;
+};
+
+// Weighted reservoir holding one light sample chosen by resampled importance
+// sampling. W is the unbiased contribution weight for the chosen sample.
+struct Reservoir {
+    LightSample sample;
+    float weight_sum = 0.0f;
+    float target_pdf = 0.0f;
+    float M = 0.0f;
+    float W = 0.0f;
+
+    bool update(const LightSample& candidate, float weight, float candidate_target_pdf, float random);
+    void finalize();
+    void reset() { *this = Reservoir(); }
+};
+
+// First-hit surface seen through a pixel. Only diffuse surfaces take part in
+// resampling; metal, emissive and background pixels leave valid = false.
+struct ResamplingSurface {
+    Vector3 position;
+    Vector3 normal;
+    Color albedo;
+    float depth = 0.0f;
+    bool valid = false;
+};
+
+struct ResamplingConfig {
+    int initial_candidates = 8;     // RIS candidates drawn per pixel per frame
+    bool temporal_reuse = true;
+    bool spatial_reuse = true;
+    int spatial_samples = 4;        // Neighbours merged per pixel
+    float spatial_radius = 16.0f;   // Neighbour search radius in pixels
+    float history_limit = 20.0f;    // History M is clamped to this multiple of the current M
+    float normal_threshold = 0.9f;  // Minimum cosine between reused surface normals
+    float depth_threshold = 0.1f;   // Maximum relative depth difference for reuse
+};
+
+// Spatiotemporal reservoir resampling (ReSTIR) for direct light from emissive
+// spheres. Each frame runs three passes over the image:
+//   1. sample_initial: RIS over light candidates, visibility test on the
+//      winner, then merge with the reprojected reservoir from the last frame
+//   2. reuse_spatial:  merge reservoirs from nearby pixels with similar geometry
+//   3. shade:          evaluate the final sample with a fresh shadow ray
+// Passes work on tiles so they can run on the TileScheduler workers; a pass
+// only writes the pixels of its own tile.
+class DirectLightResampler {
+public:
+    DirectLightResampler();
+
+    void set_scene_manager(std::shared_ptr<SceneManager> scene_manager);
+    void set_config(const ResamplingConfig& config) { config_ = config; }
+    const ResamplingConfig& config() const { return config_; }
+
+    // Drop all temporal history (resize, scene reload, mode switch)
+    void reset_history();
+
+    // Collect lights and prepare per-pixel storage for a new frame
+    void begin_frame(int width, int height, const Camera& camera);
+    void sample_initial(const RenderTile& tile, const std::vector<ResamplingSurface>& surfaces);
+    void reuse_spatial(const RenderTile& tile, const std::vector<ResamplingSurface>& surfaces);
+    Color shade(int x, int y, const ResamplingSurface& surface) const;
+    // Keep this frame's reservoirs and surfaces as history for the next frame
+    void end_frame(const std::vector<ResamplingSurface>& surfaces);
+
+    size_t light_count() const { return lights_.size(); }
+    // Whether this frame samples the object (a SceneManager object index) as
+    // a light. Only such emitters may be skipped when a bounce hits them.
+    bool samples_object(int object_index) const {
+        return object_index >= 0 && object_index < static_cast<int>(light_objects_.size()) &&
+               light_objects_[object_index] != 0;
+    }
+    uint32_t frame_index() const { return frame_index_; }
+    const Reservoir& reservoir(int x, int y) const { return final_[y * width_ + x]; }
+
+private:
+    struct EmissiveSphere {
+        Vector3 center;
+        float radius;
+        Color radiance;
+        float area;
+    };
+
+    class PixelRandom;
+
+    bool resolve(LightSample& sample) const;
+    LightSample sample_light(PixelRandom& random) const;
+    float source_pdf(const LightSample& sample) const;
+    float target_pdf(const LightSample& sample, const ResamplingSurface& surface) const;
+    Color unshadowed_contribution(const LightSample& sample, const ResamplingSurface& surface) const;
+    bool visible(const LightSample& sample, const ResamplingSurface& surface) const;
+    bool similar(const ResamplingSurface& a, const ResamplingSurface& b) const;
+    bool reproject(const Vector3& position, int& x, int& y) const;
+    void merge(Reservoir& into, const Reservoir& other, const ResamplingSurface& surface,
+               PixelRandom& random) const;
+
+    std::shared_ptr<SceneManager> scene_manager_;
+    ResamplingConfig config_;
+    std::vector<EmissiveSphere> lights_;
+    std::vector<uint8_t> light_objects_;   // Per object index, 1 for the objects in lights_
+
+    int width_;
+    int height_;
+    uint32_t frame_index_;
+    Camera current_camera_;
+
+    template <typename T>
+    using Buffer = TrackedVector<T, MemorySubsystem::LIGHT_RESAMPLING>;
+
+    Buffer<Reservoir> initial_;   // Pass 1 output
+    Buffer<Reservoir> final_;     // Pass 2 output, shaded this frame
+
+    // Previous frame state for temporal reuse
+    bool history_valid_;
+    Camera history_camera_;
+    Buffer<Reservoir> history_;
+    Buffer<ResamplingSurface> history_surfaces_;
+};
@@ -47,7 +47,8 @@ public:
         double speedupRatio = 0.0;            // GPU vs CPU performance ratio
         size_t gpuMemoryUsed = 0;             // GPU memory utilization (bytes)
         double memoryTransferOverhead = 0.0;  // Memory transfer overhead percentage
-        double gpuUtilization = 0.0;          // GPU utilization percentage
+        double gpuUtilization = 0.0;          // GPU busy time over wallTime, percent
+        double wallTime = 0.0;                // Wall time since the previous measurement (ms)
         double efficiency = 0.0;              // Overall efficiency metric
     };
 
@@ -85,6 +86,8 @@ private:
     unsigned int timerQueries_[4];  // Start/end pairs for compute and transfer
     bool queryActive_;
     std::chrono::high_resolution_clock::time_point cpuStartTime_;
+    std::chrono::high_resolution_clock::time_point lastEndTime_;
+    bool hasLastEnd_ = false;
 #endif
     
     PerformanceMetrics currentMetrics_;
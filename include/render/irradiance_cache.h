@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/resource_monitor.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct IrradianceCacheConfig {
+    float cell_size = 0.2f;            // World-space grid resolution
+    int max_samples_per_entry = 64;    // Entries stop refining after this many samples
+    float invalidation_margin = 0.5f;  // Extra distance cleared around an edit for light bleed
+};
+
+struct IrradianceCacheStats {
+    size_t entries = 0;
+    uint64_t lookups = 0;
+    uint64_t hits = 0;                 // Lookups answered by a converged entry
+    uint64_t invalidated = 0;          // Entries dropped by invalidate_region/clear
+};
+
+// World-space hashed grid of incoming radiance at diffuse surfaces. Each
+// entry is keyed by its grid cell and the dominant axis of the surface
+// normal, and holds the mean of the cosine-weighted radiance samples added
+// so far. Entries are filled lazily by the renderer and kept across frames
+// and camera moves; scene edits clear only the cells near the change.
+//
+// The table is split into independently locked shards so tile workers can
+// read and fill it concurrently.
+class IrradianceCache {
+public:
+    explicit IrradianceCache(const IrradianceCacheConfig& config = IrradianceCacheConfig());
+
+    void set_config(const IrradianceCacheConfig& config);
+    const IrradianceCacheConfig& config() const { return config_; }
+
+    // Mean incoming radiance and sample count for the cell; false if empty
+    bool lookup(const Vector3& position, const Vector3& normal, Color& radiance, int& sample_count) const;
+    // Add one incoming radiance sample and return the updated mean
+    Color add_sample(const Vector3& position, const Vector3& normal, const Color& incoming);
+    bool is_converged(int sample_count) const { return sample_count >= config_.max_samples_per_entry; }
+
+    void invalidate_region(const AABB& region);
+    void clear();
+
+    size_t size() const;
+    IrradianceCacheStats get_stats() const;
+
+private:
+    struct Entry {
+        Color radiance_sum;
+        int sample_count = 0;
+        Vector3 cell_center;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Entry, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                           TrackingAllocator<std::pair<const uint64_t, Entry>, MemorySubsystem::IRRADIANCE_CACHE>> entries;
+    };
+
+    static constexpr size_t SHARD_COUNT = 64;
+
+    uint64_t make_key(const Vector3& position, const Vector3& normal, Vector3& cell_center) const;
+    Shard& shard_for(uint64_t key) const;
+
+    IrradianceCacheConfig config_;
+    mutable std::vector<Shard> shards_;
+
+    mutable std::atomic<uint64_t> lookups_;
+    mutable std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> invalidated_;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "render/render_engine.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// What the render engine publishes once per frame or progressive pass
+struct MetricsSnapshot {
+    RenderMetrics render;
+    RenderState state = RenderState::IDLE;
+    uint64_t sequence = 0;              // Publications so far, including this one
+    double published_seconds = 0.0;     // Steady-clock time of publication
+};
+
+// Serves render telemetry in the Prometheus text exposition format over
+// plain HTTP, on a localhost TCP port or a Unix socket. Renderers publish a
+// MetricsSnapshot through a triple buffer, so neither side ever waits on
+// the other; counters that are already atomic (rays, tracked memory, queue
+// depths) are read live at scrape time. Scrapes are handled one at a time
+// on a single background thread.
+class MetricsExporter {
+public:
+    struct Config {
+        int port = 9464;                // TCP port on 127.0.0.1; 0 picks a free one
+        std::string unix_socket;        // When set, listen here instead of TCP
+    };
+
+    MetricsExporter();
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Parses "9464", "port:9464" or "unix:/path/to.sock"
+    static bool parse_endpoint(const std::string& spec, Config& config);
+
+    bool start(const Config& config);
+    void stop();
+    bool is_running() const { return running_.load(std::memory_order_relaxed); }
+    // Bound TCP port, useful after starting on port 0
+    int port() const { return bound_port_; }
+
+    // Safe from any thread; concurrent publishers serialize among themselves only
+    void publish(const RenderMetrics& metrics, RenderState state);
+
+    // Full exposition text. Only one thread may scrape at a time; while the
+    // server runs, that is the server thread.
+    void scrape(std::ostream& out);
+
+private:
+    void serve();
+    void handle_connection(int fd);
+    bool latest(MetricsSnapshot& snapshot);
+
+    // Triple buffer: the publisher fills back_, then swaps it with the
+    // shared middle slot; the reader swaps its front_ with middle only when
+    // the fresh bit says something new arrived.
+    static constexpr int FRESH = 4;
+    MetricsSnapshot buffers_[3];
+    std::atomic<int> middle_{1};
+    int back_ = 0;
+    int front_ = 2;
+    std::mutex publish_mutex_;          // Guards back_ and the sequence count
+    uint64_t published_ = 0;
+
+    std::thread server_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_requested_{false};
+    int listen_fd_ = -1;
+    int bound_port_ = 0;
+    std::string unix_socket_;
+};
@@ -2,17 +2,34 @@
 
 #include "core/common.h"
 #include "core/camera.h"
+#include "core/ray_stats.h"
+#include "core/resource_monitor.h"
+#include "render/tile_scheduler.h"
+#include "render/denoiser.h"
+#include "render/cost_heatmap.h"
+#include "render/path_vertex_cache.h"
 #include <random>
+#include <cstdint>
 #include <memory>
 #include <functional>
 #include <atomic>
 #include <chrono>
+#include <mutex>
 
 // Forward declarations
 class SceneManager;
 class GPUComputePipeline;
 class GPUMemoryManager;
 class GPURandomGenerator;
+class DirectLightResampler;
+class IrradianceCache;
+class PrimaryVisibility;
+class CheckpointWriter;
+struct RenderCheckpoint;
+struct AccumulationFile;
+struct AccumulationHeader;
+class RenderCache;
+struct SceneEdit;
 struct GPUBuffer;
 
 #ifdef USE_GPU
@@ -28,6 +45,14 @@ struct ProgressiveConfig {
     float updateInterval = 0.2f; // Seconds between progressive updates
 };
 
+// Which tiles of a progressive render a scene edit made during it resets
+enum class EditInvalidation {
+    OFF,          // Edits are picked up by later passes but nothing is reset
+    PRIMARY,      // Tiles whose primary rays saw the edited primitive or may see it now
+    PADDED,       // Those plus rings of neighbouring tiles, for nearby shadows and bounces
+    FULL_FRAME    // Every tile
+};
+
 // Progressive rendering callback for intermediate results
 using ProgressiveCallback = std::function<void(const std::vector<Color>&, int, int, int, int)>;
 
@@ -41,6 +66,16 @@ struct PerformanceMetrics {
     int imageHeight = 0;
 };
 
+// Ray counters of one CPU frame, aggregated when the frame finishes
+struct FrameStats {
+    RayStats rays;
+    double seconds = 0.0;
+    uint64_t samples = 0;   // Camera samples, pixels x samples per pixel
+    
+    double mrays_per_second() const { return seconds > 0.0 ? rays.rays() / seconds * 1e-6 : 0.0; }
+    double samples_per_second() const { return seconds > 0.0 ? samples / seconds : 0.0; }
+};
+
 class PathTracer {
 public:
     enum class RenderMode {
@@ -56,9 +91,36 @@ public:
     void trace(int width, int height);
     bool trace_interruptible(int width, int height);
     
+    // One tile of trace() as linear averages, row-major within the tile and
+    // seeded exactly as trace() seeds it, for renders split across processes.
+    // Runs on the calling thread and leaves the frame buffers alone.
+    void trace_tile(int width, int height, const RenderTile& tile, std::vector<Color>& pixels);
+    
     // Progressive rendering
     bool trace_progressive(int width, int height, const ProgressiveConfig& config, ProgressiveCallback callback);
     
+    // Distributed final renders: passes [first_pass, first_pass + pass_count)
+    // of the progressive sample sequence, left as unnormalized sums in output.
+    // Jobs with the same seed and disjoint ranges merge into the render of
+    // the union. Variance is recorded when asked for or when denoising is on.
+    // False, with output untouched, when stopped.
+    bool trace_sample_range(int width, int height, uint32_t first_pass, uint32_t pass_count,
+                            bool with_variance, AccumulationFile& output);
+    
+    // Adds pass_count passes of the progressive sample sequence to the sums
+    // the previous call left in get_image_data(), numbering on from them; a
+    // restart or a new size starts from pass 0. Any split of a render gives
+    // the sums of one call. Other trace calls in between need a restart.
+    // False when stopped; the next call finishes the interrupted pass.
+    bool accumulate_passes(int width, int height, uint32_t pass_count, bool restart = false);
+    uint32_t get_accumulated_passes() const { return accumulated_passes_; }
+    
+    // Interactive preview: one primary hit per pixel, direct light from
+    // spatiotemporally resampled reservoirs, and one diffuse bounce finished
+    // by an irradiance cache lookup. Falls back to trace_interruptible when
+    // both resampling and the cache are disabled.
+    bool trace_preview(int width, int height);
+    
 #ifdef USE_GPU
     // GPU rendering methods
     bool trace_gpu(int width, int height);
@@ -69,6 +131,9 @@ public:
     bool start_gpu_async(int width, int height);  // Start GPU work without waiting
     bool is_gpu_complete();                       // Check if GPU work is done
     bool finalize_gpu_result(int width, int height); // Get result when ready
+    
+    // GPU counterpart of trace_preview (reservoirs live in GPU buffers)
+    bool trace_gpu_preview(int width, int height);
 #endif
     
     void request_stop() { stop_requested_ = true; }
@@ -80,6 +145,83 @@ public:
     void set_camera(const Camera& camera);
     void set_max_depth(int depth) { max_depth_ = depth; }
     void set_samples_per_pixel(int samples) { samples_per_pixel_ = samples; }
+    int get_samples_per_pixel() const { return samples_per_pixel_; }
+    void set_thread_count(int threads) { tile_scheduler_.set_thread_count(threads); }
+    int get_thread_count() const { return tile_scheduler_.thread_count(); }
+    // Per-worker timing of the last tiled pass, e.g. the body of trace()
+    const TileRunStats& get_tile_stats() const { return tile_scheduler_.last_run_stats(); }
+    // Non-zero makes trace() and trace_interruptible() repeatable; 0 seeds from the OS
+    void set_random_seed(uint64_t seed) { random_seed_ = seed; }
+    uint64_t get_random_seed() const { return random_seed_; }
+    
+    // Periodic checkpoints of CPU progressive renders, saved in the background;
+    // a stopped render always saves one. An empty filename turns them off.
+    void set_checkpointing(const std::string& filename, std::chrono::seconds interval);
+    bool is_checkpointing() const { return checkpoint_writer_ != nullptr; }
+    // The next trace_progressive() continues from this checkpoint, with the
+    // checkpoint's progressive schedule, when it describes the same render
+    // (resolution, depth, camera, scene); otherwise that render starts over.
+    void set_resume_checkpoint(std::unique_ptr<RenderCheckpoint> checkpoint);
+    void wait_for_checkpoints();
+    
+    // Finished progressive accumulations are kept in this cache; a render it
+    // already holds returns at once, and one it holds with fewer samples
+    // continues from there. Renders with the cost heatmap bypass it.
+    void set_render_cache(std::shared_ptr<RenderCache> cache) { render_cache_ = cache; }
+    std::shared_ptr<RenderCache> get_render_cache() const { return render_cache_; }
+    
+    // Scene edits made while trace_progressive() runs (including from its
+    // callback) reset only the tiles they can affect; those replay their
+    // passes against the edited scene and every other tile keeps its samples.
+    // PRIMARY is exact for primary visibility; light an edit sends to other
+    // tiles is only caught by PADDED's bleed_tiles rings or FULL_FRAME.
+    void set_edit_invalidation(EditInvalidation mode, int bleed_tiles = 1);
+    EditInvalidation get_edit_invalidation() const { return edit_invalidation_; }
+    // Tiles reset by edits during the last progressive render
+    size_t get_invalidated_tiles() const { return invalidated_tiles_; }
+    // Hits of the leading progressive passes, used while edit invalidation is
+    // on. Passes replayed after material-only edits, in this render or the
+    // next one of the same view and seed, skip intersecting the scene. With
+    // a random seed the next render adopts the seed the vertices were traced with.
+    void set_path_vertex_cache(const PathVertexCacheConfig& config) { vertex_cache_->set_config(config); }
+    PathVertexCache& get_path_vertex_cache() { return *vertex_cache_; }
+    
+    // Resampled direct lighting for previews
+    void set_direct_light_resampling(bool enabled);
+    bool is_direct_light_resampling_enabled() const { return direct_light_resampling_; }
+    DirectLightResampler& get_direct_light_resampler() { return *light_resampler_; }
+    
+    // World-space irradiance cache for preview indirect light
+    void set_irradiance_cache(bool enabled);
+    bool is_irradiance_cache_enabled() const { return irradiance_cache_enabled_; }
+    IrradianceCache& get_irradiance_cache() { return *irradiance_cache_; }
+    
+    // Preview camera hits from rasterised object bounds: each pixel tests
+    // only the objects whose screen footprint covers it. Images are unchanged.
+    void set_raster_primary_visibility(bool enabled) { raster_primary_visibility_ = enabled; }
+    bool is_raster_primary_visibility_enabled() const { return raster_primary_visibility_; }
+    
+    // Edge-aware denoising of CPU output before gamma correction
+    void set_denoising(bool enabled) { denoising_enabled_ = enabled; }
+    bool is_denoising_enabled() const { return denoising_enabled_; }
+    Denoiser& get_denoiser() { return *denoiser_; }
+    
+    // First-hit AOVs written alongside the colour buffer. Only requested
+    // buffers are allocated; denoising adds AOV_DENOISE_FEATURES implicitly.
+    void set_aovs(AOVMask mask) { requested_aovs_ = mask; }
+    AOVMask get_requested_aovs() const { return requested_aovs_; }
+    const AOVBuffers& get_aovs() const { return aovs_; }
+    
+    // Per-pixel cost diagnostics for CPU frames. While enabled the finished
+    // image is replaced by a false-colour view of the selected metric.
+    void set_cost_heatmap(bool enabled) { cost_heatmap_enabled_ = enabled; }
+    bool is_cost_heatmap_enabled() const { return cost_heatmap_enabled_; }
+    void set_heatmap_metric(HeatmapMetric metric) { heatmap_metric_ = metric; }
+    HeatmapMetric get_heatmap_metric() const { return heatmap_metric_; }
+    const CostHeatmap& get_cost_heatmap() const { return cost_heatmap_; }
+    
+    // Counters of the last CPU frame; progressive renders update it per step
+    FrameStats get_frame_stats() const;
     void forceGPUShaderRecompilation();  // Force recompile GPU shaders
     void forceGPUBufferRebind();  // Force rebind GPU buffers
     bool trace_gpu_sync(int width, int height);  // Synchronous GPU rendering for testing
@@ -106,10 +248,58 @@ public:
     
     // Get rendered data
     const std::vector<Color>& get_image_data() const { return image_data_; }
+    // Radiance of the last CPU frame, or of the progressive frame last handed
+    // to the callback, before denoising, gamma and overlays. Empty after a
+    // GPU frame, which never holds a linear image on the CPU.
+    const std::vector<Color>& get_linear_image() const { return linear_image_; }
     
 private:
     // CPU ray tracing methods
-    Color ray_color(const Ray& ray, int depth) const;
+    // count_emission = false skips emitters hit by this ray that the light
+    // resampler samples, whose contribution was already added explicitly.
+    // hit_object receives the object index of this ray's hit, if any.
+    // cached reads this path's hits from the vertex cache, or records them.
+    Color ray_color(const Ray& ray, int depth, bool count_emission = true, int* hit_object = nullptr,
+                    PathVertexSpan cached = PathVertexSpan()) const;
+    Ray camera_ray(float u, float v) const;
+    float random_float() const;
+    static void seed_thread_rng(uint64_t seed);
+    Color cached_bounce_color(const Ray& ray, bool count_emission) const;
+    void sync_scene_edits();
+    void begin_frame_buffers(int width, int height, bool track_moments = true);
+    // Only tiles flagged in tiles when given
+    void write_first_hit_aovs(int width, int height, const std::vector<uint8_t>* tiles = nullptr);
+    void write_gpu_aovs(int width, int height);
+    void record_sample_moments(int index, const Color& sample);
+    std::vector<float> sample_variance(int samples) const;
+    // Denoise (optionally) and gamma-correct the linear image in image_data_
+    void finish_image(int width, int height, int samples, bool denoise);
+    CostHeatmap* heatmap_target() { return cost_heatmap_enabled_ ? &cost_heatmap_ : nullptr; }
+    void publish_frame_stats(int width, int height, int samples);
+    // tile_scheduler_.run() that adds the run's own ray counts to the frame
+    bool run_tiles(int width, int height, const TileScheduler::TileFunction& fn,
+                   const std::atomic<bool>* stop_flag = nullptr);
+    // trace()'s per-tile loop, writing averages to out with the given row
+    // stride; frame_buffers also records moments and sample-count AOVs
+    void trace_tile_samples(int width, int height, const RenderTile& tile, CostHeatmap* heatmap,
+                            bool frame_buffers, Color* out, int out_stride);
+    // One progressive sample pass over every tile not already past it. The
+    // accumulation starts at first_pass; tiles behind replay their missing passes.
+    void trace_pass(int width, int height, uint64_t seed, uint32_t first_pass, uint32_t pass, CostHeatmap* heatmap);
+    // Edit tracking of a progressive render: primary-hit primitives per tile
+    void begin_tile_tracking(int width, int height);
+    void record_tile_primitives(int tile_index, const std::vector<int>& objects);
+    // Resets the tiles the scene edits since the last call can affect; returns how many
+    size_t apply_scene_edits(int width, int height);
+    void mark_edited_tiles(const std::vector<SceneEdit>& edits, int width, int height,
+                           std::vector<uint8_t>& tiles) const;
+    // Drops cached vertices after geometry edits since they were recorded
+    void sync_vertex_cache_edits();
+    void fill_vertex_frame(PathVertexFrame& frame, int width, int height, uint64_t seed) const;
+    void fill_checkpoint_header(RenderCheckpoint& checkpoint, int width, int height) const;
+    void fill_accumulation_header(AccumulationHeader& header, int width, int height, uint64_t seed) const;
+    void submit_checkpoint(int width, int height, const ProgressiveConfig& config, uint64_t seed,
+                           int step, int step_samples, int step_start_samples);
     Vector3 random_in_unit_sphere() const;
     Vector3 random_unit_vector() const;
     Vector3 random_in_hemisphere(const Vector3& normal) const;
@@ -125,18 +315,75 @@ private:
     bool trace_gpu_progressive(int width, int height);  // GPU progressive rendering
     bool readbackGPUResult(int width, int height);
     void updateGPUUniforms(int width, int height, int samples, bool outputLinear = false);
+    bool bindReservoirBuffers(int width, int height);
+    void finishReservoirFrame();
     
     // Scene data
     std::shared_ptr<SceneManager> scene_manager_;
     Camera camera_;
     std::vector<Color> image_data_;
+    std::vector<Color> linear_image_;
     
     // CPU rendering state
     int max_depth_;
     int samples_per_pixel_;
     std::atomic<bool> stop_requested_;
-    mutable std::mt19937 rng_;
-    mutable std::uniform_real_distribution<float> uniform_dist_;
+    TileScheduler tile_scheduler_;
+    
+    // Preview direct-light resampling (CPU reservoirs; GPU ones below)
+    bool direct_light_resampling_;
+    std::unique_ptr<DirectLightResampler> light_resampler_;
+    bool irradiance_cache_enabled_;
+    std::unique_ptr<IrradianceCache> irradiance_cache_;
+    bool raster_primary_visibility_;
+    std::unique_ptr<PrimaryVisibility> primary_visibility_;
+    uint64_t scene_version_;      // Last scene edit applied to the cache
+    uint64_t preview_frame_;
+    uint64_t random_seed_ = 0;
+    uint64_t accumulation_seed_ = 0;     // Seed of the sums accumulate_passes() adds to
+    uint32_t accumulated_passes_ = 0;
+    
+    // Denoising stage and the per-sample moments it needs
+    bool denoising_enabled_;
+    std::unique_ptr<Denoiser> denoiser_;
+    TrackedVector<float, MemorySubsystem::FRAME_BUFFERS> luminance_sum_;
+    TrackedVector<float, MemorySubsystem::FRAME_BUFFERS> luminance_sq_sum_;
+    
+    // Samples per pixel of the progressive render in flight, and its checkpoints
+    TrackedVector<uint32_t, MemorySubsystem::FRAME_BUFFERS> pixel_samples_;
+    std::unique_ptr<CheckpointWriter> checkpoint_writer_;
+    std::chrono::steady_clock::duration checkpoint_interval_;
+    std::unique_ptr<RenderCheckpoint> resume_checkpoint_;
+    std::shared_ptr<RenderCache> render_cache_;
+    
+    // Scene edits during progressive renders, and the primitives each tile's
+    // primary rays hit; tiles loaded from a checkpoint or cache have no record
+    EditInvalidation edit_invalidation_;
+    int edit_bleed_tiles_;
+    uint64_t edit_version_;
+    std::vector<std::vector<uint32_t>> tile_primitives_;
+    std::vector<uint8_t> tile_primitives_known_;
+    size_t invalidated_tiles_;
+    std::unique_ptr<PathVertexCache> vertex_cache_;
+    bool vertex_cache_active_;
+    uint64_t vertex_cache_version_;   // Last scene edit checked against the vertex cache
+    
+    // Requested AOVs and the buffers of the last frame
+    AOVMask requested_aovs_;
+    AOVBuffers aovs_;
+    
+    // Cost heatmap of the last CPU frame
+    bool cost_heatmap_enabled_;
+    HeatmapMetric heatmap_metric_;
+    CostHeatmap cost_heatmap_;
+    
+    // Rays this tracer's tile runs counted since frame start, and the
+    // published per-frame stats. Other tracers' threads are not included.
+    bool frame_stats_active_;
+    RayStats frame_rays_;
+    std::chrono::steady_clock::time_point frame_start_time_;
+    mutable std::mutex frame_stats_mutex_;
+    FrameStats frame_stats_;
     
 #ifdef USE_GPU
     // GPU rendering state
@@ -154,6 +401,17 @@ private:
     SDL_GLContext gl_context_;
     std::shared_ptr<GPUBuffer> rngBuffer_;
     
+    // Reservoir ping-pong buffers for trace_gpu_preview
+    static constexpr int MAX_GPU_LIGHTS = 32;
+    std::shared_ptr<GPUBuffer> reservoirBuffers_[2];
+    int reservoirWidth_;
+    int reservoirHeight_;
+    int reservoirHistoryIndex_;
+    bool reservoirHistoryValid_;
+    bool gpuResamplingActive_;
+    Camera reservoirHistoryCamera_;
+    std::vector<int> gpuLightIndices_;
+    
     // Asynchronous GPU state
     struct AsyncGPUState {
         bool active = false;
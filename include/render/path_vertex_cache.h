@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/resource_monitor.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+struct PathVertexCacheConfig {
+    int passes = 4;    // Leading progressive passes whose vertices are kept; 0 turns the cache off
+    int depth = 1;     // Vertices per sample: 1 keeps first hits, 2 adds second hits
+};
+
+struct PathVertexCacheStats {
+    uint64_t bytes = 0;
+    uint64_t recorded_passes = 0;   // Tile passes traced and stored
+    uint64_t reused_passes = 0;     // Tile passes replayed from stored vertices
+    uint64_t invalidations = 0;     // Geometry or view changes that dropped everything
+};
+
+// One stored hit along a camera path, kept with the direction of the ray
+// that found it. A vertex is only read back for that exact ray.
+struct PathVertex {
+    static constexpr int32_t MISS = -1;          // The ray left the scene
+    static constexpr int32_t NOT_TRACED = -2;    // The path ended before reaching this vertex
+
+    Vector3 direction;
+    Vector3 normal;
+    float t = 0.0f;
+    int32_t object = NOT_TRACED;   // SceneManager object index
+};
+
+// The stored vertices of one camera sample, consumed front to back along the path
+struct PathVertexSpan {
+    PathVertex* vertices = nullptr;
+    int count = 0;
+    bool reuse = false;   // Read vertices whose rays match instead of intersecting; otherwise record them
+};
+
+// Everything the camera rays of a progressive render depend on
+struct PathVertexFrame {
+    int width = 0;
+    int height = 0;
+    int tile_size = 0;
+    uint64_t seed = 0;
+    Vector3 camera_position;
+    Vector3 camera_target;
+    Vector3 camera_up;
+    float camera_fov = 0.0f;
+    float camera_aspect = 0.0f;
+    // SceneManager::geometry_hash(); catches geometry changed without an edit record
+    uint64_t geometry = 0;
+
+    bool same_rays(const PathVertexFrame& other, bool any_seed) const;
+};
+
+// First (and optionally second) hits of every camera sample in the leading
+// passes of a progressive render. A material edit leaves geometry alone, so
+// passes replayed after one, in the same render or the next render of the
+// same view and geometry, take their hits from here and only shade and
+// bounce further. A second hit is reused only behind a reused first hit
+// that scatters the same ray again. Each tile pass is recorded by one
+// worker, so workers need no locking.
+class PathVertexCache {
+public:
+    explicit PathVertexCache(const PathVertexCacheConfig& config = PathVertexCacheConfig());
+
+    PathVertexCache(const PathVertexCache&) = delete;
+    PathVertexCache& operator=(const PathVertexCache&) = delete;
+
+    void set_config(const PathVertexCacheConfig& config);
+    const PathVertexCacheConfig& config() const { return config_; }
+    bool enabled() const { return config_.passes > 0 && config_.depth > 0; }
+
+    // Keeps what was recorded when frame shoots the same rays, else starts empty.
+    // Returns whether anything recorded was kept.
+    bool begin_frame(const PathVertexFrame& frame, int tile_count);
+    const PathVertexFrame& frame() const { return frame_; }
+    bool holds(const PathVertexFrame& frame, bool any_seed) const;
+    // Geometry changed: nothing recorded so far can be reused
+    void invalidate();
+    void release();
+
+    bool covers(uint32_t pass) const { return pass < static_cast<uint32_t>(passes_); }
+    bool is_recorded(int tile_index, uint32_t pass) const { return recorded_[tile_slot(tile_index, pass)] != 0; }
+    // Vertices of pixel's sample in a covered pass, to read back when the tile pass is recorded
+    PathVertexSpan sample(int tile_index, size_t pixel, uint32_t pass);
+    // Called once a tile has traced every pixel of a covered pass
+    void finish_tile_pass(int tile_index, uint32_t pass, bool reused);
+
+    PathVertexCacheStats get_stats() const;
+
+private:
+    bool any_recorded() const;
+    size_t tile_slot(int tile_index, uint32_t pass) const {
+        return static_cast<size_t>(tile_index) * passes_ + pass;
+    }
+
+    PathVertexCacheConfig config_;
+    PathVertexFrame frame_;
+    int passes_;
+    int depth_;
+    size_t pixel_count_;
+    TrackedVector<PathVertex, MemorySubsystem::PATH_VERTEX_CACHE> vertices_;
+    std::vector<uint8_t> recorded_;
+    std::atomic<uint64_t> recorded_passes_;
+    std::atomic<uint64_t> reused_passes_;
+    std::atomic<uint64_t> invalidations_;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/camera.h"
+#include "render/tile_scheduler.h"
+#include <cstdint>
+#include <vector>
+
+class SceneManager;
+class Primitive;
+
+// Pixel rectangle [x0, x1) x [y0, y1)
+struct PixelRect {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+
+    bool contains(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+    bool overlaps(const RenderTile& tile) const {
+        return x0 < tile.x1 && tile.x0 < x1 && y0 < tile.y1 && tile.y0 < y1;
+    }
+};
+
+// Pixels whose camera rays can pass through bounds. The corners are
+// projected onto the image plane; bounds straddling the camera plane, or
+// unbounded ones, cover the whole frame. False when nothing is on screen.
+bool project_bounds(const Camera& camera, const AABB& bounds, int width, int height, PixelRect& rect);
+
+// Camera-ray visibility from rasterised object bounds. build() projects
+// every object's bounds to a pixel rectangle and sorts the on-screen ones by
+// how near to the camera their bounds come. A tile bins the rectangles that
+// overlap it, and each pixel intersects only the candidates covering it,
+// nearest first, until the closest hit is in front of the next bounds.
+// Hits, ties included, are the ones SceneManager::hit_scene finds. A torus
+// marches in steps sized by the distance it is given, so its hit depends on
+// which objects were tested before it; tiles it covers use hit_scene.
+class PrimaryVisibility {
+public:
+    // Footprints of scene's objects in a width x height frame from camera.
+    // The scene must not change until the frame is done.
+    void build(const SceneManager& scene, const Camera& camera, int width, int height);
+    void clear();
+
+    // Footprints overlapping tile, nearest first. False when one of them
+    // needs scene order, in which case hit() must not be used for the tile.
+    bool bin_tile(const RenderTile& tile, std::vector<uint32_t>& candidates) const;
+    // Whether any candidate's footprint covers pixel (x, y). Rays through
+    // the pixel can only hit something when one does.
+    bool covers(const std::vector<uint32_t>& candidates, int x, int y) const;
+    // Closest hit of ray, a camera ray through pixel (x, y), in (t_min, inf).
+    // Only for candidates binned by a bin_tile() call that returned true.
+    bool hit(const std::vector<uint32_t>& candidates, int x, int y, const Ray& ray, float t_min,
+             HitRecord& rec) const;
+
+    size_t footprint_count() const { return footprints_.size(); }
+
+private:
+    struct Footprint {
+        PixelRect rect;
+        float near_distance;          // Camera to the nearest point of the bounds
+        int object;                   // SceneManager object index
+        const Primitive* primitive;
+        bool order_dependent;         // Hit depends on the t_max it is given
+    };
+
+    std::vector<Footprint> footprints_;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "render/accumulation_file.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Stable identity of an accumulation: resolution, depth, camera, scene
+// content hash, seed and tile size (tiles seed their own random streams),
+// plus the version of the code that samples it. Seed 0 stands for "any
+// seed", which is what a render with a random seed asks for.
+uint64_t render_cache_key(const AccumulationHeader& identity, int tile_size);
+
+// Finished progressive accumulations on local disk, one accumulation file
+// per key, evicted least recently used first once the directory grows past
+// max_bytes. Entries hold passes [0, n) of the sample sequence, so a
+// request for n samples is served as is and a request for more continues
+// from pass n. Recency survives restarts through file modification times.
+// Safe to share between threads.
+class RenderCache {
+public:
+    // Bump whenever sampling, the accumulation layout or key inputs change.
+    // Keys also hash the build's git revision, but builds outside a git
+    // checkout all report "unknown" and rely on this alone.
+    static constexpr uint32_t KEY_VERSION = 1;
+
+    struct Config {
+        std::string directory;
+        uint64_t max_bytes = 1ull << 30;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;              // Entries with exactly the requested samples
+        uint64_t partial_hits = 0;      // Entries with fewer, resumed from
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t evictions = 0;
+        uint64_t bytes = 0;
+        uint64_t entries = 0;
+    };
+
+    explicit RenderCache(const Config& config);
+
+    RenderCache(const RenderCache&) = delete;
+    RenderCache& operator=(const RenderCache&) = delete;
+
+    // Creates the directory if needed and indexes the entries already in it
+    bool open();
+
+    // The entry for key with at most max_passes passes (and luminance
+    // moments when needed); false on a miss
+    bool lookup(uint64_t key, uint32_t max_passes, bool need_variance, AccumulationFile& entry);
+    // Keeps file under key unless the cache already has as many passes for
+    // it, then evicts down to the size limit. file must cover passes [0, n).
+    bool store(uint64_t key, const AccumulationFile& file);
+    void clear();
+
+    Stats stats() const;
+    const Config& config() const { return config_; }
+
+private:
+    struct Entry {
+        uint64_t bytes = 0;
+        uint64_t last_used = 0;
+        uint32_t passes = 0;
+    };
+
+    std::string path(uint64_t key) const;
+    void touch(uint64_t key, Entry& entry);
+    void evict_locked(uint64_t keep);
+
+    Config config_;
+    mutable std::mutex mutex_;
+    std::map<uint64_t, Entry> entries_;
+    uint64_t clock_ = 0;
+    Stats stats_;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/common.h"
+#include "render/path_tracer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// State of a CPU progressive render between two sample passes: the linear
+// accumulation buffer and per-pixel sample counts, the pass cursor and
+// seed that make the remaining passes draw the same random numbers they
+// would have drawn without the interruption, and what the image depends
+// on (camera, settings, scene hash) so a stale checkpoint is not resumed.
+//
+// On disk: a fixed header, then RGB sums as floats, run-length encoded
+// sample counts and the optional denoiser moments, followed by an FNV-1a
+// checksum of everything before it. Host byte order; checkpoints are for
+// resuming on the same machine, not for interchange.
+struct RenderCheckpoint {
+    static constexpr uint32_t VERSION = 1;
+
+    int width = 0;
+    int height = 0;
+    int tile_size = 0;
+    int max_depth = 0;
+    ProgressiveConfig config;
+    uint64_t seed = 0;              // Pass p of tile t seeds from mix_seed(mix_seed(seed, p), t)
+    int step = 0;                   // Progressive step in progress
+    int step_samples = 0;           // Passes that step adds
+    int step_start_samples = 0;     // Passes completed before it
+    Vector3 camera_position;
+    Vector3 camera_target;
+    Vector3 camera_up;
+    float camera_fov = 0.0f;
+    float camera_aspect = 0.0f;
+    uint64_t scene_hash = 0;
+
+    std::vector<Color> accumulation;        // Sums of samples, not averages
+    std::vector<uint32_t> sample_counts;
+    std::vector<float> luminance_sum;       // Denoiser moments; empty when denoising was off
+    std::vector<float> luminance_sq_sum;
+
+    // True when other describes the same image: resolution, depth, camera and scene
+    bool same_render(const RenderCheckpoint& other) const;
+    uint32_t min_samples() const;
+
+    // Writes to a temporary file and renames it over filename, so a crash
+    // mid-write leaves the previous checkpoint intact
+    bool save(const std::string& filename) const;
+    // False on a missing, truncated or corrupt file
+    static bool load(const std::string& filename, RenderCheckpoint& checkpoint);
+};
+
+// Saves checkpoints on a background thread so the render only pays for a
+// buffer copy. When a write is still running, a newer submission replaces
+// the one waiting behind it.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const std::string& filename);
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    void submit(std::unique_ptr<RenderCheckpoint> checkpoint);
+    // Blocks until every submitted checkpoint is on disk
+    void wait();
+
+    const std::string& filename() const { return filename_; }
+    uint64_t written() const;
+    uint64_t failed() const;
+
+private:
+    void run();
+
+    std::string filename_;
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable idle_;
+    std::unique_ptr<RenderCheckpoint> pending_;
+    bool writing_ = false;
+    bool stop_ = false;
+    uint64_t written_ = 0;
+    uint64_t failed_ = 0;
+    std::thread thread_;
+};
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "core/common.h"
+#include "render/aov.h"
+#include "render/cost_heatmap.h"
+#include <cstdint>
 #include <memory>
 #include <atomic>
 #include <thread>
 #include <functional>
+#include <chrono>
+#include <string>
 
 // Forward declarations
 class PathTracer;
@@ -13,7 +18,12 @@ class ImageOutput;
 class Camera;
 class GPUComputePipeline;
 class GPUMemoryManager;
+class GPUPerformanceMonitor;
+class MetricsExporter;
+class SharedFramebuffer;
+class RenderCache;
 struct ProgressiveConfig;
+enum class EditInvalidation;
 
 enum class RenderState {
     IDLE,           // No render in progress
@@ -37,11 +47,27 @@ struct RenderMetrics {
     int samplesPerPixel = 0;
     int imageWidth = 0;
     int imageHeight = 0;
-    float cpu_utilization = 0.0f;
-    float gpu_utilization = 0.0f;
-    float memory_usage_mb = 0.0f;
+    float cpu_utilization = 0.0f;     // Percent of all cores, process CPU time over the last sample interval
+    float gpu_utilization = 0.0f;     // GPU busy time over wall time; 0 without a performance monitor
+    float memory_usage_mb = 0.0f;     // Process resident set
+    float peak_memory_mb = 0.0f;      // Resident set high-water mark
+    float gpu_memory_mb = 0.0f;       // Buffers held by GPUMemoryManager
+    float gpu_peak_memory_mb = 0.0f;
+    double gpu_compute_ms = 0.0;      // Timer-query interval of the last timed dispatch
+    double gpu_transfer_ms = 0.0;
+    double process_cpu_seconds = 0.0;
+    double render_cpu_seconds = 0.0;  // CPU time of the tile workers in the last tiled pass
     float render_time_ms = 0.0f;
     int samples_per_second = 0;
+    
+    // Ray counters of the last CPU frame
+    uint64_t primary_rays = 0;
+    uint64_t secondary_rays = 0;
+    uint64_t shadow_rays = 0;
+    uint64_t intersection_tests = 0;
+    double mrays_per_second = 0.0;
+    double tests_per_ray = 0.0;
+    double mean_path_length = 0.0;
 };
 
 class RenderEngine {
@@ -68,9 +94,17 @@ public:
     // State change notifications
     void set_state_change_callback(std::function<void(RenderState)> callback);
     
-    // State persistence and recovery
+    // State persistence and recovery. With checkpointing on, CPU progressive
+    // renders save their accumulation buffers to filename every interval and
+    // when stopped; restore_render_state() loads that file and returns true
+    // when the next progressive render will continue from it.
+    void set_checkpointing(const std::string& filename, std::chrono::seconds interval);
     void save_render_state();
-    void restore_render_state();
+    bool restore_render_state();
+    // Disk cache of finished progressive accumulations, see PathTracer::set_render_cache
+    void set_render_cache(std::shared_ptr<RenderCache> cache);
+    // Tiles a scene edit resets mid-render, see PathTracer::set_edit_invalidation
+    void set_edit_invalidation(EditInvalidation mode, int bleed_tiles = 1);
     
     // Component management
     void set_scene_manager(std::shared_ptr<SceneManager> scene_manager);
@@ -80,12 +114,28 @@ public:
     void set_render_size(int width, int height);
     void set_max_depth(int depth);
     void set_samples_per_pixel(int samples);
+    void set_direct_light_resampling(bool enabled);  // Reservoir-resampled direct light in previews
+    bool is_direct_light_resampling_enabled() const;
+    void set_irradiance_cache(bool enabled);  // Cached indirect light in previews
+    bool is_irradiance_cache_enabled() const;
+    void set_raster_primary_visibility(bool enabled);  // Camera hits from rasterised bounds in previews
+    bool is_raster_primary_visibility_enabled() const;
+    void set_denoising(bool enabled);  // Edge-aware denoiser before display and save
+    bool is_denoising_enabled() const;
     void set_camera_position(const Vector3& position, const Vector3& target, const Vector3& up = Vector3(0, 1, 0));
+    void set_aovs(AOVMask mask);  // First-hit AOVs to write with the next render
+    void set_cost_heatmap(bool enabled, HeatmapMetric metric = HeatmapMetric::CYCLES);  // Per-pixel cost view
+    bool is_cost_heatmap_enabled() const;
+    HeatmapMetric get_heatmap_metric() const;
     
     // Output control
     void save_image(const std::string& filename);
     void display_image();
     void update_camera_preview(const Vector3& camera_pos, const Vector3& camera_target);
+    // Write every AOV of the last render as <base_filename>_<name>.pfm
+    bool save_aovs(const std::string& base_filename);
+    // Write every cost metric of the last render as <base_filename>_<metric>.pfm
+    bool save_cost_heatmap(const std::string& base_filename);
     
     // Camera movement handling
     void start_camera_movement();
@@ -98,6 +148,12 @@ public:
     bool initialize_gpu();
     void cleanup_gpu();
     RenderMetrics get_render_metrics() const;
+    // Source of measured GPU utilization for get_render_metrics()
+    void set_gpu_performance_monitor(std::shared_ptr<GPUPerformanceMonitor> monitor);
+    // Receives a metrics snapshot on every state change and progressive pass
+    void set_metrics_exporter(std::shared_ptr<MetricsExporter> exporter);
+    // Receives every frame and progressive pass that reaches the display
+    void set_shared_framebuffer(std::shared_ptr<SharedFramebuffer> framebuffer);
     
     // Dynamic scene synchronization for GPU acceleration
     void sync_scene_changes_to_gpu();
@@ -119,6 +175,8 @@ private:
     void render_worker();
     void progressive_render_worker(const ProgressiveConfig& config);
     void set_render_state(RenderState state);
+    void publish_metrics();
+    void publish_frame(const std::vector<Color>& display, int width, int height, int samples, int target_samples);
     
     // Render orchestration
     bool validate_render_components();
@@ -135,6 +193,7 @@ private:
 #ifdef USE_GPU
     std::shared_ptr<GPUComputePipeline> gpu_pipeline_;
     std::shared_ptr<GPUMemoryManager> gpu_memory_;
+    std::shared_ptr<GPUPerformanceMonitor> gpu_performance_monitor_;
 #endif
     
     int render_width_;
@@ -148,6 +207,9 @@ private:
     std::thread render_thread_;
     std::function<void(RenderState)> state_change_callback_;
     std::function<void(int, int, int, int)> progress_callback_;
+    std::shared_ptr<MetricsExporter> metrics_exporter_;
+    std::shared_ptr<SharedFramebuffer> shared_framebuffer_;
+    std::string checkpoint_filename_;
     
     // GPU acceleration state
     RenderMode render_mode_;
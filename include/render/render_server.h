@@ -0,0 +1,206 @@
+#pragma once
+
+#include "core/common.h"
+#include "render/tile_scheduler.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SceneManager;
+
+// Render server wire protocol, framed by send_message()/receive_message().
+// Payloads are the structs below, copied as raw bytes in host byte order.
+enum class RenderServerMessage : uint32_t {
+    SUBMIT = 1,         // Client: RenderJobRequest, then SceneManager::serialize() bytes (none = server default scene)
+    CANCEL = 2,         // Client: uint64 job id
+    ACCEPTED = 16,      // Server: uint64 job id
+    REJECTED = 17,      // Server: reason text
+    TILES = 18,         // Server: TileUpdateHeader, then per tile a TileUpdateEntry and its encoded bytes
+    DONE = 19           // Server: JobDoneMessage, after the job's last TILES
+};
+
+struct RenderJobRequest {
+    int32_t priority = 0;               // Higher first; equal priorities take turns pass by pass
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t samples_per_pixel = 16;     // One progressive pass per sample
+    int32_t max_depth = 10;
+    int32_t tile_size = TileScheduler::DEFAULT_TILE_SIZE;   // Granularity of the streamed updates
+    uint32_t update_interval_ms = 100;  // Minimum time between previews; the final pass is always sent
+    uint64_t seed = 1;
+    Vector3 camera_position;
+    Vector3 camera_target = Vector3(0, 0, -1);
+    Vector3 camera_up = Vector3(0, 1, 0);
+    float camera_fov = 45.0f;
+    float camera_aspect = 0.0f;         // 0 = width / height
+};
+
+struct TileUpdateHeader {
+    uint64_t job_id = 0;
+    uint32_t samples = 0;               // Passes accumulated in the image so far
+    uint32_t target_samples = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    uint32_t tile_count = 0;
+};
+
+enum class TileEncoding : uint32_t {
+    RAW = 0,            // The tile's RGB8 bytes
+    XOR_RLE = 1         // Run-length coded XOR against the tile as last sent
+};
+
+struct TileUpdateEntry {
+    int32_t x0 = 0;
+    int32_t y0 = 0;
+    int32_t x1 = 0;
+    int32_t y1 = 0;
+    uint32_t encoding = 0;
+    uint32_t size = 0;                  // Encoded bytes following this entry
+};
+
+enum class RenderJobStatus : uint32_t {
+    COMPLETED = 0,
+    CANCELLED = 1,
+    FAILED = 2
+};
+
+struct JobDoneMessage {
+    uint64_t job_id = 0;
+    uint32_t samples = 0;
+    uint32_t status = 0;                // RenderJobStatus
+};
+
+// Dirty-tile codec. Tiles are RGB8, row-major within the tile, with the
+// square-root gamma of the interactive view. The delta XORs current against
+// previous and run-length codes the result: a control byte below 0x80 is
+// followed by that many plus one literal bytes, one at or above 0x80 stands
+// for (c & 0x7f) + 1 unchanged bytes. Falls back to RAW when that is not
+// smaller. Returns the encoding.
+TileEncoding encode_tile_delta(const uint8_t* previous, const uint8_t* current, size_t size, std::string& out);
+// Applies an encoded tile to tile, which holds the previously sent bytes
+bool decode_tile_delta(TileEncoding encoding, const char* data, size_t data_size, uint8_t* tile, size_t size);
+
+// Serves render jobs to local clients over a Unix domain socket. Each
+// client submits jobs (a RenderJobRequest plus an optional serialized
+// scene) and receives progressive previews as dirty tiles, delta coded
+// against what it was sent before. All jobs share one render thread and
+// its tile pool: after every progressive pass the thread picks the
+// highest-priority job again, so a new urgent job overtakes running ones
+// within a pass. A slow client only ever receives the latest preview.
+// Jobs of a client that disconnects are cancelled.
+class RenderServer {
+public:
+    struct Config {
+        std::string socket_path;
+        int render_threads = 0;         // Tile threads per pass, 0 = hardware concurrency
+        int max_jobs = 16;              // Queued and running jobs across all clients
+        int max_pixels = 4096 * 4096;
+        int max_samples = 1 << 16;
+        int max_depth = 64;             // Bounces recurse on the render thread's stack
+        int max_tile_size = 256;
+    };
+
+    RenderServer();
+    explicit RenderServer(const Config& config);
+    ~RenderServer();
+
+    RenderServer(const RenderServer&) = delete;
+    RenderServer& operator=(const RenderServer&) = delete;
+
+    // Scene for requests that do not carry one; SceneManager::initialize()'s by default
+    void set_default_scene(const SceneManager& scene);
+
+    bool start();
+    // Closes every connection, cancels all jobs and removes the socket
+    void stop();
+    bool is_running() const { return running_.load(std::memory_order_relaxed); }
+
+    size_t job_count() const;
+    uint64_t completed_jobs() const { return completed_jobs_.load(std::memory_order_relaxed); }
+
+private:
+    struct Job;
+    struct Session;
+
+    void accept_loop();
+    void serve_session(Session* session);
+    bool handle_submit(Session& session, const std::string& payload);
+    // Sends whatever changed in a job since the session last sent it; true once the job is done and reported
+    bool send_updates(Session& session, size_t index, bool& failed);
+    void render_loop();
+    std::shared_ptr<Job> next_job();
+    void finish_job(Job& job, RenderJobStatus status);
+
+    Config config_;
+    std::string default_scene_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_requested_{false};
+    int listen_fd_ = -1;
+    std::thread acceptor_;
+    std::thread renderer_;
+
+    std::mutex sessions_mutex_;
+    std::vector<std::unique_ptr<Session>> sessions_;
+
+    mutable std::mutex jobs_mutex_;
+    std::condition_variable jobs_changed_;
+    std::vector<std::shared_ptr<Job>> jobs_;        // Unfinished jobs, in submission order
+    uint64_t next_job_id_ = 1;
+    uint64_t turn_ = 0;
+    std::atomic<uint64_t> completed_jobs_{0};
+};
+
+// Client side of the protocol, keeping the streamed image of each job
+class RenderClient {
+public:
+    struct Update {
+        uint64_t job_id = 0;
+        uint32_t samples = 0;
+        uint32_t target_samples = 0;
+        std::vector<RenderTile> tiles;  // Tiles changed by this update
+        bool done = false;
+        RenderJobStatus status = RenderJobStatus::COMPLETED;
+    };
+
+    RenderClient() = default;
+    ~RenderClient();
+
+    RenderClient(const RenderClient&) = delete;
+    RenderClient& operator=(const RenderClient&) = delete;
+
+    bool connect(const std::string& socket_path);
+    void disconnect();
+    bool is_connected() const { return fd_ >= 0; }
+
+    // Waits for the server's answer; 0 when rejected, with the reason in error.
+    // scene may be null for the server's default scene.
+    uint64_t submit(const RenderJobRequest& request, const SceneManager* scene, std::string* error = nullptr);
+    bool cancel(uint64_t job_id);
+
+    // Blocks for the next update of any job and applies it to that job's
+    // image. False when the connection is lost.
+    bool next_update(Update& update);
+
+    // Latest RGB8 image of a job; empty before its first update
+    const std::vector<uint8_t>& image(uint64_t job_id) const;
+
+private:
+    struct Message {
+        uint32_t type;
+        std::string payload;
+    };
+
+    bool apply(const Message& message, Update& update);
+
+    int fd_ = -1;
+    std::deque<Message> pending_;       // Updates that arrived while submit() waited
+    std::map<uint64_t, std::vector<uint8_t>> images_;
+};
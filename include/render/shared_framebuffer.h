@@ -0,0 +1,140 @@
+#pragma once
+
+#include "core/common.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Layout of the shared-memory framebuffer. The segment starts with a
+// SharedFramebufferHeader; slot i begins at slots_offset + i * slot_stride
+// with a SharedFrameSlot, followed by its display pixels at display_offset
+// and its linear pixels at linear_offset (both relative to the slot).
+// Frame n is written to slot n % slot_count, so a reader can keep using a
+// frame for slot_count - 1 further publications before it is overwritten.
+//
+// Each slot is guarded by a sequence lock: the writer makes sequence odd,
+// fills the slot and makes it even again. A reader takes the sequence,
+// reads, and trusts what it read only if the sequence is unchanged.
+enum SharedFrameFormat : uint32_t {
+    SHARED_FRAME_DISPLAY_RGBA8 = 1u << 0,       // 8-bit, gamma 2 as shown in the window, alpha 255
+    SHARED_FRAME_LINEAR_RGB32F = 1u << 1        // Float radiance before denoising, gamma and overlays
+};
+
+struct SharedFramebufferHeader {
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];                              // "PTSHMFB"
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t max_width;
+    uint32_t max_height;
+    uint64_t slots_offset;
+    uint64_t slot_stride;
+    std::atomic<uint64_t> latest_frame;         // Newest complete frame; 0 before the first
+    std::atomic<uint32_t> writer_pid;           // 0 once the writer has closed the segment
+};
+
+struct SharedFrameSlot {
+    std::atomic<uint32_t> sequence;             // Odd while the writer is inside
+    uint32_t format;                            // SharedFrameFormat bits present in this frame
+    uint32_t width;
+    uint32_t height;
+    uint64_t frame;
+    uint32_t samples;
+    uint32_t target_samples;
+    double timestamp;                           // Steady-clock seconds at publication
+    uint64_t display_offset;
+    uint64_t linear_offset;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared framebuffer atomics must be address-free");
+
+// Writer side: publishes frames into a named POSIX shared-memory segment
+// (shm_open name, e.g. "/pathtracer"). Frames larger than the configured
+// maximum are skipped. Without POSIX shared memory create() fails.
+class SharedFramebuffer {
+public:
+    struct Config {
+        std::string name;
+        int max_width = 1920;
+        int max_height = 1080;
+        int slots = 3;
+    };
+
+    SharedFramebuffer() = default;
+    ~SharedFramebuffer();
+
+    SharedFramebuffer(const SharedFramebuffer&) = delete;
+    SharedFramebuffer& operator=(const SharedFramebuffer&) = delete;
+
+    // Creates (or replaces) the segment; readers see no frame until the first publish()
+    bool create(const Config& config);
+    // Unmaps and unlinks the segment; mapped readers keep their view
+    void close();
+    bool is_open() const { return base_ != nullptr; }
+
+    // Publishes display pixels as produced by PathTracer (gamma 2 applied)
+    // and, when given, the tracer's linear radiance for the same frame.
+    // Without it the frame lacks SHARED_FRAME_LINEAR_RGB32F. Safe from any thread.
+    bool publish(const std::vector<Color>& display, int width, int height, int samples, int target_samples,
+                 const std::vector<Color>* linear = nullptr);
+    uint64_t frames_published() const { return frame_.load(std::memory_order_relaxed); }
+
+private:
+    Config config_;
+    std::mutex mutex_;
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    std::atomic<uint64_t> frame_{0};   // Written under mutex_, readable without it
+    bool warned_size_ = false;
+};
+
+// A frame mapped in place. Pointers stay valid while the reader is open,
+// but the pixels are only known to be intact if validate() agrees after
+// they were read.
+struct SharedFrameView {
+    uint64_t frame = 0;
+    uint32_t format = 0;
+    int width = 0;
+    int height = 0;
+    int samples = 0;
+    int target_samples = 0;
+    double timestamp = 0.0;
+    const uint8_t* display = nullptr;           // width * height RGBA8
+    const float* linear = nullptr;              // width * height RGB; null without SHARED_FRAME_LINEAR_RGB32F
+    uint32_t sequence = 0;
+    const SharedFrameSlot* slot = nullptr;
+};
+
+// Reader side, for viewers and tests; external tools can follow the
+// layout above directly.
+class SharedFramebufferReader {
+public:
+    SharedFramebufferReader() = default;
+    ~SharedFramebufferReader();
+
+    SharedFramebufferReader(const SharedFramebufferReader&) = delete;
+    SharedFramebufferReader& operator=(const SharedFramebufferReader&) = delete;
+
+    bool open(const std::string& name);
+    void close();
+    bool is_open() const { return base_ != nullptr; }
+
+    // Newest frame number, 0 when none was published yet
+    uint64_t latest_frame() const;
+    // Maps the newest frame without copying; false when there is none or
+    // the writer kept overwriting it
+    bool acquire(SharedFrameView& view) const;
+    // True when the frame in view was not touched since acquire()
+    bool validate(const SharedFrameView& view) const;
+    // Copies the newest frame out; display is RGBA8, linear RGB or empty
+    bool read(SharedFrameView& view, std::vector<uint8_t>& display, std::vector<float>& linear) const;
+
+private:
+    const void* base_ = nullptr;
+    size_t size_ = 0;
+};
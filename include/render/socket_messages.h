@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Length-prefixed messages over a stream socket, shared by the tile
+// worker protocol and the render server. Each message is a
+// {uint32 type, uint32 size} header followed by size payload bytes, in
+// host byte order since both ends run on one machine.
+//
+// All calls block, retry on EINTR and never raise SIGPIPE; false means
+// the peer is gone or the stream is corrupt. Without POSIX sockets
+// every call fails.
+bool send_message(int fd, uint32_t type, const void* payload, size_t size);
+// Payloads larger than max_size are treated as a corrupt stream
+bool receive_message(int fd, uint32_t& type, std::string& payload, uint32_t max_size = 1u << 30);
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "core/common.h"
+#include "render/tile_scheduler.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class SceneManager;
+
+// Everything a worker needs, besides the scene, to render tiles of one
+// frame the way PathTracer::trace() renders them
+struct DistributedFrame {
+    int width = 0;
+    int height = 0;
+    int samples_per_pixel = 1;
+    int max_depth = 10;
+    int tile_size = TileScheduler::DEFAULT_TILE_SIZE;
+    uint64_t seed = 1;              // Must be non-zero for the tiles to be repeatable
+    Vector3 camera_position;
+    Vector3 camera_target = Vector3(0, 0, -1);
+    Vector3 camera_up = Vector3(0, 1, 0);
+    float camera_fov = 45.0f;
+    float camera_aspect = 16.0f / 9.0f;
+};
+
+// Counters of the last TileDistributor::render()
+struct DistributionStats {
+    std::vector<uint64_t> tiles_per_worker;     // Results accepted from each worker slot
+    uint64_t tiles = 0;
+    uint64_t speculative_tiles = 0;     // Copies of straggling tiles sent to idle workers
+    uint64_t requeued_tiles = 0;        // Tiles lost with a dead worker
+    uint64_t worker_restarts = 0;
+    double seconds = 0.0;
+};
+
+// Coordinator of local worker processes. Each worker is a fresh process
+// spawned with --worker-fd and talks to the coordinator over a Unix socket
+// pair: it receives the serialized scene, a frame description and tile
+// assignments, and streams finished tiles back. The protocol only needs a
+// byte stream, so the same worker loop can later run behind a remote
+// connection.
+//
+// Workers are exec'd rather than forked, so they share no lock state with
+// the coordinator's threads; the worker executable must answer
+// --worker-fd FD by calling run_tile_worker(FD).
+class TileDistributor {
+public:
+    struct Config {
+        int workers = 0;                    // 0 = hardware concurrency
+        int tiles_in_flight = 2;            // Per worker, so a worker never waits on the coordinator
+        double straggler_factor = 4.0;      // A tile is straggling at this multiple of the median tile time...
+        std::chrono::milliseconds min_straggler_time{250};   // ...and never sooner than this
+        int max_restarts = 4;               // Replacement workers per render
+        std::string worker_executable;      // Empty = the running executable
+    };
+
+    // Linear tile pixels, row-major within the tile, as they arrive
+    using TileCallback = std::function<void(const RenderTile&, const std::vector<Color>&)>;
+
+    TileDistributor();
+    explicit TileDistributor(const Config& config);
+    ~TileDistributor();
+
+    TileDistributor(const TileDistributor&) = delete;
+    TileDistributor& operator=(const TileDistributor&) = delete;
+
+    // Spawns the workers and sends them the scene
+    bool start(const SceneManager& scene);
+    // Closes the workers' sockets and reaps them; workers still running after a grace period are killed
+    void stop();
+    bool is_running() const { return worker_count() > 0; }
+    // Sends a changed scene to every worker; later frames render it
+    bool set_scene(const SceneManager& scene);
+
+    // Renders a frame across the workers into a linear (not gamma-corrected)
+    // image. Tiles of dead workers are requeued and the workers replaced;
+    // tiles a worker sits on for too long are also given to an idle worker
+    // and the first result wins. False when no worker is left.
+    bool render(const DistributedFrame& frame, std::vector<Color>& image, const TileCallback& on_tile = nullptr);
+
+    int worker_count() const;
+    // Process id per worker slot, -1 for a slot whose worker could not be replaced
+    std::vector<int> worker_pids() const;
+    const DistributionStats& last_stats() const { return stats_; }
+
+private:
+    struct Worker;
+
+    // Spawns a worker into slot and sends it the scene, and the frame when rendering
+    bool spawn(size_t slot, bool rendering);
+    // Kills and reaps the worker in slot, leaving the slot empty
+    void retire(size_t slot);
+
+    Config config_;
+    std::string scene_bytes_;
+    std::vector<std::unique_ptr<Worker>> workers_;   // Empty slots are dead workers
+    uint64_t frame_id_ = 0;
+    DistributedFrame frame_;
+    DistributionStats stats_;
+};
+
+// Worker side: serves one coordinator connection until it closes. Returns
+// the process exit status.
+int run_tile_worker(int fd);
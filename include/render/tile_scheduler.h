@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "core/ray_stats.h"
+
+// Rectangular block of pixels processed by one worker at a time.
+// Bounds are half-open: [x0, x1) x [y0, y1).
+struct RenderTile {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+    int index = 0;
+
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+    int pixel_count() const { return width() * height(); }
+};
+
+// Timing of one TileScheduler::run, for load balance and scaling analysis
+struct TileRunStats {
+    double wall_seconds = 0.0;
+    std::vector<double> thread_busy_seconds;   // Time spent inside the tile callback, per worker
+    std::vector<double> thread_cpu_seconds;    // CPU time of each worker; below busy time when preempted
+    std::vector<int> thread_tiles;
+    std::vector<double> tile_seconds;          // Indexed by RenderTile::index
+    RayStats rays;                             // Counted by this run's workers only, not by other renders
+
+    double busy_seconds() const;
+    // Slowest worker's busy time over the mean; 1 means perfectly balanced
+    double imbalance() const;
+};
+
+// Splits an image into tiles and runs a callback over them on a set of
+// worker threads. Tiles are claimed through an atomic counter, so faster
+// threads pick up more work and no tile is processed twice.
+class TileScheduler {
+public:
+    using TileFunction = std::function<void(const RenderTile&, int thread_index)>;
+
+    static constexpr int DEFAULT_TILE_SIZE = 32;
+
+    explicit TileScheduler(int thread_count = 0, int tile_size = DEFAULT_TILE_SIZE);
+
+    // 0 selects std::thread::hardware_concurrency()
+    void set_thread_count(int count);
+    int thread_count() const { return thread_count_; }
+
+    void set_tile_size(int size);
+    int tile_size() const { return tile_size_; }
+
+    // Row-major tile list covering a width x height image
+    std::vector<RenderTile> make_tiles(int width, int height) const;
+
+    // Runs fn over every tile and blocks until all workers finish.
+    // Returns false if stop_flag was raised before every tile was processed.
+    bool run(int width, int height, const TileFunction& fn,
+             const std::atomic<bool>* stop_flag = nullptr) const;
+
+    // Stats of the most recent run(); runs must not overlap for this to be meaningful
+    const TileRunStats& last_run_stats() const { return last_run_stats_; }
+
+private:
+    int thread_count_;
+    int tile_size_;
+    mutable TileRunStats last_run_stats_;
+};
+
+// Tiles not yet claimed, summed over every run() in progress
+int64_t tile_scheduler_pending_tiles();
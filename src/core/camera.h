@@ -19,6 +19,9 @@ public:
     
     // Getters
     const Vector3& get_position() const { return position_; }
+    const Vector3& get_target() const { return target_; }
+    const Vector3& get_up() const { return up_; }
+    float get_fov() const { return fov_; }
     const Vector3& get_lower_left_corner() const { return lower_left_corner_; }
     const Vector3& get_horizontal() const { return horizontal_; }
     const Vector3& get_vertical() const { return vertical_; }
@@ -171,9 +171,60 @@ struct HitRecord {
     Material material;
     float t;
     bool front_face;
+    int object_index = -1;   // Index into SceneManager::get_objects(), set by hit_scene
     
     void set_face_normal(const Ray& ray, const Vector3& outward_normal) noexcept {
         front_face = ray.direction.dot(outward_normal) < 0;
         normal = front_face ? outward_normal : outward_normal * -1.0f;
     }
-};
\ No newline at end of file
+};
+
+// Axis-aligned bounding box. A default-constructed box is empty.
+struct AABB {
+    Vector3 lower;
+    Vector3 upper;
+    
+    AABB() noexcept
+        : lower(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
+          upper(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()) {}
+    
+    AABB(const Vector3& lower, const Vector3& upper) noexcept : lower(lower), upper(upper) {}
+    
+    static AABB infinite() noexcept {
+        const float inf = std::numeric_limits<float>::infinity();
+        return AABB(Vector3(-inf, -inf, -inf), Vector3(inf, inf, inf));
+    }
+    
+    bool empty() const noexcept {
+        return lower.x > upper.x || lower.y > upper.y || lower.z > upper.z;
+    }
+    
+    void expand(const Vector3& p) noexcept {
+        lower = Vector3(std::min(lower.x, p.x), std::min(lower.y, p.y), std::min(lower.z, p.z));
+        upper = Vector3(std::max(upper.x, p.x), std::max(upper.y, p.y), std::max(upper.z, p.z));
+    }
+    
+    void expand(const AABB& other) noexcept {
+        if (other.empty()) return;
+        expand(other.lower);
+        expand(other.upper);
+    }
+    
+    AABB padded(float margin) const noexcept {
+        if (empty()) return *this;
+        return AABB(lower - Vector3(margin, margin, margin), upper + Vector3(margin, margin, margin));
+    }
+    
+    bool contains(const Vector3& p) const noexcept {
+        return p.x >= lower.x && p.x <= upper.x &&
+               p.y >= lower.y && p.y <= upper.y &&
+               p.z >= lower.z && p.z <= upper.z;
+    }
+    
+    bool overlaps(const AABB& other) const noexcept {
+        if (empty() || other.empty()) return false;
+        return lower.x <= other.upper.x && upper.x >= other.lower.x &&
+               lower.y <= other.upper.y && upper.y >= other.lower.y &&
+               lower.z <= other.upper.z && upper.z >= other.lower.z;
+    }
+};
@@ -0,0 +1,496 @@
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+
+std::atomic<int> g_log_levels[LOG_CHANNEL_COUNT] = {
+    {static_cast<int>(LogLevel::INFO)}, {static_cast<int>(LogLevel::INFO)},
+    {static_cast<int>(LogLevel::INFO)}, {static_cast<int>(LogLevel::INFO)},
+    {static_cast<int>(LogLevel::INFO)}, {static_cast<int>(LogLevel::INFO)}
+};
+
+namespace {
+
+struct LogRecord {
+    uint64_t time_ns = 0;
+    uint32_t thread_id = 0;
+    uint32_t suppressed = 0;
+    LogLevel level = LogLevel::INFO;
+    LogChannel channel = LogChannel::GENERAL;
+    uint32_t length = 0;
+    char text[LOG_MESSAGE_CAPACITY];
+};
+
+// Bounded multi-producer queue after Vyukov: each cell's sequence number
+// says whether it is free for the producer at that position or holds a
+// record for the consumer. Producers never wait on each other or the writer.
+class LogQueue {
+public:
+    LogQueue() {
+        for (size_t i = 0; i < LOG_QUEUE_CAPACITY; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(const LogRecord& record) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & MASK];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        std::memcpy(&cell->record, &record, offsetof(LogRecord, text) + record.length);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Single consumer
+    bool try_pop(LogRecord& record) {
+        size_t pos = dequeue_pos_;
+        Cell& cell = cells_[pos & MASK];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        std::memcpy(&record, &cell.record, offsetof(LogRecord, text) + cell.record.length);
+        cell.sequence.store(pos + LOG_QUEUE_CAPACITY, std::memory_order_release);
+        dequeue_pos_ = pos + 1;
+        return true;
+    }
+
+private:
+    static_assert((LOG_QUEUE_CAPACITY & (LOG_QUEUE_CAPACITY - 1)) == 0, "queue capacity must be a power of two");
+    static constexpr size_t MASK = LOG_QUEUE_CAPACITY - 1;
+
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    Cell cells_[LOG_QUEUE_CAPACITY];
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;
+};
+
+struct LoggerState {
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::atomic<uint32_t> rate_limit{20};
+    std::atomic<uint32_t> next_thread_id{1};
+    std::atomic<uint64_t> pushed{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t dropped_reported = 0;
+
+    LogQueue queue;
+
+    std::once_flag start_once;
+    std::thread writer;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+
+    // Guards the sinks; held by the writer while it prints a batch
+    std::mutex sink_mutex;
+    LogFormat format = LogFormat::TEXT;
+    std::ofstream file;
+};
+
+// Leaked on purpose so threads that log during static destruction still
+// find the queue
+LoggerState& state() {
+    static LoggerState* logger = new LoggerState();
+    return *logger;
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - state().epoch).count());
+}
+
+// Formats straight into a LogRecord; output past the capacity is cut off
+class LineBuffer : public std::streambuf {
+public:
+    void reset() {
+        setp(record.text, record.text + LOG_MESSAGE_CAPACITY);
+        truncated_ = false;
+    }
+
+    void finish() {
+        record.length = static_cast<uint32_t>(pptr() - pbase());
+        if (truncated_ && record.length >= 3) {
+            std::memcpy(record.text + record.length - 3, "...", 3);
+        }
+    }
+
+    LogRecord record;
+
+protected:
+    int_type overflow(int_type) override {
+        truncated_ = true;
+        return traits_type::eof();
+    }
+
+private:
+    bool truncated_ = false;
+};
+
+struct ThreadLine {
+    LineBuffer buffer;
+    std::ostream stream{&buffer};
+    uint32_t thread_id = state().next_thread_id.fetch_add(1, std::memory_order_relaxed);
+};
+
+ThreadLine& thread_line() {
+    thread_local ThreadLine line;
+    return line;
+}
+
+void write_json_string(std::ostream& out, const char* text, size_t length) {
+    out << '"';
+    for (size_t i = 0; i < length; ++i) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void format_record(std::ostream& out, const LogRecord& record, LogFormat format) {
+    char time[32];
+    std::snprintf(time, sizeof(time), "%.6f", record.time_ns * 1e-9);
+    if (format == LogFormat::JSON) {
+        out << "{\"time\":" << time
+            << ",\"level\":\"" << log_level_name(record.level)
+            << "\",\"channel\":\"" << log_channel_name(record.channel)
+            << "\",\"thread\":" << record.thread_id << ",\"message\":";
+        write_json_string(out, record.text, record.length);
+        if (record.suppressed > 0) {
+            out << ",\"suppressed\":" << record.suppressed;
+        }
+        out << "}\n";
+        return;
+    }
+
+    char prefix[64];
+    std::snprintf(prefix, sizeof(prefix), "[%12s] %-5s %-7s ", time,
+                  log_level_name(record.level), log_channel_name(record.channel));
+    out << prefix;
+    out.write(record.text, record.length);
+    if (record.suppressed > 0) {
+        out << " (+" << record.suppressed << " suppressed)";
+    }
+    out << '\n';
+}
+
+// Caller holds sink_mutex
+void write_record(LoggerState& logger, const LogRecord& record) {
+    if (logger.file.is_open()) {
+        format_record(logger.file, record, logger.format);
+    } else if (record.level >= LogLevel::WARN) {
+        format_record(std::cerr, record, logger.format);
+    } else {
+        format_record(std::cout, record, logger.format);
+    }
+}
+
+void flush_sinks(LoggerState& logger) {
+    if (logger.file.is_open()) {
+        logger.file.flush();
+    } else {
+        std::cout.flush();
+        std::cerr.flush();
+    }
+}
+
+// Writes everything queued so far; returns the number of records written
+size_t drain(LoggerState& logger) {
+    LogRecord record;
+    size_t count = 0;
+    std::lock_guard<std::mutex> lock(logger.sink_mutex);
+    while (logger.queue.try_pop(record)) {
+        write_record(logger, record);
+        ++count;
+    }
+
+    uint64_t dropped = logger.dropped.load(std::memory_order_relaxed);
+    if (dropped != logger.dropped_reported) {
+        LogRecord notice;
+        notice.time_ns = now_ns();
+        notice.level = LogLevel::WARN;
+        int length = std::snprintf(notice.text, LOG_MESSAGE_CAPACITY, "log queue full, dropped %llu records",
+                                   static_cast<unsigned long long>(dropped - logger.dropped_reported));
+        notice.length = static_cast<uint32_t>(std::min<int>(length, LOG_MESSAGE_CAPACITY - 1));
+        write_record(logger, notice);
+        logger.dropped_reported = dropped;
+    }
+
+    if (count > 0) {
+        flush_sinks(logger);
+        logger.written.fetch_add(count, std::memory_order_release);
+    }
+    return count;
+}
+
+void writer_loop() {
+    LoggerState& logger = state();
+    while (true) {
+        if (drain(logger) > 0) {
+            continue;
+        }
+        if (logger.stopping.load(std::memory_order_acquire)) {
+            drain(logger);
+            break;
+        }
+        // Producers never signal, so an idle writer polls at a few ms
+        std::unique_lock<std::mutex> lock(logger.wake_mutex);
+        logger.wake.wait_for(lock, std::chrono::milliseconds(4));
+    }
+}
+
+void start_writer() {
+    LoggerState& logger = state();
+    std::call_once(logger.start_once, [&logger]() {
+        logger.running.store(true, std::memory_order_release);
+        logger.writer = std::thread(writer_loop);
+        std::atexit(logger_shutdown);
+    });
+}
+
+bool parse_level(const std::string& text, LogLevel& level) {
+    static const std::pair<const char*, LogLevel> LEVELS[] = {
+        {"debug", LogLevel::DEBUG}, {"info", LogLevel::INFO}, {"warn", LogLevel::WARN},
+        {"warning", LogLevel::WARN}, {"error", LogLevel::ERROR}, {"off", LogLevel::OFF}
+    };
+    for (const auto& entry : LEVELS) {
+        if (text == entry.first) {
+            level = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_channel(const std::string& text, LogChannel& channel) {
+    for (int i = 0; i < LOG_CHANNEL_COUNT; ++i) {
+        if (text == log_channel_name(static_cast<LogChannel>(i))) {
+            channel = static_cast<LogChannel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+const char* log_level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "debug";
+        case LogLevel::INFO: return "info";
+        case LogLevel::WARN: return "warn";
+        case LogLevel::ERROR: return "error";
+        default: return "off";
+    }
+}
+
+const char* log_channel_name(LogChannel channel) {
+    switch (channel) {
+        case LogChannel::GENERAL: return "general";
+        case LogChannel::SCENE: return "scene";
+        case LogChannel::RENDER: return "render";
+        case LogChannel::GPU: return "gpu";
+        case LogChannel::UI: return "ui";
+        case LogChannel::PERF: return "perf";
+        default: return "unknown";
+    }
+}
+
+void logger_set_level(LogLevel level) {
+    for (auto& channel_level : g_log_levels) {
+        channel_level.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+}
+
+void logger_set_level(LogChannel channel, LogLevel level) {
+    g_log_levels[static_cast<int>(channel)].store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel logger_level(LogChannel channel) {
+    return static_cast<LogLevel>(g_log_levels[static_cast<int>(channel)].load(std::memory_order_relaxed));
+}
+
+bool logger_configure(const std::string& spec) {
+    int levels[LOG_CHANNEL_COUNT];
+    for (int i = 0; i < LOG_CHANNEL_COUNT; ++i) {
+        levels[i] = g_log_levels[i].load(std::memory_order_relaxed);
+    }
+
+    std::stringstream tokens(spec);
+    std::string token;
+    while (std::getline(tokens, token, ',')) {
+        if (token.empty()) {
+            continue;
+        }
+        LogLevel level;
+        size_t equals = token.find('=');
+        if (equals == std::string::npos) {
+            if (!parse_level(token, level)) {
+                return false;
+            }
+            std::fill(levels, levels + LOG_CHANNEL_COUNT, static_cast<int>(level));
+            continue;
+        }
+        LogChannel channel;
+        if (!parse_channel(token.substr(0, equals), channel) || !parse_level(token.substr(equals + 1), level)) {
+            return false;
+        }
+        levels[static_cast<int>(channel)] = static_cast<int>(level);
+    }
+
+    for (int i = 0; i < LOG_CHANNEL_COUNT; ++i) {
+        g_log_levels[i].store(levels[i], std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void logger_set_rate_limit(uint32_t messages_per_second) {
+    state().rate_limit.store(messages_per_second, std::memory_order_relaxed);
+}
+
+uint32_t logger_rate_limit() {
+    return state().rate_limit.load(std::memory_order_relaxed);
+}
+
+void logger_set_format(LogFormat format) {
+    LoggerState& logger = state();
+    std::lock_guard<std::mutex> lock(logger.sink_mutex);
+    logger.format = format;
+}
+
+bool logger_set_output_file(const std::string& filename) {
+    LoggerState& logger = state();
+    std::lock_guard<std::mutex> lock(logger.sink_mutex);
+    if (logger.file.is_open()) {
+        logger.file.close();
+    }
+    if (filename.empty()) {
+        return true;
+    }
+    logger.file.open(filename, std::ios::app);
+    if (!logger.file.is_open()) {
+        std::cerr << "Could not open log file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void logger_flush() {
+    LoggerState& logger = state();
+    uint64_t target = logger.pushed.load(std::memory_order_acquire);
+    while (logger.running.load(std::memory_order_acquire) &&
+           logger.written.load(std::memory_order_acquire) < target) {
+        logger.wake.notify_one();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+void logger_shutdown() {
+    LoggerState& logger = state();
+    if (!logger.running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    logger.stopping.store(true, std::memory_order_release);
+    logger.wake.notify_one();
+    if (logger.writer.joinable()) {
+        logger.writer.join();
+    }
+}
+
+uint64_t logger_dropped_count() {
+    return state().dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t logger_queue_depth() {
+    LoggerState& logger = state();
+    uint64_t written = logger.written.load(std::memory_order_relaxed);
+    uint64_t pushed = logger.pushed.load(std::memory_order_relaxed);
+    return pushed > written ? pushed - written : 0;
+}
+
+bool LogSite::allow() {
+    uint32_t limit = logger_rate_limit();
+    if (limit == 0) {
+        return true;
+    }
+    uint64_t now = now_ns();
+    uint64_t start = window_start_ns_.load(std::memory_order_relaxed);
+    if (now - start >= 1000000000ull &&
+        window_start_ns_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        window_count_.store(0, std::memory_order_relaxed);
+    }
+    if (window_count_.fetch_add(1, std::memory_order_relaxed) < limit) {
+        return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+std::ostream& logger_begin_message() {
+    ThreadLine& line = thread_line();
+    line.buffer.reset();
+    line.stream.clear();
+    line.stream.flags(std::ios_base::dec | std::ios_base::skipws);
+    line.stream.precision(6);
+    line.stream.width(0);
+    line.stream.fill(' ');
+    return line.stream;
+}
+
+void logger_commit_message(LogLevel level, LogChannel channel, uint32_t suppressed) {
+    ThreadLine& line = thread_line();
+    line.buffer.finish();
+    LogRecord& record = line.buffer.record;
+    record.time_ns = now_ns();
+    record.thread_id = line.thread_id;
+    record.level = level;
+    record.channel = channel;
+    record.suppressed = suppressed;
+
+    LoggerState& logger = state();
+    start_writer();
+    if (!logger.running.load(std::memory_order_acquire)) {
+        // After shutdown there is no writer, so print in place
+        std::lock_guard<std::mutex> lock(logger.sink_mutex);
+        write_record(logger, record);
+        flush_sinks(logger);
+        return;
+    }
+    if (logger.queue.try_push(record)) {
+        logger.pushed.fetch_add(1, std::memory_order_release);
+    } else {
+        logger.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
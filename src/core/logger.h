@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Asynchronous structured logger. Call sites format into a fixed per-thread
+// buffer and push a record onto a bounded lock-free queue; a writer thread
+// does the stream output. A full queue drops the record instead of blocking
+// the caller, so logging never stalls a render thread.
+//
+// Building without ENABLE_DEBUG_LOGS compiles every LOG_DEBUG away, which
+// is where per-frame and per-chunk chatter belongs.
+
+enum class LogLevel : int {
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    OFF
+};
+
+enum class LogChannel : int {
+    GENERAL,
+    SCENE,
+    RENDER,
+    GPU,
+    UI,
+    PERF,
+    COUNT
+};
+
+enum class LogFormat {
+    TEXT,   // "[  12.345678] INFO  render  message"
+    JSON    // One object per line
+};
+
+constexpr int LOG_CHANNEL_COUNT = static_cast<int>(LogChannel::COUNT);
+
+// Longer messages are truncated
+constexpr size_t LOG_MESSAGE_CAPACITY = 224;
+constexpr size_t LOG_QUEUE_CAPACITY = 4096;
+
+const char* log_level_name(LogLevel level);
+const char* log_channel_name(LogChannel channel);
+
+// Minimum level per channel; INFO everywhere by default
+void logger_set_level(LogLevel level);
+void logger_set_level(LogChannel channel, LogLevel level);
+LogLevel logger_level(LogChannel channel);
+
+// Applies a filter spec such as "warn" or "info,gpu=debug,ui=off".
+// Returns false and changes nothing when the spec does not parse.
+bool logger_configure(const std::string& spec);
+
+// Messages a single call site may emit per second; 0 disables the limit
+void logger_set_rate_limit(uint32_t messages_per_second);
+uint32_t logger_rate_limit();
+
+void logger_set_format(LogFormat format);
+// Routes output to a file instead of stdout/stderr; empty restores the console
+bool logger_set_output_file(const std::string& filename);
+
+// Blocks until every record queued before the call has been written
+void logger_flush();
+// Drains the queue and stops the writer; later records are written inline
+void logger_shutdown();
+
+// Records lost to a full queue since startup
+uint64_t logger_dropped_count();
+// Records queued but not yet written
+uint64_t logger_queue_depth();
+
+// Per-channel minimum levels, read inline by every LOG_* site
+extern std::atomic<int> g_log_levels[LOG_CHANNEL_COUNT];
+
+inline bool logger_should_log(LogLevel level, LogChannel channel) {
+    return static_cast<int>(level) >= g_log_levels[static_cast<int>(channel)].load(std::memory_order_relaxed);
+}
+
+// Per call site rate limiter, one static instance per LOG_* expansion
+class LogSite {
+public:
+    bool allow();
+    uint32_t take_suppressed() { return suppressed_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> window_start_ns_{0};
+    std::atomic<uint32_t> window_count_{0};
+    std::atomic<uint32_t> suppressed_{0};
+};
+
+// Calling thread's reusable line buffer, reset for a new message
+std::ostream& logger_begin_message();
+// Queues the line built since logger_begin_message()
+void logger_commit_message(LogLevel level, LogChannel channel, uint32_t suppressed);
+
+#define LOG_AT(level, channel, message)                                          \
+    do {                                                                         \
+        if (logger_should_log(level, channel)) {                                 \
+            static LogSite log_site_;                                            \
+            if (log_site_.allow()) {                                             \
+                logger_begin_message() << message;                               \
+                logger_commit_message(level, channel, log_site_.take_suppressed()); \
+            }                                                                    \
+        }                                                                        \
+    } while (0)
+
+#ifdef ENABLE_DEBUG_LOGS
+#define LOG_DEBUG(channel, message) LOG_AT(LogLevel::DEBUG, channel, message)
+#else
+// Dead branch: arguments stay type-checked and count as used, no code is emitted
+#define LOG_DEBUG(channel, message) do { if (false) { logger_begin_message() << message; } } while (0)
+#endif
+#define LOG_INFO(channel, message) LOG_AT(LogLevel::INFO, channel, message)
+#define LOG_WARN(channel, message) LOG_AT(LogLevel::WARN, channel, message)
+#define LOG_ERROR(channel, message) LOG_AT(LogLevel::ERROR, channel, message)
@@ -1,12 +1,19 @@
 #include "primitives.h"
+#include "ray_stats.h"
 #include <vector>
 #include <limits>
 
+AABB Sphere::bounding_box() const {
+    Vector3 extent(radius_, radius_, radius_);
+    return AABB(position_ - extent, position_ + extent);
+}
+
 void Sphere::update() {
     
 }
 
 bool Sphere::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+    thread_ray_stats().add(RayCounter::SPHERE_TESTS);
     Vector3 oc = ray.origin - position_;
     float a = ray.direction.length_squared();  // More efficient than dot product with self
     float half_b = oc.dot(ray.direction);
@@ -35,11 +42,18 @@ bool Sphere::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const
     return true;
 }
 
+AABB Cube::bounding_box() const {
+    const float half_size = size_ * 0.5f;
+    Vector3 extent(half_size, half_size, half_size);
+    return AABB(position_ - extent, position_ + extent);
+}
+
 void Cube::update() {
     
 }
 
 bool Cube::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+    thread_ray_stats().add(RayCounter::CUBE_TESTS);
     const float half_size = size_ * 0.5f;
     const Vector3 min_bound = position_ + Vector3(-half_size, -half_size, -half_size);
     const Vector3 max_bound = position_ + Vector3(half_size, half_size, half_size);
@@ -95,11 +109,19 @@ bool Cube::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
     return true;
 }
 
+AABB Torus::bounding_box() const {
+    // Ring lies in the XZ plane around the Y axis
+    const float ring = major_radius_ + minor_radius_;
+    Vector3 extent(ring, minor_radius_, ring);
+    return AABB(position_ - extent, position_ + extent);
+}
+
 void Torus::update() {
     
 }
 
 bool Torus::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+    thread_ray_stats().add(RayCounter::TORUS_TESTS);
     // Simplified torus intersection using iterative approach
     // Torus equation: (sqrt(x²+z²) - R)² + y² = r²
     
@@ -160,11 +182,19 @@ bool Torus::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const
     return false;
 }
 
+AABB Pyramid::bounding_box() const {
+    // Base centred at position, apex straight up
+    const float half_base = base_size_ * 0.5f;
+    return AABB(position_ + Vector3(-half_base, 0.0f, -half_base),
+                position_ + Vector3(half_base, height_, half_base));
+}
+
 void Pyramid::update() {
     
 }
 
 bool Pyramid::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+    thread_ray_stats().add(RayCounter::PYRAMID_TESTS);
     
     // Square pyramid with base centered at position and apex pointing up
     float half_base = base_size_ * 0.5f;
@@ -19,13 +19,15 @@ public:
     
     virtual void update() = 0;
     virtual bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const = 0;
+    virtual AABB bounding_box() const = 0;
     
     // Getters
     const Vector3& position() const noexcept { return position_; }
     const Color& color() const noexcept { return color_; }
     const Material& material() const noexcept { return material_; }
     
-    // Setters
+    // Setters. Objects already in a SceneManager are edited through it so
+    // caches see the change.
     void set_position(const Vector3& position) noexcept { position_ = position; }
     void set_color(const Color& color) noexcept { color_ = color; }
     void set_material(const Material& material) noexcept { material_ = material; }
@@ -48,6 +50,7 @@ public:
     
     void update() override;
     bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const override;
+    AABB bounding_box() const override;
     
     float radius() const noexcept { return radius_; }
     void set_radius(float radius) {
@@ -73,6 +76,7 @@ public:
     
     void update() override;
     bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const override;
+    AABB bounding_box() const override;
     
     float size() const noexcept { return size_; }
     void set_size(float size) {
@@ -101,6 +105,7 @@ public:
     
     void update() override;
     bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const override;
+    AABB bounding_box() const override;
     
     float major_radius() const noexcept { return major_radius_; }
     float minor_radius() const noexcept { return minor_radius_; }
@@ -132,6 +137,7 @@ public:
     
     void update() override;
     bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const override;
+    AABB bounding_box() const override;
     
     float base_size() const noexcept { return base_size_; }
     float height() const noexcept { return height_; }
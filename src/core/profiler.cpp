@@ -0,0 +1,206 @@
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+// The owning thread and an exporter are the only users of a ring, so its
+// mutex is uncontended outside an export
+struct ThreadRing {
+    std::mutex mutex;
+    std::vector<ProfileEvent> events;
+    uint64_t written = 0;
+    bool in_use = false;
+};
+
+struct ProfilerState {
+    std::atomic<bool> enabled{false};
+    std::atomic<uint32_t> next_thread_id{1};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    std::map<std::string, uint32_t> named_tracks;
+};
+
+ProfilerState& state() {
+    static ProfilerState profiler;
+    return profiler;
+}
+
+// Rings of exited threads are handed to new ones; their events stay
+// tagged with the old thread id until overwritten
+struct ThreadContext {
+    uint32_t id = state().next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    ThreadRing* ring = nullptr;
+
+    ~ThreadContext() {
+        if (ring) {
+            std::lock_guard<std::mutex> lock(state().registry_mutex);
+            ring->in_use = false;
+        }
+    }
+
+    ThreadRing& acquire_ring() {
+        if (ring) {
+            return *ring;
+        }
+        ProfilerState& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.registry_mutex);
+        for (auto& candidate : profiler.rings) {
+            if (!candidate->in_use) {
+                ring = candidate.get();
+                break;
+            }
+        }
+        if (!ring) {
+            profiler.rings.push_back(std::make_unique<ThreadRing>());
+            ring = profiler.rings.back().get();
+            ring->events.resize(PROFILE_RING_CAPACITY);
+        }
+        ring->in_use = true;
+        return *ring;
+    }
+};
+
+ThreadContext& thread_context() {
+    thread_local ThreadContext context;
+    return context;
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+void profiler_set_enabled(bool enabled) {
+    state().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool profiler_enabled() {
+    return state().enabled.load(std::memory_order_relaxed);
+}
+
+void profiler_clear() {
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.registry_mutex);
+    for (auto& ring : profiler.rings) {
+        std::lock_guard<std::mutex> ring_lock(ring->mutex);
+        ring->written = 0;
+    }
+}
+
+uint64_t profiler_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - state().epoch).count());
+}
+
+void profiler_set_thread_name(const std::string& name) {
+    ThreadContext& context = thread_context();
+    std::lock_guard<std::mutex> lock(state().registry_mutex);
+    // Short-lived threads of the same role (tile workers are respawned every
+    // run) share one track instead of opening a new one per spawn
+    auto inserted = state().named_tracks.emplace(name, context.id);
+    context.id = inserted.first->second;
+}
+
+ProfileZone::~ProfileZone() {
+    if (!active_ || !profiler_enabled()) {
+        return;
+    }
+
+    ProfileEvent event;
+    event.name = name_;
+    event.start_ns = start_ns_;
+    event.end_ns = profiler_now_ns();
+
+    ThreadContext& context = thread_context();
+    event.thread_id = context.id;
+    ThreadRing& ring = context.acquire_ring();
+    std::lock_guard<std::mutex> lock(ring.mutex);
+    ring.events[ring.written % PROFILE_RING_CAPACITY] = event;
+    ring.written++;
+}
+
+size_t profiler_collect(std::vector<ProfileEvent>& events) {
+    events.clear();
+    ProfilerState& profiler = state();
+    {
+        std::lock_guard<std::mutex> lock(profiler.registry_mutex);
+        for (auto& ring : profiler.rings) {
+            std::lock_guard<std::mutex> ring_lock(ring->mutex);
+            uint64_t count = std::min<uint64_t>(ring->written, PROFILE_RING_CAPACITY);
+            for (uint64_t i = ring->written - count; i < ring->written; ++i) {
+                events.push_back(ring->events[i % PROFILE_RING_CAPACITY]);
+            }
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+        return a.start_ns < b.start_ns;
+    });
+    return events.size();
+}
+
+bool profiler_export_chrome_trace(const std::string& filename) {
+    std::vector<ProfileEvent> events;
+    profiler_collect(events);
+
+    std::map<std::string, uint32_t> tracks;
+    {
+        std::lock_guard<std::mutex> lock(state().registry_mutex);
+        tracks = state().named_tracks;
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    // Complete ("X") events in microseconds; viewers derive nesting from the spans
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& entry : tracks) {
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+             << entry.second << ",\"args\":{\"name\":";
+        write_json_string(file, entry.first);
+        file << "}}";
+        first = false;
+    }
+    file << std::fixed << std::setprecision(3);
+    for (const auto& event : events) {
+        file << (first ? "" : ",\n") << "{\"name\":";
+        write_json_string(file, event.name ? event.name : "?");
+        file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread_id
+             << ",\"ts\":" << event.start_ns * 1e-3
+             << ",\"dur\":" << (event.end_ns - event.start_ns) * 1e-3 << "}";
+        first = false;
+    }
+    file << "\n]}\n";
+
+    if (file.fail()) {
+        std::cerr << "Error writing to file: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Wrote " << events.size() << " profile events to " << filename << std::endl;
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scoped tracing profiler. Zones are recorded into per-thread ring buffers
+// while capture is enabled and exported as Chrome trace JSON, which both
+// chrome://tracing and Perfetto open. Zone names must outlive the capture
+// (string literals or __func__).
+//
+// Building without ENABLE_PROFILING compiles every PROFILE_* macro away.
+
+struct ProfileEvent {
+    const char* name = nullptr;
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+    uint32_t thread_id = 0;
+};
+
+// Events kept per thread; older events are overwritten
+constexpr size_t PROFILE_RING_CAPACITY = 1 << 15;
+
+void profiler_set_enabled(bool enabled);
+bool profiler_enabled();
+void profiler_clear();
+uint64_t profiler_now_ns();
+
+// Label the calling thread in the exported trace. Threads given the same
+// name share a track, so use distinct names for concurrent threads.
+void profiler_set_thread_name(const std::string& name);
+
+// Every event still held in the rings, ordered by start time
+size_t profiler_collect(std::vector<ProfileEvent>& events);
+bool profiler_export_chrome_trace(const std::string& filename);
+
+// Records one zone on destruction. Checks the enable flag once on entry, so
+// a disabled profiler costs a relaxed load per zone.
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name)
+        : name_(name), active_(profiler_enabled()), start_ns_(active_ ? profiler_now_ns() : 0) {}
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name_;
+    bool active_;
+    uint64_t start_ns_;
+};
+
+#ifdef ENABLE_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#define PROFILE_THREAD_NAME(name) profiler_set_thread_name(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,96 @@
+#include "ray_stats.h"
+
+namespace {
+
+// More threads than this share the last slot; their adds may then lose
+// increments but never corrupt anything
+constexpr int MAX_RAY_STATS_SLOTS = 256;
+
+RayStatsSlot g_slots[MAX_RAY_STATS_SLOTS];
+std::atomic<uint64_t> g_retired[RAY_COUNTER_COUNT];
+
+RayStatsSlot* acquire_slot() {
+    for (int i = 0; i < MAX_RAY_STATS_SLOTS - 1; ++i) {
+        bool expected = false;
+        if (!g_slots[i].in_use.load(std::memory_order_relaxed) &&
+            g_slots[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return &g_slots[i];
+        }
+    }
+    return &g_slots[MAX_RAY_STATS_SLOTS - 1];
+}
+
+} // namespace
+
+uint64_t RayStats::rays() const {
+    return (*this)[RayCounter::PRIMARY_RAYS] + (*this)[RayCounter::SECONDARY_RAYS] +
+           (*this)[RayCounter::SHADOW_RAYS];
+}
+
+uint64_t RayStats::intersection_tests() const {
+    return (*this)[RayCounter::SPHERE_TESTS] + (*this)[RayCounter::CUBE_TESTS] +
+           (*this)[RayCounter::TORUS_TESTS] + (*this)[RayCounter::PYRAMID_TESTS];
+}
+
+double RayStats::tests_per_ray() const {
+    uint64_t count = rays();
+    return count > 0 ? static_cast<double>(intersection_tests()) / count : 0.0;
+}
+
+double RayStats::mean_path_length() const {
+    uint64_t paths = (*this)[RayCounter::PATHS];
+    return paths > 0 ? static_cast<double>((*this)[RayCounter::PATH_VERTICES]) / paths : 0.0;
+}
+
+RayStats& RayStats::operator+=(const RayStats& other) {
+    for (int i = 0; i < RAY_COUNTER_COUNT; ++i) {
+        counters[i] += other.counters[i];
+    }
+    return *this;
+}
+
+RayStats RayStats::operator-(const RayStats& other) const {
+    RayStats result;
+    for (int i = 0; i < RAY_COUNTER_COUNT; ++i) {
+        result.counters[i] = counters[i] - other.counters[i];
+    }
+    return result;
+}
+
+uint64_t RayStatsSlot::intersection_tests() const {
+    return get(RayCounter::SPHERE_TESTS) + get(RayCounter::CUBE_TESTS) +
+           get(RayCounter::TORUS_TESTS) + get(RayCounter::PYRAMID_TESTS);
+}
+
+RayStats RayStatsSlot::snapshot() const {
+    RayStats stats;
+    for (int i = 0; i < RAY_COUNTER_COUNT; ++i) {
+        stats.counters[i] = counters[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+RayStatsHandle::RayStatsHandle() : slot(acquire_slot()) {
+}
+
+RayStatsHandle::~RayStatsHandle() {
+    if (slot == &g_slots[MAX_RAY_STATS_SLOTS - 1]) {
+        return;  // Shared overflow slot stays live
+    }
+    for (int i = 0; i < RAY_COUNTER_COUNT; ++i) {
+        g_retired[i].fetch_add(slot->counters[i].exchange(0, std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+    }
+    slot->in_use.store(false, std::memory_order_release);
+}
+
+RayStats ray_stats_total() {
+    RayStats total;
+    for (int i = 0; i < RAY_COUNTER_COUNT; ++i) {
+        total.counters[i] = g_retired[i].load(std::memory_order_relaxed);
+    }
+    for (const auto& slot : g_slots) {
+        total += slot.snapshot();
+    }
+    return total;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Counters bumped on the ray hot path
+enum class RayCounter : int {
+    PRIMARY_RAYS,       // Camera rays
+    SECONDARY_RAYS,     // Rays scattered off a surface
+    SHADOW_RAYS,        // Visibility rays towards a light
+    SPHERE_TESTS,       // Primitive hit() calls, by type
+    CUBE_TESTS,
+    TORUS_TESTS,
+    PYRAMID_TESTS,
+    PATHS,              // Paths that terminated (miss, emitter, absorption or depth limit)
+    PATH_VERTICES,      // Surface hits along those paths
+    CACHED_HITS,        // Scene intersections answered by the path vertex cache instead
+    COUNT
+};
+
+constexpr int RAY_COUNTER_COUNT = static_cast<int>(RayCounter::COUNT);
+
+// Plain snapshot of the counters, either one thread's or summed over all
+struct RayStats {
+    uint64_t counters[RAY_COUNTER_COUNT] = {};
+
+    uint64_t operator[](RayCounter counter) const { return counters[static_cast<int>(counter)]; }
+
+    uint64_t rays() const;
+    uint64_t intersection_tests() const;
+    double tests_per_ray() const;
+    double mean_path_length() const;
+
+    RayStats& operator+=(const RayStats& other);
+    RayStats operator-(const RayStats& other) const;
+};
+
+// One thread's live counters on cache lines of their own. Only the owning
+// thread writes, so an add is a relaxed load and store with no locked
+// instruction; the atomics only make concurrent snapshots well defined.
+struct alignas(64) RayStatsSlot {
+    std::atomic<uint64_t> counters[RAY_COUNTER_COUNT] = {};
+    std::atomic<bool> in_use{false};
+
+    void add(RayCounter counter, uint64_t n = 1) {
+        std::atomic<uint64_t>& value = counters[static_cast<int>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    uint64_t get(RayCounter counter) const {
+        return counters[static_cast<int>(counter)].load(std::memory_order_relaxed);
+    }
+    uint64_t intersection_tests() const;
+    RayStats snapshot() const;
+};
+
+// Claims a registry slot for the lifetime of a thread. On thread exit the
+// slot's counts are folded into the retired totals and the slot is reused.
+class RayStatsHandle {
+public:
+    RayStatsHandle();
+    ~RayStatsHandle();
+
+    RayStatsHandle(const RayStatsHandle&) = delete;
+    RayStatsHandle& operator=(const RayStatsHandle&) = delete;
+
+    RayStatsSlot* slot;
+};
+
+inline RayStatsSlot& thread_ray_stats() {
+    thread_local RayStatsHandle handle;
+    return *handle.slot;
+}
+
+// Sum over retired threads and every live slot. Exact when no thread is
+// counting, e.g. after the tile workers of a frame have joined.
+RayStats ray_stats_total();
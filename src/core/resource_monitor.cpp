@@ -0,0 +1,299 @@
+#include "resource_monitor.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t HISTORY_CAPACITY = 240;
+
+// One cache line per subsystem so allocations in different subsystems don't contend
+struct alignas(64) SubsystemCounters {
+    std::atomic<int64_t> current{0};
+    std::atomic<int64_t> peak{0};
+    std::atomic<uint64_t> allocations{0};
+};
+
+SubsystemCounters g_subsystems[MEMORY_SUBSYSTEM_COUNT];
+
+struct RegisteredThread {
+    std::string name;
+    std::thread::id id;
+#ifdef __linux__
+    clockid_t clock;
+#endif
+    double last_cpu_seconds = 0.0;
+};
+
+struct Monitor {
+    std::mutex mutex;                       // Guards everything below
+    std::vector<RegisteredThread> threads;
+    std::deque<ResourceSample> history;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_wall = start;
+    double last_process_cpu = 0.0;
+    std::chrono::milliseconds interval{250};
+
+    std::mutex sampler_mutex;               // Guards the sampler thread and its wakeup
+    std::condition_variable wakeup;
+    std::thread sampler;
+    bool stop = false;
+};
+
+Monitor& monitor() {
+    static Monitor instance;
+    return instance;
+}
+
+#ifdef __linux__
+// Negative when the clock is gone, e.g. its thread exited
+double clock_seconds(clockid_t clock) {
+    timespec ts;
+    if (clock_gettime(clock, &ts) == 0) {
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+    }
+    return -1.0;
+}
+#endif
+
+ResourceSample take_sample(Monitor& m) {
+    ResourceSample sample;
+    auto now = std::chrono::steady_clock::now();
+    sample.process_cpu_seconds = process_cpu_seconds();
+    sample.memory = process_memory();
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+        sample.subsystems[i] = memory_usage(static_cast<MemorySubsystem>(i));
+    }
+
+    std::lock_guard<std::mutex> lock(m.mutex);
+    sample.wall_seconds = std::chrono::duration<double>(now - m.start).count();
+    double interval = std::chrono::duration<double>(now - m.last_wall).count();
+    if (interval > 0.0) {
+        sample.cores_busy = (sample.process_cpu_seconds - m.last_process_cpu) / interval;
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        sample.cpu_utilization = 100.0 * sample.cores_busy / cores;
+    }
+    m.last_wall = now;
+    m.last_process_cpu = sample.process_cpu_seconds;
+
+    for (auto& thread : m.threads) {
+        ThreadCpuSample entry;
+        entry.name = thread.name;
+#ifdef __linux__
+        double cpu = clock_seconds(thread.clock);
+        if (cpu >= 0.0) {
+            entry.cpu_seconds = cpu;
+            if (interval > 0.0) {
+                entry.utilization = 100.0 * (cpu - thread.last_cpu_seconds) / interval;
+            }
+            thread.last_cpu_seconds = cpu;
+        }
+#endif
+        sample.threads.push_back(entry);
+    }
+
+    m.history.push_back(sample);
+    if (m.history.size() > HISTORY_CAPACITY) {
+        m.history.pop_front();
+    }
+    return sample;
+}
+
+void sampler_loop() {
+    Monitor& m = monitor();
+    resource_register_thread("resource monitor");
+    std::unique_lock<std::mutex> lock(m.sampler_mutex);
+    while (!m.stop) {
+        lock.unlock();
+        take_sample(m);
+        lock.lock();
+        m.wakeup.wait_for(lock, m.interval, [&m]() { return m.stop; });
+    }
+    lock.unlock();
+    resource_unregister_thread();
+}
+
+} // namespace
+
+const char* memory_subsystem_name(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MemorySubsystem::FRAME_BUFFERS: return "frame_buffers";
+        case MemorySubsystem::IRRADIANCE_CACHE: return "irradiance_cache";
+        case MemorySubsystem::LIGHT_RESAMPLING: return "light_resampling";
+        case MemorySubsystem::PATH_VERTEX_CACHE: return "path_vertex_cache";
+        default: return "unknown";
+    }
+}
+
+void memory_track_allocate(MemorySubsystem subsystem, size_t bytes) {
+    SubsystemCounters& counters = g_subsystems[static_cast<int>(subsystem)];
+    int64_t current = counters.current.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + bytes;
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    int64_t peak = counters.peak.load(std::memory_order_relaxed);
+    while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void memory_track_release(MemorySubsystem subsystem, size_t bytes) {
+    g_subsystems[static_cast<int>(subsystem)].current.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+MemoryUsage memory_usage(MemorySubsystem subsystem) {
+    const SubsystemCounters& counters = g_subsystems[static_cast<int>(subsystem)];
+    MemoryUsage usage;
+    usage.current_bytes = counters.current.load(std::memory_order_relaxed);
+    usage.peak_bytes = counters.peak.load(std::memory_order_relaxed);
+    usage.allocations = counters.allocations.load(std::memory_order_relaxed);
+    return usage;
+}
+
+double thread_cpu_seconds() {
+#ifdef __linux__
+    return std::max(0.0, clock_seconds(CLOCK_THREAD_CPUTIME_ID));
+#else
+    return 0.0;
+#endif
+}
+
+double process_cpu_seconds() {
+#ifdef __linux__
+    return std::max(0.0, clock_seconds(CLOCK_PROCESS_CPUTIME_ID));
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+ProcessMemory process_memory() {
+    ProcessMemory memory;
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            memory.rss_mb = std::stod(line.substr(6)) / 1024.0;
+        } else if (line.rfind("VmHWM:", 0) == 0) {
+            memory.peak_rss_mb = std::stod(line.substr(6)) / 1024.0;
+        }
+    }
+    if (memory.peak_rss_mb == 0.0) {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            memory.peak_rss_mb = usage.ru_maxrss / 1024.0;
+        }
+    }
+#endif
+    return memory;
+}
+
+void resource_monitor_start(std::chrono::milliseconds interval) {
+    Monitor& m = monitor();
+    std::lock_guard<std::mutex> lock(m.sampler_mutex);
+    m.interval = std::max(interval, std::chrono::milliseconds(1));
+    if (!m.sampler.joinable()) {
+        static bool exit_hook = false;
+        if (!exit_hook) {
+            // A joinable std::thread at static destruction would terminate the process
+            std::atexit(resource_monitor_stop);
+            exit_hook = true;
+        }
+        m.stop = false;
+        m.sampler = std::thread(sampler_loop);
+    }
+    m.wakeup.notify_all();
+}
+
+void resource_monitor_stop() {
+    Monitor& m = monitor();
+    std::thread sampler;
+    {
+        std::lock_guard<std::mutex> lock(m.sampler_mutex);
+        m.stop = true;
+        sampler = std::move(m.sampler);
+    }
+    m.wakeup.notify_all();
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+}
+
+bool resource_monitor_running() {
+    Monitor& m = monitor();
+    std::lock_guard<std::mutex> lock(m.sampler_mutex);
+    return m.sampler.joinable();
+}
+
+ResourceSample resource_monitor_latest() {
+    Monitor& m = monitor();
+    if (resource_monitor_running()) {
+        std::lock_guard<std::mutex> lock(m.mutex);
+        if (!m.history.empty()) {
+            return m.history.back();
+        }
+    }
+    return take_sample(m);
+}
+
+std::vector<ResourceSample> resource_monitor_history() {
+    Monitor& m = monitor();
+    std::lock_guard<std::mutex> lock(m.mutex);
+    return std::vector<ResourceSample>(m.history.begin(), m.history.end());
+}
+
+void resource_register_thread(const std::string& name) {
+    RegisteredThread thread;
+    thread.name = name;
+    thread.id = std::this_thread::get_id();
+#ifdef __linux__
+    if (pthread_getcpuclockid(pthread_self(), &thread.clock) != 0) {
+        return;
+    }
+    thread.last_cpu_seconds = std::max(0.0, clock_seconds(thread.clock));
+#endif
+    Monitor& m = monitor();
+    std::lock_guard<std::mutex> lock(m.mutex);
+    m.threads.push_back(thread);
+}
+
+void resource_unregister_thread() {
+    Monitor& m = monitor();
+    std::lock_guard<std::mutex> lock(m.mutex);
+    auto id = std::this_thread::get_id();
+    m.threads.erase(std::remove_if(m.threads.begin(), m.threads.end(),
+                                   [id](const RegisteredThread& thread) { return thread.id == id; }),
+                    m.threads.end());
+}
+
+void resource_report(std::ostream& out) {
+    ResourceSample sample = resource_monitor_latest();
+    out << "\n=== Resource Usage ===" << std::endl;
+    out << std::fixed << std::setprecision(1);
+    out << "CPU:       " << sample.cpu_utilization << "% of " << std::thread::hardware_concurrency()
+        << " cores (" << std::setprecision(2) << sample.cores_busy << " busy), "
+        << sample.process_cpu_seconds << " s total" << std::endl;
+    out << std::setprecision(1);
+    out << "Memory:    " << sample.memory.rss_mb << " MB resident, peak " << sample.memory.peak_rss_mb << " MB" << std::endl;
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+        const MemoryUsage& usage = sample.subsystems[i];
+        out << "  " << std::left << std::setw(18) << memory_subsystem_name(static_cast<MemorySubsystem>(i))
+            << std::right << std::setw(9) << usage.current_bytes / (1024.0 * 1024.0) << " MB, peak "
+            << usage.peak_bytes / (1024.0 * 1024.0) << " MB, " << usage.allocations << " allocations" << std::endl;
+    }
+    for (const auto& thread : sample.threads) {
+        out << "Thread " << std::left << std::setw(18) << thread.name << std::right
+            << std::setw(9) << thread.cpu_seconds << " s CPU, " << thread.utilization << "% of a core" << std::endl;
+    }
+    out << std::defaultfloat;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Measured resource use of the process, for capacity planning: CPU time
+// per registered thread and for the whole process, resident set size and
+// its high-water mark, and host allocations of the large render buffers,
+// counted through TrackingAllocator. A background thread samples the
+// process a few times per second; reading a sample never blocks rendering.
+
+enum class MemorySubsystem : int {
+    FRAME_BUFFERS,       // Per-pixel accumulation and variance buffers
+    IRRADIANCE_CACHE,
+    LIGHT_RESAMPLING,    // Reservoirs and their history
+    PATH_VERTEX_CACHE,   // Camera path hits kept for re-shading after material edits
+    COUNT
+};
+
+constexpr int MEMORY_SUBSYSTEM_COUNT = static_cast<int>(MemorySubsystem::COUNT);
+
+const char* memory_subsystem_name(MemorySubsystem subsystem);
+
+struct MemoryUsage {
+    int64_t current_bytes = 0;
+    int64_t peak_bytes = 0;
+    uint64_t allocations = 0;
+};
+
+void memory_track_allocate(MemorySubsystem subsystem, size_t bytes);
+void memory_track_release(MemorySubsystem subsystem, size_t bytes);
+MemoryUsage memory_usage(MemorySubsystem subsystem);
+
+// std::allocator that books every allocation against a subsystem
+template <typename T, MemorySubsystem S>
+class TrackingAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = TrackingAllocator<U, S>;
+    };
+
+    TrackingAllocator() noexcept = default;
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, S>&) noexcept {}
+
+    T* allocate(size_t count) {
+        T* memory = std::allocator<T>().allocate(count);
+        memory_track_allocate(S, count * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, size_t count) noexcept {
+        memory_track_release(S, count * sizeof(T));
+        std::allocator<T>().deallocate(memory, count);
+    }
+};
+
+template <typename T, typename U, MemorySubsystem S>
+bool operator==(const TrackingAllocator<T, S>&, const TrackingAllocator<U, S>&) { return true; }
+template <typename T, typename U, MemorySubsystem S>
+bool operator!=(const TrackingAllocator<T, S>&, const TrackingAllocator<U, S>&) { return false; }
+
+template <typename T, MemorySubsystem S>
+using TrackedVector = std::vector<T, TrackingAllocator<T, S>>;
+
+// CPU time consumed so far by the calling thread and by the whole process
+double thread_cpu_seconds();
+double process_cpu_seconds();
+
+struct ProcessMemory {
+    double rss_mb = 0.0;
+    double peak_rss_mb = 0.0;
+};
+
+ProcessMemory process_memory();
+
+struct ThreadCpuSample {
+    std::string name;
+    double cpu_seconds = 0.0;
+    double utilization = 0.0;   // Percent of one core over the last interval
+};
+
+struct ResourceSample {
+    double wall_seconds = 0.0;          // Since the first sample
+    double process_cpu_seconds = 0.0;
+    double cpu_utilization = 0.0;       // Percent of all cores over the last interval
+    double cores_busy = 0.0;            // The same interval, in cores
+    ProcessMemory memory;
+    std::vector<ThreadCpuSample> threads;
+    MemoryUsage subsystems[MEMORY_SUBSYSTEM_COUNT];
+};
+
+// Starts or stops the background sampler; starting twice changes the interval
+void resource_monitor_start(std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+void resource_monitor_stop();
+bool resource_monitor_running();
+
+// Latest background sample, or a fresh one when the sampler is not running
+ResourceSample resource_monitor_latest();
+// Recent samples, oldest first
+std::vector<ResourceSample> resource_monitor_history();
+
+// Registers the calling thread so its CPU time is reported by name.
+// Threads must unregister before they exit.
+void resource_register_thread(const std::string& name);
+void resource_unregister_thread();
+
+class ResourceThreadScope {
+public:
+    explicit ResourceThreadScope(const std::string& name) { resource_register_thread(name); }
+    ~ResourceThreadScope() { resource_unregister_thread(); }
+    ResourceThreadScope(const ResourceThreadScope&) = delete;
+    ResourceThreadScope& operator=(const ResourceThreadScope&) = delete;
+};
+
+void resource_report(std::ostream& out);
@@ -1,14 +1,18 @@
 #include "scene_manager.h"
 #include "core/camera.h"
 #include "core/primitives.h"
+#include "core/profiler.h"
 #include "render/gpu_memory.h"
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 
 SceneManager::SceneManager() 
     : initialized_(false)
     , next_primitive_id_(1)
+    , scene_version_(0)
     , gpu_primitive_data_dirty_(false)
     , gpu_synced_(false)
     , gpu_buffer_primitive_count_(0) {
@@ -47,6 +51,8 @@ void SceneManager::shutdown() {
 void SceneManager::add_object(std::shared_ptr<Primitive> object) {
     if (object) {
         objects_.push_back(object);
+        register_object_id(object);
+        record_edit(SceneEditKind::ADDED, object, AABB(), object->bounding_box());
 #ifdef USE_GPU
         markGPUDirty();
 #endif
@@ -57,6 +63,8 @@ void SceneManager::remove_object(std::shared_ptr<Primitive> object) {
     auto it = std::find(objects_.begin(), objects_.end(), object);
     if (it != objects_.end()) {
         objects_.erase(it);
+        record_edit(SceneEditKind::REMOVED, object, object->bounding_box(), AABB());
+        unregister_object_id(object);
 #ifdef USE_GPU
         markGPUDirty();
 #endif
@@ -64,7 +72,12 @@ void SceneManager::remove_object(std::shared_ptr<Primitive> object) {
 }
 
 void SceneManager::clear_objects() {
+    // Stale IDs must not resolve to objects that left the scene
+    for (const auto& object : objects_) {
+        unregister_object_id(object);
+    }
     objects_.clear();
+    record_edit(SceneEditKind::CLEARED, nullptr, AABB::infinite(), AABB::infinite());
 #ifdef USE_GPU
     markGPUDirty();
 #endif
@@ -91,6 +104,7 @@ PrimitiveID SceneManager::addPrimitive(PrimitiveType type, const Vector3& positi
     primitives_by_id_[id] = primitive;
     primitive_ids_[primitive] = id;
     objects_.push_back(primitive);
+    record_edit(SceneEditKind::ADDED, primitive, AABB(), primitive->bounding_box());
     
     updateGPUPrimitiveData(id);
     markPrimitiveGPUDirty();
@@ -117,6 +131,7 @@ bool SceneManager::removePrimitive(PrimitiveID id) {
     if (objects_it != objects_.end()) {
         objects_.erase(objects_it);
     }
+    record_edit(SceneEditKind::REMOVED, primitive, primitive->bounding_box(), AABB());
     
     primitives_by_id_.erase(it);
     primitive_ids_.erase(primitive);
@@ -140,15 +155,51 @@ std::shared_ptr<Primitive> SceneManager::getPrimitive(PrimitiveID id) const {
     return nullptr;
 }
 
+PrimitiveID SceneManager::get_object_id(int object_index) const {
+    if (object_index < 0 || object_index >= static_cast<int>(objects_.size())) {
+        return INVALID_PRIMITIVE_ID;
+    }
+    auto it = primitive_ids_.find(objects_[object_index]);
+    return it != primitive_ids_.end() ? it->second : INVALID_PRIMITIVE_ID;
+}
+
+bool SceneManager::move_object(PrimitiveID id, const Vector3& position) {
+    auto object = getPrimitive(id);
+    if (!object) {
+        return false;
+    }
+    const AABB previous = object->bounding_box();
+    object->set_position(position);
+    notify_object_changed(object, previous, SceneEditKind::MODIFIED);
+    return true;
+}
+
+bool SceneManager::set_object_material(PrimitiveID id, const Material& material) {
+    auto object = getPrimitive(id);
+    if (!object) {
+        return false;
+    }
+    object->set_material(material);
+    notify_object_changed(object, object->bounding_box(), SceneEditKind::MATERIAL);
+    return true;
+}
+
 void SceneManager::add_light(const Vector3& position, const Color& color, float intensity) {
     // Create a small emissive sphere as a light source
     Material light_material(color, 0.0f, 0.0f, intensity);
     auto light_sphere = std::make_shared<Sphere>(position, 0.1f, color, light_material);
     lights_.push_back(light_sphere);
     objects_.push_back(light_sphere); // Also add to objects for rendering
+    register_object_id(light_sphere);
+    record_edit(SceneEditKind::ADDED, light_sphere, AABB(), light_sphere->bounding_box());
 }
 
 void SceneManager::clear_lights() {
+    // add_light made each light a scene object too; it leaves with the light
+    for (const auto& light : lights_) {
+        remove_object(light);
+        unregister_object_id(light);
+    }
     lights_.clear();
 }
 
@@ -156,16 +207,259 @@ const std::vector<std::shared_ptr<Primitive>>& SceneManager::get_lights() const
     return lights_;
 }
 
+uint64_t SceneManager::get_scene_version() const {
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    return scene_version_;
+}
+
+bool SceneManager::get_edits_since(uint64_t version, std::vector<SceneEdit>& edits) const {
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    if (version >= scene_version_) {
+        return true;
+    }
+    if (edit_journal_.empty() || edit_journal_.front().version > version + 1) {
+        return false;
+    }
+    for (const auto& edit : edit_journal_) {
+        if (edit.version > version) {
+            edits.push_back(edit);
+        }
+    }
+    return true;
+}
+
+void SceneManager::notify_object_changed(std::shared_ptr<Primitive> object, const AABB& previous_bounds,
+                                         SceneEditKind kind) {
+    if (!object) return;
+    record_edit(kind, object, previous_bounds, object->bounding_box());
+    
+    auto id_it = primitive_ids_.find(object);
+    if (id_it != primitive_ids_.end()) {
+        updateGPUPrimitiveData(id_it->second);
+        markPrimitiveGPUDirty();
+    }
+#ifdef USE_GPU
+    markGPUDirty();
+#endif
+}
+
+namespace {
+
+void hash_bytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+void hash_floats(uint64_t& hash, std::initializer_list<float> values) {
+    for (float value : values) {
+        hash_bytes(hash, &value, sizeof(value));
+    }
+}
+
+// Type, shape and placement: everything a ray's hits depend on
+void hash_geometry(uint64_t& hash, const Primitive& primitive) {
+    uint32_t type = 0;
+    if (auto sphere = dynamic_cast<const Sphere*>(&primitive)) {
+        type = static_cast<uint32_t>(PrimitiveType::SPHERE);
+        hash_floats(hash, {sphere->radius()});
+    } else if (auto cube = dynamic_cast<const Cube*>(&primitive)) {
+        type = static_cast<uint32_t>(PrimitiveType::CUBE);
+        hash_floats(hash, {cube->size()});
+    } else if (auto torus = dynamic_cast<const Torus*>(&primitive)) {
+        type = static_cast<uint32_t>(PrimitiveType::TORUS);
+        hash_floats(hash, {torus->major_radius(), torus->minor_radius()});
+    } else if (auto pyramid = dynamic_cast<const Pyramid*>(&primitive)) {
+        type = static_cast<uint32_t>(PrimitiveType::PYRAMID);
+        hash_floats(hash, {pyramid->base_size(), pyramid->height()});
+    }
+    hash_bytes(hash, &type, sizeof(type));
+    const Vector3& p = primitive.position();
+    hash_floats(hash, {p.x, p.y, p.z});
+}
+
+void hash_primitive(uint64_t& hash, const Primitive& primitive) {
+    hash_geometry(hash, primitive);
+    const Color& c = primitive.color();
+    const Material& m = primitive.material();
+    hash_floats(hash, {c.r, c.g, c.b, c.a,
+                       m.albedo.r, m.albedo.g, m.albedo.b, m.roughness, m.metallic, m.emission});
+}
+
+} // namespace
+
+uint64_t SceneManager::content_hash() const {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const auto& object : objects_) {
+        if (object) {
+            hash_primitive(hash, *object);
+        }
+    }
+    // Separates an object list from a light list that happen to concatenate alike
+    uint64_t lights = lights_.size();
+    hash_bytes(hash, &lights, sizeof(lights));
+    for (const auto& light : lights_) {
+        if (light) {
+            hash_primitive(hash, *light);
+        }
+    }
+    return hash;
+}
+
+uint64_t SceneManager::geometry_hash() const {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    uint64_t count = objects_.size();
+    hash_bytes(hash, &count, sizeof(count));
+    for (const auto& object : objects_) {
+        if (object) {
+            hash_geometry(hash, *object);
+        }
+    }
+    return hash;
+}
+
+namespace {
+
+// One object of a serialized scene; shape holds the type's one or two dimensions
+struct SerializedPrimitive {
+    uint32_t type;
+    uint32_t is_light;
+    float shape[2];
+    float position[3];
+    float color[4];
+    float albedo[4];
+    float roughness;
+    float metallic;
+    float emission;
+};
+
+} // namespace
+
+std::string SceneManager::serialize() const {
+    std::string bytes;
+    uint32_t count = static_cast<uint32_t>(objects_.size());
+    bytes.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& object : objects_) {
+        SerializedPrimitive record{};
+        if (auto sphere = std::dynamic_pointer_cast<const Sphere>(object)) {
+            record.type = static_cast<uint32_t>(PrimitiveType::SPHERE);
+            record.shape[0] = sphere->radius();
+        } else if (auto cube = std::dynamic_pointer_cast<const Cube>(object)) {
+            record.type = static_cast<uint32_t>(PrimitiveType::CUBE);
+            record.shape[0] = cube->size();
+        } else if (auto torus = std::dynamic_pointer_cast<const Torus>(object)) {
+            record.type = static_cast<uint32_t>(PrimitiveType::TORUS);
+            record.shape[0] = torus->major_radius();
+            record.shape[1] = torus->minor_radius();
+        } else if (auto pyramid = std::dynamic_pointer_cast<const Pyramid>(object)) {
+            record.type = static_cast<uint32_t>(PrimitiveType::PYRAMID);
+            record.shape[0] = pyramid->base_size();
+            record.shape[1] = pyramid->height();
+        }
+        record.is_light = std::find(lights_.begin(), lights_.end(), object) != lights_.end();
+        const Vector3& p = object->position();
+        const Color& c = object->color();
+        const Material& m = object->material();
+        const float values[] = {p.x, p.y, p.z, c.r, c.g, c.b, c.a, m.albedo.r, m.albedo.g, m.albedo.b, m.albedo.a};
+        std::copy(values, values + 3, record.position);
+        std::copy(values + 3, values + 7, record.color);
+        std::copy(values + 7, values + 11, record.albedo);
+        record.roughness = m.roughness;
+        record.metallic = m.metallic;
+        record.emission = m.emission;
+        bytes.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    return bytes;
+}
+
+bool SceneManager::deserialize(const std::string& bytes) {
+    uint32_t count = 0;
+    if (bytes.size() < sizeof(count)) {
+        return false;
+    }
+    std::memcpy(&count, bytes.data(), sizeof(count));
+    if (bytes.size() != sizeof(count) + static_cast<size_t>(count) * sizeof(SerializedPrimitive)) {
+        return false;
+    }
+    
+    // Build everything first; constructors throw on invalid dimensions
+    std::vector<std::pair<std::shared_ptr<Primitive>, bool>> objects;
+    try {
+        for (uint32_t i = 0; i < count; ++i) {
+            SerializedPrimitive record;
+            std::memcpy(&record, bytes.data() + sizeof(count) + i * sizeof(record), sizeof(record));
+            Vector3 position(record.position[0], record.position[1], record.position[2]);
+            Color color(record.color[0], record.color[1], record.color[2], record.color[3]);
+            Material material(Color(record.albedo[0], record.albedo[1], record.albedo[2], record.albedo[3]),
+                              record.roughness, record.metallic, record.emission);
+            std::shared_ptr<Primitive> object;
+            switch (static_cast<PrimitiveType>(record.type)) {
+                case PrimitiveType::SPHERE:
+                    object = std::make_shared<Sphere>(position, record.shape[0], color, material);
+                    break;
+                case PrimitiveType::CUBE:
+                    object = std::make_shared<Cube>(position, record.shape[0], color, material);
+                    break;
+                case PrimitiveType::TORUS:
+                    object = std::make_shared<Torus>(position, record.shape[0], record.shape[1], color, material);
+                    break;
+                case PrimitiveType::PYRAMID:
+                    object = std::make_shared<Pyramid>(position, record.shape[0], record.shape[1], color, material);
+                    break;
+                default:
+                    return false;
+            }
+            objects.emplace_back(object, record.is_light != 0);
+        }
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+    
+    clear_objects();
+    clear_lights();
+    for (const auto& entry : objects) {
+        add_object(entry.first);
+        if (entry.second) {
+            lights_.push_back(entry.first);
+        }
+    }
+    return true;
+}
+
+void SceneManager::record_edit(SceneEditKind kind, std::shared_ptr<Primitive> object,
+                               const AABB& old_bounds, const AABB& new_bounds) {
+    SceneEdit edit;
+    edit.kind = kind;
+    edit.old_bounds = old_bounds;
+    edit.new_bounds = new_bounds;
+    if (object) {
+        auto id_it = primitive_ids_.find(object);
+        if (id_it != primitive_ids_.end()) {
+            edit.id = id_it->second;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    edit.version = ++scene_version_;
+    edit_journal_.push_back(edit);
+    if (edit_journal_.size() > MAX_EDIT_JOURNAL) {
+        edit_journal_.pop_front();
+    }
+}
+
 bool SceneManager::hit_scene(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
     HitRecord temp_rec;
     bool hit_anything = false;
     float closest_so_far = t_max;
     
-    for (const auto& object : objects_) {
-        if (object->hit(ray, t_min, closest_so_far, temp_rec)) {
+    for (size_t i = 0; i < objects_.size(); ++i) {
+        if (objects_[i]->hit(ray, t_min, closest_so_far, temp_rec)) {
             hit_anything = true;
             closest_so_far = temp_rec.t;
             rec = temp_rec;
+            rec.object_index = static_cast<int>(i);
         }
     }
     
@@ -188,9 +482,7 @@ void SceneManager::setup_default_scene() {
     add_object(ground);
     
     // Also add to GPU primitive tracking for default objects
-    PrimitiveID ground_id = generatePrimitiveID();
-    primitives_by_id_[ground_id] = ground;
-    primitive_ids_[ground] = ground_id;
+    PrimitiveID ground_id = primitive_ids_[ground];  // Assigned by add_object
     updateGPUPrimitiveData(ground_id);
     
     // Center sphere - Use consistent material color
@@ -198,9 +490,7 @@ void SceneManager::setup_default_scene() {
     auto center_sphere = std::make_shared<Sphere>(Vector3(0, 0, -1), 0.5f, center_material.albedo, center_material);
     add_object(center_sphere);
     
-    PrimitiveID center_id = generatePrimitiveID();
-    primitives_by_id_[center_id] = center_sphere;
-    primitive_ids_[center_sphere] = center_id;
+    PrimitiveID center_id = primitive_ids_[center_sphere];  // Assigned by add_object
     updateGPUPrimitiveData(center_id);
     
     // Left sphere (metal) - Use consistent material color
@@ -208,9 +498,7 @@ void SceneManager::setup_default_scene() {
     auto left_sphere = std::make_shared<Sphere>(Vector3(-1, 0, -1), 0.5f, left_material.albedo, left_material);
     add_object(left_sphere);
     
-    PrimitiveID left_id = generatePrimitiveID();
-    primitives_by_id_[left_id] = left_sphere;
-    primitive_ids_[left_sphere] = left_id;
+    PrimitiveID left_id = primitive_ids_[left_sphere];  // Assigned by add_object
     updateGPUPrimitiveData(left_id);
     
     // Right sphere (glass-like) - Use consistent material color
@@ -218,9 +506,7 @@ void SceneManager::setup_default_scene() {
     auto right_sphere = std::make_shared<Sphere>(Vector3(1, 0, -1), 0.5f, right_material.albedo, right_material);
     add_object(right_sphere);
     
-    PrimitiveID right_id = generatePrimitiveID();
-    primitives_by_id_[right_id] = right_sphere;
-    primitive_ids_[right_sphere] = right_id;
+    PrimitiveID right_id = primitive_ids_[right_sphere];  // Assigned by add_object
     updateGPUPrimitiveData(right_id);
     
     // Add a cube - Use consistent material color
@@ -228,9 +514,7 @@ void SceneManager::setup_default_scene() {
     auto cube = std::make_shared<Cube>(Vector3(0, 1, -2), 0.8f, cube_material.albedo, cube_material);
     add_object(cube);
     
-    PrimitiveID cube_id = generatePrimitiveID();
-    primitives_by_id_[cube_id] = cube;
-    primitive_ids_[cube] = cube_id;
+    PrimitiveID cube_id = primitive_ids_[cube];  // Assigned by add_object
     updateGPUPrimitiveData(cube_id);
     
     // Add a torus for debugging - Use consistent material color
@@ -238,9 +522,7 @@ void SceneManager::setup_default_scene() {
     auto torus = std::make_shared<Torus>(Vector3(-1.5f, 0, -2), 0.8f, 0.3f, torus_material.albedo, torus_material);
     add_object(torus);
     
-    PrimitiveID torus_id = generatePrimitiveID();
-    primitives_by_id_[torus_id] = torus;
-    primitive_ids_[torus] = torus_id;
+    PrimitiveID torus_id = primitive_ids_[torus];  // Assigned by add_object
     updateGPUPrimitiveData(torus_id);
     
     // Add a pyramid for debugging - Use consistent material color
@@ -248,9 +530,7 @@ void SceneManager::setup_default_scene() {
     auto pyramid = std::make_shared<Pyramid>(Vector3(1.5f, 0, -2), 1.0f, 1.2f, pyramid_material.albedo, pyramid_material);
     add_object(pyramid);
     
-    PrimitiveID pyramid_id = generatePrimitiveID();
-    primitives_by_id_[pyramid_id] = pyramid;
-    primitive_ids_[pyramid] = pyramid_id;
+    PrimitiveID pyramid_id = primitive_ids_[pyramid];  // Assigned by add_object
     updateGPUPrimitiveData(pyramid_id);
     
     // Mark primitive data as dirty to trigger GPU sync
@@ -330,6 +610,28 @@ bool SceneManager::is_valid_camera_position(const Vector3& position) const {
 }
 
 // Helper methods for primitive management
+void SceneManager::register_object_id(std::shared_ptr<Primitive> object) {
+    // Objects added through the legacy path get an ID too so picking and
+    // ID buffers can name every visible object
+    if (primitive_ids_.count(object)) {
+        return;
+    }
+    PrimitiveID id = generatePrimitiveID();
+    primitives_by_id_[id] = object;
+    primitive_ids_[object] = id;
+}
+
+void SceneManager::unregister_object_id(std::shared_ptr<Primitive> object) {
+    auto id_it = primitive_ids_.find(object);
+    if (id_it == primitive_ids_.end()) {
+        return;
+    }
+    removeFromGPUData(id_it->second);
+    markPrimitiveGPUDirty();
+    primitives_by_id_.erase(id_it->second);
+    primitive_ids_.erase(id_it);
+}
+
 PrimitiveID SceneManager::generatePrimitiveID() {
     if (next_primitive_id_ == INVALID_PRIMITIVE_ID) {
         next_primitive_id_++;
@@ -451,6 +753,7 @@ void SceneManager::setGPUMemoryManager(std::shared_ptr<GPUMemoryManager> gpu_mem
 }
 
 void SceneManager::syncSceneToGPU() {
+    PROFILE_FUNCTION();
     if (!gpu_memory_manager_ || objects_.empty()) {
         return;
     }
@@ -577,6 +880,7 @@ bool SceneManager::isGPUSynced() const {
 
 // Enhanced GPU primitive management methods
 void SceneManager::syncPrimitivesToGPU() {
+    PROFILE_FUNCTION();
     if (!gpu_memory_manager_ || gpu_primitive_data_.empty()) {
         return;
     }
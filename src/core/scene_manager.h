@@ -6,6 +6,9 @@
 #include <memory>
 #include <unordered_map>
 #include <algorithm>
+#include <deque>
+#include <mutex>
+#include <string>
 
 // Forward declarations
 class Camera;
@@ -44,6 +47,24 @@ struct GPUPrimitiveData {
     }
 };
 
+// Journal entry describing one scene change. Caches that depend on scene
+// content poll get_edits_since() and invalidate only the affected region.
+enum class SceneEditKind {
+    ADDED,
+    REMOVED,
+    MODIFIED,   // Geometry or transform changed
+    MATERIAL,   // Material only; first hits are unchanged
+    CLEARED     // Whole scene replaced
+};
+
+struct SceneEdit {
+    uint64_t version = 0;
+    SceneEditKind kind = SceneEditKind::MODIFIED;
+    PrimitiveID id = INVALID_PRIMITIVE_ID;
+    AABB old_bounds;   // Empty for ADDED
+    AABB new_bounds;   // Empty for REMOVED
+};
+
 class SceneManager {
 public:
     SceneManager();
@@ -58,6 +79,14 @@ public:
                            const Color& color = Color::white(), const Material& material = Material());
     bool removePrimitive(PrimitiveID id);
     std::shared_ptr<Primitive> getPrimitive(PrimitiveID id) const;
+    // ID of the object hit_scene() reported in HitRecord::object_index
+    PrimitiveID get_object_id(int object_index) const;
+    // Moves an object and records the edit with its old and new bounds.
+    // False for an unknown ID.
+    bool move_object(PrimitiveID id, const Vector3& position);
+    // Replaces an object's material and records a MATERIAL edit, which
+    // keeps caches of first hits. False for an unknown ID.
+    bool set_object_material(PrimitiveID id, const Material& material);
     
     // Legacy object management (for backward compatibility)
     void add_object(std::shared_ptr<Primitive> object);
@@ -79,6 +108,27 @@ public:
     std::shared_ptr<GPUBuffer> getSceneGPUBuffer() const;
     bool isGPUSynced() const;
     
+    // Scene edit journal
+    uint64_t get_scene_version() const;
+    // Appends edits newer than version. Returns false if the journal no longer
+    // reaches back that far, in which case the caller must treat everything as changed.
+    bool get_edits_since(uint64_t version, std::vector<SceneEdit>& edits) const;
+    // Report an in-place change made through Primitive setters; prefer
+    // move_object and set_object_material, which record the edit themselves
+    void notify_object_changed(std::shared_ptr<Primitive> object, const AABB& previous_bounds,
+                               SceneEditKind kind = SceneEditKind::MODIFIED);
+    // Hash of every object's and light's shape, placement, colour and
+    // material; equal scenes hash equal regardless of edit history
+    uint64_t content_hash() const;
+    // Hash of every object's type, shape and placement in scene order.
+    // Material and colour edits leave it unchanged.
+    uint64_t geometry_hash() const;
+    // Every object and light (shape, placement, colour, material) as bytes
+    // for rebuilding the scene in another process; the camera is not included
+    std::string serialize() const;
+    // Replaces objects and lights. False, leaving the scene untouched, on malformed data
+    bool deserialize(const std::string& bytes);
+    
     // Light source management  
     void add_light(const Vector3& position, const Color& color, float intensity);
     void clear_lights();
@@ -108,6 +158,12 @@ private:
     std::unordered_map<std::shared_ptr<Primitive>, PrimitiveID> primitive_ids_;
     PrimitiveID next_primitive_id_;
     std::vector<GPUPrimitiveData> gpu_primitive_data_;
+    
+    // Scene edit journal (bounded; oldest entries are dropped)
+    static constexpr size_t MAX_EDIT_JOURNAL = 1024;
+    mutable std::mutex edit_mutex_;
+    std::deque<SceneEdit> edit_journal_;
+    uint64_t scene_version_;
     bool gpu_primitive_data_dirty_;
     
     // GPU memory coordination
@@ -121,12 +177,16 @@ private:
     void create_default_camera();
     void markGPUDirty();
     void markPrimitiveGPUDirty();
+    void record_edit(SceneEditKind kind, std::shared_ptr<Primitive> object,
+                     const AABB& old_bounds, const AABB& new_bounds);
     bool validateGPUBufferSize() const;
     void resizeGPUBufferIfNeeded();
     void resizePrimitiveGPUBufferIfNeeded();
     
     // Helper methods for primitive management
     PrimitiveID generatePrimitiveID();
+    void register_object_id(std::shared_ptr<Primitive> object);
+    void unregister_object_id(std::shared_ptr<Primitive> object);
     std::shared_ptr<Primitive> createPrimitive(PrimitiveType type, const Vector3& position, 
                                              const Color& color, const Material& material);
     void updateGPUPrimitiveData(PrimitiveID id);
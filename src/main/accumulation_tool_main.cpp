@@ -0,0 +1,209 @@
+#include "performance/cpu_benchmark.h"
+#include "render/accumulation_file.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " render SCENARIO [options]\n"
+              << "       " << program << " merge FILE... [options]\n"
+              << "       " << program << " info FILE...\n"
+              << "\n"
+              << "render: one job of a distributed render, as an accumulation file\n"
+              << "  --first-pass N     First sample pass of this job (default 0)\n"
+              << "  --passes N         Passes to render (default: the scenario's samples per pixel)\n"
+              << "  --seed N           Seed shared by every job of the render (default: the scenario's)\n"
+              << "  --scale F          Resolution scale (default 1.0)\n"
+              << "  --threads N        Render threads (default: hardware concurrency)\n"
+              << "  --variance         Record per-pixel luminance moments\n"
+              << "  --output FILE      Accumulation file (default SCENARIO_FIRST_LAST.accum)\n"
+              << "\n"
+              << "merge: add jobs with disjoint pass ranges\n"
+              << "  --output FILE      Merged accumulation file\n"
+              << "  --image FILE       Final linear image as PFM\n"
+              << "  --threads N        Merge threads (default: hardware concurrency)\n"
+              << "  --band-rows N      Rows streamed per read (default 16)\n";
+}
+
+void print_header(const std::string& filename, const AccumulationHeader& header) {
+    std::cout << filename << ": " << header.width << "x" << header.height << ", depth " << header.max_depth
+              << ", seed " << header.seed << ", " << header.pass_count() << " passes in";
+    for (const SampleRange& range : header.ranges) {
+        std::cout << " [" << range.first << ", " << range.end() << ")";
+    }
+    std::cout << (header.has_variance ? ", with variance" : "") << std::endl;
+}
+
+int run_render(int argc, char* argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    const std::string name = argv[2];
+    long long first_pass = 0;
+    long long passes = -1;
+    long long seed = -1;
+    double scale = 1.0;
+    int threads = 0;
+    bool variance = false;
+    std::string output;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--first-pass" && has_value) {
+            first_pass = std::atoll(argv[++i]);
+        } else if (arg == "--passes" && has_value) {
+            passes = std::atoll(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            seed = std::atoll(argv[++i]);
+        } else if (arg == "--scale" && has_value) {
+            scale = std::atof(argv[++i]);
+        } else if (arg == "--threads" && has_value) {
+            threads = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--variance") {
+            variance = true;
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<CPUBenchmarkSuite::Scenario> scenarios = CPUBenchmarkSuite::standardScenarios();
+    auto scenario = std::find_if(scenarios.begin(), scenarios.end(),
+                                 [&](const CPUBenchmarkSuite::Scenario& s) { return s.name == name; });
+    if (scenario == scenarios.end()) {
+        std::cerr << "Unknown scenario " << name << std::endl;
+        return 1;
+    }
+    if (passes < 0) {
+        passes = scenario->samplesPerPixel;
+    }
+    // Seed 0 would mean a random seed per job, and jobs could not be merged
+    if (seed <= 0) {
+        seed = static_cast<long long>(scenario->seed);
+    }
+    if (first_pass < 0 || passes <= 0 || first_pass + passes > 0xffffffffll || scale <= 0.0) {
+        std::cerr << "Invalid pass range or scale" << std::endl;
+        return 1;
+    }
+    if (output.empty()) {
+        output = name + "_" + std::to_string(first_pass) + "_" + std::to_string(first_pass + passes) + ".accum";
+    }
+
+    const int width = std::max(1, static_cast<int>(std::lround(scenario->width * scale)));
+    const int height = std::max(1, static_cast<int>(std::lround(scenario->height * scale)));
+    auto scene = std::make_shared<SceneManager>();
+    scene->initialize();
+    if (scenario->buildScene) {
+        scenario->buildScene(*scene);
+    }
+    Camera camera = *scene->get_camera();
+    camera.set_aspect_ratio(float(width) / float(height));
+
+    PathTracer path_tracer;
+    path_tracer.set_scene_manager(scene);
+    path_tracer.set_camera(camera);
+    path_tracer.set_max_depth(scenario->maxDepth);
+    path_tracer.set_random_seed(static_cast<uint64_t>(seed));
+    if (threads > 0) {
+        path_tracer.set_thread_count(threads);
+    }
+
+    AccumulationFile file;
+    if (!path_tracer.trace_sample_range(width, height, static_cast<uint32_t>(first_pass),
+                                        static_cast<uint32_t>(passes), variance, file)) {
+        std::cerr << "Render stopped before the range was complete" << std::endl;
+        return 1;
+    }
+    if (!file.save(output)) {
+        std::cerr << "Could not write " << output << std::endl;
+        return 1;
+    }
+    FrameStats stats = path_tracer.get_frame_stats();
+    std::cout << "Rendered passes [" << first_pass << ", " << first_pass + passes << ") of " << name
+              << " in " << stats.seconds << " s (" << stats.mrays_per_second() << " Mrays/s)" << std::endl;
+    print_header(output, file.header);
+    return 0;
+}
+
+int run_merge(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    AccumulationMergeOptions options;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--output" && has_value) {
+            options.output = argv[++i];
+        } else if (arg == "--image" && has_value) {
+            options.image = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--band-rows" && has_value) {
+            options.band_rows = std::max(1, std::atoi(argv[++i]));
+        } else if (!arg.empty() && arg[0] != '-') {
+            inputs.push_back(arg);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (inputs.empty() || (options.output.empty() && options.image.empty())) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    AccumulationHeader merged;
+    std::string error;
+    if (!merge_accumulation_files(inputs, options, &merged, &error)) {
+        std::cerr << "Merge failed: " << error << std::endl;
+        return 1;
+    }
+    print_header(options.output.empty() ? options.image : options.output, merged);
+    return 0;
+}
+
+int run_info(int argc, char* argv[]) {
+    int status = argc > 2 ? 0 : 1;
+    for (int i = 2; i < argc; ++i) {
+        AccumulationHeader header;
+        if (AccumulationFile::read_header(argv[i], header)) {
+            print_header(argv[i], header);
+        } else {
+            std::cerr << argv[i] << ": not an accumulation file" << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string command = argc > 1 ? argv[1] : "";
+    logger_set_level(LogLevel::WARN);
+
+    if (command == "render") {
+        return run_render(argc, argv);
+    }
+    if (command == "merge") {
+        return run_merge(argc, argv);
+    }
+    if (command == "info") {
+        return run_info(argc, argv);
+    }
+    print_usage(argv[0]);
+    return command == "--help" || command == "-h" ? 0 : 1;
+}
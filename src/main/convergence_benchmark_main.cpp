@@ -0,0 +1,145 @@
+#include "performance/convergence_benchmark.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] [scenario...]\n"
+              << "  --scale F            Resolution scale (default 0.5)\n"
+              << "  --reference-spp N    Samples per pixel of the reference (default 1024)\n"
+              << "  --max-spp N          Largest sample count measured (default 64)\n"
+              << "  --threads N          Worker threads (default: hardware concurrency)\n"
+              << "  --reference-dir DIR  Reference cache (default benchmark_references)\n"
+              << "  --refresh            Re-render cached references\n"
+              << "  --technique LIST     Comma-separated: path, path_denoised, progressive, preview, preview_no_cache\n"
+              << "  --metric M           rmse, relmse or dssim for the time-to-error table (default relmse)\n"
+              << "  --targets LIST       Comma-separated error targets (default 0.1,0.03,0.01)\n"
+              << "  --csv FILE           Error-versus-time curves, one row per point\n"
+              << "  --output FILE        JSON results (default convergence.json)\n";
+}
+
+std::vector<std::string> split_list(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+bool parse_technique(const std::string& name, ConvergenceBenchmark::Technique& technique) {
+    using Technique = ConvergenceBenchmark::Technique;
+    for (Technique candidate : {Technique::PATH, Technique::PATH_DENOISED, Technique::PROGRESSIVE,
+                                Technique::PREVIEW, Technique::PREVIEW_NO_CACHE}) {
+        if (name == ConvergenceBenchmark::techniqueName(candidate)) {
+            technique = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_metric(const std::string& name, ConvergenceBenchmark::ErrorMetric& metric) {
+    using ErrorMetric = ConvergenceBenchmark::ErrorMetric;
+    for (ErrorMetric candidate : {ErrorMetric::RMSE, ErrorMetric::REL_MSE, ErrorMetric::DSSIM}) {
+        if (name == ConvergenceBenchmark::metricName(candidate)) {
+            metric = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ConvergenceBenchmark benchmark;
+    ConvergenceBenchmark::Configuration config;
+    std::vector<std::string> scenarios;
+    std::string output = "convergence.json";
+    std::string csv;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--scale" && has_value) {
+            config.resolutionScale = std::atof(argv[++i]);
+        } else if (arg == "--reference-spp" && has_value) {
+            config.referenceSamples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--max-spp" && has_value) {
+            config.maxSamples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && has_value) {
+            config.threadCount = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--reference-dir" && has_value) {
+            config.referenceDir = argv[++i];
+        } else if (arg == "--refresh") {
+            config.refreshReferences = true;
+        } else if (arg == "--technique" && has_value) {
+            config.techniques.clear();
+            for (const auto& name : split_list(argv[++i])) {
+                ConvergenceBenchmark::Technique technique;
+                if (!parse_technique(name, technique)) {
+                    std::cerr << "Unknown technique: " << name << std::endl;
+                    return 1;
+                }
+                config.techniques.push_back(technique);
+            }
+        } else if (arg == "--metric" && has_value) {
+            if (!parse_metric(argv[++i], config.reportMetric)) {
+                std::cerr << "Unknown metric: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--targets" && has_value) {
+            config.targets.clear();
+            for (const auto& target : split_list(argv[++i])) {
+                config.targets.push_back(std::atof(target.c_str()));
+            }
+        } else if (arg == "--csv" && has_value) {
+            csv = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] != '-') {
+            scenarios.push_back(arg);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.resolutionScale <= 0.0) {
+        std::cerr << "Resolution scale must be positive" << std::endl;
+        return 1;
+    }
+    // References are expensive; default to a diffuse scene and a glossy one
+    if (scenarios.empty()) {
+        scenarios = {"simple", "metal_heavy"};
+    }
+
+    logger_set_level(LogLevel::WARN);
+
+    benchmark.setConfiguration(config);
+    std::vector<ConvergenceBenchmark::Curve> curves = benchmark.runScenarios(scenarios);
+    if (curves.empty()) {
+        std::cerr << "No matching scenarios" << std::endl;
+        return 1;
+    }
+
+    benchmark.printReport(std::cout, curves);
+    bool ok = benchmark.writeFile(output, curves, false);
+    if (!csv.empty()) {
+        ok = benchmark.writeFile(csv, curves, true) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include "performance/cpu_benchmark.h"
+#include "performance/benchmark_baseline.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] [scenario...]\n"
+              << "  --output FILE      JSON results file (default cpu_benchmark.json, - for stdout)\n"
+              << "  --iterations N     Timed renders per scenario (default 5)\n"
+              << "  --warmup N         Untimed renders per scenario (default 1)\n"
+              << "  --threads N        Worker threads (default: hardware concurrency)\n"
+              << "  --scale F          Resolution scale for quick runs (default 1.0)\n"
+              << "  --no-counters      Skip hardware performance counters\n"
+              << "  --list             List scenarios and exit\n"
+              << "  --baseline-dir DIR Where baselines are kept (default benchmark_baselines)\n"
+              << "  --save-baseline    Store these results as the baseline for this machine and build\n"
+              << "  --compare          Compare against the stored baseline; exit 2 on a regression\n"
+              << "  --alpha P          Significance level of the regression test (default 0.01)\n"
+              << "  --threshold F      Smallest slowdown reported, as a fraction (default 0.03)\n";
+}
+
+// Thread count and scale change the timings, so they are part of the baseline name
+std::string baseline_suite_name(const CPUBenchmarkSuite::Configuration& config) {
+    std::ostringstream name;
+    name << "cpu";
+    if (config.threadCount > 0) {
+        name << "-t" << config.threadCount;
+    }
+    if (config.resolutionScale != 1.0) {
+        name << "-s" << config.resolutionScale;
+    }
+    return name.str();
+}
+
+int compare_with_baseline(const std::string& path, const MachineFingerprint& fingerprint,
+                          const std::vector<CPUBenchmarkSuite::Result>& results,
+                          double alpha, double threshold) {
+    BenchmarkBaseline baseline;
+    if (!BenchmarkBaseline::load(path, baseline)) {
+        std::cerr << "No baseline at " << path << "; run with --save-baseline first" << std::endl;
+        return 1;
+    }
+    if (baseline.fingerprint.key != fingerprint.key) {
+        std::cerr << "Baseline " << path << " was recorded on a different machine or build" << std::endl;
+        return 1;
+    }
+
+    std::vector<RegressionCheck> checks = baseline.compare(CPUBenchmarkSuite::baselineMetrics(results), alpha, threshold);
+    std::cout << "Baseline recorded " << baseline.created << " on " << baseline.fingerprint.description() << std::endl;
+    printRegressionReport(std::cout, checks);
+
+    int regressions = 0;
+    for (const auto& check : checks) {
+        if (check.regression) {
+            ++regressions;
+        }
+    }
+    if (regressions > 0) {
+        std::cout << regressions << " regression(s) against baseline" << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    CPUBenchmarkSuite suite;
+    CPUBenchmarkSuite::Configuration config;
+    std::string output = "cpu_benchmark.json";
+    std::vector<std::string> scenarios;
+    std::string baseline_dir = "benchmark_baselines";
+    bool save_baseline = false;
+    bool compare_baseline = false;
+    double alpha = 0.01;
+    double threshold = 0.03;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--iterations" && has_value) {
+            config.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && has_value) {
+            config.warmupIterations = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && has_value) {
+            config.threadCount = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--scale" && has_value) {
+            config.resolutionScale = std::atof(argv[++i]);
+        } else if (arg == "--no-counters") {
+            config.enableHardwareCounters = false;
+        } else if (arg == "--baseline-dir" && has_value) {
+            baseline_dir = argv[++i];
+        } else if (arg == "--save-baseline") {
+            save_baseline = true;
+        } else if (arg == "--compare") {
+            compare_baseline = true;
+        } else if (arg == "--alpha" && has_value) {
+            alpha = std::atof(argv[++i]);
+        } else if (arg == "--threshold" && has_value) {
+            threshold = std::atof(argv[++i]);
+        } else if (arg == "--list") {
+            for (const auto& scenario : CPUBenchmarkSuite::standardScenarios()) {
+                std::cout << scenario.name << " (" << scenario.width << "x" << scenario.height
+                          << ", " << scenario.samplesPerPixel << " spp, depth " << scenario.maxDepth << ")" << std::endl;
+            }
+            return 0;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] != '-') {
+            scenarios.push_back(arg);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.resolutionScale <= 0.0) {
+        std::cerr << "Resolution scale must be positive" << std::endl;
+        return 1;
+    }
+
+    // Per-render progress lines would interleave with the report
+    logger_set_level(LogLevel::WARN);
+
+    suite.setConfiguration(config);
+    std::vector<CPUBenchmarkSuite::Result> results = suite.runScenarios(scenarios);
+    if (results.empty()) {
+        std::cerr << "No matching scenarios; use --list to see them" << std::endl;
+        return 1;
+    }
+
+    suite.printReport(std::cout, results);
+    bool written = true;
+    if (output == "-") {
+        suite.writeJSON(std::cout, results);
+    } else {
+        written = suite.writeJSON(output, results);
+    }
+
+    MachineFingerprint fingerprint = MachineFingerprint::current();
+    std::string baseline_path = BenchmarkBaseline::defaultPath(baseline_dir, baseline_suite_name(config), fingerprint);
+    int status = written ? 0 : 1;
+    if (compare_baseline) {
+        // Compare before saving so --compare --save-baseline checks against the previous run
+        status = std::max(status, compare_with_baseline(baseline_path, fingerprint, results, alpha, threshold));
+    }
+    if (save_baseline) {
+        if (mkdir(baseline_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            std::cerr << "Could not create baseline directory: " << baseline_dir << std::endl;
+            return std::max(status, 1);
+        }
+        BenchmarkBaseline baseline;
+        baseline.suite = baseline_suite_name(config);
+        baseline.fingerprint = fingerprint;
+        baseline.samples = CPUBenchmarkSuite::baselineMetrics(results);
+        if (!baseline.save(baseline_path)) {
+            return std::max(status, 1);
+        }
+        std::cout << "Baseline for " << fingerprint.description() << " written to " << baseline_path << std::endl;
+    }
+    return status;
+}
@@ -0,0 +1,130 @@
+#include "performance/cpu_benchmark.h"
+#include "render/tile_distributor.h"
+#include "render/image_output.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] SCENARIO\n"
+              << "       " << program << " --worker-fd FD\n"
+              << "\n"
+              << "Renders a CPU benchmark scenario across spawned worker processes.\n"
+              << "  --workers N        Worker processes (default: hardware concurrency)\n"
+              << "  --frames N         Frames to render, to see steady-state timing (default 1)\n"
+              << "  --samples N        Samples per pixel (default: the scenario's)\n"
+              << "  --scale F          Resolution scale (default 1.0)\n"
+              << "  --tile-size N      Tile edge in pixels (default 32)\n"
+              << "  --output FILE      Linear image of the last frame as PFM\n"
+              << "  --worker-fd FD     Serve a coordinator on an inherited socket instead\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    TileDistributor::Config config;
+    DistributedFrame frame;
+    std::string name;
+    std::string output;
+    int frames = 1;
+    int samples = 0;
+    double scale = 1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--worker-fd" && has_value) {
+            return run_tile_worker(std::atoi(argv[++i]));
+        } else if (arg == "--workers" && has_value) {
+            config.workers = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--frames" && has_value) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--samples" && has_value) {
+            samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--scale" && has_value) {
+            scale = std::atof(argv[++i]);
+        } else if (arg == "--tile-size" && has_value) {
+            frame.tile_size = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] != '-' && name.empty()) {
+            name = arg;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<CPUBenchmarkSuite::Scenario> scenarios = CPUBenchmarkSuite::standardScenarios();
+    auto scenario = std::find_if(scenarios.begin(), scenarios.end(),
+                                 [&](const CPUBenchmarkSuite::Scenario& s) { return s.name == name; });
+    if (scenario == scenarios.end() || scale <= 0.0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    logger_set_level(LogLevel::WARN);
+
+    auto scene = std::make_shared<SceneManager>();
+    scene->initialize();
+    if (scenario->buildScene) {
+        scenario->buildScene(*scene);
+    }
+    frame.width = std::max(1, static_cast<int>(std::lround(scenario->width * scale)));
+    frame.height = std::max(1, static_cast<int>(std::lround(scenario->height * scale)));
+    frame.samples_per_pixel = samples > 0 ? samples : scenario->samplesPerPixel;
+    frame.max_depth = scenario->maxDepth;
+    frame.seed = scenario->seed;
+    Camera camera = *scene->get_camera();
+    frame.camera_position = camera.get_position();
+    frame.camera_target = camera.get_target();
+    frame.camera_up = camera.get_up();
+    frame.camera_fov = camera.get_fov();
+    frame.camera_aspect = float(frame.width) / float(frame.height);
+
+    TileDistributor distributor(config);
+    if (!distributor.start(*scene)) {
+        std::cerr << "Could not start worker processes" << std::endl;
+        return 1;
+    }
+
+    std::vector<Color> image;
+    for (int f = 0; f < frames; ++f) {
+        if (!distributor.render(frame, image)) {
+            std::cerr << "Frame " << f << " failed" << std::endl;
+            return 1;
+        }
+        const DistributionStats& stats = distributor.last_stats();
+        std::cout << "Frame " << f << ": " << frame.width << "x" << frame.height << " at " << frame.samples_per_pixel
+                  << " spp, " << stats.tiles << " tiles on " << distributor.worker_count() << " workers in "
+                  << stats.seconds * 1000.0 << " ms (" << stats.speculative_tiles << " speculative, "
+                  << stats.requeued_tiles << " requeued, " << stats.worker_restarts << " restarts)" << std::endl;
+    }
+    distributor.stop();
+
+    if (!output.empty()) {
+        std::vector<float> rgb;
+        rgb.reserve(image.size() * 3);
+        for (const Color& pixel : image) {
+            rgb.push_back(pixel.r);
+            rgb.push_back(pixel.g);
+            rgb.push_back(pixel.b);
+        }
+        if (!ImageOutput::write_pfm(output, frame.width, frame.height, rgb)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "performance/intersection_benchmark.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --output FILE      Also write JSON results (- for stdout)\n"
+              << "  --rays N           Rays per batch (default 4096)\n"
+              << "  --repetitions N    Timed repetitions per batch (default 15)\n"
+              << "  --min-time MS      Minimum duration of one repetition (default 2)\n"
+              << "  --scenes A,B,...   Scene sizes for hit_scene (default 8,64,512)\n"
+              << "  --seed N           Ray and scene seed (default 42)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    IntersectionBenchmark benchmark;
+    IntersectionBenchmark::Configuration config;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--rays" && has_value) {
+            config.raysPerBatch = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--repetitions" && has_value) {
+            config.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--min-time" && has_value) {
+            config.minRepetitionMs = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--seed" && has_value) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--scenes" && has_value) {
+            config.sceneSizes.clear();
+            std::stringstream sizes(argv[++i]);
+            std::string size;
+            while (std::getline(sizes, size, ',')) {
+                if (std::atoi(size.c_str()) > 0) {
+                    config.sceneSizes.push_back(std::atoi(size.c_str()));
+                }
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    benchmark.setConfiguration(config);
+    std::vector<IntersectionBenchmark::Result> results = benchmark.runAll();
+    benchmark.printReport(std::cout, results);
+
+    if (output == "-") {
+        benchmark.writeJSON(std::cout, results);
+    } else if (!output.empty()) {
+        return benchmark.writeJSON(output, results) ? 0 : 1;
+    }
+    return 0;
+}
@@ -2,11 +2,20 @@
 #include "ui/ui_manager.h"
 #include "ui/ui_input.h"
 #include "render/render_engine.h"
+#include "render/path_tracer.h"
+#include "render/metrics_exporter.h"
+#include "render/shared_framebuffer.h"
+#include "render/render_cache.h"
 #include "render/image_output.h"
 #include "core/scene_manager.h"
+#include "core/profiler.h"
+#include "core/logger.h"
+#include "core/resource_monitor.h"
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <chrono>
+#include <cstdlib>
 #include <thread>
 
 #ifdef USE_SDL
@@ -29,6 +38,31 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     std::cout << "Using GLFW for windowing" << std::endl;
 #endif
 
+    // PATHTRACER_PROFILE=<file.json> captures the whole session as a Chrome trace
+    const char* profile_path = std::getenv("PATHTRACER_PROFILE");
+    PROFILE_THREAD_NAME("UI");
+    if (profile_path) {
+        profiler_set_enabled(true);
+    }
+    
+    // PATHTRACER_LOG takes a filter such as "warn" or "info,gpu=debug";
+    // PATHTRACER_LOG_FILE and PATHTRACER_LOG_FORMAT=json redirect the output
+    if (const char* log_spec = std::getenv("PATHTRACER_LOG")) {
+        if (!logger_configure(log_spec)) {
+            std::cerr << "Ignoring invalid PATHTRACER_LOG filter: " << log_spec << std::endl;
+        }
+    }
+    if (const char* log_format = std::getenv("PATHTRACER_LOG_FORMAT")) {
+        logger_set_format(std::string(log_format) == "json" ? LogFormat::JSON : LogFormat::TEXT);
+    }
+    if (const char* log_file = std::getenv("PATHTRACER_LOG_FILE")) {
+        logger_set_output_file(log_file);
+    }
+    
+    // Background sampling of CPU time and memory behind RenderMetrics
+    resource_monitor_start();
+    ResourceThreadScope main_thread_resources("main");
+    
     try {
         auto render_engine = std::make_shared<RenderEngine>();
         auto ui_manager = std::make_shared<UIManager>();
@@ -40,6 +74,72 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
         render_engine->set_scene_manager(scene_manager);
         render_engine->set_image_output(image_output);
         
+        // PATHTRACER_METRICS=9464 or unix:/path serves Prometheus metrics for scraping
+        std::shared_ptr<MetricsExporter> metrics_exporter;
+        if (const char* metrics_spec = std::getenv("PATHTRACER_METRICS")) {
+            MetricsExporter::Config metrics_config;
+            if (!MetricsExporter::parse_endpoint(metrics_spec, metrics_config)) {
+                std::cerr << "Ignoring invalid PATHTRACER_METRICS endpoint: " << metrics_spec << std::endl;
+            } else {
+                metrics_exporter = std::make_shared<MetricsExporter>();
+                if (metrics_exporter->start(metrics_config)) {
+                    render_engine->set_metrics_exporter(metrics_exporter);
+                }
+            }
+        }
+        
+        // PATHTRACER_SHM=/name publishes displayed frames to POSIX shared memory
+        std::shared_ptr<SharedFramebuffer> shared_framebuffer;
+        if (const char* shm_name = std::getenv("PATHTRACER_SHM")) {
+            SharedFramebuffer::Config shm_config;
+            shm_config.name = shm_name;
+            shared_framebuffer = std::make_shared<SharedFramebuffer>();
+            if (shared_framebuffer->create(shm_config)) {
+                render_engine->set_shared_framebuffer(shared_framebuffer);
+            }
+        }
+        
+        // PATHTRACER_CHECKPOINT names a file that CPU progressive renders are
+        // checkpointed to every PATHTRACER_CHECKPOINT_MINUTES (default 5)
+        const char* checkpoint_file = std::getenv("PATHTRACER_CHECKPOINT");
+        if (checkpoint_file) {
+            long minutes = 5;
+            if (const char* checkpoint_minutes = std::getenv("PATHTRACER_CHECKPOINT_MINUTES")) {
+                minutes = std::max(1L, std::atol(checkpoint_minutes));
+            }
+            render_engine->set_checkpointing(checkpoint_file, std::chrono::minutes(minutes));
+        }
+        
+        // PATHTRACER_CACHE names a directory of finished progressive renders,
+        // bounded by PATHTRACER_CACHE_MB (default 1024)
+        if (const char* cache_directory = std::getenv("PATHTRACER_CACHE")) {
+            RenderCache::Config cache_config;
+            cache_config.directory = cache_directory;
+            if (const char* cache_mb = std::getenv("PATHTRACER_CACHE_MB")) {
+                cache_config.max_bytes = static_cast<uint64_t>(std::max(1L, std::atol(cache_mb))) << 20;
+            }
+            auto render_cache = std::make_shared<RenderCache>(cache_config);
+            if (render_cache->open()) {
+                render_engine->set_render_cache(render_cache);
+            }
+        }
+        
+        // PATHTRACER_EDIT_INVALIDATION=primary, padded[:tiles] or full lets scene
+        // edits during a progressive render reset only the tiles they reach
+        if (const char* invalidation = std::getenv("PATHTRACER_EDIT_INVALIDATION")) {
+            const std::string mode = invalidation;
+            if (mode == "primary") {
+                render_engine->set_edit_invalidation(EditInvalidation::PRIMARY);
+            } else if (mode.compare(0, 6, "padded") == 0) {
+                int rings = mode.size() > 7 && mode[6] == ':' ? std::atoi(mode.c_str() + 7) : 1;
+                render_engine->set_edit_invalidation(EditInvalidation::PADDED, rings);
+            } else if (mode == "full") {
+                render_engine->set_edit_invalidation(EditInvalidation::FULL_FRAME);
+            } else {
+                std::cerr << "Ignoring invalid PATHTRACER_EDIT_INVALIDATION mode: " << invalidation << std::endl;
+            }
+        }
+        
         // Connect UI to render engine, scene manager, and image output
         ui_manager->set_scene_manager(scene_manager);
         ui_manager->set_render_engine(render_engine);
@@ -111,6 +211,12 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
             render_engine->set_samples_per_pixel(original_samples);  // Restore settings
         }
         
+        // Pick up an interrupted progressive render; the checkpoint brings its own schedule
+        if (checkpoint_file && render_engine->restore_render_state()) {
+            std::cout << "Resuming progressive render from " << checkpoint_file << std::endl;
+            render_engine->start_progressive_render(ProgressiveConfig());
+        }
+        
         std::cout << "Application ready - press G for full quality render!" << std::endl;
         
         std::cout << "SDL window opened! Use WASD+RF keys to move camera." << std::endl;
@@ -131,7 +237,11 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
             std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS
         }
         
+        logger_flush();
         std::cout << "Application shutting down..." << std::endl;
+        if (profile_path) {
+            profiler_export_chrome_trace(profile_path);
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
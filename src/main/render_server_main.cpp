@@ -0,0 +1,185 @@
+#include "performance/cpu_benchmark.h"
+#include "render/render_server.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> interrupted{false};
+
+void handle_signal(int) {
+    interrupted = true;
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] --socket PATH\n"
+              << "       " << program << " --socket PATH --submit SCENARIO [--output FILE.ppm]\n"
+              << "\n"
+              << "Serves render jobs on a Unix socket until interrupted, or submits a\n"
+              << "CPU benchmark scenario to a running server and follows its progress.\n"
+              << "  --threads N        Tile threads of the shared render pool (default: hardware concurrency)\n"
+              << "  --max-jobs N       Jobs queued across all clients (default 16)\n"
+              << "  --scene SCENARIO   Default scene for jobs that bring none (default: the standard scene)\n"
+              << "  --submit SCENARIO  Client mode\n"
+              << "  --samples N        Client: samples per pixel (default: the scenario's)\n"
+              << "  --priority N       Client: job priority (default 0)\n"
+              << "  --output FILE      Client: final image as binary PPM\n";
+}
+
+const CPUBenchmarkSuite::Scenario* find_scenario(const std::vector<CPUBenchmarkSuite::Scenario>& scenarios,
+                                                 const std::string& name) {
+    auto it = std::find_if(scenarios.begin(), scenarios.end(),
+                           [&](const CPUBenchmarkSuite::Scenario& s) { return s.name == name; });
+    return it != scenarios.end() ? &*it : nullptr;
+}
+
+void build_scene(const CPUBenchmarkSuite::Scenario& scenario, SceneManager& scene) {
+    scene.initialize();
+    if (scenario.buildScene) {
+        scenario.buildScene(scene);
+    }
+}
+
+int run_client(const std::string& socket_path, const CPUBenchmarkSuite::Scenario& scenario, int samples,
+               int priority, const std::string& output) {
+    SceneManager scene;
+    build_scene(scenario, scene);
+    Camera camera = *scene.get_camera();
+    RenderJobRequest request;
+    request.priority = priority;
+    request.width = scenario.width;
+    request.height = scenario.height;
+    request.samples_per_pixel = samples > 0 ? samples : scenario.samplesPerPixel;
+    request.max_depth = scenario.maxDepth;
+    request.seed = scenario.seed;
+    request.camera_position = camera.get_position();
+    request.camera_target = camera.get_target();
+    request.camera_up = camera.get_up();
+    request.camera_fov = camera.get_fov();
+
+    RenderClient client;
+    if (!client.connect(socket_path)) {
+        return 1;
+    }
+    std::string error;
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t job = client.submit(request, &scene, &error);
+    if (job == 0) {
+        std::cerr << "Job rejected: " << error << std::endl;
+        return 1;
+    }
+    RenderClient::Update update;
+    while (client.next_update(update)) {
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (update.done) {
+            std::cout << "Job " << job << " finished with status " << static_cast<uint32_t>(update.status) << " after "
+                      << update.samples << " samples in " << ms << " ms" << std::endl;
+            break;
+        }
+        std::cout << "Job " << job << ": " << update.samples << "/" << update.target_samples << " samples, "
+                  << update.tiles.size() << " tiles changed at " << ms << " ms" << std::endl;
+    }
+    if (!update.done || update.status != RenderJobStatus::COMPLETED) {
+        return 1;
+    }
+
+    if (!output.empty()) {
+        std::ofstream file(output, std::ios::binary);
+        file << "P6\n" << request.width << " " << request.height << "\n255\n";
+        const std::vector<uint8_t>& image = client.image(job);
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!file) {
+            std::cerr << "Cannot write " << output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    RenderServer::Config config;
+    std::string scene_name;
+    std::string submit;
+    std::string output;
+    int samples = 0;
+    int priority = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--socket" && has_value) {
+            config.socket_path = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            config.render_threads = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--max-jobs" && has_value) {
+            config.max_jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--scene" && has_value) {
+            scene_name = argv[++i];
+        } else if (arg == "--submit" && has_value) {
+            submit = argv[++i];
+        } else if (arg == "--samples" && has_value) {
+            samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--priority" && has_value) {
+            priority = std::atoi(argv[++i]);
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.socket_path.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<CPUBenchmarkSuite::Scenario> scenarios = CPUBenchmarkSuite::standardScenarios();
+    if (!submit.empty()) {
+        const CPUBenchmarkSuite::Scenario* scenario = find_scenario(scenarios, submit);
+        if (!scenario) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        logger_set_level(LogLevel::WARN);
+        return run_client(config.socket_path, *scenario, samples, priority, output);
+    }
+
+    RenderServer server(config);
+    if (!scene_name.empty()) {
+        const CPUBenchmarkSuite::Scenario* scenario = find_scenario(scenarios, scene_name);
+        if (!scenario) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        SceneManager scene;
+        build_scene(*scenario, scene);
+        server.set_default_scene(scene);
+    }
+    if (!server.start()) {
+        return 1;
+    }
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    while (!interrupted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    server.stop();
+    std::cout << server.completed_jobs() << " jobs completed" << std::endl;
+    return 0;
+}
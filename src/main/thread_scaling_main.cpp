@@ -0,0 +1,106 @@
+#include "performance/thread_scaling.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] [scenario...]\n"
+              << "  --threads LIST     Comma-separated thread counts (default: 1, 2, 4, ... up to --max-threads)\n"
+              << "  --max-threads N    Largest thread count (default: hardware concurrency)\n"
+              << "  --mode M           strong, weak or both (default both)\n"
+              << "  --iterations N     Timed renders per point (default 3)\n"
+              << "  --warmup N         Untimed renders per point (default 1)\n"
+              << "  --scale F          Resolution scale of the base image (default 1.0)\n"
+              << "  --csv FILE         Write one row per point for plotting\n"
+              << "  --output FILE      JSON results with per-thread breakdown (default thread_scaling.json)\n";
+}
+
+std::vector<int> parse_thread_list(const std::string& text) {
+    std::vector<int> counts;
+    std::istringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int count = std::atoi(item.c_str());
+        if (count > 0) {
+            counts.push_back(count);
+        }
+    }
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ThreadScalingBenchmark benchmark;
+    ThreadScalingBenchmark::Configuration config;
+    std::vector<std::string> scenarios;
+    std::string output = "thread_scaling.json";
+    std::string csv;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            config.threadCounts = parse_thread_list(argv[++i]);
+        } else if (arg == "--max-threads" && has_value) {
+            config.maxThreads = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--mode" && has_value) {
+            std::string mode = argv[++i];
+            config.strongScaling = mode == "strong" || mode == "both";
+            config.weakScaling = mode == "weak" || mode == "both";
+            if (!config.strongScaling && !config.weakScaling) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--iterations" && has_value) {
+            config.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && has_value) {
+            config.warmupIterations = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--scale" && has_value) {
+            config.resolutionScale = std::atof(argv[++i]);
+        } else if (arg == "--csv" && has_value) {
+            csv = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] != '-') {
+            scenarios.push_back(arg);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.resolutionScale <= 0.0) {
+        std::cerr << "Resolution scale must be positive" << std::endl;
+        return 1;
+    }
+    // Weak scaling multiplies the pixel count, so default to a cheap scene and a heavy one
+    if (scenarios.empty()) {
+        scenarios = {"simple", "many_primitives"};
+    }
+
+    logger_set_level(LogLevel::WARN);
+
+    benchmark.setConfiguration(config);
+    std::vector<ThreadScalingBenchmark::Point> points = benchmark.runScenarios(scenarios);
+    if (points.empty()) {
+        std::cerr << "No matching scenarios" << std::endl;
+        return 1;
+    }
+
+    benchmark.printReport(std::cout, points);
+    bool ok = benchmark.writeFile(output, points, false);
+    if (!csv.empty()) {
+        ok = benchmark.writeFile(csv, points, true) && ok;
+    }
+    return ok ? 0 : 1;
+}
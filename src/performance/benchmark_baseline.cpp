@@ -0,0 +1,364 @@
+#include "performance/benchmark_baseline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+const char* BASELINE_HEADER = "# pathtracer benchmark baseline v1";
+
+// Continued fraction for the incomplete beta function (Lentz's method)
+double beta_continued_fraction(double a, double b, double x) {
+    const int MAX_ITERATIONS = 200;
+    const double EPSILON = 1e-12;
+    const double TINY = 1e-300;
+
+    double qab = a + b;
+    double qap = a + 1.0;
+    double qam = a - 1.0;
+    double c = 1.0;
+    double d = 1.0 - qab * x / qap;
+    if (std::fabs(d) < TINY) d = TINY;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= MAX_ITERATIONS; ++m) {
+        int m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < TINY) d = TINY;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < TINY) c = TINY;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < TINY) d = TINY;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < TINY) c = TINY;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < EPSILON) {
+            break;
+        }
+    }
+    return h;
+}
+
+// Regularized incomplete beta function I_x(a, b)
+double incomplete_beta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                            a * std::log(x) + b * std::log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        return front * beta_continued_fraction(a, b, x) / a;
+    }
+    return 1.0 - front * beta_continued_fraction(b, a, 1.0 - x) / b;
+}
+
+// t with P(T > t) = tail, by bisection
+double student_t_quantile(double tail, double degrees_of_freedom) {
+    double low = 0.0;
+    double high = 1000.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = 0.5 * (low + high);
+        if (studentTUpperTail(mid, degrees_of_freedom) > tail) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return 0.5 * (low + high);
+}
+
+std::string read_cpu_model() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                size_t start = line.find_first_not_of(' ', colon + 1);
+                return start == std::string::npos ? "" : line.substr(start);
+            }
+        }
+    }
+    return "unknown";
+}
+
+std::string build_config() {
+    std::string config;
+#ifdef NDEBUG
+    config += "release";
+#else
+    config += "debug";
+#endif
+#ifdef __OPTIMIZE__
+    config += ",optimized";
+#endif
+#ifdef USE_GPU
+    config += ",gpu";
+#endif
+#ifdef ENABLE_PROFILING
+    config += ",profiling";
+#endif
+#ifdef ENABLE_DEBUG_LOGS
+    config += ",debug_logs";
+#endif
+    return config;
+}
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 1469598103934665603ull;
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+double studentTUpperTail(double t, double degreesOfFreedom) {
+    if (!(degreesOfFreedom > 0.0)) {
+        return t > 0.0 ? 0.0 : 1.0;
+    }
+    double tail = 0.5 * incomplete_beta(0.5 * degreesOfFreedom, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t));
+    return t >= 0.0 ? tail : 1.0 - tail;
+}
+
+SampleStats computeSampleStats(const std::vector<double>& samples, double confidence) {
+    SampleStats stats;
+    stats.count = static_cast<int>(samples.size());
+    if (samples.empty()) {
+        return stats;
+    }
+
+    double sum = 0.0;
+    for (double value : samples) {
+        sum += value;
+    }
+    stats.mean = sum / samples.size();
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    size_t mid = sorted.size() / 2;
+    stats.median = sorted.size() % 2 ? sorted[mid] : 0.5 * (sorted[mid - 1] + sorted[mid]);
+
+    if (samples.size() > 1) {
+        double squares = 0.0;
+        for (double value : samples) {
+            squares += (value - stats.mean) * (value - stats.mean);
+        }
+        stats.stddev = std::sqrt(squares / (samples.size() - 1));
+        double t = student_t_quantile(0.5 * (1.0 - confidence), samples.size() - 1.0);
+        double half_width = t * stats.stddev / std::sqrt(static_cast<double>(samples.size()));
+        stats.ciLow = stats.mean - half_width;
+        stats.ciHigh = stats.mean + half_width;
+    } else {
+        stats.ciLow = stats.ciHigh = stats.mean;
+    }
+    return stats;
+}
+
+RegressionCheck compareSamples(const std::string& name, const std::vector<double>& baseline,
+                               const std::vector<double>& current, double alpha, double minRelativeChange) {
+    RegressionCheck check;
+    check.name = name;
+    check.baseline = computeSampleStats(baseline);
+    check.current = computeSampleStats(current);
+    if (check.baseline.count == 0 || check.current.count == 0 || check.baseline.mean == 0.0) {
+        return check;
+    }
+    check.relativeChange = (check.current.mean - check.baseline.mean) / check.baseline.mean;
+
+    // Welch's t-test: unequal variances, Welch-Satterthwaite degrees of freedom
+    double vb = check.baseline.stddev * check.baseline.stddev / check.baseline.count;
+    double vc = check.current.stddev * check.current.stddev / check.current.count;
+    double diff = check.current.mean - check.baseline.mean;
+    double p_slower;
+    double p_faster;
+    if (vb + vc <= 0.0) {
+        p_slower = diff > 0.0 ? 0.0 : 1.0;
+        p_faster = diff < 0.0 ? 0.0 : 1.0;
+    } else {
+        double t = diff / std::sqrt(vb + vc);
+        double df_denominator = 0.0;
+        if (check.baseline.count > 1) df_denominator += vb * vb / (check.baseline.count - 1);
+        if (check.current.count > 1) df_denominator += vc * vc / (check.current.count - 1);
+        double df = df_denominator > 0.0 ? (vb + vc) * (vb + vc) / df_denominator : 1.0;
+        p_slower = studentTUpperTail(t, df);
+        p_faster = studentTUpperTail(-t, df);
+    }
+
+    check.pValue = p_slower;
+    check.regression = p_slower < alpha && check.relativeChange > minRelativeChange;
+    check.improvement = p_faster < alpha && check.relativeChange < -minRelativeChange;
+    return check;
+}
+
+std::string MachineFingerprint::description() const {
+    std::ostringstream out;
+    out << cpuModel << ", " << logicalCores << " threads, " << compiler << ", " << buildConfig;
+    return out.str();
+}
+
+MachineFingerprint MachineFingerprint::current() {
+    MachineFingerprint fingerprint;
+    fingerprint.cpuModel = read_cpu_model();
+    fingerprint.logicalCores = static_cast<int>(std::thread::hardware_concurrency());
+#if defined(__clang__)
+    fingerprint.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    fingerprint.compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    fingerprint.compiler = "msvc " + std::to_string(_MSC_VER);
+#else
+    fingerprint.compiler = "unknown";
+#endif
+    fingerprint.buildConfig = build_config();
+
+    std::ostringstream key;
+    key << std::hex << std::setw(12) << std::setfill('0')
+        << (fnv1a(fingerprint.description()) & 0xFFFFFFFFFFFFull);
+    fingerprint.key = key.str();
+    return fingerprint;
+}
+
+std::string BenchmarkBaseline::defaultPath(const std::string& directory, const std::string& suite,
+                                           const MachineFingerprint& fingerprint) {
+    std::string path = directory;
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    return path + suite + "-" + fingerprint.key + ".baseline";
+}
+
+bool BenchmarkBaseline::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    std::string timestamp = created;
+    if (timestamp.empty()) {
+        std::time_t now = std::time(nullptr);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        timestamp = buffer;
+    }
+
+    file << BASELINE_HEADER << "\n";
+    file << "suite " << suite << "\n";
+    file << "fingerprint " << fingerprint.key << "\n";
+    file << "cpu " << fingerprint.cpuModel << "\n";
+    file << "cores " << fingerprint.logicalCores << "\n";
+    file << "compiler " << fingerprint.compiler << "\n";
+    file << "build " << fingerprint.buildConfig << "\n";
+    file << "created " << timestamp << "\n";
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& metric : samples) {
+        file << "metric " << metric.first;
+        for (double value : metric.second) {
+            file << " " << value;
+        }
+        file << "\n";
+    }
+
+    if (file.fail()) {
+        std::cerr << "Error writing to file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool BenchmarkBaseline::load(const std::string& filename, BenchmarkBaseline& baseline) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != BASELINE_HEADER) {
+        std::cerr << "Not a benchmark baseline: " << filename << std::endl;
+        return false;
+    }
+
+    BenchmarkBaseline loaded;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == "suite") {
+            fields >> loaded.suite;
+        } else if (tag == "fingerprint") {
+            fields >> loaded.fingerprint.key;
+        } else if (tag == "cpu") {
+            std::getline(fields >> std::ws, loaded.fingerprint.cpuModel);
+        } else if (tag == "cores") {
+            fields >> loaded.fingerprint.logicalCores;
+        } else if (tag == "compiler") {
+            std::getline(fields >> std::ws, loaded.fingerprint.compiler);
+        } else if (tag == "build") {
+            fields >> loaded.fingerprint.buildConfig;
+        } else if (tag == "created") {
+            fields >> loaded.created;
+        } else if (tag == "metric") {
+            std::string name;
+            fields >> name;
+            std::vector<double>& values = loaded.samples[name];
+            double value;
+            while (fields >> value) {
+                values.push_back(value);
+            }
+        }
+    }
+    baseline = loaded;
+    return true;
+}
+
+std::vector<RegressionCheck> BenchmarkBaseline::compare(const std::map<std::string, std::vector<double>>& current,
+                                                         double alpha, double minRelativeChange) const {
+    std::vector<RegressionCheck> checks;
+    for (const auto& metric : current) {
+        auto it = samples.find(metric.first);
+        if (it == samples.end() || it->second.empty() || metric.second.empty()) {
+            continue;
+        }
+        checks.push_back(compareSamples(metric.first, it->second, metric.second, alpha, minRelativeChange));
+    }
+    return checks;
+}
+
+void printRegressionReport(std::ostream& out, const std::vector<RegressionCheck>& checks) {
+    out << "\n=== Baseline Comparison ===" << std::endl;
+    out << std::left << std::setw(30) << "Metric"
+        << std::right << std::setw(22) << "Baseline (95% CI)"
+        << std::setw(22) << "Current (95% CI)"
+        << std::setw(9) << "Change"
+        << std::setw(10) << "p" << "  Verdict" << std::endl;
+    for (const auto& check : checks) {
+        auto interval = [](const SampleStats& stats) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(2) << stats.mean
+                 << " +/-" << (stats.ciHigh - stats.mean);
+            return text.str();
+        };
+        const char* verdict = check.regression ? "REGRESSION" : (check.improvement ? "improved" : "ok");
+        out << std::left << std::setw(30) << check.name
+            << std::right << std::setw(22) << interval(check.baseline)
+            << std::setw(22) << interval(check.current)
+            << std::setw(8) << std::fixed << std::setprecision(1) << check.relativeChange * 100.0 << "%"
+            << std::setw(10) << std::setprecision(4) << check.pValue
+            << "  " << verdict << std::endl;
+    }
+}
@@ -0,0 +1,463 @@
+#include "performance/convergence_benchmark.h"
+#include "render/path_tracer.h"
+#include "render/image_output.h"
+#include "render/tile_scheduler.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace {
+
+const float REL_MSE_EPSILON = 0.01f;
+const int SSIM_WINDOW = 8;
+const int SSIM_STRIDE = 4;
+const double SSIM_C1 = 0.01 * 0.01;
+const double SSIM_C2 = 0.03 * 0.03;
+
+// Tonemapped output is gamma 2.0, so squaring recovers linear radiance
+std::vector<float> linear_rgb(const std::vector<Color>& image) {
+    std::vector<float> rgb(image.size() * 3);
+    for (size_t i = 0; i < image.size(); ++i) {
+        rgb[i * 3 + 0] = image[i].r * image[i].r;
+        rgb[i * 3 + 1] = image[i].g * image[i].g;
+        rgb[i * 3 + 2] = image[i].b * image[i].b;
+    }
+    return rgb;
+}
+
+std::vector<float> display_luminance(const std::vector<Color>& image) {
+    std::vector<float> luminance(image.size());
+    for (size_t i = 0; i < image.size(); ++i) {
+        float y = 0.2126f * image[i].r + 0.7152f * image[i].g + 0.0722f * image[i].b;
+        luminance[i] = std::min(1.0f, std::max(0.0f, y));
+    }
+    return luminance;
+}
+
+// Eight independent accumulators let the compiler keep the loop in vector
+// registers without having to reassociate float additions
+void accumulate_error(const float* image, const float* reference, int count, double& squared, double& relative) {
+    float sq[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    float rel[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        for (int lane = 0; lane < 8; ++lane) {
+            float d = image[i + lane] - reference[i + lane];
+            float r = reference[i + lane];
+            sq[lane] += d * d;
+            rel[lane] += d * d / (r * r + REL_MSE_EPSILON);
+        }
+    }
+    for (; i < count; ++i) {
+        float d = image[i] - reference[i];
+        sq[0] += d * d;
+        rel[0] += d * d / (reference[i] * reference[i] + REL_MSE_EPSILON);
+    }
+    for (int lane = 0; lane < 8; ++lane) {
+        squared += sq[lane];
+        relative += rel[lane];
+    }
+}
+
+double window_ssim(const float* a, const float* b, int stride) {
+    float sum_a = 0, sum_b = 0, sum_aa = 0, sum_bb = 0, sum_ab = 0;
+    for (int y = 0; y < SSIM_WINDOW; ++y) {
+        const float* row_a = a + y * stride;
+        const float* row_b = b + y * stride;
+        for (int x = 0; x < SSIM_WINDOW; ++x) {
+            sum_a += row_a[x];
+            sum_b += row_b[x];
+            sum_aa += row_a[x] * row_a[x];
+            sum_bb += row_b[x] * row_b[x];
+            sum_ab += row_a[x] * row_b[x];
+        }
+    }
+    const double n = SSIM_WINDOW * SSIM_WINDOW;
+    double mean_a = sum_a / n;
+    double mean_b = sum_b / n;
+    double var_a = std::max(0.0, sum_aa / n - mean_a * mean_a);
+    double var_b = std::max(0.0, sum_bb / n - mean_b * mean_b);
+    double cov = sum_ab / n - mean_a * mean_b;
+    return ((2.0 * mean_a * mean_b + SSIM_C1) * (2.0 * cov + SSIM_C2)) /
+           ((mean_a * mean_a + mean_b * mean_b + SSIM_C1) * (var_a + var_b + SSIM_C2));
+}
+
+struct TileError {
+    double squared = 0.0;
+    double relative = 0.0;
+    double ssim = 0.0;
+    int windows = 0;
+};
+
+} // namespace
+
+double ConvergenceBenchmark::ImageError::value(ErrorMetric metric) const {
+    switch (metric) {
+        case ErrorMetric::RMSE: return rmse;
+        case ErrorMetric::REL_MSE: return relMSE;
+        case ErrorMetric::DSSIM: return 1.0 - ssim;
+    }
+    return rmse;
+}
+
+double ConvergenceBenchmark::Curve::timeToError(double target, ErrorMetric metric) const {
+    for (size_t i = 0; i < points.size(); ++i) {
+        double error = points[i].error.value(metric);
+        if (error > target) {
+            continue;
+        }
+        if (i == 0) {
+            return points[0].seconds;
+        }
+
+        // Error falls roughly as a power of time, so interpolate in log-log space
+        const CurvePoint& before = points[i - 1];
+        const CurvePoint& after = points[i];
+        double e0 = before.error.value(metric);
+        double e1 = error;
+        if (e0 <= 0.0 || e1 <= 0.0 || before.seconds <= 0.0 || e0 == e1) {
+            return after.seconds;
+        }
+        double f = (std::log(target) - std::log(e0)) / (std::log(e1) - std::log(e0));
+        return std::exp(std::log(before.seconds) + f * (std::log(after.seconds) - std::log(before.seconds)));
+    }
+    return -1.0;
+}
+
+const char* ConvergenceBenchmark::techniqueName(Technique technique) {
+    switch (technique) {
+        case Technique::PATH: return "path";
+        case Technique::PATH_DENOISED: return "path_denoised";
+        case Technique::PROGRESSIVE: return "progressive";
+        case Technique::PREVIEW: return "preview";
+        case Technique::PREVIEW_NO_CACHE: return "preview_no_cache";
+    }
+    return "unknown";
+}
+
+const char* ConvergenceBenchmark::metricName(ErrorMetric metric) {
+    switch (metric) {
+        case ErrorMetric::RMSE: return "rmse";
+        case ErrorMetric::REL_MSE: return "relmse";
+        case ErrorMetric::DSSIM: return "dssim";
+    }
+    return "unknown";
+}
+
+ConvergenceBenchmark::ImageError ConvergenceBenchmark::measureError(const std::vector<Color>& image,
+                                                                    const std::vector<Color>& reference,
+                                                                    int width, int height, int threadCount) {
+    ImageError error;
+    const size_t pixels = static_cast<size_t>(width) * height;
+    if (width <= 0 || height <= 0 || image.size() != pixels || reference.size() != pixels) {
+        error.rmse = error.relMSE = std::numeric_limits<double>::infinity();
+        error.ssim = 0.0;
+        return error;
+    }
+
+    const std::vector<float> image_rgb = linear_rgb(image);
+    const std::vector<float> reference_rgb = linear_rgb(reference);
+    const std::vector<float> image_y = display_luminance(image);
+    const std::vector<float> reference_y = display_luminance(reference);
+
+    // Tile sizes are a multiple of the SSIM stride, so every window starts in exactly one tile
+    TileScheduler scheduler(threadCount, TileScheduler::DEFAULT_TILE_SIZE);
+    std::vector<TileError> tiles(scheduler.make_tiles(width, height).size());
+    scheduler.run(width, height, [&](const RenderTile& tile, int) {
+        // Accumulated locally; neighbouring tiles' partials share cache lines
+        TileError partial;
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            size_t offset = (static_cast<size_t>(y) * width + tile.x0) * 3;
+            accumulate_error(image_rgb.data() + offset, reference_rgb.data() + offset,
+                             tile.width() * 3, partial.squared, partial.relative);
+        }
+
+        int first_y = (tile.y0 + SSIM_STRIDE - 1) / SSIM_STRIDE * SSIM_STRIDE;
+        int first_x = (tile.x0 + SSIM_STRIDE - 1) / SSIM_STRIDE * SSIM_STRIDE;
+        for (int y = first_y; y < tile.y1 && y + SSIM_WINDOW <= height; y += SSIM_STRIDE) {
+            for (int x = first_x; x < tile.x1 && x + SSIM_WINDOW <= width; x += SSIM_STRIDE) {
+                size_t offset = static_cast<size_t>(y) * width + x;
+                partial.ssim += window_ssim(image_y.data() + offset, reference_y.data() + offset, width);
+                ++partial.windows;
+            }
+        }
+        tiles[tile.index] = partial;
+    });
+
+    // Summed in tile order so the result does not depend on the thread count
+    TileError total;
+    for (const auto& tile : tiles) {
+        total.squared += tile.squared;
+        total.relative += tile.relative;
+        total.ssim += tile.ssim;
+        total.windows += tile.windows;
+    }
+    const double samples = static_cast<double>(pixels) * 3.0;
+    error.rmse = std::sqrt(total.squared / samples);
+    error.relMSE = total.relative / samples;
+    error.ssim = total.windows > 0 ? total.ssim / total.windows : 1.0;
+    return error;
+}
+
+std::string ConvergenceBenchmark::referencePath(const CPUBenchmarkSuite::Scenario& scenario, int width, int height) const {
+    std::ostringstream path;
+    path << config_.referenceDir;
+    if (!config_.referenceDir.empty() && config_.referenceDir.back() != '/') {
+        path << '/';
+    }
+    path << scenario.name << "_" << width << "x" << height << "_d" << scenario.maxDepth
+         << "_" << config_.referenceSamples << "spp.pfm";
+    return path.str();
+}
+
+namespace {
+
+std::unique_ptr<PathTracer> make_tracer(const CPUBenchmarkSuite::Scenario& scenario, int width, int height,
+                                        int threads, std::shared_ptr<SceneManager>& scene) {
+    scene = std::make_shared<SceneManager>();
+    scene->initialize();
+    if (scenario.buildScene) {
+        scenario.buildScene(*scene);
+    }
+    Camera camera = *scene->get_camera();
+    camera.set_aspect_ratio(float(width) / float(height));
+
+    auto path_tracer = std::make_unique<PathTracer>();
+    path_tracer->set_scene_manager(scene);
+    path_tracer->set_camera(camera);
+    path_tracer->set_max_depth(scenario.maxDepth);
+    path_tracer->set_thread_count(threads);
+    return path_tracer;
+}
+
+} // namespace
+
+std::vector<Color> ConvergenceBenchmark::reference(const CPUBenchmarkSuite::Scenario& scenario,
+                                                   int& width, int& height) const {
+    width = std::max(1, static_cast<int>(scenario.width * config_.resolutionScale));
+    height = std::max(1, static_cast<int>(scenario.height * config_.resolutionScale));
+    const std::string path = referencePath(scenario, width, height);
+
+    std::vector<Color> image;
+    int cached_width = 0;
+    int cached_height = 0;
+    std::vector<float> rgb;
+    if (!config_.refreshReferences && ImageOutput::read_pfm(path, cached_width, cached_height, rgb) &&
+        cached_width == width && cached_height == height) {
+        image.resize(static_cast<size_t>(width) * height);
+        for (size_t i = 0; i < image.size(); ++i) {
+            image[i] = Color(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+        return image;
+    }
+
+    std::cout << "Rendering " << config_.referenceSamples << " spp reference for " << scenario.name
+              << " (" << width << "x" << height << ")..." << std::endl;
+    std::shared_ptr<SceneManager> scene;
+    auto path_tracer = make_tracer(scenario, width, height, config_.threadCount, scene);
+    path_tracer->set_samples_per_pixel(config_.referenceSamples);
+    // Independent of every seed the measured renders use
+    path_tracer->set_random_seed(~scenario.seed);
+    path_tracer->trace(width, height);
+    image = path_tracer->get_image_data();
+
+    if (mkdir(config_.referenceDir.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "Could not create reference directory: " << config_.referenceDir << std::endl;
+        return image;
+    }
+    rgb.resize(image.size() * 3);
+    for (size_t i = 0; i < image.size(); ++i) {
+        rgb[i * 3] = image[i].r;
+        rgb[i * 3 + 1] = image[i].g;
+        rgb[i * 3 + 2] = image[i].b;
+    }
+    ImageOutput::write_pfm(path, width, height, rgb);
+    return image;
+}
+
+ConvergenceBenchmark::Curve ConvergenceBenchmark::runTechnique(const CPUBenchmarkSuite::Scenario& scenario,
+                                                               Technique technique,
+                                                               const std::vector<Color>& reference,
+                                                               int width, int height) const {
+    using Clock = std::chrono::steady_clock;
+    Curve curve;
+    curve.scenarioName = scenario.name;
+    curve.technique = techniqueName(technique);
+    curve.imageWidth = width;
+    curve.imageHeight = height;
+    const int max_samples = std::max(1, config_.maxSamples);
+
+    if (technique == Technique::PROGRESSIVE) {
+        std::shared_ptr<SceneManager> scene;
+        auto path_tracer = make_tracer(scenario, width, height, config_.threadCount, scene);
+        ProgressiveConfig progressive;
+        progressive.initialSamples = 1;
+        progressive.targetSamples = max_samples;
+        progressive.progressiveSteps = std::min(max_samples, 8);
+        progressive.updateInterval = 0.0f;
+
+        // Time spent measuring inside the callback is not render time
+        auto start = Clock::now();
+        double excluded = 0.0;
+        path_tracer->trace_progressive(width, height, progressive,
+            [&](const std::vector<Color>& image, int, int, int samples, int) {
+                auto callback_start = Clock::now();
+                CurvePoint point;
+                point.samplesPerPixel = samples;
+                point.seconds = std::chrono::duration<double>(callback_start - start).count() - excluded;
+                point.error = measureError(image, reference, width, height, config_.threadCount);
+                curve.points.push_back(point);
+                excluded += std::chrono::duration<double>(Clock::now() - callback_start).count();
+            });
+        return curve;
+    }
+
+    for (int samples = 1; samples <= max_samples; samples *= 2) {
+        // A fresh tracer per point so caches and temporal reuse start cold, as a user's first frame would
+        std::shared_ptr<SceneManager> scene;
+        auto path_tracer = make_tracer(scenario, width, height, config_.threadCount, scene);
+        path_tracer->set_samples_per_pixel(samples);
+        path_tracer->set_random_seed(scenario.seed);
+        path_tracer->set_denoising(technique == Technique::PATH_DENOISED);
+        path_tracer->set_irradiance_cache(technique == Technique::PREVIEW);
+
+        auto start = Clock::now();
+        if (technique == Technique::PREVIEW || technique == Technique::PREVIEW_NO_CACHE) {
+            path_tracer->trace_preview(width, height);
+        } else {
+            path_tracer->trace(width, height);
+        }
+
+        CurvePoint point;
+        point.samplesPerPixel = samples;
+        point.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        point.error = measureError(path_tracer->get_image_data(), reference, width, height, config_.threadCount);
+        curve.points.push_back(point);
+    }
+    return curve;
+}
+
+std::vector<ConvergenceBenchmark::Curve> ConvergenceBenchmark::runScenarios(const std::vector<std::string>& names) const {
+    std::vector<Curve> curves;
+    for (const auto& scenario : CPUBenchmarkSuite::standardScenarios()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), scenario.name) == names.end()) {
+            continue;
+        }
+        int width = 0;
+        int height = 0;
+        std::vector<Color> reference_image = reference(scenario, width, height);
+        for (Technique technique : config_.techniques) {
+            std::cout << "Converging " << scenario.name << " with " << techniqueName(technique) << "..." << std::endl;
+            curves.push_back(runTechnique(scenario, technique, reference_image, width, height));
+        }
+    }
+    return curves;
+}
+
+void ConvergenceBenchmark::printReport(std::ostream& out, const std::vector<Curve>& curves) const {
+    out << "\n=== Convergence Report (time to " << metricName(config_.reportMetric) << ") ===" << std::endl;
+    out << std::left << std::setw(18) << "Scenario" << std::setw(18) << "Technique" << std::right;
+    for (double target : config_.targets) {
+        std::ostringstream label;
+        label << "<= " << target;
+        out << std::setw(12) << label.str();
+    }
+    out << std::setw(12) << "Final" << std::setw(9) << "SSIM" << std::endl;
+
+    for (const auto& curve : curves) {
+        out << std::left << std::setw(18) << curve.scenarioName << std::setw(18) << curve.technique << std::right;
+        for (double target : config_.targets) {
+            double seconds = curve.timeToError(target, config_.reportMetric);
+            std::ostringstream cell;
+            if (seconds < 0.0) {
+                cell << "-";
+            } else {
+                cell << std::fixed << std::setprecision(seconds < 10.0 ? 3 : 1) << seconds << "s";
+            }
+            out << std::setw(12) << cell.str();
+        }
+        if (!curve.points.empty()) {
+            const ImageError& final_error = curve.points.back().error;
+            out << std::setw(12) << std::setprecision(4) << std::defaultfloat << final_error.value(config_.reportMetric)
+                << std::setw(9) << std::fixed << std::setprecision(3) << final_error.ssim;
+        }
+        out << std::defaultfloat << std::endl;
+    }
+    out << "'-' means the target was not reached within " << config_.maxSamples << " spp" << std::endl;
+}
+
+void ConvergenceBenchmark::writeCSV(std::ostream& out, const std::vector<Curve>& curves) const {
+    out << "scenario,technique,width,height,spp,seconds,rmse,relmse,ssim\n";
+    for (const auto& curve : curves) {
+        for (const auto& point : curve.points) {
+            out << curve.scenarioName << "," << curve.technique << "," << curve.imageWidth << ","
+                << curve.imageHeight << "," << point.samplesPerPixel << "," << point.seconds << ","
+                << point.error.rmse << "," << point.error.relMSE << "," << point.error.ssim << "\n";
+        }
+    }
+}
+
+void ConvergenceBenchmark::writeJSON(std::ostream& out, const std::vector<Curve>& curves) const {
+    out << "{\n  \"suite\": \"convergence\",\n  \"version\": 1,\n";
+    out << "  \"reference_spp\": " << config_.referenceSamples << ",\n";
+    out << "  \"resolution_scale\": " << config_.resolutionScale << ",\n";
+    out << "  \"report_metric\": \"" << metricName(config_.reportMetric) << "\",\n";
+    out << "  \"curves\": [";
+    for (size_t c = 0; c < curves.size(); ++c) {
+        const Curve& curve = curves[c];
+        out << (c == 0 ? "\n" : ",\n") << "    {\"scenario\": \"" << curve.scenarioName << "\""
+            << ", \"technique\": \"" << curve.technique << "\""
+            << ", \"width\": " << curve.imageWidth
+            << ", \"height\": " << curve.imageHeight
+            << ",\n     \"time_to_target\": {";
+        for (size_t t = 0; t < config_.targets.size(); ++t) {
+            double seconds = curve.timeToError(config_.targets[t], config_.reportMetric);
+            out << (t == 0 ? "" : ", ") << "\"" << config_.targets[t] << "\": ";
+            if (seconds < 0.0) {
+                out << "null";
+            } else {
+                out << seconds;
+            }
+        }
+        out << "},\n     \"points\": [";
+        for (size_t i = 0; i < curve.points.size(); ++i) {
+            const CurvePoint& point = curve.points[i];
+            out << (i == 0 ? "" : ", ") << "{\"spp\": " << point.samplesPerPixel
+                << ", \"seconds\": " << point.seconds
+                << ", \"rmse\": " << point.error.rmse
+                << ", \"relmse\": " << point.error.relMSE
+                << ", \"ssim\": " << point.error.ssim << "}";
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool ConvergenceBenchmark::writeFile(const std::string& filename, const std::vector<Curve>& curves, bool csv) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+    if (csv) {
+        writeCSV(file, curves);
+    } else {
+        writeJSON(file, curves);
+    }
+    if (file.fail()) {
+        std::cerr << "Error writing to file: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Convergence results written to " << filename << std::endl;
+    return true;
+}
@@ -0,0 +1,383 @@
+#include "performance/cpu_benchmark.h"
+#include "performance/benchmark_baseline.h"
+#include "performance/hw_counters.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+#include "core/camera.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+void add_ground(SceneManager& scene) {
+    Material ground(Color(0.5f, 0.5f, 0.5f), 1.0f, 0.0f, 0.0f);
+    scene.add_object(std::make_shared<Sphere>(Vector3(0, -100.5f, -1), 100.0f, ground.albedo, ground));
+}
+
+void build_simple(SceneManager& scene) {
+    // The default scene as set up by initialize()
+    scene.set_camera_position(Vector3(0, 0, 3));
+    scene.set_camera_target(Vector3(0, 0, -1));
+}
+
+void build_metal_heavy(SceneManager& scene) {
+    scene.clear_objects();
+    scene.clear_lights();
+    add_ground(scene);
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 5; ++col) {
+            float roughness = 0.02f + 0.08f * row;
+            Color albedo(0.9f - 0.1f * col, 0.85f, 0.7f + 0.05f * col);
+            Material metal(albedo, roughness, 1.0f, 0.0f);
+            Vector3 center(-2.0f + col, -0.1f + 0.05f * row, -1.0f - 0.9f * row);
+            scene.add_object(std::make_shared<Sphere>(center, 0.4f, albedo, metal));
+        }
+    }
+    scene.add_light(Vector3(2, 4, -1), Color(1.0f, 1.0f, 0.8f), 5.0f);
+    scene.set_camera_position(Vector3(0, 1.0f, 3));
+    scene.set_camera_target(Vector3(0, 0, -2));
+}
+
+void build_torus_heavy(SceneManager& scene) {
+    scene.clear_objects();
+    scene.clear_lights();
+    add_ground(scene);
+    for (int i = 0; i < 12; ++i) {
+        float x = -2.5f + (i % 4) * 1.7f;
+        float z = -1.0f - (i / 4) * 1.6f;
+        Material material(Color(0.2f + 0.05f * i, 0.3f, 0.8f - 0.05f * i), 0.4f, (i % 3) * 0.4f, 0.0f);
+        scene.add_object(std::make_shared<Torus>(Vector3(x, 0, z), 0.6f, 0.2f, material.albedo, material));
+    }
+    scene.add_light(Vector3(2, 4, -1), Color(1.0f, 1.0f, 0.8f), 5.0f);
+    scene.set_camera_position(Vector3(0, 1.5f, 3));
+    scene.set_camera_target(Vector3(0, 0, -2));
+}
+
+void build_many_primitives(SceneManager& scene) {
+    scene.clear_objects();
+    scene.clear_lights();
+    add_ground(scene);
+    // Fixed seed so the layout is identical on every machine
+    std::mt19937 layout(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < 200; ++i) {
+        Vector3 center(-4.0f + 8.0f * unit(layout), -0.3f + 0.6f * unit(layout), -1.0f - 8.0f * unit(layout));
+        Material material(Color(unit(layout), unit(layout), unit(layout)), unit(layout),
+                          unit(layout) < 0.3f ? 1.0f : 0.0f, 0.0f);
+        switch (i % 3) {
+            case 0:
+                scene.add_object(std::make_shared<Sphere>(center, 0.15f + 0.1f * unit(layout), material.albedo, material));
+                break;
+            case 1:
+                scene.add_object(std::make_shared<Cube>(center, 0.2f + 0.15f * unit(layout), material.albedo, material));
+                break;
+            default:
+                scene.add_object(std::make_shared<Pyramid>(center, 0.3f, 0.35f, material.albedo, material));
+                break;
+        }
+    }
+    scene.add_light(Vector3(2, 4, -1), Color(1.0f, 1.0f, 0.8f), 5.0f);
+    scene.add_light(Vector3(-3, 3, -5), Color(0.8f, 0.9f, 1.0f), 4.0f);
+    scene.set_camera_position(Vector3(0, 1.0f, 3));
+    scene.set_camera_target(Vector3(0, 0, -4));
+}
+
+// Clears the kernel's resident set high-water mark so each scenario reports
+// its own peak; returns false where that is not supported
+bool reset_peak_memory() {
+#ifdef __linux__
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs.is_open()) {
+        clear_refs << "5";
+        return static_cast<bool>(clear_refs.flush());
+    }
+#endif
+    return false;
+}
+
+double peak_memory_mb() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stod(line.substr(6)) / 1024.0;
+        }
+    }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss / 1024.0;
+    }
+#endif
+    return 0.0;
+}
+
+std::string iso_timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::vector<CPUBenchmarkSuite::Scenario> CPUBenchmarkSuite::standardScenarios() {
+    std::vector<Scenario> scenarios(5);
+    scenarios[0].name = "simple";
+    scenarios[0].samplesPerPixel = 8;
+    scenarios[0].seed = 101;
+    scenarios[0].buildScene = build_simple;
+
+    scenarios[1].name = "metal_heavy";
+    scenarios[1].samplesPerPixel = 8;
+    scenarios[1].maxDepth = 8;
+    scenarios[1].seed = 202;
+    scenarios[1].buildScene = build_metal_heavy;
+
+    scenarios[2].name = "torus_heavy";
+    scenarios[2].seed = 303;
+    scenarios[2].buildScene = build_torus_heavy;
+
+    scenarios[3].name = "many_primitives";
+    scenarios[3].seed = 404;
+    scenarios[3].buildScene = build_many_primitives;
+
+    scenarios[4].name = "high_resolution";
+    scenarios[4].width = 1280;
+    scenarios[4].height = 720;
+    scenarios[4].samplesPerPixel = 2;
+    scenarios[4].seed = 505;
+    scenarios[4].buildScene = build_simple;
+    return scenarios;
+}
+
+CPUBenchmarkSuite::Result CPUBenchmarkSuite::runScenario(const Scenario& scenario) {
+    Result result;
+    result.scenarioName = scenario.name;
+    result.imageWidth = std::max(1, static_cast<int>(scenario.width * config_.resolutionScale));
+    result.imageHeight = std::max(1, static_cast<int>(scenario.height * config_.resolutionScale));
+    result.samplesPerPixel = scenario.samplesPerPixel;
+    result.maxDepth = scenario.maxDepth;
+
+    reset_peak_memory();
+
+    auto scene = std::make_shared<SceneManager>();
+    scene->initialize();
+    if (scenario.buildScene) {
+        scenario.buildScene(*scene);
+    }
+    result.primitiveCount = static_cast<int>(scene->get_objects().size());
+
+    Camera camera = *scene->get_camera();
+    camera.set_aspect_ratio(float(result.imageWidth) / float(result.imageHeight));
+
+    PathTracer path_tracer;
+    path_tracer.set_scene_manager(scene);
+    path_tracer.set_camera(camera);
+    path_tracer.set_samples_per_pixel(scenario.samplesPerPixel);
+    path_tracer.set_max_depth(scenario.maxDepth);
+    int threads = config_.threadCount > 0 ? config_.threadCount
+                                          : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    path_tracer.set_thread_count(threads);
+    path_tracer.set_random_seed(scenario.seed);
+
+    auto render = [&]() {
+        auto start = std::chrono::steady_clock::now();
+        path_tracer.trace(result.imageWidth, result.imageHeight);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    for (int i = 0; i < config_.warmupIterations; ++i) {
+        render();
+    }
+
+    bool counters = config_.enableHardwareCounters && hw_counters_supported();
+    if (counters) {
+        hw_counters_set_enabled(true);
+        hw_stage_stats_reset();
+    }
+
+    std::vector<double> times;
+    uint64_t total_rays = 0;
+    double ray_seconds = 0.0;
+    int iterations = std::max(1, config_.iterations);
+    for (int i = 0; i < iterations; ++i) {
+        times.push_back(render());
+        FrameStats frame = path_tracer.get_frame_stats();
+        total_rays += frame.rays.rays();
+        ray_seconds += frame.seconds;
+    }
+
+    if (counters) {
+        // The trace stage alone, so setup and tonemapping don't inflate the per-ray figures
+        HwCounterValues values = hw_stage_total("trace");
+        uint64_t trace_rays = hw_stage_rays("trace");
+        result.ipc = values.ipc();
+        result.cacheMissesPerRay = values.per_ray(HwCounter::CACHE_MISSES, trace_rays);
+        result.branchMissesPerRay = values.per_ray(HwCounter::BRANCH_MISSES, trace_rays);
+        hw_counters_set_enabled(false);
+    }
+
+    result.wallTimeSamplesMs = times;
+    SampleStats stats = computeSampleStats(times);
+    result.wallTimeCi95Ms = stats.ciHigh - stats.mean;
+
+    std::sort(times.begin(), times.end());
+    result.iterations = iterations;
+    result.wallTimeMs = times[times.size() / 2];
+    result.minWallTimeMs = times.front();
+    result.maxWallTimeMs = times.back();
+    result.rays = total_rays / iterations;
+    result.mraysPerSecond = ray_seconds > 0.0 ? total_rays / ray_seconds * 1e-6 : 0.0;
+    double samples = double(result.imageWidth) * result.imageHeight * result.samplesPerPixel;
+    result.samplesPerSecond = result.wallTimeMs > 0.0 ? samples / (result.wallTimeMs * 1e-3) : 0.0;
+    result.peakMemoryMB = peak_memory_mb();
+    result.imageChecksum = imageChecksum(path_tracer.get_image_data());
+    return result;
+}
+
+std::vector<CPUBenchmarkSuite::Result> CPUBenchmarkSuite::runScenarios(const std::vector<std::string>& names) {
+    std::vector<Result> results;
+    for (const auto& scenario : standardScenarios()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), scenario.name) == names.end()) {
+            continue;
+        }
+        std::cout << "Running " << scenario.name << "..." << std::endl;
+        results.push_back(runScenario(scenario));
+    }
+    return results;
+}
+
+void CPUBenchmarkSuite::printReport(std::ostream& out, const std::vector<Result>& results) const {
+    out << "\n=== CPU Benchmark Report ===" << std::endl;
+    out << std::left << std::setw(18) << "Scenario"
+        << std::right << std::setw(12) << "Resolution"
+        << std::setw(6) << "SPP"
+        << std::setw(11) << "Wall ms"
+        << std::setw(9) << "+/-95%"
+        << std::setw(10) << "Mrays/s"
+        << std::setw(12) << "Ksamples/s"
+        << std::setw(9) << "Peak MB"
+        << std::setw(7) << "IPC" << std::endl;
+    for (const auto& result : results) {
+        std::string resolution = std::to_string(result.imageWidth) + "x" + std::to_string(result.imageHeight);
+        out << std::left << std::setw(18) << result.scenarioName
+            << std::right << std::setw(12) << resolution
+            << std::setw(6) << result.samplesPerPixel
+            << std::fixed << std::setprecision(1)
+            << std::setw(11) << result.wallTimeMs
+            << std::setw(9) << result.wallTimeCi95Ms
+            << std::setprecision(2)
+            << std::setw(10) << result.mraysPerSecond
+            << std::setprecision(1)
+            << std::setw(12) << result.samplesPerSecond * 1e-3
+            << std::setw(9) << result.peakMemoryMB
+            << std::setprecision(2)
+            << std::setw(7) << result.ipc << std::endl;
+    }
+    if (config_.enableHardwareCounters && !hw_counters_supported()) {
+        out << "Hardware counters unavailable: " << hw_counters_status() << std::endl;
+    }
+}
+
+void CPUBenchmarkSuite::writeJSON(std::ostream& out, const std::vector<Result>& results) const {
+    int threads = config_.threadCount > 0 ? config_.threadCount
+                                          : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    out << "{\n  \"suite\": \"cpu\",\n  \"version\": 1,\n  \"timestamp\": \"" << iso_timestamp() << "\",\n";
+    out << "  \"threads\": " << threads << ",\n";
+    out << "  \"iterations\": " << config_.iterations << ",\n";
+    out << "  \"warmup_iterations\": " << config_.warmupIterations << ",\n";
+    out << "  \"resolution_scale\": " << config_.resolutionScale << ",\n";
+    out << "  \"hardware_counters\": ";
+    write_json_string(out, hw_counters_status());
+    out << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"scenario\": ";
+        write_json_string(out, result.scenarioName);
+        out << ", \"width\": " << result.imageWidth
+            << ", \"height\": " << result.imageHeight
+            << ", \"spp\": " << result.samplesPerPixel
+            << ", \"max_depth\": " << result.maxDepth
+            << ", \"primitives\": " << result.primitiveCount
+            << ", \"iterations\": " << result.iterations
+            << ",\n     \"wall_ms\": " << result.wallTimeMs
+            << ", \"wall_ms_min\": " << result.minWallTimeMs
+            << ", \"wall_ms_max\": " << result.maxWallTimeMs
+            << ", \"wall_ms_ci95\": " << result.wallTimeCi95Ms
+            << ", \"rays\": " << result.rays
+            << ", \"mrays_per_second\": " << result.mraysPerSecond
+            << ", \"samples_per_second\": " << result.samplesPerSecond
+            << ",\n     \"peak_memory_mb\": " << result.peakMemoryMB
+            << ", \"ipc\": " << result.ipc
+            << ", \"cache_misses_per_ray\": " << result.cacheMissesPerRay
+            << ", \"branch_misses_per_ray\": " << result.branchMissesPerRay
+            << ", \"image_checksum\": \"" << std::hex << result.imageChecksum << std::dec << "\"}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool CPUBenchmarkSuite::writeJSON(const std::string& filename, const std::vector<Result>& results) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+    writeJSON(file, results);
+    if (file.fail()) {
+        std::cerr << "Error writing to file: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Benchmark results written to " << filename << std::endl;
+    return true;
+}
+
+// FNV-1a over the 8-bit display values
+uint64_t CPUBenchmarkSuite::imageChecksum(const std::vector<Color>& image) {
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](float value) {
+        hash ^= static_cast<uint64_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        hash *= 1099511628211ull;
+    };
+    for (const auto& pixel : image) {
+        mix(pixel.r);
+        mix(pixel.g);
+        mix(pixel.b);
+    }
+    return hash;
+}
+
+std::map<std::string, std::vector<double>> CPUBenchmarkSuite::baselineMetrics(const std::vector<Result>& results) {
+    std::map<std::string, std::vector<double>> metrics;
+    for (const auto& result : results) {
+        metrics[result.scenarioName + ".wall_ms"] = result.wallTimeSamplesMs;
+    }
+    return metrics;
+}
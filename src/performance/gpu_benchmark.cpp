@@ -164,6 +164,7 @@ GPUBenchmarkSuite::BenchmarkResult GPUBenchmarkSuite::benchmarkProgressiveRender
         // Measure CPU comparison if enabled
         if (config_.enableCPUComparison) {
             result.cpuTime = measureCPUPerformance(result.imageWidth, result.imageHeight, result.samplesPerPixel);
+            applyCPUCounters(result);
         }
         
         // Calculate speedup
@@ -232,6 +233,7 @@ GPUBenchmarkSuite::BenchmarkResult GPUBenchmarkSuite::runBenchmarkScenario(const
         
         if (!cpuTimes.empty()) {
             result.cpuTime = std::accumulate(cpuTimes.begin(), cpuTimes.end(), 0.0) / cpuTimes.size();
+            applyCPUCounters(result);
         }
         
         // Measure memory transfer overhead
@@ -293,15 +295,35 @@ double GPUBenchmarkSuite::measureCPUPerformance(int width, int height, int sampl
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
+    if (config_.enableHardwareCounters) {
+        hw_counters_set_enabled(true);
+        hw_stage_stats_reset();
+    }
+    
     pathTracer_->set_samples_per_pixel(samples);
     pathTracer_->trace(width, height);
     
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
     
+    FrameStats frame = pathTracer_->get_frame_stats();
+    cpuRays_ += frame.rays.rays();
+    cpuSeconds_ += frame.seconds;
+    if (hw_counters_enabled()) {
+        cpuCounters_ += hw_stage_total("trace");
+        cpuCounterRays_ += hw_stage_rays("trace");
+    }
+    
     return duration.count() / 1000.0; // Convert to milliseconds
 }
 
+void GPUBenchmarkSuite::applyCPUCounters(BenchmarkResult& result) const {
+    result.cpuMraysPerSecond = cpuSeconds_ > 0.0 ? cpuRays_ / cpuSeconds_ * 1e-6 : 0.0;
+    result.cpuIPC = cpuCounters_.ipc();
+    result.cpuCacheMissesPerRay = cpuCounters_.per_ray(HwCounter::CACHE_MISSES, cpuCounterRays_);
+    result.cpuBranchMissesPerRay = cpuCounters_.per_ray(HwCounter::BRANCH_MISSES, cpuCounterRays_);
+}
+
 double GPUBenchmarkSuite::measureMemoryTransferOverhead(int width, int height) {
     if (!performanceMonitor_) return 0.0;
     
@@ -385,6 +407,26 @@ void GPUBenchmarkSuite::generateBenchmarkReport(const std::vector<BenchmarkResul
     
     std::cout << "Summary: " << passCount << "/" << results.size() << " scenarios passed, "
               << "Average speedup: " << std::fixed << std::setprecision(2) << avgSpeedup << "x" << std::endl;
+    
+    // CPU-side hardware counters, when the kernel allows them
+    if (config_.enableHardwareCounters && config_.enableCPUComparison) {
+        if (!hw_counters_supported()) {
+            std::cout << "CPU hardware counters unavailable: " << hw_counters_status() << std::endl;
+        } else {
+            std::cout << std::left << std::setw(20) << "Scenario"
+                      << std::setw(12) << "Mrays/s"
+                      << std::setw(8) << "IPC"
+                      << std::setw(14) << "Cache/ray"
+                      << std::setw(14) << "Branch/ray" << std::endl;
+            for (const auto& result : results) {
+                std::cout << std::left << std::setw(20) << result.scenarioName
+                          << std::setw(12) << std::setprecision(2) << result.cpuMraysPerSecond
+                          << std::setw(8) << result.cpuIPC
+                          << std::setw(14) << std::setprecision(3) << result.cpuCacheMissesPerRay
+                          << std::setw(14) << result.cpuBranchMissesPerRay << std::endl;
+            }
+        }
+    }
     std::cout << "=========================" << std::endl;
 }
 
@@ -413,6 +455,10 @@ bool GPUBenchmarkSuite::isResultValid(const BenchmarkResult& result) const {
 void GPUBenchmarkSuite::setupBenchmarkScene(int primitiveCount) {
     // This would set up a scene with the specified number of primitives
     // For now, we'll just ensure the path tracer is ready
+    cpuCounters_ = HwCounterValues();
+    cpuCounterRays_ = 0;
+    cpuRays_ = 0;
+    cpuSeconds_ = 0.0;
     if (pathTracer_) {
         pathTracer_->reset_stop_request();
     }
@@ -432,8 +478,12 @@ void GPUBenchmarkSuite::validateBenchmarkAccuracy(const BenchmarkResult& result)
 void GPUBenchmarkSuite::logBenchmarkResult(const BenchmarkResult& result) const {
     std::cout << "  " << result.scenarioName << ": " 
               << result.speedupRatio << "x speedup"
-              << " (GPU: " << result.gpuTime << "ms, CPU: " << result.cpuTime << "ms)"
-              << " - " << (result.meetsPerformanceTarget ? "PASS" : "FAIL") << std::endl;
+              << " (GPU: " << result.gpuTime << "ms, CPU: " << result.cpuTime << "ms";
+    if (result.cpuIPC > 0.0) {
+        std::cout << ", CPU IPC " << result.cpuIPC
+                  << ", " << result.cpuCacheMissesPerRay << " cache misses/ray";
+    }
+    std::cout << ")" << " - " << (result.meetsPerformanceTarget ? "PASS" : "FAIL") << std::endl;
 }
 
 void GPUBenchmarkSuite::calculateStatistics(std::vector<BenchmarkResult>& results) const {
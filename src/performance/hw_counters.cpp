@@ -0,0 +1,413 @@
+#include "performance/hw_counters.h"
+#include "core/ray_stats.h"
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+
+#ifdef __linux__
+const uint64_t EVENT_CONFIGS[HW_COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+int open_event(uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0;
+    // User space only, which perf_event_paranoid <= 2 still permits
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+
+// One event group per thread, led by the cycle counter. Events the PMU
+// lacks are left out of the group instead of failing it.
+struct CounterGroup {
+    int fds[HW_COUNTER_COUNT] = {-1, -1, -1, -1};
+    int read_slot[HW_COUNTER_COUNT] = {-1, -1, -1, -1};
+    int event_count = 0;
+    uint32_t available = 0;
+
+    bool open(std::string& error) {
+#ifdef __linux__
+        for (int i = 0; i < HW_COUNTER_COUNT; ++i) {
+            int fd = open_event(EVENT_CONFIGS[i], i == 0 ? -1 : fds[0]);
+            if (fd < 0) {
+                if (i == 0) {
+                    error = std::string("perf_event_open failed: ") + std::strerror(errno) +
+                            " (see /proc/sys/kernel/perf_event_paranoid)";
+                    return false;
+                }
+                continue;
+            }
+            fds[i] = fd;
+            read_slot[i] = event_count++;
+            available |= 1u << i;
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+#else
+        error = "hardware counters need Linux perf_event_open";
+        return false;
+#endif
+    }
+
+    bool read(HwCounterValues& values) const {
+#ifdef __linux__
+        if (fds[0] < 0) {
+            return false;
+        }
+        uint64_t data[3 + HW_COUNTER_COUNT] = {};
+        ssize_t expected = static_cast<ssize_t>((3 + event_count) * sizeof(uint64_t));
+        if (::read(fds[0], data, sizeof(data)) < expected) {
+            return false;
+        }
+        // Scale up when the kernel multiplexed the group off the PMU
+        uint64_t enabled = data[1];
+        uint64_t running = data[2];
+        double scale = running > 0 ? static_cast<double>(enabled) / running : 0.0;
+        for (int i = 0; i < HW_COUNTER_COUNT; ++i) {
+            values.values[i] = read_slot[i] >= 0
+                ? static_cast<uint64_t>(data[3 + read_slot[i]] * scale) : 0;
+        }
+        values.available = available;
+        return true;
+#else
+        (void)values;
+        return false;
+#endif
+    }
+
+    void close() {
+#ifdef __linux__
+        for (int& fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+#endif
+        event_count = 0;
+        available = 0;
+    }
+};
+
+struct ThreadCounters {
+    CounterGroup group;
+    bool tried = false;
+    bool ok = false;
+
+    ~ThreadCounters() {
+        group.close();
+    }
+};
+
+ThreadCounters& thread_counters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+struct HwCounterState {
+    std::once_flag probe_once;
+    bool supported = false;
+    std::string status;
+    std::atomic<bool> enabled{false};
+
+    std::mutex stages_mutex;
+    std::map<std::pair<std::string, int>, HwStageStats> stages;
+};
+
+HwCounterState& state() {
+    static HwCounterState counters;
+    return counters;
+}
+
+void merge_stage(HwStageStats& into, const HwStageStats& from) {
+    into.stage = from.stage;
+    into.thread_index = from.thread_index;
+    into.calls += from.calls;
+    into.rays += from.rays;
+    into.values += from.values;
+}
+
+// Stage totals of the calling thread not yet merged into the shared table.
+// Only a handful of stages exist, so a linear scan beats a map.
+struct PendingStages {
+    std::vector<HwStageStats> stages;
+
+    HwStageStats& find(const char* stage, int thread_index) {
+        for (auto& entry : stages) {
+            if (entry.thread_index == thread_index && entry.stage == stage) {
+                return entry;
+            }
+        }
+        stages.emplace_back();
+        stages.back().stage = stage;
+        stages.back().thread_index = thread_index;
+        return stages.back();
+    }
+
+    void flush() {
+        if (stages.empty()) {
+            return;
+        }
+        HwCounterState& counters = state();
+        std::lock_guard<std::mutex> lock(counters.stages_mutex);
+        for (const auto& entry : stages) {
+            merge_stage(counters.stages[std::make_pair(entry.stage, entry.thread_index)], entry);
+        }
+        stages.clear();
+    }
+
+    ~PendingStages() {
+        flush();
+    }
+};
+
+PendingStages& pending_stages() {
+    thread_local PendingStages pending;
+    return pending;
+}
+
+uint64_t thread_rays() {
+    const RayStatsSlot& slot = thread_ray_stats();
+    return slot.get(RayCounter::PRIMARY_RAYS) + slot.get(RayCounter::SECONDARY_RAYS) +
+           slot.get(RayCounter::SHADOW_RAYS);
+}
+
+} // namespace
+
+const char* hw_counter_name(HwCounter counter) {
+    switch (counter) {
+        case HwCounter::CYCLES: return "cycles";
+        case HwCounter::INSTRUCTIONS: return "instructions";
+        case HwCounter::CACHE_MISSES: return "cache_misses";
+        case HwCounter::BRANCH_MISSES: return "branch_misses";
+        default: return "unknown";
+    }
+}
+
+double HwCounterValues::ipc() const {
+    if (!has(HwCounter::CYCLES) || !has(HwCounter::INSTRUCTIONS) || (*this)[HwCounter::CYCLES] == 0) {
+        return 0.0;
+    }
+    return static_cast<double>((*this)[HwCounter::INSTRUCTIONS]) / (*this)[HwCounter::CYCLES];
+}
+
+double HwCounterValues::per_ray(HwCounter counter, uint64_t rays) const {
+    return has(counter) && rays > 0 ? static_cast<double>((*this)[counter]) / rays : 0.0;
+}
+
+HwCounterValues& HwCounterValues::operator+=(const HwCounterValues& other) {
+    for (int i = 0; i < HW_COUNTER_COUNT; ++i) {
+        values[i] += other.values[i];
+    }
+    available |= other.available;
+    return *this;
+}
+
+HwCounterValues HwCounterValues::operator-(const HwCounterValues& other) const {
+    HwCounterValues result;
+    for (int i = 0; i < HW_COUNTER_COUNT; ++i) {
+        // Multiplex scaling can make a later reading dip below an earlier one
+        result.values[i] = values[i] > other.values[i] ? values[i] - other.values[i] : 0;
+    }
+    result.available = available & other.available;
+    return result;
+}
+
+bool hw_counters_supported() {
+    HwCounterState& counters = state();
+    std::call_once(counters.probe_once, [&counters]() {
+        CounterGroup probe;
+        std::string error;
+        counters.supported = probe.open(error);
+        if (counters.supported) {
+            counters.status = "available:";
+            for (int i = 0; i < HW_COUNTER_COUNT; ++i) {
+                if (probe.available & (1u << i)) {
+                    counters.status += std::string(" ") + hw_counter_name(static_cast<HwCounter>(i));
+                }
+            }
+        } else {
+            counters.status = error;
+        }
+        probe.close();
+    });
+    return counters.supported;
+}
+
+const std::string& hw_counters_status() {
+    hw_counters_supported();
+    return state().status;
+}
+
+void hw_counters_set_enabled(bool enabled) {
+    state().enabled.store(enabled && hw_counters_supported(), std::memory_order_relaxed);
+}
+
+bool hw_counters_enabled() {
+    return state().enabled.load(std::memory_order_relaxed);
+}
+
+bool hw_counters_read_thread(HwCounterValues& values) {
+    if (!hw_counters_enabled()) {
+        return false;
+    }
+    ThreadCounters& counters = thread_counters();
+    if (!counters.tried) {
+        counters.tried = true;
+        std::string error;
+        counters.ok = counters.group.open(error);
+    }
+    return counters.ok && counters.group.read(values);
+}
+
+std::vector<HwStageStats> hw_stage_stats() {
+    hw_stage_flush();
+    HwCounterState& counters = state();
+    std::lock_guard<std::mutex> lock(counters.stages_mutex);
+    std::vector<HwStageStats> stats;
+    stats.reserve(counters.stages.size());
+    for (const auto& entry : counters.stages) {
+        stats.push_back(entry.second);
+    }
+    return stats;
+}
+
+HwCounterValues hw_stage_total() {
+    HwCounterValues total;
+    for (const auto& stage : hw_stage_stats()) {
+        total += stage.values;
+    }
+    return total;
+}
+
+HwCounterValues hw_stage_total(const std::string& stage) {
+    HwCounterValues total;
+    for (const auto& entry : hw_stage_stats()) {
+        if (entry.stage == stage) {
+            total += entry.values;
+        }
+    }
+    return total;
+}
+
+uint64_t hw_stage_rays(const std::string& stage) {
+    uint64_t rays = 0;
+    for (const auto& entry : hw_stage_stats()) {
+        if (entry.stage == stage) {
+            rays += entry.rays;
+        }
+    }
+    return rays;
+}
+
+void hw_stage_stats_reset() {
+    pending_stages().stages.clear();
+    HwCounterState& counters = state();
+    std::lock_guard<std::mutex> lock(counters.stages_mutex);
+    counters.stages.clear();
+}
+
+void hw_stage_flush() {
+    pending_stages().flush();
+}
+
+void hw_counters_report(std::ostream& out) {
+    std::vector<HwStageStats> stats = hw_stage_stats();
+    if (stats.empty()) {
+        out << "Hardware counters: " << (hw_counters_supported() ? "no samples" : hw_counters_status()) << std::endl;
+        return;
+    }
+
+    // Stages that trace no rays have no per-ray figure
+    auto print_per_ray = [&out](const HwStageStats& row, HwCounter counter) {
+        if (row.rays > 0) {
+            out << std::setw(14) << std::setprecision(3) << row.per_ray(counter);
+        } else {
+            out << std::setw(14) << "-";
+        }
+    };
+    auto print_row = [&out, &print_per_ray](const std::string& label, const HwStageStats& row) {
+        out << std::left << std::setw(28) << label
+            << std::right << std::setw(8) << row.calls
+            << std::setw(12) << row.rays
+            << std::setw(12) << std::fixed << std::setprecision(1) << row.values[HwCounter::CYCLES] * 1e-6
+            << std::setw(8) << std::setprecision(2) << row.values.ipc();
+        print_per_ray(row, HwCounter::CACHE_MISSES);
+        print_per_ray(row, HwCounter::BRANCH_MISSES);
+        out << std::endl;
+    };
+
+    out << "\n=== Hardware Counters ===" << std::endl;
+    out << std::left << std::setw(28) << "Stage / thread"
+        << std::right << std::setw(8) << "Calls"
+        << std::setw(12) << "Rays"
+        << std::setw(12) << "Mcycles"
+        << std::setw(8) << "IPC"
+        << std::setw(14) << "Cache/ray"
+        << std::setw(14) << "Branch/ray" << std::endl;
+
+    // Stats arrive sorted by stage, then thread
+    HwCounterValues total;
+    for (size_t i = 0; i < stats.size();) {
+        size_t end = i;
+        HwStageStats stage_total;
+        while (end < stats.size() && stats[end].stage == stats[i].stage) {
+            merge_stage(stage_total, stats[end]);
+            ++end;
+        }
+        total += stage_total.values;
+        print_row(stats[i].stage, stage_total);
+        if (end - i > 1) {
+            for (size_t j = i; j < end; ++j) {
+                print_row("  thread " + std::to_string(stats[j].thread_index), stats[j]);
+            }
+        }
+        i = end;
+    }
+
+    out << "Total: IPC " << std::setprecision(2) << total.ipc() << std::endl;
+}
+
+HwStageScope::HwStageScope(const char* stage, int thread_index)
+    : stage_(stage), thread_index_(thread_index), active_(false), start_rays_(0) {
+    if (hw_counters_enabled()) {
+        active_ = hw_counters_read_thread(start_);
+        start_rays_ = thread_rays();
+    }
+}
+
+HwStageScope::~HwStageScope() {
+    HwCounterValues end;
+    if (!active_ || !hw_counters_read_thread(end)) {
+        return;
+    }
+
+    HwStageStats& stats = pending_stages().find(stage_, thread_index_);
+    stats.calls++;
+    stats.rays += thread_rays() - start_rays_;
+    stats.values += end - start_;
+}
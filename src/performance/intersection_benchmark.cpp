@@ -0,0 +1,324 @@
+#include "performance/intersection_benchmark.h"
+#include "core/primitives.h"
+#include "core/scene_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+
+// Keeps hit distances observable so the compiler cannot drop the kernel
+volatile float g_sink = 0.0f;
+
+bool ray_hits_box(const Ray& ray, const AABB& box) {
+    float t_near = 0.0f;
+    float t_far = std::numeric_limits<float>::infinity();
+    const float origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+    const float direction[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+    const float lower[3] = {box.lower.x, box.lower.y, box.lower.z};
+    const float upper[3] = {box.upper.x, box.upper.y, box.upper.z};
+    for (int axis = 0; axis < 3; ++axis) {
+        float inverse = 1.0f / direction[axis];
+        float t0 = (lower[axis] - origin[axis]) * inverse;
+        float t1 = (upper[axis] - origin[axis]) * inverse;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        t_near = std::max(t_near, t0);
+        t_far = std::min(t_far, t1);
+        if (t_near > t_far) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Vector3 random_unit_vector(std::mt19937_64& rng) {
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    Vector3 v(normal(rng), normal(rng), normal(rng));
+    float length = v.length();
+    return length > 1e-6f ? v * (1.0f / length) : Vector3(0, 0, 1);
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+const char* IntersectionBenchmark::batchName(RayBatchKind kind) {
+    switch (kind) {
+        case RayBatchKind::COHERENT_HIT: return "coherent_hit";
+        case RayBatchKind::COHERENT_MISS: return "coherent_miss";
+        case RayBatchKind::INCOHERENT_HIT: return "incoherent_hit";
+        case RayBatchKind::INCOHERENT_MISS: return "incoherent_miss";
+        default: return "unknown";
+    }
+}
+
+std::vector<Ray> IntersectionBenchmark::generateRays(const AABB& bounds, RayBatchKind kind, int count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const Vector3 center = (bounds.lower + bounds.upper) * 0.5f;
+    const Vector3 half = (bounds.upper - bounds.lower) * 0.5f;
+    const float extent = std::max(half.x, std::max(half.y, half.z));
+    const Vector3 eye = center + Vector3(0, 0.3f * extent, 4.0f * extent);
+    const int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count)))));
+
+    std::vector<Ray> rays;
+    rays.reserve(count);
+    for (int i = 0; rays.size() < static_cast<size_t>(count); ++i) {
+        float gx = ((i % side) + 0.5f) / side * 2.0f - 1.0f;
+        float gy = (((i / side) % side) + 0.5f) / side * 2.0f - 1.0f;
+        switch (kind) {
+            case RayBatchKind::COHERENT_HIT: {
+                Vector3 target = center + Vector3(gx * 0.6f * half.x, gy * 0.6f * half.y, 0);
+                rays.emplace_back(eye, target - eye);
+                break;
+            }
+            case RayBatchKind::COHERENT_MISS: {
+                Vector3 target = center + Vector3(2.5f * extent + gx * 0.3f * half.x, gy * 0.6f * half.y, 0);
+                Ray ray(eye, target - eye);
+                if (!ray_hits_box(ray, bounds)) {
+                    rays.push_back(ray);
+                }
+                break;
+            }
+            case RayBatchKind::INCOHERENT_HIT: {
+                Vector3 origin = center + random_unit_vector(rng) * (4.0f * extent);
+                Vector3 target = center + Vector3((unit(rng) - 0.5f) * half.x, (unit(rng) - 0.5f) * half.y,
+                                                  (unit(rng) - 0.5f) * half.z);
+                rays.emplace_back(origin, target - origin);
+                break;
+            }
+            case RayBatchKind::INCOHERENT_MISS: {
+                Vector3 origin = center + random_unit_vector(rng) * (4.0f * extent);
+                Ray ray(origin, random_unit_vector(rng));
+                if (!ray_hits_box(ray, bounds)) {
+                    rays.push_back(ray);
+                }
+                break;
+            }
+        }
+    }
+    return rays;
+}
+
+std::shared_ptr<SceneManager> IntersectionBenchmark::buildScene(int primitives, uint64_t seed) {
+    auto scene = std::make_shared<SceneManager>();
+    scene->initialize();
+    scene->clear_objects();
+    scene->clear_lights();
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < primitives; ++i) {
+        Vector3 position(-5.0f + 10.0f * unit(rng), -2.0f + 4.0f * unit(rng), -10.0f + 9.0f * unit(rng));
+        float size = 0.1f + 0.3f * unit(rng);
+        switch (i % 4) {
+            case 0:
+                scene->add_object(std::make_shared<Sphere>(position, size));
+                break;
+            case 1:
+                scene->add_object(std::make_shared<Cube>(position, 2.0f * size));
+                break;
+            case 2:
+                scene->add_object(std::make_shared<Torus>(position, 1.5f * size, 0.5f * size));
+                break;
+            default:
+                scene->add_object(std::make_shared<Pyramid>(position, 2.0f * size, 2.4f * size));
+                break;
+        }
+    }
+    return scene;
+}
+
+template <typename Kernel>
+IntersectionBenchmark::Result IntersectionBenchmark::measure(const std::vector<Ray>& rays, Kernel&& kernel) const {
+    using Clock = std::chrono::steady_clock;
+    Result result;
+    result.raysPerBatch = static_cast<int>(rays.size());
+
+    auto run_batch = [&rays, &kernel]() {
+        HitRecord rec;
+        int hits = 0;
+        float t_sum = 0.0f;
+        for (const Ray& ray : rays) {
+            if (kernel(ray, rec)) {
+                ++hits;
+                t_sum += rec.t;
+            }
+        }
+        g_sink = g_sink + t_sum;
+        return hits;
+    };
+
+    // One pass sizes the repetitions and measures the hit rate
+    auto start = Clock::now();
+    int hits = run_batch();
+    double pass_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    result.hitRate = rays.empty() ? 0.0 : double(hits) / rays.size();
+    int loops = std::max(1, static_cast<int>(std::ceil(config_.minRepetitionMs / std::max(pass_ms, 1e-6))));
+
+    for (int i = 0; i < config_.warmupRepetitions; ++i) {
+        run_batch();
+    }
+
+    std::vector<double> ns_per_ray;
+    int repetitions = std::max(1, config_.repetitions);
+    for (int r = 0; r < repetitions; ++r) {
+        start = Clock::now();
+        for (int l = 0; l < loops; ++l) {
+            run_batch();
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        ns_per_ray.push_back(ns / (double(loops) * std::max<size_t>(1, rays.size())));
+    }
+
+    double mean = 0.0;
+    for (double value : ns_per_ray) {
+        mean += value;
+    }
+    mean /= ns_per_ray.size();
+    double variance = 0.0;
+    for (double value : ns_per_ray) {
+        variance += (value - mean) * (value - mean);
+    }
+
+    result.repetitions = repetitions;
+    result.nsPerRay = median(ns_per_ray);
+    result.nsPerRayMin = *std::min_element(ns_per_ray.begin(), ns_per_ray.end());
+    result.nsPerRayStdDev = ns_per_ray.size() > 1 ? std::sqrt(variance / (ns_per_ray.size() - 1)) : 0.0;
+    result.raysPerSecond = result.nsPerRay > 0.0 ? 1e9 / result.nsPerRay : 0.0;
+    return result;
+}
+
+IntersectionBenchmark::Result IntersectionBenchmark::benchmarkPrimitive(const std::string& name, const Primitive& primitive,
+                                                                        RayBatchKind kind) const {
+    std::vector<Ray> rays = generateRays(primitive.bounding_box(), kind, config_.raysPerBatch, config_.seed);
+    Result result = measure(rays, [&primitive](const Ray& ray, HitRecord& rec) {
+        return primitive.hit(ray, ray.t_min, ray.t_max, rec);
+    });
+    result.kernel = name;
+    result.batch = batchName(kind);
+    return result;
+}
+
+IntersectionBenchmark::Result IntersectionBenchmark::benchmarkScene(const SceneManager& scene, RayBatchKind kind) const {
+    AABB bounds;
+    for (const auto& object : scene.get_objects()) {
+        bounds.expand(object->bounding_box());
+    }
+    std::vector<Ray> rays = generateRays(bounds, kind, config_.raysPerBatch, config_.seed);
+    Result result = measure(rays, [&scene](const Ray& ray, HitRecord& rec) {
+        return scene.hit_scene(ray, ray.t_min, ray.t_max, rec);
+    });
+    result.kernel = "hit_scene";
+    result.batch = batchName(kind);
+    result.primitiveCount = static_cast<int>(scene.get_objects().size());
+    return result;
+}
+
+std::vector<IntersectionBenchmark::Result> IntersectionBenchmark::runAll() const {
+    const RayBatchKind kinds[] = {RayBatchKind::COHERENT_HIT, RayBatchKind::COHERENT_MISS,
+                                  RayBatchKind::INCOHERENT_HIT, RayBatchKind::INCOHERENT_MISS};
+    const std::pair<const char*, std::shared_ptr<Primitive>> primitives[] = {
+        {"sphere", std::make_shared<Sphere>(Vector3(0, 0, 0), 0.5f)},
+        {"cube", std::make_shared<Cube>(Vector3(0, 0, 0), 1.0f)},
+        {"torus", std::make_shared<Torus>(Vector3(0, 0, 0), 0.8f, 0.3f)},
+        {"pyramid", std::make_shared<Pyramid>(Vector3(0, 0, 0), 1.0f, 1.2f)}
+    };
+
+    std::vector<Result> results;
+    for (const auto& entry : primitives) {
+        for (RayBatchKind kind : kinds) {
+            results.push_back(benchmarkPrimitive(entry.first, *entry.second, kind));
+        }
+    }
+    for (int size : config_.sceneSizes) {
+        auto scene = buildScene(size, config_.seed);
+        for (RayBatchKind kind : kinds) {
+            results.push_back(benchmarkScene(*scene, kind));
+        }
+    }
+    return results;
+}
+
+void IntersectionBenchmark::printReport(std::ostream& out, const std::vector<Result>& results) const {
+    out << "\n=== Intersection Microbenchmarks (" << config_.raysPerBatch << " rays x "
+        << config_.repetitions << " repetitions) ===" << std::endl;
+    out << std::left << std::setw(12) << "Kernel"
+        << std::setw(17) << "Batch"
+        << std::right << std::setw(7) << "Prims"
+        << std::setw(10) << "ns/ray"
+        << std::setw(9) << "+/-"
+        << std::setw(10) << "min"
+        << std::setw(11) << "Mrays/s"
+        << std::setw(8) << "Hits" << std::endl;
+    for (const auto& result : results) {
+        out << std::left << std::setw(12) << result.kernel
+            << std::setw(17) << result.batch
+            << std::right << std::setw(7) << result.primitiveCount
+            << std::fixed << std::setprecision(2)
+            << std::setw(10) << result.nsPerRay
+            << std::setw(9) << result.nsPerRayStdDev
+            << std::setw(10) << result.nsPerRayMin
+            << std::setw(11) << result.raysPerSecond * 1e-6
+            << std::setprecision(0)
+            << std::setw(7) << result.hitRate * 100.0 << "%" << std::endl;
+    }
+}
+
+void IntersectionBenchmark::writeJSON(std::ostream& out, const std::vector<Result>& results) const {
+    out << "{\n  \"suite\": \"intersection\",\n  \"version\": 1,\n";
+    out << "  \"rays_per_batch\": " << config_.raysPerBatch << ",\n";
+    out << "  \"repetitions\": " << config_.repetitions << ",\n";
+    out << "  \"seed\": " << config_.seed << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"kernel\": ";
+        write_json_string(out, result.kernel);
+        out << ", \"batch\": ";
+        write_json_string(out, result.batch);
+        out << ", \"primitives\": " << result.primitiveCount
+            << ", \"ns_per_ray\": " << result.nsPerRay
+            << ", \"ns_per_ray_min\": " << result.nsPerRayMin
+            << ", \"ns_per_ray_stddev\": " << result.nsPerRayStdDev
+            << ", \"rays_per_second\": " << result.raysPerSecond
+            << ", \"hit_rate\": " << result.hitRate << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool IntersectionBenchmark::writeJSON(const std::string& filename, const std::vector<Result>& results) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+    writeJSON(file, results);
+    if (file.fail()) {
+        std::cerr << "Error writing to file: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Benchmark results written to " << filename << std::endl;
+    return true;
+}
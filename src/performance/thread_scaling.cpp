@@ -0,0 +1,325 @@
+#include "performance/thread_scaling.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace {
+
+double median_of(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+double coefficient_of_variation(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    double mean = sum / values.size();
+    if (mean <= 0.0) {
+        return 0.0;
+    }
+    double squares = 0.0;
+    for (double value : values) {
+        squares += (value - mean) * (value - mean);
+    }
+    return std::sqrt(squares / (values.size() - 1)) / mean;
+}
+
+} // namespace
+
+const char* ThreadScalingBenchmark::modeName(Mode mode) {
+    return mode == Mode::STRONG ? "strong" : "weak";
+}
+
+std::vector<int> ThreadScalingBenchmark::threadCounts() const {
+    std::vector<int> counts;
+    if (!config_.threadCounts.empty()) {
+        for (int count : config_.threadCounts) {
+            if (count > 0) {
+                counts.push_back(count);
+            }
+        }
+    } else {
+        int max_threads = config_.maxThreads > 0 ? config_.maxThreads
+                                                 : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int count = 1; count < max_threads; count *= 2) {
+            counts.push_back(count);
+        }
+        counts.push_back(max_threads);
+    }
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    return counts;
+}
+
+ThreadScalingBenchmark::Point ThreadScalingBenchmark::measure(const CPUBenchmarkSuite::Scenario& scenario,
+                                                              Mode mode, int threads, int baseThreads) const {
+    Point point;
+    point.scenarioName = scenario.name;
+    point.mode = modeName(mode);
+    point.threads = threads;
+    point.samplesPerPixel = scenario.samplesPerPixel;
+
+    // Weak scaling grows both sides so the aspect ratio, and the view, stay put
+    double size_factor = mode == Mode::WEAK ? std::sqrt(double(threads) / baseThreads) : 1.0;
+    point.imageWidth = std::max(1, static_cast<int>(std::lround(scenario.width * config_.resolutionScale * size_factor)));
+    point.imageHeight = std::max(1, static_cast<int>(std::lround(scenario.height * config_.resolutionScale * size_factor)));
+
+    auto scene = std::make_shared<SceneManager>();
+    scene->initialize();
+    if (scenario.buildScene) {
+        scenario.buildScene(*scene);
+    }
+    Camera camera = *scene->get_camera();
+    camera.set_aspect_ratio(float(point.imageWidth) / float(point.imageHeight));
+
+    PathTracer path_tracer;
+    path_tracer.set_scene_manager(scene);
+    path_tracer.set_camera(camera);
+    path_tracer.set_samples_per_pixel(scenario.samplesPerPixel);
+    path_tracer.set_max_depth(scenario.maxDepth);
+    path_tracer.set_thread_count(threads);
+    path_tracer.set_random_seed(scenario.seed);
+
+    auto render = [&]() {
+        auto start = std::chrono::steady_clock::now();
+        path_tracer.trace(point.imageWidth, point.imageHeight);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    for (int i = 0; i < config_.warmupIterations; ++i) {
+        render();
+    }
+
+    int iterations = std::max(1, config_.iterations);
+    std::vector<double> times;
+    std::vector<double> tile_times;
+    uint64_t total_rays = 0;
+    double ray_seconds = 0.0;
+    double serial_ms = 0.0;
+    point.threadBusyMs.assign(threads, 0.0);
+    point.threadIdleMs.assign(threads, 0.0);
+    point.threadTiles.assign(threads, 0);
+    for (int i = 0; i < iterations; ++i) {
+        double frame_ms = render();
+        times.push_back(frame_ms);
+
+        FrameStats frame = path_tracer.get_frame_stats();
+        total_rays += frame.rays.rays();
+        ray_seconds += frame.seconds;
+
+        // The last tiled pass of trace() is the render itself
+        const TileRunStats& tiles = path_tracer.get_tile_stats();
+        double pass_ms = tiles.wall_seconds * 1e3;
+        serial_ms += std::max(0.0, frame_ms - pass_ms);
+        for (int t = 0; t < threads && t < static_cast<int>(tiles.thread_busy_seconds.size()); ++t) {
+            double busy_ms = tiles.thread_busy_seconds[t] * 1e3;
+            point.threadBusyMs[t] += busy_ms;
+            point.threadIdleMs[t] += std::max(0.0, pass_ms - busy_ms);
+            point.threadTiles[t] += tiles.thread_tiles[t];
+        }
+        tile_times.insert(tile_times.end(), tiles.tile_seconds.begin(), tiles.tile_seconds.end());
+    }
+
+    // Per-iteration averages
+    double busy_total = 0.0;
+    double idle_total = 0.0;
+    double busy_max = 0.0;
+    for (int t = 0; t < threads; ++t) {
+        point.threadBusyMs[t] /= iterations;
+        point.threadIdleMs[t] /= iterations;
+        point.threadTiles[t] /= iterations;
+        busy_total += point.threadBusyMs[t];
+        idle_total += point.threadIdleMs[t];
+        busy_max = std::max(busy_max, point.threadBusyMs[t]);
+    }
+
+    point.iterations = iterations;
+    point.wallTimeMs = median_of(times);
+    point.mraysPerSecond = ray_seconds > 0.0 ? total_rays / ray_seconds * 1e-6 : 0.0;
+    point.serialMs = serial_ms / iterations;
+    point.meanBusyMs = busy_total / threads;
+    point.meanIdleMs = idle_total / threads;
+    point.tileImbalance = point.meanBusyMs > 0.0 ? busy_max / point.meanBusyMs : 1.0;
+    point.tileTimeCV = coefficient_of_variation(tile_times);
+    point.imageChecksum = CPUBenchmarkSuite::imageChecksum(path_tracer.get_image_data());
+    return point;
+}
+
+std::vector<ThreadScalingBenchmark::Point> ThreadScalingBenchmark::runScenario(
+    const CPUBenchmarkSuite::Scenario& scenario, Mode mode) const {
+    std::vector<Point> points;
+    std::vector<int> counts = threadCounts();
+    if (counts.empty()) {
+        return points;
+    }
+
+    const int base_threads = counts.front();
+    for (int threads : counts) {
+        points.push_back(measure(scenario, mode, threads, base_threads));
+    }
+
+    // The smallest count is the reference; it need not be one thread
+    const Point& base = points.front();
+    for (Point& point : points) {
+        if (point.wallTimeMs <= 0.0) {
+            continue;
+        }
+        if (mode == Mode::STRONG) {
+            point.speedup = base.threads * base.wallTimeMs / point.wallTimeMs;
+            point.efficiency = point.speedup / point.threads;
+        } else {
+            // Work grew with the threads, so ideal is a constant frame time
+            point.efficiency = base.wallTimeMs / point.wallTimeMs;
+            point.speedup = point.efficiency * point.threads;
+        }
+    }
+    return points;
+}
+
+std::vector<ThreadScalingBenchmark::Point> ThreadScalingBenchmark::runScenarios(const std::vector<std::string>& names) const {
+    std::vector<Point> points;
+    for (const auto& scenario : CPUBenchmarkSuite::standardScenarios()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), scenario.name) == names.end()) {
+            continue;
+        }
+        for (Mode mode : {Mode::STRONG, Mode::WEAK}) {
+            if ((mode == Mode::STRONG && !config_.strongScaling) || (mode == Mode::WEAK && !config_.weakScaling)) {
+                continue;
+            }
+            std::cout << "Scaling " << scenario.name << " (" << modeName(mode) << ")..." << std::endl;
+            std::vector<Point> scenario_points = runScenario(scenario, mode);
+            points.insert(points.end(), scenario_points.begin(), scenario_points.end());
+        }
+    }
+    return points;
+}
+
+void ThreadScalingBenchmark::printReport(std::ostream& out, const std::vector<Point>& points) const {
+    out << "\n=== Thread Scaling Report ===" << std::endl;
+    out << std::left << std::setw(18) << "Scenario"
+        << std::setw(8) << "Mode"
+        << std::right << std::setw(8) << "Threads"
+        << std::setw(12) << "Resolution"
+        << std::setw(11) << "Wall ms"
+        << std::setw(9) << "Speedup"
+        << std::setw(7) << "Eff"
+        << std::setw(10) << "Busy ms"
+        << std::setw(10) << "Idle ms"
+        << std::setw(10) << "Serial ms"
+        << std::setw(11) << "Imbalance" << std::endl;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Point& point = points[i];
+        std::string resolution = std::to_string(point.imageWidth) + "x" + std::to_string(point.imageHeight);
+        out << std::left << std::setw(18) << point.scenarioName
+            << std::setw(8) << point.mode
+            << std::right << std::setw(8) << point.threads
+            << std::setw(12) << resolution
+            << std::fixed << std::setprecision(1)
+            << std::setw(11) << point.wallTimeMs
+            << std::setprecision(2)
+            << std::setw(9) << point.speedup
+            << std::setw(7) << point.efficiency
+            << std::setprecision(1)
+            << std::setw(10) << point.meanBusyMs
+            << std::setw(10) << point.meanIdleMs
+            << std::setw(10) << point.serialMs
+            << std::setprecision(2)
+            << std::setw(11) << point.tileImbalance << std::endl;
+
+        // Strong-scaling points of one scenario render the same seeded image
+        if (i > 0 && point.mode == "strong" && points[i - 1].mode == "strong" &&
+            points[i - 1].scenarioName == point.scenarioName &&
+            points[i - 1].imageChecksum != point.imageChecksum) {
+            out << "  warning: image differs from " << points[i - 1].threads << " threads" << std::endl;
+        }
+    }
+}
+
+void ThreadScalingBenchmark::writeCSV(std::ostream& out, const std::vector<Point>& points) const {
+    out << "scenario,mode,threads,width,height,spp,iterations,wall_ms,speedup,efficiency,"
+           "mrays_per_second,serial_ms,mean_busy_ms,mean_idle_ms,tile_imbalance,tile_time_cv\n";
+    for (const auto& point : points) {
+        out << point.scenarioName << "," << point.mode << "," << point.threads << ","
+            << point.imageWidth << "," << point.imageHeight << "," << point.samplesPerPixel << ","
+            << point.iterations << "," << point.wallTimeMs << "," << point.speedup << ","
+            << point.efficiency << "," << point.mraysPerSecond << "," << point.serialMs << ","
+            << point.meanBusyMs << "," << point.meanIdleMs << "," << point.tileImbalance << ","
+            << point.tileTimeCV << "\n";
+    }
+}
+
+void ThreadScalingBenchmark::writeJSON(std::ostream& out, const std::vector<Point>& points) const {
+    auto write_array = [&out](const auto& values) {
+        out << "[";
+        for (size_t i = 0; i < values.size(); ++i) {
+            out << (i == 0 ? "" : ", ") << values[i];
+        }
+        out << "]";
+    };
+
+    out << "{\n  \"suite\": \"thread_scaling\",\n  \"version\": 1,\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"iterations\": " << config_.iterations << ",\n";
+    out << "  \"resolution_scale\": " << config_.resolutionScale << ",\n";
+    out << "  \"points\": [";
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Point& point = points[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"scenario\": \"" << point.scenarioName << "\""
+            << ", \"mode\": \"" << point.mode << "\""
+            << ", \"threads\": " << point.threads
+            << ", \"width\": " << point.imageWidth
+            << ", \"height\": " << point.imageHeight
+            << ", \"spp\": " << point.samplesPerPixel
+            << ",\n     \"wall_ms\": " << point.wallTimeMs
+            << ", \"speedup\": " << point.speedup
+            << ", \"efficiency\": " << point.efficiency
+            << ", \"mrays_per_second\": " << point.mraysPerSecond
+            << ", \"serial_ms\": " << point.serialMs
+            << ",\n     \"tile_imbalance\": " << point.tileImbalance
+            << ", \"tile_time_cv\": " << point.tileTimeCV
+            << ", \"image_checksum\": \"" << std::hex << point.imageChecksum << std::dec << "\""
+            << ",\n     \"thread_busy_ms\": ";
+        write_array(point.threadBusyMs);
+        out << ",\n     \"thread_idle_ms\": ";
+        write_array(point.threadIdleMs);
+        out << ",\n     \"thread_tiles\": ";
+        write_array(point.threadTiles);
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool ThreadScalingBenchmark::writeFile(const std::string& filename, const std::vector<Point>& points, bool csv) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+    if (csv) {
+        writeCSV(file, points);
+    } else {
+        writeJSON(file, points);
+    }
+    if (file.fail()) {
+        std::cerr << "Error writing to file: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Scaling results written to " << filename << std::endl;
+    return true;
+}
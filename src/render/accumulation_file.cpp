@@ -0,0 +1,477 @@
+#include "render/accumulation_file.h"
+#include "core/logger.h"
+#include "core/profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+namespace {
+
+const char MAGIC[8] = {'P', 'T', 'A', 'C', 'C', 'U', 'M', '\0'};
+constexpr uint32_t MAX_RANGES = 1u << 20;
+
+// Section sizes per pixel, in order
+constexpr size_t SUM_BYTES = 3 * sizeof(float);
+constexpr size_t COUNT_BYTES = sizeof(uint32_t);
+constexpr size_t MOMENT_BYTES = sizeof(float);
+
+template <typename T>
+void put(std::string& bytes, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "raw writes need trivially copyable types");
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void put(std::string& bytes, const Vector3& v) {
+    put(bytes, v.x);
+    put(bytes, v.y);
+    put(bytes, v.z);
+}
+
+template <typename T>
+bool get(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool get(std::istream& in, Vector3& v) {
+    return get(in, v.x) && get(in, v.y) && get(in, v.z);
+}
+
+bool same_vector(const Vector3& a, const Vector3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+std::string encode_header(const AccumulationHeader& header) {
+    std::string bytes(MAGIC, sizeof(MAGIC));
+    put(bytes, AccumulationHeader::VERSION);
+    put(bytes, header.width);
+    put(bytes, header.height);
+    put(bytes, header.max_depth);
+    put(bytes, header.seed);
+    put(bytes, header.camera_position);
+    put(bytes, header.camera_target);
+    put(bytes, header.camera_up);
+    put(bytes, header.camera_fov);
+    put(bytes, header.camera_aspect);
+    put(bytes, header.scene_hash);
+    put(bytes, static_cast<uint32_t>(header.has_variance));
+    put(bytes, static_cast<uint32_t>(header.ranges.size()));
+    for (const SampleRange& range : header.ranges) {
+        put(bytes, range.first);
+        put(bytes, range.count);
+    }
+    return bytes;
+}
+
+// Leaves in positioned at the first section
+bool decode_header(std::istream& in, AccumulationHeader& header) {
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    uint32_t has_variance = 0;
+    uint32_t range_count = 0;
+    AccumulationHeader decoded;
+    bool ok = in.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              get(in, version) && version == AccumulationHeader::VERSION &&
+              get(in, decoded.width) && get(in, decoded.height) && get(in, decoded.max_depth) &&
+              get(in, decoded.seed) &&
+              get(in, decoded.camera_position) && get(in, decoded.camera_target) && get(in, decoded.camera_up) &&
+              get(in, decoded.camera_fov) && get(in, decoded.camera_aspect) &&
+              get(in, decoded.scene_hash) && get(in, has_variance) && get(in, range_count);
+    if (!ok || decoded.width <= 0 || decoded.height <= 0 || range_count > MAX_RANGES) {
+        return false;
+    }
+    decoded.has_variance = has_variance != 0;
+    decoded.ranges.resize(range_count);
+    for (SampleRange& range : decoded.ranges) {
+        if (!get(in, range.first) || !get(in, range.count) ||
+            range.count > std::numeric_limits<uint32_t>::max() - range.first) {
+            return false;
+        }
+    }
+    header = std::move(decoded);
+    return true;
+}
+
+size_t section_bytes(const AccumulationHeader& header) {
+    return header.pixel_count() * (SUM_BYTES + COUNT_BYTES + (header.has_variance ? 2 * MOMENT_BYTES : 0));
+}
+
+// Sorts ranges and fails on any overlap; adjacent ranges are joined
+bool normalize_ranges(std::vector<SampleRange>& ranges) {
+    std::sort(ranges.begin(), ranges.end(),
+              [](const SampleRange& a, const SampleRange& b) { return a.first < b.first; });
+    std::vector<SampleRange> joined;
+    for (const SampleRange& range : ranges) {
+        if (range.count == 0) {
+            continue;
+        }
+        if (!joined.empty() && range.first < joined.back().end()) {
+            return false;
+        }
+        if (!joined.empty() && range.first == joined.back().end()) {
+            joined.back().count += range.count;
+        } else {
+            joined.push_back(range);
+        }
+    }
+    ranges = std::move(joined);
+    return true;
+}
+
+bool fail(std::string* error, const std::string& reason) {
+    LOG_WARN(LogChannel::RENDER, "Accumulation merge failed: " << reason);
+    if (error) {
+        *error = reason;
+    }
+    return false;
+}
+
+// One input as one worker sees it; every worker has its own stream
+struct MergeInput {
+    std::ifstream stream;
+    std::streamoff data_offset = 0;
+};
+
+// Reads count values of one section, starting at pixel first
+template <typename T>
+bool read_section(MergeInput& input, std::streamoff section_offset, size_t first, size_t count, T* values) {
+    input.stream.seekg(input.data_offset + section_offset + static_cast<std::streamoff>(first * sizeof(T)));
+    return static_cast<bool>(input.stream.read(reinterpret_cast<char*>(values),
+                                               static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+} // namespace
+
+bool AccumulationHeader::same_render(const AccumulationHeader& other) const {
+    return width == other.width && height == other.height && max_depth == other.max_depth &&
+           seed == other.seed &&
+           same_vector(camera_position, other.camera_position) &&
+           same_vector(camera_target, other.camera_target) &&
+           same_vector(camera_up, other.camera_up) &&
+           camera_fov == other.camera_fov && camera_aspect == other.camera_aspect &&
+           scene_hash == other.scene_hash;
+}
+
+uint64_t AccumulationHeader::pass_count() const {
+    uint64_t passes = 0;
+    for (const SampleRange& range : ranges) {
+        passes += range.count;
+    }
+    return passes;
+}
+
+bool AccumulationFile::save(const std::string& filename) const {
+    PROFILE_FUNCTION();
+    const size_t pixel_count = header.pixel_count();
+    if (sums.size() != pixel_count || sample_counts.size() != pixel_count ||
+        (header.has_variance && (luminance_sum.size() != pixel_count || luminance_sq_sum.size() != pixel_count))) {
+        return false;
+    }
+
+    std::string bytes = encode_header(header);
+    bytes.reserve(bytes.size() + section_bytes(header));
+    // Alpha is always 1 in the accumulator, so only RGB is stored
+    for (const Color& sum : sums) {
+        put(bytes, sum.r);
+        put(bytes, sum.g);
+        put(bytes, sum.b);
+    }
+    bytes.append(reinterpret_cast<const char*>(sample_counts.data()), pixel_count * COUNT_BYTES);
+    if (header.has_variance) {
+        bytes.append(reinterpret_cast<const char*>(luminance_sum.data()), pixel_count * MOMENT_BYTES);
+        bytes.append(reinterpret_cast<const char*>(luminance_sq_sum.data()), pixel_count * MOMENT_BYTES);
+    }
+
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(bytes.data(), static_cast<std::streamsize>(bytes.size())) || !file.flush()) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool AccumulationFile::read_header(const std::string& filename, AccumulationHeader& header) {
+    std::ifstream file(filename, std::ios::binary);
+    return file && decode_header(file, header);
+}
+
+bool AccumulationFile::load(const std::string& filename, AccumulationFile& file) {
+    std::ifstream in(filename, std::ios::binary);
+    AccumulationFile loaded;
+    if (!in || !decode_header(in, loaded.header)) {
+        return false;
+    }
+
+    const size_t pixel_count = loaded.header.pixel_count();
+    std::vector<float> rgb(pixel_count * 3);
+    loaded.sample_counts.resize(pixel_count);
+    bool ok = in.read(reinterpret_cast<char*>(rgb.data()), static_cast<std::streamsize>(rgb.size() * sizeof(float))) &&
+              in.read(reinterpret_cast<char*>(loaded.sample_counts.data()),
+                      static_cast<std::streamsize>(pixel_count * COUNT_BYTES));
+    if (ok && loaded.header.has_variance) {
+        loaded.luminance_sum.resize(pixel_count);
+        loaded.luminance_sq_sum.resize(pixel_count);
+        ok = in.read(reinterpret_cast<char*>(loaded.luminance_sum.data()),
+                     static_cast<std::streamsize>(pixel_count * MOMENT_BYTES)) &&
+             in.read(reinterpret_cast<char*>(loaded.luminance_sq_sum.data()),
+                     static_cast<std::streamsize>(pixel_count * MOMENT_BYTES));
+    }
+    // Trailing bytes mean the file was not written by save()
+    if (!ok || in.peek() != std::char_traits<char>::eof()) {
+        return false;
+    }
+
+    loaded.sums.resize(pixel_count);
+    for (size_t i = 0; i < pixel_count; ++i) {
+        loaded.sums[i] = Color(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+    }
+    file = std::move(loaded);
+    return true;
+}
+
+bool merge_accumulation_files(const std::vector<std::string>& inputs, const AccumulationMergeOptions& options,
+                              AccumulationHeader* merged, std::string* error) {
+    PROFILE_FUNCTION();
+    auto start = std::chrono::steady_clock::now();
+    if (inputs.empty()) {
+        return fail(error, "no input files");
+    }
+    if (options.output.empty() && options.image.empty()) {
+        return fail(error, "no output requested");
+    }
+
+    // Headers first, so mismatches are reported before any pixel is read
+    std::vector<AccumulationHeader> headers(inputs.size());
+    std::vector<std::streamoff> data_offsets(inputs.size());
+    AccumulationHeader result;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        std::ifstream file(inputs[i], std::ios::binary);
+        if (!file || !decode_header(file, headers[i])) {
+            return fail(error, "cannot read accumulation header of " + inputs[i]);
+        }
+        data_offsets[i] = file.tellg();
+        file.seekg(0, std::ios::end);
+        if (file.tellg() != data_offsets[i] + static_cast<std::streamoff>(section_bytes(headers[i]))) {
+            return fail(error, inputs[i] + " is truncated or has trailing data");
+        }
+        if (i == 0) {
+            result = headers[0];
+            result.ranges.clear();
+        } else if (!headers[i].same_render(result)) {
+            return fail(error, inputs[i] + " is from a different render than " + inputs[0] +
+                        " (resolution, depth, seed, camera or scene differ)");
+        }
+        result.has_variance = result.has_variance && headers[i].has_variance;
+        result.ranges.insert(result.ranges.end(), headers[i].ranges.begin(), headers[i].ranges.end());
+    }
+    if (!normalize_ranges(result.ranges)) {
+        return fail(error, "inputs overlap in sample passes; their samples are correlated and cannot be added");
+    }
+
+    const int width = result.width;
+    const int height = result.height;
+    const size_t pixel_count = result.pixel_count();
+    const std::string output_temporary = options.output + ".tmp";
+    const std::string image_temporary = options.image + ".tmp";
+    std::mutex write_mutex;
+    std::ofstream output;
+    std::ofstream image;
+    std::streamoff output_data = 0;
+    std::streamoff image_data = 0;
+    if (!options.output.empty()) {
+        output.open(output_temporary, std::ios::binary | std::ios::trunc);
+        const std::string header = encode_header(result);
+        output.write(header.data(), static_cast<std::streamsize>(header.size()));
+        output_data = static_cast<std::streamoff>(header.size());
+        if (!output) {
+            return fail(error, "cannot write " + options.output);
+        }
+    }
+    if (!options.image.empty()) {
+        // Negative scale marks little-endian data; PFM rows run bottom to top
+        std::ostringstream pfm_header;
+        pfm_header << "PF\n" << width << " " << height << "\n-1.0\n";
+        image.open(image_temporary, std::ios::binary | std::ios::trunc);
+        image << pfm_header.str();
+        image_data = static_cast<std::streamoff>(pfm_header.str().size());
+        if (!image) {
+            if (output.is_open()) {
+                output.close();
+                std::remove(output_temporary.c_str());
+            }
+            return fail(error, "cannot write " + options.image);
+        }
+    }
+
+    const int band_rows = std::max(1, options.band_rows);
+    const int band_count = (height + band_rows - 1) / band_rows;
+    int thread_count = options.threads > 0 ? options.threads
+                                           : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    thread_count = std::min(thread_count, band_count);
+    std::atomic<int> next_band(0);
+    std::atomic<bool> failed(false);
+    std::string failure;
+
+    auto worker = [&]() {
+        PROFILE_THREAD_NAME("Accumulation merge");
+        std::vector<MergeInput> streams(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            streams[i].stream.open(inputs[i], std::ios::binary);
+            streams[i].data_offset = data_offsets[i];
+        }
+
+        // Sums accumulate in double so many inputs do not lose low-order bits
+        const size_t band_pixels = static_cast<size_t>(band_rows) * width;
+        std::vector<double> sum(band_pixels * 3);
+        std::vector<uint32_t> count(band_pixels);
+        std::vector<double> moment(result.has_variance ? band_pixels : 0);
+        std::vector<double> moment_sq(moment.size());
+        std::vector<float> floats(band_pixels * 3);
+        std::vector<uint32_t> counts(band_pixels);
+
+        for (int band = next_band++; band < band_count && !failed; band = next_band++) {
+            PROFILE_ZONE("merge band");
+            const int y0 = band * band_rows;
+            const int y1 = std::min(height, y0 + band_rows);
+            const size_t first = static_cast<size_t>(y0) * width;
+            const size_t n = static_cast<size_t>(y1 - y0) * width;
+            std::fill(sum.begin(), sum.begin() + n * 3, 0.0);
+            std::fill(count.begin(), count.begin() + n, 0u);
+            std::fill(moment.begin(), moment.end(), 0.0);
+            std::fill(moment_sq.begin(), moment_sq.end(), 0.0);
+
+            for (size_t i = 0; i < streams.size(); ++i) {
+                MergeInput& input = streams[i];
+                const std::streamoff counts_offset = static_cast<std::streamoff>(pixel_count * SUM_BYTES);
+                bool ok = read_section(input, 0, first * 3, n * 3, floats.data()) &&
+                          read_section(input, counts_offset, first, n, counts.data());
+                for (size_t k = 0; ok && k < n * 3; ++k) {
+                    sum[k] += floats[k];
+                }
+                for (size_t k = 0; ok && k < n; ++k) {
+                    count[k] += counts[k];
+                }
+                if (ok && result.has_variance) {
+                    const std::streamoff moments_offset = counts_offset + static_cast<std::streamoff>(pixel_count * COUNT_BYTES);
+                    ok = read_section(input, moments_offset, first, n, floats.data());
+                    for (size_t k = 0; ok && k < n; ++k) {
+                        moment[k] += floats[k];
+                    }
+                    ok = ok && read_section(input, moments_offset + static_cast<std::streamoff>(pixel_count * MOMENT_BYTES),
+                                            first, n, floats.data());
+                    for (size_t k = 0; ok && k < n; ++k) {
+                        moment_sq[k] += floats[k];
+                    }
+                }
+                if (!ok) {
+                    std::lock_guard<std::mutex> lock(write_mutex);
+                    failure = "read error in " + inputs[i];
+                    failed = true;
+                    return;
+                }
+            }
+
+            // Sections are written in place, so bands may finish in any order
+            std::lock_guard<std::mutex> lock(write_mutex);
+            if (output.is_open()) {
+                for (size_t k = 0; k < n * 3; ++k) {
+                    floats[k] = static_cast<float>(sum[k]);
+                }
+                output.seekp(output_data + static_cast<std::streamoff>(first * SUM_BYTES));
+                output.write(reinterpret_cast<const char*>(floats.data()), static_cast<std::streamsize>(n * SUM_BYTES));
+                output.seekp(output_data + static_cast<std::streamoff>(pixel_count * SUM_BYTES + first * COUNT_BYTES));
+                output.write(reinterpret_cast<const char*>(count.data()), static_cast<std::streamsize>(n * COUNT_BYTES));
+                if (result.has_variance) {
+                    const std::streamoff moments_offset =
+                        output_data + static_cast<std::streamoff>(pixel_count * (SUM_BYTES + COUNT_BYTES));
+                    for (int section = 0; section < 2; ++section) {
+                        const std::vector<double>& values = section == 0 ? moment : moment_sq;
+                        for (size_t k = 0; k < n; ++k) {
+                            floats[k] = static_cast<float>(values[k]);
+                        }
+                        output.seekp(moments_offset +
+                                     static_cast<std::streamoff>((section * pixel_count + first) * MOMENT_BYTES));
+                        output.write(reinterpret_cast<const char*>(floats.data()), static_cast<std::streamsize>(n * MOMENT_BYTES));
+                    }
+                }
+            }
+            if (image.is_open()) {
+                for (size_t k = 0; k < n; ++k) {
+                    const double inv = count[k] > 0 ? 1.0 / count[k] : 0.0;
+                    for (int c = 0; c < 3; ++c) {
+                        floats[3 * k + c] = static_cast<float>(sum[3 * k + c] * inv);
+                    }
+                }
+                const size_t row_bytes = static_cast<size_t>(width) * SUM_BYTES;
+                for (int y = y0; y < y1; ++y) {
+                    image.seekp(image_data + static_cast<std::streamoff>((height - 1 - y) * row_bytes));
+                    image.write(reinterpret_cast<const char*>(floats.data() + static_cast<size_t>(y - y0) * width * 3),
+                                static_cast<std::streamsize>(row_bytes));
+                }
+            }
+            if ((output.is_open() && !output) || (image.is_open() && !image)) {
+                failure = "write error";
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < thread_count; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    // Nothing is renamed into place unless both outputs are complete
+    bool ok = !failed;
+    if (output.is_open()) {
+        output.close();
+        ok = ok && !output.fail();
+    }
+    if (image.is_open()) {
+        image.close();
+        ok = ok && !image.fail();
+    }
+    bool output_renamed = false;
+    if (ok && !options.output.empty()) {
+        ok = output_renamed = std::rename(output_temporary.c_str(), options.output.c_str()) == 0;
+    }
+    if (ok && !options.image.empty()) {
+        ok = std::rename(image_temporary.c_str(), options.image.c_str()) == 0;
+    }
+    if (!ok) {
+        if (!options.output.empty()) {
+            std::remove((output_renamed ? options.output : output_temporary).c_str());
+        }
+        if (!options.image.empty()) {
+            std::remove(image_temporary.c_str());
+        }
+        return fail(error, failure.empty() ? "cannot write merge output" : failure);
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO(LogChannel::RENDER, "Merged " << inputs.size() << " accumulation files (" << result.pass_count()
+             << " passes) on " << thread_count << " threads in " << ms << " ms");
+    if (merged) {
+        *merged = result;
+    }
+    return true;
+}
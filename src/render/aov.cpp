@@ -0,0 +1,87 @@
+#include "render/aov.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+uint32_t hash_float(uint32_t hash, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // FNV-1a over the four bytes
+    for (int i = 0; i < 4; ++i) {
+        hash ^= (bits >> (i * 8)) & 0xFFu;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+void allocate_if(bool wanted, std::vector<T>& buffer, size_t count, const T& value) {
+    if (wanted) {
+        buffer.assign(count, value);
+    } else {
+        std::vector<T>().swap(buffer);
+    }
+}
+
+} // namespace
+
+const char* aov_name(AOVType type) {
+    switch (type) {
+        case AOVType::DEPTH: return "depth";
+        case AOVType::NORMAL: return "normal";
+        case AOVType::ALBEDO: return "albedo";
+        case AOVType::PRIMITIVE_ID: return "primitive_id";
+        case AOVType::MATERIAL_ID: return "material_id";
+        case AOVType::SAMPLE_COUNT: return "sample_count";
+    }
+    return "unknown";
+}
+
+void AOVBuffers::allocate(AOVMask requested, int w, int h) {
+    width = w;
+    height = h;
+    mask = requested & AOV_ALL;
+    const size_t count = static_cast<size_t>(std::max(0, w)) * std::max(0, h);
+
+    allocate_if(has(AOVType::DEPTH), depth, count, 0.0f);
+    allocate_if(has(AOVType::NORMAL), normal, count, Vector3(0, 0, 0));
+    allocate_if(has(AOVType::ALBEDO), albedo, count, Color(1, 1, 1));
+    allocate_if(has(AOVType::PRIMITIVE_ID), primitive_id, count, 0u);
+    allocate_if(has(AOVType::MATERIAL_ID), material_id, count, 0u);
+    allocate_if(has(AOVType::SAMPLE_COUNT), sample_count, count, 0u);
+}
+
+void AOVBuffers::write_hit(size_t index, const HitRecord& hit, uint32_t id) {
+    if (!depth.empty()) depth[index] = hit.t;
+    if (!normal.empty()) normal[index] = hit.normal;
+    if (!albedo.empty()) albedo[index] = hit.material.albedo;
+    if (!primitive_id.empty()) primitive_id[index] = id;
+    if (!material_id.empty()) material_id[index] = material_id_for(hit.material);
+}
+
+void AOVBuffers::clear_pixel(size_t index) {
+    if (!depth.empty()) depth[index] = 0.0f;
+    if (!normal.empty()) normal[index] = Vector3(0, 0, 0);
+    if (!albedo.empty()) albedo[index] = Color(1, 1, 1);
+    if (!primitive_id.empty()) primitive_id[index] = 0u;
+    if (!material_id.empty()) material_id[index] = 0u;
+    if (!sample_count.empty()) sample_count[index] = 0u;
+}
+
+void AOVBuffers::fill_sample_count(uint32_t samples) {
+    std::fill(sample_count.begin(), sample_count.end(), samples);
+}
+
+uint32_t AOVBuffers::material_id_for(const Material& material) {
+    uint32_t hash = 2166136261u;
+    hash = hash_float(hash, material.albedo.r);
+    hash = hash_float(hash, material.albedo.g);
+    hash = hash_float(hash, material.albedo.b);
+    hash = hash_float(hash, material.roughness);
+    hash = hash_float(hash, material.metallic);
+    hash = hash_float(hash, material.emission);
+    // 24 bits survive a round trip through float buffers; 0 is background
+    hash = (hash ^ (hash >> 24)) & 0xFFFFFFu;
+    return hash == 0 ? 1u : hash;
+}
@@ -0,0 +1,122 @@
+#include "render/cost_heatmap.h"
+#include "render/image_output.h"
+#include <algorithm>
+
+namespace {
+
+// Dark blue -> cyan -> green -> yellow -> red
+Color heat_color(float t) {
+    static const Color stops[] = {
+        Color(0.0f, 0.0f, 0.3f), Color(0.0f, 0.6f, 1.0f), Color(0.0f, 0.9f, 0.2f),
+        Color(1.0f, 0.9f, 0.0f), Color(1.0f, 0.1f, 0.0f)
+    };
+    const int last = static_cast<int>(sizeof(stops) / sizeof(stops[0])) - 1;
+    t = std::clamp(t, 0.0f, 1.0f) * last;
+    int i = std::min(static_cast<int>(t), last - 1);
+    float f = t - i;
+    return stops[i] * (1.0f - f) + stops[i + 1] * f;
+}
+
+} // namespace
+
+const char* heatmap_metric_name(HeatmapMetric metric) {
+    switch (metric) {
+        case HeatmapMetric::CYCLES: return "cycles";
+        case HeatmapMetric::INTERSECTION_TESTS: return "intersection_tests";
+        case HeatmapMetric::BOUNCES: return "bounces";
+    }
+    return "unknown";
+}
+
+CostHeatmap::CostHeatmap()
+    : width_(0), height_(0) {
+}
+
+void CostHeatmap::allocate(int width, int height) {
+    width_ = width;
+    height_ = height;
+    size_t count = static_cast<size_t>(std::max(0, width)) * std::max(0, height);
+    cycles_.assign(count, 0.0f);
+    intersection_tests_.assign(count, 0.0f);
+    bounces_.assign(count, 0.0f);
+}
+
+void CostHeatmap::clear() {
+    width_ = 0;
+    height_ = 0;
+    std::vector<float>().swap(cycles_);
+    std::vector<float>().swap(intersection_tests_);
+    std::vector<float>().swap(bounces_);
+}
+
+void CostHeatmap::add(int index, uint64_t cycles, uint64_t intersection_tests, uint64_t bounces) {
+    cycles_[index] += static_cast<float>(cycles);
+    intersection_tests_[index] += static_cast<float>(intersection_tests);
+    bounces_[index] += static_cast<float>(bounces);
+}
+
+const std::vector<float>& CostHeatmap::values(HeatmapMetric metric) const {
+    switch (metric) {
+        case HeatmapMetric::INTERSECTION_TESTS: return intersection_tests_;
+        case HeatmapMetric::BOUNCES: return bounces_;
+        case HeatmapMetric::CYCLES:
+        default: return cycles_;
+    }
+}
+
+float CostHeatmap::value(HeatmapMetric metric, int index) const {
+    return values(metric)[index];
+}
+
+double CostHeatmap::total(HeatmapMetric metric) const {
+    double sum = 0.0;
+    for (float v : values(metric)) {
+        sum += v;
+    }
+    return sum;
+}
+
+std::vector<Color> CostHeatmap::false_color(HeatmapMetric metric) const {
+    const std::vector<float>& data = values(metric);
+    std::vector<Color> image(data.size());
+    if (data.empty()) {
+        return image;
+    }
+
+    // A few pathological pixels would otherwise flatten the rest of the map
+    std::vector<float> sorted = data;
+    size_t rank = std::min(sorted.size() - 1, sorted.size() * 99 / 100);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    float scale = sorted[rank] > 0.0f ? 1.0f / sorted[rank] : 0.0f;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        image[i] = heat_color(data[i] * scale);
+    }
+    return image;
+}
+
+void CostHeatmap::overlay(std::vector<Color>& image, HeatmapMetric metric, float opacity) const {
+    if (image.size() != cycles_.size()) {
+        return;
+    }
+    std::vector<Color> heat = false_color(metric);
+    for (size_t i = 0; i < image.size(); ++i) {
+        // Keep a little of the luminance so the scene stays recognisable
+        float l = 0.2126f * image[i].r + 0.7152f * image[i].g + 0.0722f * image[i].b;
+        Color base(l, l, l);
+        image[i] = base * (1.0f - opacity) + heat[i] * opacity;
+    }
+}
+
+bool CostHeatmap::save(const std::string& filename, HeatmapMetric metric) const {
+    const std::vector<float>& data = values(metric);
+    if (data.empty()) {
+        return false;
+    }
+
+    std::vector<float> rgb(data.size() * 3);
+    for (size_t i = 0; i < data.size(); ++i) {
+        rgb[i * 3 + 0] = rgb[i * 3 + 1] = rgb[i * 3 + 2] = data[i];
+    }
+    return ImageOutput::write_pfm(filename, width_, height_, rgb);
+}
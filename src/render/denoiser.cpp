@@ -0,0 +1,268 @@
+#include "render/denoiser.h"
+#include "core/profiler.h"
+#include "performance/hw_counters.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// B3 spline taps of the à-trous kernel
+constexpr float KERNEL[5] = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+constexpr float GAUSS3[3] = {0.25f, 0.5f, 0.25f};
+constexpr float ALBEDO_EPSILON = 1e-3f;
+
+inline float luminance(float r, float g, float b) {
+    return 0.2126f * r + 0.7152f * g + 0.0722f * b;
+}
+
+inline float sanitize(float v) {
+    return std::isfinite(v) ? v : 0.0f;
+}
+
+} // namespace
+
+// Planar copies of the inputs; one float array per channel
+struct Denoiser::Planes {
+    int width = 0;
+    int height = 0;
+    std::vector<float> r, g, b;           // Illumination (colour / albedo)
+    std::vector<float> ar, ag, ab;        // Albedo used for remodulation
+    std::vector<float> nx, ny, nz;
+    std::vector<float> depth;
+    std::vector<float> depth_gradient;    // Screen-space depth change per pixel
+    std::vector<float> variance;
+
+    void resize(size_t count) {
+        for (auto* plane : {&r, &g, &b, &ar, &ag, &ab, &nx, &ny, &nz, &depth, &depth_gradient, &variance}) {
+            plane->assign(count, 0.0f);
+        }
+    }
+};
+
+Denoiser::Denoiser(const DenoiserConfig& config)
+    : config_(config) {
+}
+
+bool Denoiser::denoise(std::vector<Color>& color, int width, int height, const AOVBuffers& features,
+                       const std::vector<float>& variance) const {
+    PROFILE_FUNCTION();
+    const size_t count = static_cast<size_t>(width) * height;
+    if (width <= 0 || height <= 0 || color.size() != count || !features.matches(width, height) ||
+        !features.has_all(AOV_DENOISE_FEATURES)) {
+        return false;
+    }
+    if (!variance.empty() && variance.size() != count) {
+        return false;
+    }
+
+    Planes planes;
+    planes.width = width;
+    planes.height = height;
+    planes.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const bool background = features.depth[i] <= 0.0f;
+        const Color albedo = background ? Color(1, 1, 1) : features.albedo[i];
+
+        if (config_.demodulate_albedo) {
+            planes.ar[i] = std::max(albedo.r, ALBEDO_EPSILON);
+            planes.ag[i] = std::max(albedo.g, ALBEDO_EPSILON);
+            planes.ab[i] = std::max(albedo.b, ALBEDO_EPSILON);
+        } else {
+            planes.ar[i] = planes.ag[i] = planes.ab[i] = 1.0f;
+        }
+        planes.r[i] = sanitize(color[i].r) / planes.ar[i];
+        planes.g[i] = sanitize(color[i].g) / planes.ag[i];
+        planes.b[i] = sanitize(color[i].b) / planes.ab[i];
+
+        // Background shares one normal so the depth term alone separates it
+        Vector3 n = features.normal[i];
+        if (background || n.length_squared() < 1e-8f) {
+            n = Vector3(0, 0, 1);
+        }
+        planes.nx[i] = n.x;
+        planes.ny[i] = n.y;
+        planes.nz[i] = n.z;
+        planes.depth[i] = background ? 0.0f : features.depth[i];
+
+        if (!variance.empty()) {
+            float albedo_luminance = std::max(luminance(planes.ar[i], planes.ag[i], planes.ab[i]), ALBEDO_EPSILON);
+            planes.variance[i] = sanitize(variance[i]) / (albedo_luminance * albedo_luminance);
+        }
+    }
+
+    // Smallest one-sided difference per axis so silhouettes don't widen the gradient
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const size_t i = static_cast<size_t>(y) * width + x;
+            const float z = planes.depth[i];
+            float gx = std::numeric_limits<float>::max();
+            float gy = std::numeric_limits<float>::max();
+            if (x > 0) gx = std::min(gx, std::abs(z - planes.depth[i - 1]));
+            if (x + 1 < width) gx = std::min(gx, std::abs(z - planes.depth[i + 1]));
+            if (y > 0) gy = std::min(gy, std::abs(z - planes.depth[i - width]));
+            if (y + 1 < height) gy = std::min(gy, std::abs(z - planes.depth[i + width]));
+            if (gx == std::numeric_limits<float>::max()) gx = 0.0f;
+            if (gy == std::numeric_limits<float>::max()) gy = 0.0f;
+            planes.depth_gradient[i] = std::sqrt(gx * gx + gy * gy);
+        }
+    }
+
+    if (variance.empty()) {
+        estimate_variance(planes);
+    }
+
+    // Ping-pong between the input planes and scratch planes
+    std::vector<float> r2(count), g2(count), b2(count), var2(count);
+    std::vector<float> r1 = planes.r, g1 = planes.g, b1 = planes.b, var1 = planes.variance;
+    for (int iteration = 0; iteration < config_.iterations; ++iteration) {
+        filter_pass(planes, 1 << iteration, r1.data(), g1.data(), b1.data(), var1.data(),
+                    r2.data(), g2.data(), b2.data(), var2.data());
+        std::swap(r1, r2);
+        std::swap(g1, g2);
+        std::swap(b1, b2);
+        std::swap(var1, var2);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        color[i] = Color(r1[i] * planes.ar[i], g1[i] * planes.ag[i], b1[i] * planes.ab[i], color[i].a);
+    }
+    return true;
+}
+
+void Denoiser::estimate_variance(Planes& planes) const {
+    const int width = planes.width;
+    const int height = planes.height;
+
+    scheduler_.run(width, height, [&](const RenderTile& tile, int thread_index) {
+        HwStageScope counters("denoise variance", thread_index);
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                const size_t p = static_cast<size_t>(y) * width + x;
+                const float zp = planes.depth[p];
+                float sum_weight = 0.0f, sum_l = 0.0f, sum_l2 = 0.0f;
+
+                for (int dy = -1; dy <= 1; ++dy) {
+                    int qy = y + dy;
+                    if (qy < 0 || qy >= height) continue;
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        int qx = x + dx;
+                        if (qx < 0 || qx >= width) continue;
+                        const size_t q = static_cast<size_t>(qy) * width + qx;
+
+                        // Only pool pixels from the same surface
+                        float n_dot = planes.nx[p] * planes.nx[q] + planes.ny[p] * planes.ny[q] + planes.nz[p] * planes.nz[q];
+                        float z_scale = config_.sigma_depth * planes.depth_gradient[p] + 1e-3f;
+                        if (n_dot < 0.9f || std::abs(zp - planes.depth[q]) > z_scale * 2.0f) continue;
+
+                        float l = luminance(planes.r[q], planes.g[q], planes.b[q]);
+                        sum_weight += 1.0f;
+                        sum_l += l;
+                        sum_l2 += l * l;
+                    }
+                }
+
+                float mean = sum_l / sum_weight;
+                planes.variance[p] = std::max(0.0f, sum_l2 / sum_weight - mean * mean);
+            }
+        }
+    });
+}
+
+void Denoiser::filter_pass(const Planes& planes, int step, const float* in_r, const float* in_g, const float* in_b,
+                           const float* in_var, float* out_r, float* out_g, float* out_b, float* out_var) const {
+    const int width = planes.width;
+    const int height = planes.height;
+    const float* nx = planes.nx.data();
+    const float* ny = planes.ny.data();
+    const float* nz = planes.nz.data();
+    const float* depth = planes.depth.data();
+    const float* depth_gradient = planes.depth_gradient.data();
+    const float sigma_luminance = config_.sigma_luminance;
+    const float sigma_normal = config_.sigma_normal;
+    const float sigma_depth = config_.sigma_depth;
+
+    scheduler_.run(width, height, [&](const RenderTile& tile, int thread_index) {
+        HwStageScope counters("denoise filter", thread_index);
+        const int span = tile.width();
+        std::vector<float> sum_r(span), sum_g(span), sum_b(span), sum_w(span), sum_var(span);
+        std::vector<float> centre_l(span), luminance_scale(span), depth_scale(span);
+
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            const size_t row = static_cast<size_t>(y) * width;
+
+            // Per-pixel edge-stopping scales from the 3x3 blurred variance
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                float blurred = 0.0f;
+                float weight = 0.0f;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    int qy = std::min(std::max(y + dy, 0), height - 1);
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        int qx = std::min(std::max(x + dx, 0), width - 1);
+                        float k = GAUSS3[dx + 1] * GAUSS3[dy + 1];
+                        blurred += k * in_var[static_cast<size_t>(qy) * width + qx];
+                        weight += k;
+                    }
+                }
+                const size_t p = row + x;
+                const int i = x - tile.x0;
+                centre_l[i] = luminance(in_r[p], in_g[p], in_b[p]);
+                luminance_scale[i] = 1.0f / (sigma_luminance * std::sqrt(std::max(blurred / weight, 0.0f)) + 1e-4f);
+                depth_scale[i] = sigma_depth * depth_gradient[p];
+            }
+
+            std::fill(sum_r.begin(), sum_r.end(), 0.0f);
+            std::fill(sum_g.begin(), sum_g.end(), 0.0f);
+            std::fill(sum_b.begin(), sum_b.end(), 0.0f);
+            std::fill(sum_w.begin(), sum_w.end(), 0.0f);
+            std::fill(sum_var.begin(), sum_var.end(), 0.0f);
+
+            for (int ky = 0; ky < 5; ++ky) {
+                const int qy = y + (ky - 2) * step;
+                if (qy < 0 || qy >= height) continue;
+                const size_t q_row = static_cast<size_t>(qy) * width;
+
+                for (int kx = 0; kx < 5; ++kx) {
+                    const int dx = (kx - 2) * step;
+                    const int x_begin = std::max(tile.x0, -dx);
+                    const int x_end = std::min(tile.x1, width - dx);
+                    const float kernel = KERNEL[kx] * KERNEL[ky];
+                    const float distance = step * std::sqrt(float((kx - 2) * (kx - 2) + (ky - 2) * (ky - 2)));
+
+                    // Branch-free over a contiguous run of pixels
+                    for (int x = x_begin; x < x_end; ++x) {
+                        const size_t p = row + x;
+                        const size_t q = q_row + x + dx;
+                        const int i = x - tile.x0;
+
+                        float lq = luminance(in_r[q], in_g[q], in_b[q]);
+                        float n_dot = std::max(0.0f, nx[p] * nx[q] + ny[p] * ny[q] + nz[p] * nz[q]);
+                        float w_normal = std::pow(n_dot, sigma_normal);
+                        float w_luminance = std::abs(centre_l[i] - lq) * luminance_scale[i];
+                        float w_depth = std::abs(depth[p] - depth[q]) /
+                                        (depth_scale[i] * distance + 1e-3f * (1.0f + depth[p]));
+                        float w = kernel * w_normal * std::exp(-w_luminance - w_depth);
+
+                        sum_r[i] += w * in_r[q];
+                        sum_g[i] += w * in_g[q];
+                        sum_b[i] += w * in_b[q];
+                        sum_w[i] += w;
+                        sum_var[i] += w * w * in_var[q];
+                    }
+                }
+            }
+
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                const size_t p = row + x;
+                const int i = x - tile.x0;
+                // The centre tap always has weight KERNEL[2]^2, so sum_w > 0
+                float inv = 1.0f / sum_w[i];
+                out_r[p] = sum_r[i] * inv;
+                out_g[p] = sum_g[i] * inv;
+                out_b[p] = sum_b[i] * inv;
+                out_var[p] = sum_var[i] * inv * inv;
+            }
+        }
+    });
+}
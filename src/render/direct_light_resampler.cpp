@@ -0,0 +1,357 @@
+#include "render/direct_light_resampler.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+#include "core/ray_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float PI = 3.14159265358979323846f;
+
+float luminance(const Color& c) {
+    return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
+}
+
+} // namespace
+
+// Stateless per-pixel generator (PCG hash) so every pixel draws the same
+// sequence regardless of which worker thread processes its tile.
+class DirectLightResampler::PixelRandom {
+public:
+    PixelRandom(int x, int y, uint32_t frame, uint32_t pass)
+        : state_(hash(static_cast<uint32_t>(x) * 1973u + static_cast<uint32_t>(y) * 9277u +
+                      frame * 26699u + pass * 104729u)) {}
+
+    float next() {
+        state_ = hash(state_);
+        return static_cast<float>(state_ >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    static uint32_t hash(uint32_t v) {
+        uint32_t state = v * 747796405u + 2891336453u;
+        uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+
+    uint32_t state_;
+};
+
+bool Reservoir::update(const LightSample& candidate, float weight, float candidate_target_pdf, float random) {
+    M += 1.0f;
+    if (weight <= 0.0f) {
+        return false;
+    }
+    weight_sum += weight;
+    if (random * weight_sum < weight) {
+        sample = candidate;
+        target_pdf = candidate_target_pdf;
+        return true;
+    }
+    return false;
+}
+
+void Reservoir::finalize() {
+    W = (target_pdf > 0.0f && M > 0.0f) ? weight_sum / (M * target_pdf) : 0.0f;
+}
+
+DirectLightResampler::DirectLightResampler()
+    : width_(0), height_(0), frame_index_(0), history_valid_(false) {
+}
+
+void DirectLightResampler::set_scene_manager(std::shared_ptr<SceneManager> scene_manager) {
+    scene_manager_ = scene_manager;
+    reset_history();
+}
+
+void DirectLightResampler::reset_history() {
+    history_valid_ = false;
+}
+
+void DirectLightResampler::begin_frame(int width, int height, const Camera& camera) {
+    size_t pixel_count = static_cast<size_t>(width) * height;
+    if (width != width_ || height != height_) {
+        width_ = width;
+        height_ = height;
+        initial_.assign(pixel_count, Reservoir());
+        final_.assign(pixel_count, Reservoir());
+        history_.assign(pixel_count, Reservoir());
+        history_surfaces_.assign(pixel_count, ResamplingSurface());
+        history_valid_ = false;
+    }
+
+    // Emissive spheres are sampled as lights; other emitters reach the image
+    // through indirect bounces, which must keep counting their emission.
+    lights_.clear();
+    light_objects_.clear();
+    if (scene_manager_) {
+        const auto& objects = scene_manager_->get_objects();
+        light_objects_.assign(objects.size(), 0);
+        for (size_t i = 0; i < objects.size(); ++i) {
+            const auto& object = objects[i];
+            if (!object || !object->material().is_emissive()) continue;
+            auto sphere = std::dynamic_pointer_cast<Sphere>(object);
+            if (!sphere) continue;
+            light_objects_[i] = 1;
+
+            EmissiveSphere light;
+            light.center = sphere->position();
+            light.radius = sphere->radius();
+            light.radiance = object->material().albedo * object->material().emission;
+            light.area = 4.0f * PI * light.radius * light.radius;
+            lights_.push_back(light);
+        }
+    }
+
+    current_camera_ = camera;
+    ++frame_index_;
+}
+
+void DirectLightResampler::sample_initial(const RenderTile& tile, const std::vector<ResamplingSurface>& surfaces) {
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        for (int x = tile.x0; x < tile.x1; ++x) {
+            int index = y * width_ + x;
+            const ResamplingSurface& surface = surfaces[index];
+            Reservoir reservoir;
+
+            if (!surface.valid || lights_.empty()) {
+                initial_[index] = reservoir;
+                continue;
+            }
+
+            PixelRandom random(x, y, frame_index_, 0);
+
+            // Resampled importance sampling over cheap, unshadowed candidates
+            for (int c = 0; c < config_.initial_candidates; ++c) {
+                LightSample candidate = sample_light(random);
+                float p_hat = target_pdf(candidate, surface);
+                float weight = p_hat / source_pdf(candidate);
+                reservoir.update(candidate, weight, p_hat, random.next());
+            }
+            reservoir.finalize();
+
+            // Only the winner pays for a shadow ray
+            if (reservoir.W > 0.0f && !visible(reservoir.sample, surface)) {
+                reservoir.W = 0.0f;
+            }
+
+            if (config_.temporal_reuse && history_valid_) {
+                int px, py;
+                if (reproject(surface.position, px, py)) {
+                    int history_index = py * width_ + px;
+                    ResamplingSurface expected = surface;
+                    expected.depth = (surface.position - history_camera_.get_position()).length();
+
+                    if (similar(expected, history_surfaces_[history_index])) {
+                        Reservoir previous = history_[history_index];
+                        previous.M = std::min(previous.M, config_.history_limit * std::max(reservoir.M, 1.0f));
+
+                        // Re-validate: the light may be gone or newly occluded
+                        if (previous.W > 0.0f &&
+                            (!resolve(previous.sample) || !visible(previous.sample, surface))) {
+                            previous.W = 0.0f;
+                        }
+
+                        Reservoir combined;
+                        merge(combined, reservoir, surface, random);
+                        merge(combined, previous, surface, random);
+                        combined.finalize();
+                        reservoir = combined;
+                    }
+                }
+            }
+
+            initial_[index] = reservoir;
+        }
+    }
+}
+
+void DirectLightResampler::reuse_spatial(const RenderTile& tile, const std::vector<ResamplingSurface>& surfaces) {
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        for (int x = tile.x0; x < tile.x1; ++x) {
+            int index = y * width_ + x;
+            const ResamplingSurface& surface = surfaces[index];
+
+            if (!config_.spatial_reuse || !surface.valid || lights_.empty()) {
+                final_[index] = initial_[index];
+                continue;
+            }
+
+            PixelRandom random(x, y, frame_index_, 1);
+            Reservoir combined;
+            merge(combined, initial_[index], surface, random);
+
+            for (int n = 0; n < config_.spatial_samples; ++n) {
+                float radius = config_.spatial_radius * std::sqrt(random.next());
+                float angle = 2.0f * PI * random.next();
+                int nx = x + static_cast<int>(std::lround(radius * std::cos(angle)));
+                int ny = y + static_cast<int>(std::lround(radius * std::sin(angle)));
+                if (nx < 0 || ny < 0 || nx >= width_ || ny >= height_ || (nx == x && ny == y)) {
+                    continue;
+                }
+
+                int neighbour = ny * width_ + nx;
+                if (!similar(surface, surfaces[neighbour])) {
+                    continue;
+                }
+                merge(combined, initial_[neighbour], surface, random);
+            }
+
+            combined.finalize();
+            final_[index] = combined;
+        }
+    }
+}
+
+Color DirectLightResampler::shade(int x, int y, const ResamplingSurface& surface) const {
+    if (!surface.valid || lights_.empty()) {
+        return Color(0, 0, 0);
+    }
+
+    const Reservoir& reservoir = final_[y * width_ + x];
+    if (reservoir.W <= 0.0f) {
+        return Color(0, 0, 0);
+    }
+
+    LightSample sample = reservoir.sample;
+    if (!resolve(sample) || !visible(sample, surface)) {
+        return Color(0, 0, 0);
+    }
+    return unshadowed_contribution(sample, surface) * reservoir.W;
+}
+
+void DirectLightResampler::end_frame(const std::vector<ResamplingSurface>& surfaces) {
+    history_ = final_;
+    history_surfaces_.assign(surfaces.begin(), surfaces.end());
+    history_camera_ = current_camera_;
+    history_valid_ = true;
+}
+
+bool DirectLightResampler::resolve(LightSample& sample) const {
+    if (sample.light_index < 0 || sample.light_index >= static_cast<int>(lights_.size())) {
+        return false;
+    }
+    const EmissiveSphere& light = lights_[sample.light_index];
+    sample.position = light.center + sample.local_direction * light.radius;
+    sample.normal = sample.local_direction;
+    sample.radiance = light.radiance;
+    return true;
+}
+
+LightSample DirectLightResampler::sample_light(PixelRandom& random) const {
+    LightSample sample;
+    int count = static_cast<int>(lights_.size());
+    sample.light_index = std::min(count - 1, static_cast<int>(random.next() * count));
+
+    // Uniform direction on the unit sphere
+    float z = 1.0f - 2.0f * random.next();
+    float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+    float phi = 2.0f * PI * random.next();
+    sample.local_direction = Vector3(r * std::cos(phi), r * std::sin(phi), z);
+
+    resolve(sample);
+    return sample;
+}
+
+float DirectLightResampler::source_pdf(const LightSample& sample) const {
+    // Uniform light choice, then uniform area sampling on that sphere
+    return 1.0f / (static_cast<float>(lights_.size()) * lights_[sample.light_index].area);
+}
+
+float DirectLightResampler::target_pdf(const LightSample& sample, const ResamplingSurface& surface) const {
+    return luminance(unshadowed_contribution(sample, surface));
+}
+
+Color DirectLightResampler::unshadowed_contribution(const LightSample& sample, const ResamplingSurface& surface) const {
+    Vector3 to_light = sample.position - surface.position;
+    float distance_squared = to_light.length_squared();
+    if (distance_squared < 1e-8f) {
+        return Color(0, 0, 0);
+    }
+
+    Vector3 direction = to_light * (1.0f / std::sqrt(distance_squared));
+    float cos_surface = surface.normal.dot(direction);
+    float cos_light = -sample.normal.dot(direction);
+    if (cos_surface <= 0.0f || cos_light <= 0.0f) {
+        return Color(0, 0, 0);
+    }
+
+    // Lambertian BRDF times the area-measure geometry term
+    float geometry = cos_surface * cos_light / distance_squared;
+    return surface.albedo * sample.radiance * (geometry / PI);
+}
+
+bool DirectLightResampler::visible(const LightSample& sample, const ResamplingSurface& surface) const {
+    if (!scene_manager_) {
+        return false;
+    }
+
+    Vector3 to_light = sample.position - surface.position;
+    float distance = to_light.length();
+    Ray shadow_ray(surface.position + surface.normal * 0.001f, to_light);
+
+    HitRecord rec;
+    thread_ray_stats().add(RayCounter::SHADOW_RAYS);
+    return !scene_manager_->hit_scene(shadow_ray, 0.001f, distance * 0.999f, rec);
+}
+
+bool DirectLightResampler::similar(const ResamplingSurface& a, const ResamplingSurface& b) const {
+    if (!a.valid || !b.valid) {
+        return false;
+    }
+    if (a.normal.dot(b.normal) < config_.normal_threshold) {
+        return false;
+    }
+    float depth_scale = std::max(a.depth, 1e-4f);
+    return std::abs(a.depth - b.depth) / depth_scale <= config_.depth_threshold;
+}
+
+bool DirectLightResampler::reproject(const Vector3& position, int& x, int& y) const {
+    const Vector3& origin = history_camera_.get_position();
+    const Vector3& lower_left = history_camera_.get_lower_left_corner();
+    const Vector3& horizontal = history_camera_.get_horizontal();
+    const Vector3& vertical = history_camera_.get_vertical();
+
+    // Intersect the ray towards the point with the previous image plane
+    Vector3 plane_normal = horizontal.cross(vertical);
+    Vector3 direction = position - origin;
+    float denom = direction.dot(plane_normal);
+    if (std::abs(denom) < 1e-8f) {
+        return false;
+    }
+    float s = (lower_left - origin).dot(plane_normal) / denom;
+    if (s <= 0.0f) {
+        return false;
+    }
+
+    Vector3 on_plane = origin + direction * s - lower_left;
+    float u = on_plane.dot(horizontal) / horizontal.length_squared();
+    float v = on_plane.dot(vertical) / vertical.length_squared();
+    if (u < 0.0f || u >= 1.0f || v < 0.0f || v >= 1.0f) {
+        return false;
+    }
+
+    x = std::min(width_ - 1, static_cast<int>(u * width_));
+    y = std::min(height_ - 1, static_cast<int>(v * height_));
+    return true;
+}
+
+void DirectLightResampler::merge(Reservoir& into, const Reservoir& other, const ResamplingSurface& surface,
+                                 PixelRandom& random) const {
+    if (other.M <= 0.0f) {
+        return;
+    }
+
+    // Re-target the other pixel's sample to this surface and weight it by
+    // its contribution weight and the number of candidates it represents
+    float p_hat = 0.0f;
+    float weight = 0.0f;
+    if (other.W > 0.0f) {
+        p_hat = target_pdf(other.sample, surface);
+        weight = p_hat * other.W * other.M;
+    }
+
+    into.update(other.sample, weight, p_hat, random.next());
+    into.M += other.M - 1.0f;
+}
@@ -1,4 +1,5 @@
 #include "gpu_compute.h"
+#include "core/logger.h"
 #include <iostream>
 #include <sstream>
 
@@ -316,9 +317,9 @@ bool GPUComputePipeline::dispatch(unsigned int work_groups_x, unsigned int work_
     }
     
     if (debugging_enabled_) {
-        std::cout << "Compute dispatch: " << work_groups_x 
+        LOG_DEBUG(LogChannel::GPU, "Compute dispatch: " << work_groups_x 
                   << "x" << work_groups_y 
-                  << "x" << work_groups_z << std::endl;
+                  << "x" << work_groups_z);
     }
     
     return true;
@@ -1,4 +1,5 @@
 #include "gpu_memory.h"
+#include "core/logger.h"
 #include <iostream>
 #include <algorithm>
 #include <sstream>
@@ -421,7 +422,7 @@ bool GPUMemoryManager::transferFromGPU(std::shared_ptr<GPUBuffer> buffer, void*
     call_glBindBuffer(buffer->target, 0);
     
     if (profiling_enabled_) {
-        std::cout << "Transferred " << size << " bytes from GPU buffer: " << buffer->name << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Transferred " << size << " bytes from GPU buffer: " << buffer->name);
     }
     
     return true;
@@ -887,9 +888,9 @@ bool GPUMemoryManager::transferBatched(const std::vector<std::pair<std::shared_p
     recordTransfer(total_bytes, elapsed_ms);
     
     if (profiling_enabled_ && all_success) {
-        std::cout << "Batched transfer completed: " << transfers.size() 
+        LOG_DEBUG(LogChannel::GPU, "Batched transfer completed: " << transfers.size() 
                   << " buffers, " << total_bytes << " bytes, " 
-                  << elapsed_ms << "ms" << std::endl;
+                  << elapsed_ms << "ms");
     }
     
     return all_success;
@@ -936,8 +937,8 @@ std::shared_ptr<GPUBuffer> GPUMemoryManager::allocateFromExistingPool(size_t siz
             pool->used_buffers.push_back(buffer);
             
             if (profiling_enabled_) {
-                std::cout << "Allocated from pool: " << buffer->name 
-                          << " (pool_size=" << pool->buffer_size << ")" << std::endl;
+                LOG_DEBUG(LogChannel::GPU, "Allocated from pool: " << buffer->name 
+                          << " (pool_size=" << pool->buffer_size << ")");
             }
             
             return buffer;
@@ -959,7 +960,7 @@ void GPUMemoryManager::returnBufferToPool(std::shared_ptr<GPUBuffer> buffer) {
             pool->used_buffers.erase(it);
             
             if (profiling_enabled_) {
-                std::cout << "Returned buffer to pool: " << buffer->name << std::endl;
+                LOG_DEBUG(LogChannel::GPU, "Returned buffer to pool: " << buffer->name);
             }
             break;
         }
@@ -1,4 +1,5 @@
 #include "render/gpu_performance.h"
+#include "core/logger.h"
 #include <iostream>
 #include <algorithm>
 #include <numeric>
@@ -56,7 +57,7 @@ void GPUPerformanceMonitor::startGPUTiming() {
     queryActive_ = true;
     
     if (detailedLogging_) {
-        std::cout << "Started GPU performance timing" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Started GPU performance timing");
     }
 #endif
 }
@@ -73,6 +74,12 @@ void GPUPerformanceMonitor::endGPUTiming() {
     auto cpuDuration = std::chrono::duration_cast<std::chrono::microseconds>(cpuEndTime - cpuStartTime_);
     currentMetrics_.cpuComputeTime = cpuDuration.count() / 1000.0; // Convert to ms
     
+    // Utilization covers everything since the previous measurement, idle gaps included
+    auto wallStart = hasLastEnd_ ? lastEndTime_ : cpuStartTime_;
+    currentMetrics_.wallTime = std::chrono::duration<double, std::milli>(cpuEndTime - wallStart).count();
+    lastEndTime_ = cpuEndTime;
+    hasLastEnd_ = true;
+    
     // Wait for GPU queries to complete and get results
     if (waitForQueryResult(timerQueries_[1])) {
         unsigned long long startTime, endTime;
@@ -87,9 +94,9 @@ void GPUPerformanceMonitor::endGPUTiming() {
         updateHistory();
         
         if (detailedLogging_) {
-            std::cout << "GPU compute time: " << currentMetrics_.gpuComputeTime << "ms, "
+            LOG_DEBUG(LogChannel::GPU, "GPU compute time: " << currentMetrics_.gpuComputeTime << "ms, "
                       << "CPU time: " << currentMetrics_.cpuComputeTime << "ms, "
-                      << "Speedup: " << currentMetrics_.speedupRatio << "x" << std::endl;
+                      << "Speedup: " << currentMetrics_.speedupRatio << "x");
         }
     }
     
@@ -111,8 +118,8 @@ void GPUPerformanceMonitor::recordMemoryTransfer(size_t bytes, double transferTi
     }
     
     if (detailedLogging_) {
-        std::cout << "Recorded memory transfer: " << bytes << " bytes in " << transferTime 
-                  << "ms (overhead: " << currentMetrics_.memoryTransferOverhead << "%)" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Recorded memory transfer: " << bytes << " bytes in " << transferTime 
+                  << "ms (overhead: " << currentMetrics_.memoryTransferOverhead << "%)");
     }
 }
 
@@ -157,11 +164,10 @@ void GPUPerformanceMonitor::calculateDerivedMetrics() {
         currentMetrics_.speedupRatio = 0.0;
     }
     
-    // Calculate GPU utilization (simplified metric)
-    // In practice, this would use more sophisticated GPU monitoring
-    if (currentMetrics_.gpuComputeTime > 0 && currentMetrics_.totalGPUTime > 0) {
+    // GPU timestamp interval over wall time: the share of time the GPU was executing our work
+    if (currentMetrics_.gpuComputeTime > 0 && currentMetrics_.wallTime > 0) {
         currentMetrics_.gpuUtilization = 
-            (currentMetrics_.gpuComputeTime / currentMetrics_.totalGPUTime) * 100.0;
+            std::min(100.0, (currentMetrics_.gpuComputeTime / currentMetrics_.wallTime) * 100.0);
     }
     
     // Calculate efficiency metric (speedup relative to memory overhead)
@@ -225,11 +231,11 @@ void GPUPerformanceMonitor::updateRealTimeMetrics() {
     
     if (detailedLogging_) {
         const auto& metrics = currentMetrics_;
-        std::cout << "Real-time GPU metrics - "
+        LOG_DEBUG(LogChannel::GPU, "Real-time GPU metrics - "
                   << "Compute: " << metrics.gpuComputeTime << "ms, "
                   << "Transfer: " << metrics.gpuMemoryTransferTime << "ms, "
                   << "Speedup: " << metrics.speedupRatio << "x, "
-                  << "Efficiency: " << metrics.efficiency << std::endl;
+                  << "Efficiency: " << metrics.efficiency);
     }
 }
 
@@ -1,6 +1,7 @@
 #include "render/hybrid_mode_selector.h"
 #include "render/gpu_performance.h"
 #include "render/gpu_hardware_optimizer.h"
+#include "core/logger.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -214,9 +215,9 @@ void HybridModeSelector::updatePerformanceModel(const SceneCharacteristics& scen
                                 thresholdData_.totalDecisions;
     thresholdData_.averageSpeedup = (thresholdData_.averageSpeedup * 0.9) + (actualSpeedup * 0.1);
     
-    std::cout << "Updated performance model - GPU: " << actualGPUTime 
+    LOG_DEBUG(LogChannel::PERF, "Updated performance model - GPU: " << actualGPUTime 
               << "ms, CPU: " << actualCPUTime << "ms, Speedup: " << actualSpeedup 
-              << "x, Success rate: " << thresholdData_.successRate << std::endl;
+              << "x, Success rate: " << thresholdData_.successRate);
 }
 
 void HybridModeSelector::calibratePerformanceModel() {
@@ -326,8 +327,8 @@ void HybridModeSelector::analyzePerformanceHistory() {
         double avgGPUError = totalGPUError / validSamples;
         double avgCPUError = totalCPUError / validSamples;
         
-        std::cout << "Performance model accuracy - GPU error: " << (avgGPUError * 100.0) 
-                  << "%, CPU error: " << (avgCPUError * 100.0) << "%" << std::endl;
+        LOG_DEBUG(LogChannel::PERF, "Performance model accuracy - GPU error: " << (avgGPUError * 100.0) 
+                  << "%, CPU error: " << (avgCPUError * 100.0) << "%");
     }
 }
 
@@ -381,8 +382,8 @@ void HybridModeSelector::updateAdaptiveThresholds() {
     // Keep threshold in reasonable bounds
     performanceThreshold_ = std::max(1.2, std::min(performanceThreshold_, 10.0));
     
-    std::cout << "Adaptive threshold updated to " << performanceThreshold_ 
-              << " (success rate: " << thresholdData_.successRate << ")" << std::endl;
+    LOG_DEBUG(LogChannel::PERF, "Adaptive threshold updated to " << performanceThreshold_ 
+              << " (success rate: " << thresholdData_.successRate << ")");
 }
 
 void HybridModeSelector::setPerformanceMonitor(std::shared_ptr<GPUPerformanceMonitor> monitor) {
@@ -1,8 +1,10 @@
 #include "image_output.h"
+#include "core/profiler.h"
 #include <fstream>
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <ctime>
 #include <iomanip>
@@ -72,6 +74,7 @@ void ImageOutput::save_to_file(const std::string& filename, const SaveOptions& o
 }
 
 bool ImageOutput::save_with_format(const std::string& filename, ImageFormat format, int jpeg_quality) {
+    PROFILE_FUNCTION();
     if (image_data_.empty()) {
         std::cerr << "No image data to save" << std::endl;
         return false;
@@ -99,7 +102,98 @@ bool ImageOutput::save_with_format(const std::string& filename, ImageFormat form
     }
 }
 
+bool ImageOutput::write_pfm(const std::string& filename, int width, int height, const std::vector<float>& rgb) {
+    PROFILE_FUNCTION();
+    if (width <= 0 || height <= 0 || rgb.size() != static_cast<size_t>(width) * height * 3) {
+        std::cerr << "Invalid float image for " << filename << std::endl;
+        return false;
+    }
+    
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+    
+    // Negative scale marks little-endian data; PFM rows run bottom to top
+    file << "PF\n" << width << " " << height << "\n-1.0\n";
+    const size_t row_floats = static_cast<size_t>(width) * 3;
+    for (int y = height - 1; y >= 0; --y) {
+        file.write(reinterpret_cast<const char*>(rgb.data() + y * row_floats), row_floats * sizeof(float));
+    }
+    
+    if (file.fail()) {
+        std::cerr << "Error writing to file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ImageOutput::read_pfm(const std::string& filename, int& width, int& height, std::vector<float>& rgb) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::string magic;
+    float scale = 0.0f;
+    file >> magic >> width >> height >> scale;
+    file.get();  // Single whitespace before the raster
+    if (!file || magic != "PF" || width <= 0 || height <= 0 || scale == 0.0f) {
+        std::cerr << "Not an RGB PFM: " << filename << std::endl;
+        return false;
+    }
+    
+    const size_t row_floats = static_cast<size_t>(width) * 3;
+    rgb.resize(row_floats * height);
+    for (int y = height - 1; y >= 0; --y) {
+        file.read(reinterpret_cast<char*>(rgb.data() + y * row_floats), row_floats * sizeof(float));
+    }
+    if (!file) {
+        std::cerr << "Truncated PFM: " << filename << std::endl;
+        return false;
+    }
+    
+    // A positive scale means big-endian data
+    const uint16_t probe = 1;
+    const bool host_little_endian = *reinterpret_cast<const uint8_t*>(&probe) == 1;
+    if ((scale > 0.0f) == host_little_endian) {
+        for (float& value : rgb) {
+            uint8_t* bytes = reinterpret_cast<uint8_t*>(&value);
+            std::swap(bytes[0], bytes[3]);
+            std::swap(bytes[1], bytes[2]);
+        }
+    }
+    return true;
+}
+
+bool ImageOutput::save_aov(const std::string& filename, const AOVBuffers& aovs, AOVType type) {
+    if (!aovs.has(type) || aovs.width <= 0 || aovs.height <= 0) {
+        std::cerr << "AOV '" << aov_name(type) << "' was not rendered" << std::endl;
+        return false;
+    }
+    
+    const size_t count = static_cast<size_t>(aovs.width) * aovs.height;
+    std::vector<float> rgb(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+        float r = 0.0f, g = 0.0f, b = 0.0f;
+        switch (type) {
+            case AOVType::DEPTH: r = g = b = aovs.depth[i]; break;
+            case AOVType::NORMAL: r = aovs.normal[i].x; g = aovs.normal[i].y; b = aovs.normal[i].z; break;
+            case AOVType::ALBEDO: r = aovs.albedo[i].r; g = aovs.albedo[i].g; b = aovs.albedo[i].b; break;
+            case AOVType::PRIMITIVE_ID: r = g = b = static_cast<float>(aovs.primitive_id[i]); break;
+            case AOVType::MATERIAL_ID: r = g = b = static_cast<float>(aovs.material_id[i]); break;
+            case AOVType::SAMPLE_COUNT: r = g = b = static_cast<float>(aovs.sample_count[i]); break;
+        }
+        rgb[i * 3 + 0] = r;
+        rgb[i * 3 + 1] = g;
+        rgb[i * 3 + 2] = b;
+    }
+    return write_pfm(filename, aovs.width, aovs.height, rgb);
+}
+
 void ImageOutput::display_to_screen() {
+    PROFILE_FUNCTION();
     if (image_data_.empty()) {
         std::cout << "No image data to display" << std::endl;
         return;
@@ -158,6 +252,7 @@ void ImageOutput::update_camera_preview(const Vector3& /* camera_pos */, const V
 }
 
 void ImageOutput::update_progressive_display(const std::vector<Color>& data, int width, int height, int current_samples, int target_samples) {
+    PROFILE_FUNCTION();
     // Update image data with progressive result
     set_image_data(data, width, height);
     
@@ -308,6 +403,7 @@ void ImageOutput::force_immediate_update() {
 }
 
 void ImageOutput::process_pending_progressive_updates() {
+    PROFILE_FUNCTION();
 #ifdef USE_SDL
     // Check if there's a pending progressive update and we have a window
     if (progressive_update_pending_.load() && window_open_) {
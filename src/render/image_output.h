@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/common.h"
+#include "render/aov.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -41,6 +42,13 @@ public:
     void save_to_file(const std::string& filename);
     void save_to_file(const std::string& filename, const SaveOptions& options);
     bool save_with_format(const std::string& filename, ImageFormat format, int jpeg_quality = 90);
+    // Write one AOV as a little-endian PFM (float RGB). Scalar and ID
+    // buffers are replicated into all three channels.
+    static bool save_aov(const std::string& filename, const AOVBuffers& aovs, AOVType type);
+    // Little-endian PFM from interleaved RGB floats, top row first
+    static bool write_pfm(const std::string& filename, int width, int height, const std::vector<float>& rgb);
+    // Reads a colour PFM written by write_pfm (or any RGB PFM), top row first
+    static bool read_pfm(const std::string& filename, int& width, int& height, std::vector<float>& rgb);
     
     // Display operations
     void display_to_screen();
@@ -0,0 +1,144 @@
+#include "render/irradiance_cache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 20 bits per axis keeps a signed cell index of +-524287 cells
+constexpr int64_t AXIS_BIAS = 1 << 19;
+constexpr uint64_t AXIS_MASK = (1u << 20) - 1;
+
+uint64_t mix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return key;
+}
+
+int normal_bucket(const Vector3& n) {
+    float ax = std::abs(n.x), ay = std::abs(n.y), az = std::abs(n.z);
+    if (ax >= ay && ax >= az) return n.x >= 0.0f ? 0 : 1;
+    if (ay >= az) return n.y >= 0.0f ? 2 : 3;
+    return n.z >= 0.0f ? 4 : 5;
+}
+
+} // namespace
+
+IrradianceCache::IrradianceCache(const IrradianceCacheConfig& config)
+    : config_(config), shards_(SHARD_COUNT), lookups_(0), hits_(0), invalidated_(0) {
+}
+
+void IrradianceCache::set_config(const IrradianceCacheConfig& config) {
+    // A different grid makes every key meaningless
+    bool regrid = config.cell_size != config_.cell_size;
+    config_ = config;
+    if (regrid) {
+        clear();
+    }
+}
+
+uint64_t IrradianceCache::make_key(const Vector3& position, const Vector3& normal, Vector3& cell_center) const {
+    const float inv_cell = 1.0f / config_.cell_size;
+    int64_t ix = static_cast<int64_t>(std::floor(position.x * inv_cell));
+    int64_t iy = static_cast<int64_t>(std::floor(position.y * inv_cell));
+    int64_t iz = static_cast<int64_t>(std::floor(position.z * inv_cell));
+
+    cell_center = Vector3((ix + 0.5f) * config_.cell_size,
+                          (iy + 0.5f) * config_.cell_size,
+                          (iz + 0.5f) * config_.cell_size);
+
+    uint64_t key = static_cast<uint64_t>(ix + AXIS_BIAS) & AXIS_MASK;
+    key = (key << 20) | (static_cast<uint64_t>(iy + AXIS_BIAS) & AXIS_MASK);
+    key = (key << 20) | (static_cast<uint64_t>(iz + AXIS_BIAS) & AXIS_MASK);
+    return (key << 3) | static_cast<uint64_t>(normal_bucket(normal));
+}
+
+IrradianceCache::Shard& IrradianceCache::shard_for(uint64_t key) const {
+    return shards_[mix(key) % SHARD_COUNT];
+}
+
+bool IrradianceCache::lookup(const Vector3& position, const Vector3& normal, Color& radiance, int& sample_count) const {
+    Vector3 cell_center;
+    uint64_t key = make_key(position, normal, cell_center);
+    Shard& shard = shard_for(key);
+
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || it->second.sample_count == 0) {
+        sample_count = 0;
+        return false;
+    }
+
+    sample_count = it->second.sample_count;
+    radiance = it->second.radiance_sum / float(sample_count);
+    if (is_converged(sample_count)) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+Color IrradianceCache::add_sample(const Vector3& position, const Vector3& normal, const Color& incoming) {
+    Vector3 cell_center;
+    uint64_t key = make_key(position, normal, cell_center);
+    Shard& shard = shard_for(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Entry& entry = shard.entries[key];
+    entry.cell_center = cell_center;
+    if (!is_converged(entry.sample_count)) {
+        entry.radiance_sum += incoming;
+        entry.sample_count++;
+    }
+    return entry.radiance_sum / float(entry.sample_count);
+}
+
+void IrradianceCache::invalidate_region(const AABB& region) {
+    if (region.empty()) return;
+
+    // A cell is affected if any part of it lies within the padded region
+    const float half_cell = config_.cell_size * 0.5f;
+    AABB affected = region.padded(config_.invalidation_margin + half_cell);
+
+    uint64_t removed = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (affected.contains(it->second.cell_center)) {
+                it = shard.entries.erase(it);
+                ++removed;
+            } else {
+                ++it;
+            }
+        }
+    }
+    invalidated_.fetch_add(removed, std::memory_order_relaxed);
+}
+
+void IrradianceCache::clear() {
+    uint64_t removed = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        removed += shard.entries.size();
+        shard.entries.clear();
+    }
+    invalidated_.fetch_add(removed, std::memory_order_relaxed);
+}
+
+size_t IrradianceCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+IrradianceCacheStats IrradianceCache::get_stats() const {
+    IrradianceCacheStats stats;
+    stats.entries = size();
+    stats.lookups = lookups_.load(std::memory_order_relaxed);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.invalidated = invalidated_.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,333 @@
+#include "render/metrics_exporter.h"
+#include "render/tile_scheduler.h"
+#include "core/logger.h"
+#include "core/profiler.h"
+#include "core/ray_stats.h"
+#include "core/resource_monitor.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define METRICS_EXPORTER_SOCKETS 1
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+constexpr int POLL_INTERVAL_MS = 200;     // How quickly stop() is noticed
+constexpr int REQUEST_TIMEOUT_MS = 1000;
+constexpr size_t MAX_REQUEST_BYTES = 8192;
+
+double steady_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* render_state_name(RenderState state) {
+    switch (state) {
+        case RenderState::IDLE: return "idle";
+        case RenderState::RENDERING: return "rendering";
+        case RenderState::COMPLETED: return "completed";
+        case RenderState::STOPPED: return "stopped";
+        case RenderState::ERROR: return "error";
+    }
+    return "unknown";
+}
+
+void header(std::ostream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << ' ' << help << '\n'
+        << "# TYPE " << name << ' ' << type << '\n';
+}
+
+template <typename T>
+void gauge(std::ostream& out, const char* name, const char* help, T value) {
+    header(out, name, "gauge", help);
+    out << name << ' ' << value << '\n';
+}
+
+template <typename T>
+void counter(std::ostream& out, const char* name, const char* help, T value) {
+    header(out, name, "counter", help);
+    out << name << ' ' << value << '\n';
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter() = default;
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::parse_endpoint(const std::string& spec, Config& config) {
+    if (spec.rfind("unix:", 0) == 0) {
+        config.unix_socket = spec.substr(5);
+        return !config.unix_socket.empty();
+    }
+    std::string port = spec.rfind("port:", 0) == 0 ? spec.substr(5) : spec;
+    char* end = nullptr;
+    long value = std::strtol(port.c_str(), &end, 10);
+    if (port.empty() || *end != '\0' || value < 0 || value > 65535) {
+        return false;
+    }
+    config.port = static_cast<int>(value);
+    config.unix_socket.clear();
+    return true;
+}
+
+void MetricsExporter::publish(const RenderMetrics& metrics, RenderState state) {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    MetricsSnapshot& snapshot = buffers_[back_];
+    snapshot.render = metrics;
+    snapshot.state = state;
+    snapshot.sequence = ++published_;
+    snapshot.published_seconds = steady_seconds();
+    back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+bool MetricsExporter::latest(MetricsSnapshot& snapshot) {
+    if (middle_.load(std::memory_order_acquire) & FRESH) {
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~FRESH;
+    }
+    snapshot = buffers_[front_];
+    return snapshot.sequence > 0;
+}
+
+void MetricsExporter::scrape(std::ostream& out) {
+    MetricsSnapshot snapshot;
+    bool published = latest(snapshot);
+    const RenderMetrics& m = snapshot.render;
+
+    // Live counters, all plain atomic loads
+    RayStats rays = ray_stats_total();
+    header(out, "pathtracer_rays_total", "counter", "Rays traced since startup, by kind");
+    out << "pathtracer_rays_total{kind=\"primary\"} " << rays[RayCounter::PRIMARY_RAYS] << '\n'
+        << "pathtracer_rays_total{kind=\"secondary\"} " << rays[RayCounter::SECONDARY_RAYS] << '\n'
+        << "pathtracer_rays_total{kind=\"shadow\"} " << rays[RayCounter::SHADOW_RAYS] << '\n';
+    header(out, "pathtracer_intersection_tests_total", "counter", "Primitive intersection tests, by primitive");
+    out << "pathtracer_intersection_tests_total{primitive=\"sphere\"} " << rays[RayCounter::SPHERE_TESTS] << '\n'
+        << "pathtracer_intersection_tests_total{primitive=\"cube\"} " << rays[RayCounter::CUBE_TESTS] << '\n'
+        << "pathtracer_intersection_tests_total{primitive=\"torus\"} " << rays[RayCounter::TORUS_TESTS] << '\n'
+        << "pathtracer_intersection_tests_total{primitive=\"pyramid\"} " << rays[RayCounter::PYRAMID_TESTS] << '\n';
+    counter(out, "pathtracer_paths_total", "Terminated paths", rays[RayCounter::PATHS]);
+    counter(out, "pathtracer_path_vertices_total", "Surface hits along terminated paths", rays[RayCounter::PATH_VERTICES]);
+    counter(out, "pathtracer_cached_hits_total", "Intersections answered by the path vertex cache", rays[RayCounter::CACHED_HITS]);
+
+    gauge(out, "pathtracer_tile_queue_depth", "Tiles waiting to be claimed by a worker", tile_scheduler_pending_tiles());
+    gauge(out, "pathtracer_log_queue_depth", "Log records waiting for the writer thread", logger_queue_depth());
+    counter(out, "pathtracer_log_dropped_total", "Log records lost to a full queue", logger_dropped_count());
+
+    header(out, "pathtracer_tracked_memory_bytes", "gauge", "Host memory held by tracked render buffers");
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+        MemoryUsage usage = memory_usage(static_cast<MemorySubsystem>(i));
+        out << "pathtracer_tracked_memory_bytes{subsystem=\"" << memory_subsystem_name(static_cast<MemorySubsystem>(i))
+            << "\"} " << usage.current_bytes << '\n';
+    }
+    header(out, "pathtracer_tracked_memory_peak_bytes", "gauge", "High-water mark of tracked render buffers");
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+        MemoryUsage usage = memory_usage(static_cast<MemorySubsystem>(i));
+        out << "pathtracer_tracked_memory_peak_bytes{subsystem=\""
+            << memory_subsystem_name(static_cast<MemorySubsystem>(i)) << "\"} " << usage.peak_bytes << '\n';
+    }
+
+    // Values as of the last published frame
+    counter(out, "pathtracer_snapshots_published_total", "Metric snapshots published by the render engine",
+            snapshot.sequence);
+    if (!published) {
+        return;
+    }
+    gauge(out, "pathtracer_snapshot_age_seconds", "Time since the render engine last published",
+          steady_seconds() - snapshot.published_seconds);
+    header(out, "pathtracer_render_state", "gauge", "Render engine state; 1 for the current one");
+    for (RenderState state : {RenderState::IDLE, RenderState::RENDERING, RenderState::COMPLETED,
+                              RenderState::STOPPED, RenderState::ERROR}) {
+        out << "pathtracer_render_state{state=\"" << render_state_name(state) << "\"} "
+            << (state == snapshot.state ? 1 : 0) << '\n';
+    }
+    gauge(out, "pathtracer_image_width_pixels", "Width of the last frame", m.imageWidth);
+    gauge(out, "pathtracer_image_height_pixels", "Height of the last frame", m.imageHeight);
+    gauge(out, "pathtracer_frame_seconds", "Wall time of the last frame", m.render_time_ms / 1000.0);
+    gauge(out, "pathtracer_frame_samples_per_second", "Pixel samples per second in the last frame", m.samples_per_second);
+    gauge(out, "pathtracer_frame_mrays_per_second", "Ray throughput of the last frame", m.mrays_per_second);
+    gauge(out, "pathtracer_frame_tests_per_ray", "Intersection tests per ray in the last frame", m.tests_per_ray);
+    gauge(out, "pathtracer_frame_path_length", "Mean vertices per path in the last frame", m.mean_path_length);
+    gauge(out, "pathtracer_frame_cpu_seconds", "CPU time of the tile workers in the last frame", m.render_cpu_seconds);
+    gauge(out, "pathtracer_cpu_utilization_percent", "Process CPU time over wall time, percent of all cores",
+          m.cpu_utilization);
+    counter(out, "pathtracer_process_cpu_seconds_total", "CPU time of the whole process", m.process_cpu_seconds);
+    gauge(out, "pathtracer_resident_memory_bytes", "Process resident set",
+          static_cast<uint64_t>(m.memory_usage_mb * 1024.0 * 1024.0));
+    gauge(out, "pathtracer_resident_memory_peak_bytes", "Process resident set high-water mark",
+          static_cast<uint64_t>(m.peak_memory_mb * 1024.0 * 1024.0));
+    gauge(out, "pathtracer_gpu_memory_bytes", "GPU buffers held by the memory manager",
+          static_cast<uint64_t>(m.gpu_memory_mb * 1024.0 * 1024.0));
+    gauge(out, "pathtracer_gpu_memory_peak_bytes", "High-water mark of GPU buffers",
+          static_cast<uint64_t>(m.gpu_peak_memory_mb * 1024.0 * 1024.0));
+    gauge(out, "pathtracer_gpu_utilization_percent", "GPU busy time over wall time", m.gpu_utilization);
+    gauge(out, "pathtracer_gpu_compute_seconds", "GPU time of the last timed dispatch", m.gpu_compute_ms / 1000.0);
+    gauge(out, "pathtracer_gpu_transfer_seconds", "Host-device transfer time of the last timed dispatch",
+          m.gpu_transfer_ms / 1000.0);
+}
+
+#ifdef METRICS_EXPORTER_SOCKETS
+
+bool MetricsExporter::start(const Config& config) {
+    if (running_) {
+        return true;
+    }
+    int fd = -1;
+    if (!config.unix_socket.empty()) {
+        sockaddr_un address{};
+        if (config.unix_socket.size() >= sizeof(address.sun_path)) {
+            LOG_ERROR(LogChannel::PERF, "Metrics socket path too long: " << config.unix_socket);
+            return false;
+        }
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, config.unix_socket.c_str(), sizeof(address.sun_path) - 1);
+        // A stale socket from a crashed run would make bind fail
+        unlink(config.unix_socket.c_str());
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            LOG_ERROR(LogChannel::PERF, "Cannot bind metrics socket " << config.unix_socket << ": " << std::strerror(errno));
+            if (fd >= 0) close(fd);
+            return false;
+        }
+        unix_socket_ = config.unix_socket;
+        bound_port_ = 0;
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(config.port));
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            LOG_ERROR(LogChannel::PERF, "Cannot bind metrics port " << config.port << ": " << std::strerror(errno));
+            if (fd >= 0) close(fd);
+            return false;
+        }
+        socklen_t length = sizeof(address);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+        bound_port_ = ntohs(address.sin_port);
+        unix_socket_.clear();
+    }
+    if (listen(fd, 8) != 0) {
+        LOG_ERROR(LogChannel::PERF, "Cannot listen for metrics scrapes: " << std::strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    stop_requested_ = false;
+    running_ = true;
+    server_ = std::thread(&MetricsExporter::serve, this);
+    if (unix_socket_.empty()) {
+        LOG_INFO(LogChannel::PERF, "Serving metrics on http://127.0.0.1:" << bound_port_ << "/metrics");
+    } else {
+        LOG_INFO(LogChannel::PERF, "Serving metrics on unix:" << unix_socket_);
+    }
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!server_.joinable()) {
+        return;
+    }
+    stop_requested_ = true;
+    server_.join();
+    close(listen_fd_);
+    listen_fd_ = -1;
+    if (!unix_socket_.empty()) {
+        unlink(unix_socket_.c_str());
+    }
+    running_ = false;
+}
+
+void MetricsExporter::serve() {
+    PROFILE_THREAD_NAME("Metrics exporter");
+    ResourceThreadScope resources("metrics exporter");
+    while (!stop_requested_.load(std::memory_order_relaxed)) {
+        pollfd listener{listen_fd_, POLLIN, 0};
+        if (poll(&listener, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        int client = accept(listen_fd_, nullptr, nullptr);
+        if (client >= 0) {
+            handle_connection(client);
+            close(client);
+        }
+    }
+}
+
+void MetricsExporter::handle_connection(int fd) {
+    // Read until the end of the request headers; the body, if any, is ignored
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        pollfd client{fd, POLLIN, 0};
+        if (poll(&client, 1, REQUEST_TIMEOUT_MS) <= 0) {
+            return;
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    std::string status = "200 OK";
+    std::string body;
+    std::string request_line = request.substr(0, request.find("\r\n"));
+    if (request_line.rfind("GET /metrics ", 0) == 0 || request_line.rfind("GET / ", 0) == 0) {
+        std::ostringstream text;
+        scrape(text);
+        body = text.str();
+    } else if (request_line.rfind("GET ", 0) == 0) {
+        status = "404 Not Found";
+        body = "Metrics are served at /metrics\n";
+    } else {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    std::string bytes = response.str();
+    size_t sent = 0;
+    while (sent < bytes.size()) {
+        ssize_t n = send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+#else
+
+bool MetricsExporter::start(const Config&) {
+    LOG_WARN(LogChannel::PERF, "Metrics exporter needs POSIX sockets; not available on this platform");
+    return false;
+}
+
+void MetricsExporter::stop() {}
+void MetricsExporter::serve() {}
+void MetricsExporter::handle_connection(int) {}
+
+#endif
@@ -2,6 +2,17 @@
 #include "core/common.h"
 #include "core/scene_manager.h"
 #include "core/camera.h"
+#include "core/profiler.h"
+#include "core/logger.h"
+#include "performance/hw_counters.h"
+#include "render/direct_light_resampler.h"
+#include "render/irradiance_cache.h"
+#include "render/denoiser.h"
+#include "render/render_checkpoint.h"
+#include "render/accumulation_file.h"
+#include "render/render_cache.h"
+#include "render/primary_visibility.h"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -41,6 +52,8 @@ extern "C" {
     int glGetUniformLocation(unsigned int program, const char* name);
     void glMemoryBarrier(unsigned int barriers);
     void glUniform1i(int location, int v0);
+    void glUniform1f(int location, float v0);
+    void glUniform1iv(int location, int count, const int* value);
     void glUniform3f(int location, float v0, float v1, float v2);
     void glUniformMatrix4fv(int location, int count, unsigned char transpose, const float* value);
 }
@@ -86,14 +99,54 @@ static bool loadTextureOpenGLFunctions() {
 }
 #endif
 
+namespace {
+// Each thread owns its generator so tile workers can share ray_color()
+std::mt19937& thread_rng() {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return rng;
+}
+
+uint64_t mix_seed(uint64_t a, uint64_t b) {
+    uint64_t h = a * 0x9E3779B97F4A7C15ull + b;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 29);
+}
+
+bool same_direction(const Vector3& a, const Vector3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// Flags the tiles of a row-major tile grid that overlap rect
+void mark_tiles(const PixelRect& rect, int tile_size, int tiles_x, std::vector<uint8_t>& tiles) {
+    for (int ty = rect.y0 / tile_size; ty <= (rect.y1 - 1) / tile_size; ++ty) {
+        for (int tx = rect.x0 / tile_size; tx <= (rect.x1 - 1) / tile_size; ++tx) {
+            tiles[ty * tiles_x + tx] = 1;
+        }
+    }
+}
+} // namespace
+
 // PathTracer implementation
 PathTracer::PathTracer() 
     : camera_(Vector3(0, 0, 0), Vector3(0, 0, -1), Vector3(0, 1, 0)),
       max_depth_(10), samples_per_pixel_(10), stop_requested_(false),
-      rng_(std::random_device{}()), uniform_dist_(0.0f, 1.0f)
+      direct_light_resampling_(true), light_resampler_(std::make_unique<DirectLightResampler>()),
+      irradiance_cache_enabled_(true), irradiance_cache_(std::make_unique<IrradianceCache>()),
+      raster_primary_visibility_(true), primary_visibility_(std::make_unique<PrimaryVisibility>()),
+      scene_version_(0), preview_frame_(0),
+      denoising_enabled_(false), denoiser_(std::make_unique<Denoiser>()),
+      checkpoint_interval_(std::chrono::minutes(5)),
+      edit_invalidation_(EditInvalidation::OFF), edit_bleed_tiles_(1), edit_version_(0),
+      invalidated_tiles_(0), vertex_cache_(std::make_unique<PathVertexCache>()),
+      vertex_cache_active_(false), vertex_cache_version_(0), requested_aovs_(AOV_NONE),
+      cost_heatmap_enabled_(false), heatmap_metric_(HeatmapMetric::CYCLES),
+      frame_stats_active_(false)
 #ifdef USE_GPU
       , currentMode_(RenderMode::HYBRID_AUTO), rayTracingProgram_(0), outputTexture_(0),
-        gl_window_(nullptr), gl_context_(nullptr)
+        gl_window_(nullptr), gl_context_(nullptr),
+        reservoirWidth_(0), reservoirHeight_(0), reservoirHistoryIndex_(0),
+        reservoirHistoryValid_(false), gpuResamplingActive_(false)
 #endif
 {
 }
@@ -111,19 +164,32 @@ void PathTracer::captureOpenGLContext() {
     gl_context_ = SDL_GL_GetCurrentContext();
     
     if (gl_window_ && gl_context_) {
-        std::cout << "OpenGL context captured successfully" << std::endl;
-        std::cout << "  Window: " << gl_window_ << std::endl;
-        std::cout << "  Context: " << gl_context_ << std::endl;
+        LOG_INFO(LogChannel::GPU, "OpenGL context captured successfully");
+        LOG_INFO(LogChannel::GPU, "  Window: " << gl_window_);
+        LOG_INFO(LogChannel::GPU, "  Context: " << gl_context_);
     } else {
-        std::cout << "Warning: Could not capture OpenGL context" << std::endl;
-        std::cout << "  Window: " << gl_window_ << std::endl;
-        std::cout << "  Context: " << gl_context_ << std::endl;
+        LOG_WARN(LogChannel::GPU, "Could not capture OpenGL context");
+        LOG_INFO(LogChannel::GPU, "  Window: " << gl_window_);
+        LOG_INFO(LogChannel::GPU, "  Context: " << gl_context_);
     }
 }
 #endif
 
 void PathTracer::set_scene_manager(std::shared_ptr<SceneManager> scene_manager) {
     scene_manager_ = scene_manager;
+    light_resampler_->set_scene_manager(scene_manager);
+    irradiance_cache_->clear();
+    scene_version_ = scene_manager ? scene_manager->get_scene_version() : 0;
+    vertex_cache_->invalidate();
+    vertex_cache_version_ = scene_version_;
+}
+
+void PathTracer::set_direct_light_resampling(bool enabled) {
+    direct_light_resampling_ = enabled;
+    light_resampler_->reset_history();
+#ifdef USE_GPU
+    reservoirHistoryValid_ = false;
+#endif
 }
 
 void PathTracer::set_camera(const Camera& camera) {
@@ -131,138 +197,267 @@ void PathTracer::set_camera(const Camera& camera) {
 }
 
 void PathTracer::trace(int width, int height) {
+    PROFILE_FUNCTION();
     image_data_.clear();
     image_data_.resize(width * height);
+    begin_frame_buffers(width, height);
+    CostHeatmap* heatmap = heatmap_target();
     
     auto start_time = std::chrono::steady_clock::now();
     
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
+    run_tiles(width, height, [&](const RenderTile& tile, int thread_index) {
+        HwStageScope counters("trace", thread_index);
+        trace_tile_samples(width, height, tile, heatmap, true, &image_data_[tile.y0 * width + tile.x0], width);
+    });
+    
+    finish_image(width, height, samples_per_pixel_, true);
+    
+    auto end_time = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    LOG_INFO(LogChannel::RENDER, "Rendering completed in " << duration.count() << " ms");
+}
+
+void PathTracer::trace_tile(int width, int height, const RenderTile& tile, std::vector<Color>& pixels) {
+    pixels.assign(static_cast<size_t>(tile.pixel_count()), Color(0, 0, 0));
+    trace_tile_samples(width, height, tile, nullptr, false, pixels.data(), tile.width());
+}
+
+void PathTracer::trace_tile_samples(int width, int height, const RenderTile& tile, CostHeatmap* heatmap,
+                                    bool frame_buffers, Color* out, int out_stride) {
+    // Seeding per tile keeps a seeded frame identical at any thread or process count
+    if (random_seed_ != 0) {
+        seed_thread_rng(mix_seed(random_seed_, static_cast<uint64_t>(tile.index)));
+    }
+    
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        Color* row = out + static_cast<size_t>(y - tile.y0) * out_stride;
+        for (int x = tile.x0; x < tile.x1; ++x) {
+            int index = y * width + x;
+            PixelCostScope cost(heatmap, index);
             Color pixel_color(0, 0, 0);
             
             for (int s = 0; s < samples_per_pixel_; ++s) {
-                float u = (x + uniform_dist_(rng_)) / float(width);
-                float v = (y + uniform_dist_(rng_)) / float(height);
+                float u = (x + random_float()) / float(width);
+                float v = (y + random_float()) / float(height);
                 
-                Ray ray = camera_.get_ray(u, v);
-                pixel_color = pixel_color + ray_color(ray, max_depth_);
+                Ray ray = camera_ray(u, v);
+                Color sample_color = ray_color(ray, max_depth_);
+                pixel_color = pixel_color + sample_color;
+                if (frame_buffers) {
+                    record_sample_moments(index, sample_color);
+                }
             }
             
             // Average the samples
-            pixel_color = pixel_color / float(samples_per_pixel_);
-            
-            // Gamma correction (gamma=2.0)
-            pixel_color = Color(std::sqrt(pixel_color.r), std::sqrt(pixel_color.g), std::sqrt(pixel_color.b));
-            
-            image_data_[y * width + x] = pixel_color;
+            row[x - tile.x0] = pixel_color / float(samples_per_pixel_);
+            if (frame_buffers && !aovs_.sample_count.empty()) {
+                aovs_.sample_count[index] = static_cast<uint32_t>(samples_per_pixel_);
+            }
         }
     }
-    
-    auto end_time = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-    std::cout << "Rendering completed in " << duration.count() << " ms" << std::endl;
 }
 
 bool PathTracer::trace_interruptible(int width, int height) {
+    PROFILE_FUNCTION();
     image_data_.clear();
     image_data_.resize(width * height);
+    begin_frame_buffers(width, height);
+    CostHeatmap* heatmap = heatmap_target();
     
     auto start_time = std::chrono::steady_clock::now();
     
-    for (int y = 0; y < height && !stop_requested_; ++y) {
-        for (int x = 0; x < width && !stop_requested_; ++x) {
-            Color pixel_color(0, 0, 0);
-            
-            for (int s = 0; s < samples_per_pixel_ && !stop_requested_; ++s) {
-                float u = (x + uniform_dist_(rng_)) / float(width);
-                float v = (y + uniform_dist_(rng_)) / float(height);
+    run_tiles(width, height, [&](const RenderTile& tile, int thread_index) {
+        HwStageScope counters("trace", thread_index);
+        if (random_seed_ != 0) {
+            seed_thread_rng(mix_seed(random_seed_, static_cast<uint64_t>(tile.index)));
+        }
+        
+        for (int y = tile.y0; y < tile.y1 && !stop_requested_; ++y) {
+            for (int x = tile.x0; x < tile.x1 && !stop_requested_; ++x) {
+                int index = y * width + x;
+                PixelCostScope cost(heatmap, index);
+                Color pixel_color(0, 0, 0);
+                
+                for (int s = 0; s < samples_per_pixel_ && !stop_requested_; ++s) {
+                    float u = (x + random_float()) / float(width);
+                    float v = (y + random_float()) / float(height);
+                    
+                    Ray ray = camera_ray(u, v);
+                    Color sample_color = ray_color(ray, max_depth_);
+                    pixel_color = pixel_color + sample_color;
+                    record_sample_moments(index, sample_color);
+                }
+                
+                if (stop_requested_) break;
                 
-                Ray ray = camera_.get_ray(u, v);
-                pixel_color = pixel_color + ray_color(ray, max_depth_);
+                // Average the samples
+                image_data_[index] = pixel_color / float(samples_per_pixel_);
+                if (!aovs_.sample_count.empty()) {
+                    aovs_.sample_count[index] = static_cast<uint32_t>(samples_per_pixel_);
+                }
             }
-            
-            if (stop_requested_) break;
-            
-            // Average the samples
-            pixel_color = pixel_color / float(samples_per_pixel_);
-            
-            // Gamma correction (gamma=2.0)
-            pixel_color = Color(std::sqrt(pixel_color.r), std::sqrt(pixel_color.g), std::sqrt(pixel_color.b));
-            
-            image_data_[y * width + x] = pixel_color;
         }
-        
-        if (stop_requested_) break;
-    }
+    }, &stop_requested_);
+    
+    // A partial frame is only gamma corrected; filtering it would smear the gap
+    finish_image(width, height, samples_per_pixel_, !stop_requested_);
     
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     
     if (stop_requested_) {
-        std::cout << "Rendering interrupted after " << duration.count() << " ms" << std::endl;
+        LOG_INFO(LogChannel::RENDER, "Rendering interrupted after " << duration.count() << " ms");
         return false;
     } else {
-        std::cout << "Interruptible rendering completed in " << duration.count() << " ms" << std::endl;
+        LOG_INFO(LogChannel::RENDER, "Interruptible rendering completed in " << duration.count() << " ms");
         return true;
     }
 }
 
-bool PathTracer::trace_progressive(int width, int height, const ProgressiveConfig& config, ProgressiveCallback callback) {
-    image_data_.clear();
-    image_data_.resize(width * height);
-    
-    // Initialize with black image
-    std::fill(image_data_.begin(), image_data_.end(), Color(0, 0, 0));
-    
+bool PathTracer::trace_progressive(int width, int height, const ProgressiveConfig& requested_config, ProgressiveCallback callback) {
+    PROFILE_FUNCTION();
+    const int pixel_count = width * height;
+    // Edits from here on are applied to this render; the buffers below already see earlier ones
+    edit_version_ = scene_manager_ ? scene_manager_->get_scene_version() : 0;
+    invalidated_tiles_ = 0;
+    image_data_.assign(pixel_count, Color(0, 0, 0));
+    begin_frame_buffers(width, height);
+    pixel_samples_.assign(pixel_count, 0);
+    CostHeatmap* heatmap = heatmap_target();
+    
+    // Every pass of every tile draws from its own seed, so the image does not
+    // depend on thread count and a resumed render repeats no random numbers
+    ProgressiveConfig config = requested_config;
+    uint64_t seed = random_seed_ != 0 ? random_seed_
+                                      : (uint64_t(std::random_device{}()) << 32) | std::random_device{}();
+    int step = 0;
     int current_samples = config.initialSamples;
     int total_samples = 0;
     
+    if (resume_checkpoint_) {
+        std::unique_ptr<RenderCheckpoint> checkpoint = std::move(resume_checkpoint_);
+        RenderCheckpoint current;
+        fill_checkpoint_header(current, width, height);
+        if (checkpoint->same_render(current)) {
+            tile_scheduler_.set_tile_size(checkpoint->tile_size);
+            config = checkpoint->config;
+            seed = checkpoint->seed;
+            step = checkpoint->step;
+            current_samples = checkpoint->step_samples;
+            total_samples = checkpoint->step_start_samples;
+            std::copy(checkpoint->accumulation.begin(), checkpoint->accumulation.end(), image_data_.begin());
+            pixel_samples_.assign(checkpoint->sample_counts.begin(), checkpoint->sample_counts.end());
+            if (!luminance_sum_.empty() && checkpoint->luminance_sum.size() == luminance_sum_.size()) {
+                luminance_sum_.assign(checkpoint->luminance_sum.begin(), checkpoint->luminance_sum.end());
+                luminance_sq_sum_.assign(checkpoint->luminance_sq_sum.begin(), checkpoint->luminance_sq_sum.end());
+            }
+            LOG_INFO(LogChannel::RENDER, "Resuming progressive render at " << checkpoint->min_samples()
+                     << " of " << config.targetSamples << " samples per pixel");
+        } else {
+            LOG_WARN(LogChannel::RENDER, "Checkpoint does not match the current camera, scene or settings; starting over");
+        }
+    }
+    
+    // A cached accumulation of this render stands in for its first passes;
+    // with a random seed any cached seed will do, and the render adopts it
+    const bool cacheable = render_cache_ && total_samples == 0 && !heatmap;
+    uint64_t cache_key = 0;
+    uint64_t cache_scene_hash = 0;
+    int cached_samples = 0;
+    if (cacheable) {
+        AccumulationHeader identity;
+        fill_accumulation_header(identity, width, height, random_seed_);
+        cache_key = render_cache_key(identity, tile_scheduler_.tile_size());
+        cache_scene_hash = identity.scene_hash;
+        AccumulationFile cached;
+        if (render_cache_->lookup(cache_key, static_cast<uint32_t>(config.targetSamples), !luminance_sum_.empty(), cached) &&
+            cached.header.pixel_count() == static_cast<size_t>(pixel_count)) {
+            seed = cached.header.seed;
+            cached_samples = static_cast<int>(cached.header.pass_count());
+            total_samples = cached_samples;
+            current_samples = std::min(current_samples, config.targetSamples - total_samples);
+            std::copy(cached.sums.begin(), cached.sums.end(), image_data_.begin());
+            pixel_samples_.assign(cached.sample_counts.begin(), cached.sample_counts.end());
+            if (!luminance_sum_.empty()) {
+                luminance_sum_.assign(cached.luminance_sum.begin(), cached.luminance_sum.end());
+                luminance_sq_sum_.assign(cached.luminance_sq_sum.begin(), cached.luminance_sq_sum.end());
+            }
+            LOG_INFO(LogChannel::RENDER, "Render cache holds " << cached_samples << " of " << config.targetSamples
+                     << " samples per pixel");
+        }
+    }
+    
+    begin_tile_tracking(width, height);
+    
+    // Vertices recorded by an earlier render of this view survive material edits
+    vertex_cache_active_ = edit_invalidation_ != EditInvalidation::OFF && vertex_cache_->enabled() && scene_manager_;
+    if (vertex_cache_active_) {
+        sync_vertex_cache_edits();
+        PathVertexFrame frame;
+        fill_vertex_frame(frame, width, height, seed);
+        if (random_seed_ == 0 && total_samples == 0 && vertex_cache_->holds(frame, true)) {
+            seed = vertex_cache_->frame().seed;
+            frame.seed = seed;
+        }
+        vertex_cache_->begin_frame(frame, static_cast<int>(tile_scheduler_.make_tiles(width, height).size()));
+    }
+    
+    // Normalize, denoise and gamma-correct for display
+    auto update_display = [&]() {
+        std::vector<Color> display_image(pixel_count);
+        linear_image_.resize(pixel_count);
+        for (int i = 0; i < pixel_count; ++i) {
+            display_image[i] = image_data_[i] / float(total_samples);
+            linear_image_[i] = image_data_[i] / float(std::max<uint32_t>(1, pixel_samples_[i]));
+        }
+        if (denoising_enabled_) {
+            denoiser_->denoise(display_image, width, height, aovs_, sample_variance(total_samples));
+        }
+        for (auto& pixel : display_image) {
+            pixel = Color(std::sqrt(pixel.r), std::sqrt(pixel.g), std::sqrt(pixel.b));
+        }
+        if (heatmap) {
+            heatmap->overlay(display_image, heatmap_metric_);
+        }
+        publish_frame_stats(width, height, total_samples);
+        
+        callback(display_image, width, height, total_samples, config.targetSamples);
+    };
+    if (total_samples >= config.targetSamples) {
+        aovs_.fill_sample_count(static_cast<uint32_t>(total_samples));
+        update_display();
+        step = config.progressiveSteps;
+    }
+    
     auto last_update = std::chrono::steady_clock::now();
-    auto last_yield = std::chrono::steady_clock::now();
-    const auto yield_interval = std::chrono::milliseconds(16); // Yield every 16ms (~60 FPS)
+    auto last_checkpoint = last_update;
     
-    for (int step = 0; step < config.progressiveSteps && !stop_requested_; ++step) {
-        // Render additional samples with periodic yielding
+    for (; step < config.progressiveSteps && !stop_requested_; ++step) {
+        PROFILE_ZONE("progressive step");
+        const int step_start = total_samples;
         for (int sample = 0; sample < current_samples && !stop_requested_; ++sample) {
-            for (int y = 0; y < height && !stop_requested_; ++y) {
-                // Check if we should yield control to prevent UI hanging
-                auto now = std::chrono::steady_clock::now();
-                if (now - last_yield >= yield_interval) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Brief yield
-                    last_yield = now;
-                }
-                
-                for (int x = 0; x < width && !stop_requested_; ++x) {
-                    float u = (x + uniform_dist_(rng_)) / float(width);
-                    float v = (y + uniform_dist_(rng_)) / float(height);
-                    
-                    Ray ray = camera_.get_ray(u, v);
-                    Color sample_color = ray_color(ray, max_depth_);
-                    
-                    // Progressive accumulation
-                    int index = y * width + x;
-                    image_data_[index] = image_data_[index] + sample_color;
-                }
+            const uint32_t pass = static_cast<uint32_t>(step_start + sample);
+            apply_scene_edits(width, height);
+            trace_pass(width, height, seed, 0, pass, heatmap);
+            
+            if (checkpoint_writer_ && !stop_requested_ &&
+                std::chrono::steady_clock::now() - last_checkpoint >= checkpoint_interval_) {
+                submit_checkpoint(width, height, config, seed, step, current_samples, step_start);
+                last_checkpoint = std::chrono::steady_clock::now();
             }
         }
         
         if (stop_requested_) break;
         
         total_samples += current_samples;
+        aovs_.fill_sample_count(static_cast<uint32_t>(total_samples));
         
         // Check if enough time has passed for callback
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration<float>(now - last_update).count();
         
         if (elapsed >= config.updateInterval || step == config.progressiveSteps - 1) {
-            // Normalize and gamma-correct for display
-            std::vector<Color> display_image(width * height);
-            for (int i = 0; i < width * height; ++i) {
-                Color normalized = image_data_[i] / float(total_samples);
-                display_image[i] = Color(std::sqrt(normalized.r), std::sqrt(normalized.g), std::sqrt(normalized.b));
-            }
-            
-            callback(display_image, width, height, total_samples, config.targetSamples);
+            update_display();
             last_update = now;
         }
         
@@ -278,27 +473,736 @@ bool PathTracer::trace_progressive(int width, int height, const ProgressiveConfi
         if (current_samples <= 0) break;
     }
     
-    // Final normalization
-    for (int i = 0; i < width * height; ++i) {
-        image_data_[i] = image_data_[i] / float(total_samples);
-        image_data_[i] = Color(std::sqrt(image_data_[i].r), std::sqrt(image_data_[i].g), std::sqrt(image_data_[i].b));
+    // The loop variables now point at the first pass not yet complete everywhere
+    if (stop_requested_ && checkpoint_writer_) {
+        submit_checkpoint(width, height, config, seed, step, current_samples, total_samples);
+    }
+    vertex_cache_active_ = false;
+    
+    // Passes traced across an edit are not what a fresh render of either scene
+    // would give. Edits need not reset any tile (invalidation off, or off
+    // screen), so compare the scene itself against the one the key was made from.
+    const bool scene_unchanged = invalidated_tiles_ == 0 &&
+        (scene_manager_ ? scene_manager_->content_hash() : 0) == cache_scene_hash;
+    if (cacheable && !stop_requested_ && total_samples > cached_samples && scene_unchanged) {
+        AccumulationFile entry;
+        fill_accumulation_header(entry.header, width, height, seed);
+        entry.header.has_variance = !luminance_sum_.empty();
+        entry.header.ranges.assign(1, SampleRange{0, static_cast<uint32_t>(total_samples)});
+        entry.sums.assign(image_data_.begin(), image_data_.end());
+        entry.sample_counts.assign(pixel_samples_.begin(), pixel_samples_.end());
+        entry.luminance_sum.assign(luminance_sum_.begin(), luminance_sum_.end());
+        entry.luminance_sq_sum.assign(luminance_sq_sum_.begin(), luminance_sq_sum_.end());
+        render_cache_->store(cache_key, entry);
+    }
+    
+    // Final normalization; after a stop, tiles of the interrupted pass have one sample more
+    for (int i = 0; i < pixel_count; ++i) {
+        image_data_[i] = image_data_[i] / float(std::max<uint32_t>(1, pixel_samples_[i]));
     }
+    finish_image(width, height, total_samples, !stop_requested_);
     
     return !stop_requested_;
 }
 
+void PathTracer::trace_pass(int width, int height, uint64_t seed, uint32_t first_pass, uint32_t pass,
+                            CostHeatmap* heatmap) {
+    const bool track_primitives = !tile_primitives_.empty();
+    PathVertexCache* vertex_cache = vertex_cache_active_ ? vertex_cache_.get() : nullptr;
+    run_tiles(width, height, [&](const RenderTile& tile, int thread_index) {
+        // Tiles always finish a pass, so one pixel tells which pass a tile is on:
+        // past this one when resumed, behind it when reset by a scene edit
+        uint32_t next_pass = first_pass + pixel_samples_[tile.y0 * width + tile.x0];
+        if (next_pass > pass) {
+            return;
+        }
+        HwStageScope counters("progressive", thread_index);
+        std::vector<int> hit_objects;
+        
+        for (; next_pass <= pass && !stop_requested_; ++next_pass) {
+            seed_thread_rng(mix_seed(mix_seed(seed, next_pass), static_cast<uint64_t>(tile.index)));
+            const bool cache_pass = vertex_cache && vertex_cache->covers(next_pass);
+            const bool reuse = cache_pass && vertex_cache->is_recorded(tile.index, next_pass);
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) {
+                    int index = y * width + x;
+                    PixelCostScope cost(heatmap, index);
+                    float u = (x + random_float()) / float(width);
+                    float v = (y + random_float()) / float(height);
+                    
+                    Ray ray = camera_ray(u, v);
+                    int hit_object = -1;
+                    PathVertexSpan cached = cache_pass ? vertex_cache->sample(tile.index, index, next_pass)
+                                                       : PathVertexSpan();
+                    Color sample_color = ray_color(ray, max_depth_, true, track_primitives ? &hit_object : nullptr,
+                                                   cached);
+                    if (hit_object >= 0 &&
+                        std::find(hit_objects.begin(), hit_objects.end(), hit_object) == hit_objects.end()) {
+                        hit_objects.push_back(hit_object);
+                    }
+                    
+                    // Progressive accumulation
+                    image_data_[index] = image_data_[index] + sample_color;
+                    record_sample_moments(index, sample_color);
+                    ++pixel_samples_[index];
+                }
+            }
+            if (cache_pass) {
+                vertex_cache->finish_tile_pass(tile.index, next_pass, reuse);
+            }
+        }
+        if (track_primitives) {
+            record_tile_primitives(tile.index, hit_objects);
+        }
+    }, &stop_requested_);
+}
+
+void PathTracer::set_edit_invalidation(EditInvalidation mode, int bleed_tiles) {
+    edit_invalidation_ = mode;
+    edit_bleed_tiles_ = std::max(0, bleed_tiles);
+}
+
+void PathTracer::begin_tile_tracking(int width, int height) {
+    tile_primitives_.clear();
+    tile_primitives_known_.clear();
+    if (edit_invalidation_ == EditInvalidation::OFF || edit_invalidation_ == EditInvalidation::FULL_FRAME) {
+        return;
+    }
+    const std::vector<RenderTile> tiles = tile_scheduler_.make_tiles(width, height);
+    tile_primitives_.resize(tiles.size());
+    tile_primitives_known_.resize(tiles.size());
+    for (const RenderTile& tile : tiles) {
+        tile_primitives_known_[tile.index] = pixel_samples_[tile.y0 * width + tile.x0] == 0;
+    }
+}
+
+void PathTracer::record_tile_primitives(int tile_index, const std::vector<int>& objects) {
+    // Object indices shift when objects are removed, so keep the stable IDs
+    std::vector<uint32_t>& ids = tile_primitives_[tile_index];
+    for (int object : objects) {
+        PrimitiveID id = scene_manager_->get_object_id(object);
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (id != INVALID_PRIMITIVE_ID && (it == ids.end() || *it != id)) {
+            ids.insert(it, id);
+        }
+    }
+}
+
+size_t PathTracer::apply_scene_edits(int width, int height) {
+    if (edit_invalidation_ == EditInvalidation::OFF || !scene_manager_ ||
+        scene_manager_->get_scene_version() == edit_version_) {
+        return 0;
+    }
+    PROFILE_FUNCTION();
+    if (vertex_cache_active_) {
+        sync_vertex_cache_edits();
+    }
+    std::vector<SceneEdit> edits;
+    const bool complete = scene_manager_->get_edits_since(edit_version_, edits);
+    edit_version_ = complete && !edits.empty() ? edits.back().version : scene_manager_->get_scene_version();
+    
+    const std::vector<RenderTile> tiles = tile_scheduler_.make_tiles(width, height);
+    std::vector<uint8_t> reset(tiles.size(), 0);
+    if (!complete || edit_invalidation_ == EditInvalidation::FULL_FRAME) {
+        std::fill(reset.begin(), reset.end(), 1);
+    } else {
+        mark_edited_tiles(edits, width, height, reset);
+    }
+    
+    // Light bounced or shadowed by the edit mostly lands near it on screen
+    if (edit_invalidation_ == EditInvalidation::PADDED && edit_bleed_tiles_ > 0) {
+        const int tile_size = tile_scheduler_.tile_size();
+        const int tiles_x = (width + tile_size - 1) / tile_size;
+        std::vector<uint8_t> padded(reset.size(), 0);
+        const int pad = edit_bleed_tiles_ * tile_size;
+        for (const RenderTile& tile : tiles) {
+            if (reset[tile.index]) {
+                PixelRect rect{std::max(0, tile.x0 - pad), std::max(0, tile.y0 - pad),
+                               std::min(width, tile.x1 + pad), std::min(height, tile.y1 + pad)};
+                mark_tiles(rect, tile_size, tiles_x, padded);
+            }
+        }
+        reset.swap(padded);
+    }
+    
+    size_t reset_count = 0;
+    for (const RenderTile& tile : tiles) {
+        if (!reset[tile.index]) continue;
+        ++reset_count;
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                const size_t index = static_cast<size_t>(y) * width + x;
+                image_data_[index] = Color(0, 0, 0);
+                pixel_samples_[index] = 0;
+                if (!luminance_sum_.empty()) {
+                    luminance_sum_[index] = 0.0f;
+                    luminance_sq_sum_[index] = 0.0f;
+                }
+                aovs_.clear_pixel(index);
+            }
+        }
+        if (!tile_primitives_.empty()) {
+            tile_primitives_[tile.index].clear();
+            tile_primitives_known_[tile.index] = 1;
+        }
+    }
+    if (reset_count > 0 && (aovs_.mask & ~aov_bit(AOVType::SAMPLE_COUNT)) != AOV_NONE) {
+        write_first_hit_aovs(width, height, &reset);
+    }
+    
+    invalidated_tiles_ += reset_count;
+    LOG_DEBUG(LogChannel::RENDER, edits.size() << " scene edits reset " << reset_count << " of "
+              << tiles.size() << " tiles");
+    return reset_count;
+}
+
+void PathTracer::mark_edited_tiles(const std::vector<SceneEdit>& edits, int width, int height,
+                                   std::vector<uint8_t>& tiles) const {
+    const int tile_size = tile_scheduler_.tile_size();
+    const int tiles_x = (width + tile_size - 1) / tile_size;
+    std::vector<uint8_t> unknown_tiles;
+    for (size_t i = 0; i < tile_primitives_known_.size(); ++i) {
+        if (!tile_primitives_known_[i]) {
+            unknown_tiles.assign(tiles.size(), 0);
+            break;
+        }
+    }
+    
+    for (const SceneEdit& edit : edits) {
+        // Where the primitive was, the tiles that recorded hitting it are exactly those its samples touched
+        const bool recorded = edit.id != INVALID_PRIMITIVE_ID && !tile_primitives_.empty();
+        
+        // No ray has seen where the primitive is now, so that area is projected;
+        // a material edit leaves it where the recorded hits found it
+        PixelRect rect;
+        if ((edit.kind != SceneEditKind::MATERIAL || !recorded) &&
+            project_bounds(camera_, edit.new_bounds, width, height, rect)) {
+            mark_tiles(rect, tile_size, tiles_x, tiles);
+        }
+        
+        if (recorded) {
+            for (size_t i = 0; i < tile_primitives_.size(); ++i) {
+                if (std::binary_search(tile_primitives_[i].begin(), tile_primitives_[i].end(), edit.id)) {
+                    tiles[i] = 1;
+                }
+            }
+        }
+        // Samples loaded from a checkpoint or cache carry no record; bound those instead
+        if (project_bounds(camera_, edit.old_bounds, width, height, rect)) {
+            if (!recorded) {
+                mark_tiles(rect, tile_size, tiles_x, tiles);
+            } else if (!unknown_tiles.empty()) {
+                mark_tiles(rect, tile_size, tiles_x, unknown_tiles);
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < unknown_tiles.size(); ++i) {
+        tiles[i] |= unknown_tiles[i] && !tile_primitives_known_[i];
+    }
+}
+
+void PathTracer::sync_vertex_cache_edits() {
+    std::vector<SceneEdit> edits;
+    const bool complete = scene_manager_->get_edits_since(vertex_cache_version_, edits);
+    const bool geometry_changed = !complete ||
+        std::any_of(edits.begin(), edits.end(), [](const SceneEdit& edit) { return edit.kind != SceneEditKind::MATERIAL; });
+    if (geometry_changed) {
+        vertex_cache_->invalidate();
+    }
+    vertex_cache_version_ = complete && !edits.empty() ? edits.back().version : scene_manager_->get_scene_version();
+}
+
+void PathTracer::fill_vertex_frame(PathVertexFrame& frame, int width, int height, uint64_t seed) const {
+    frame.width = width;
+    frame.height = height;
+    frame.tile_size = tile_scheduler_.tile_size();
+    frame.seed = seed;
+    frame.camera_position = camera_.get_position();
+    frame.camera_target = camera_.get_target();
+    frame.camera_up = camera_.get_up();
+    frame.camera_fov = camera_.get_fov();
+    frame.camera_aspect = camera_.get_aspect_ratio();
+    frame.geometry = scene_manager_ ? scene_manager_->geometry_hash() : 0;
+}
+
+bool PathTracer::trace_sample_range(int width, int height, uint32_t first_pass, uint32_t pass_count,
+                                    bool with_variance, AccumulationFile& output) {
+    PROFILE_FUNCTION();
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    image_data_.assign(pixel_count, Color(0, 0, 0));
+    linear_image_.clear();
+    begin_frame_buffers(width, height);
+    pixel_samples_.assign(pixel_count, 0);
+    if (with_variance) {
+        luminance_sum_.assign(pixel_count, 0.0f);
+        luminance_sq_sum_.assign(pixel_count, 0.0f);
+    }
+    
+    // Jobs of one distributed render must share the seed; a random one is
+    // recorded in the output so further ranges can be rendered to match
+    uint64_t seed = random_seed_ != 0 ? random_seed_
+                                      : (uint64_t(std::random_device{}()) << 32) | std::random_device{}();
+    CostHeatmap* heatmap = heatmap_target();
+    uint32_t passes = 0;
+    for (; passes < pass_count && !stop_requested_; ++passes) {
+        PROFILE_ZONE("sample range pass");
+        trace_pass(width, height, seed, first_pass, first_pass + passes, heatmap);
+    }
+    // The interrupted pass covers only some tiles; drop the range instead of leaving it uneven
+    if (stop_requested_) {
+        return false;
+    }
+    publish_frame_stats(width, height, static_cast<int>(passes));
+    
+    AccumulationHeader& header = output.header;
+    fill_accumulation_header(header, width, height, seed);
+    header.has_variance = !luminance_sum_.empty();
+    header.ranges.assign(1, SampleRange{first_pass, pass_count});
+    output.sums.assign(image_data_.begin(), image_data_.end());
+    output.sample_counts.assign(pixel_samples_.begin(), pixel_samples_.end());
+    output.luminance_sum.assign(luminance_sum_.begin(), luminance_sum_.end());
+    output.luminance_sq_sum.assign(luminance_sq_sum_.begin(), luminance_sq_sum_.end());
+    return true;
+}
+
+bool PathTracer::accumulate_passes(int width, int height, uint32_t pass_count, bool restart) {
+    PROFILE_FUNCTION();
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    if (restart || accumulated_passes_ == 0 || image_data_.size() != pixel_count) {
+        image_data_.assign(pixel_count, Color(0, 0, 0));
+        linear_image_.clear();
+        begin_frame_buffers(width, height);
+        pixel_samples_.assign(pixel_count, 0);
+        accumulation_seed_ = random_seed_ != 0 ? random_seed_
+                                               : (uint64_t(std::random_device{}()) << 32) | std::random_device{}();
+        accumulated_passes_ = 0;
+    }
+    
+    // Tiles pick up at their own sample count, as on a resumed progressive render
+    CostHeatmap* heatmap = heatmap_target();
+    for (uint32_t pass = 0; pass < pass_count && !stop_requested_; ++pass) {
+        PROFILE_ZONE("accumulated pass");
+        trace_pass(width, height, accumulation_seed_, 0, accumulated_passes_, heatmap);
+        if (!stop_requested_) {
+            ++accumulated_passes_;
+        }
+    }
+    if (stop_requested_) {
+        return false;
+    }
+    publish_frame_stats(width, height, static_cast<int>(accumulated_passes_));
+    return true;
+}
+
+void PathTracer::set_checkpointing(const std::string& filename, std::chrono::seconds interval) {
+    checkpoint_writer_.reset();
+    if (!filename.empty()) {
+        checkpoint_writer_ = std::make_unique<CheckpointWriter>(filename);
+    }
+    checkpoint_interval_ = interval;
+}
+
+void PathTracer::set_resume_checkpoint(std::unique_ptr<RenderCheckpoint> checkpoint) {
+    resume_checkpoint_ = std::move(checkpoint);
+}
+
+void PathTracer::wait_for_checkpoints() {
+    if (checkpoint_writer_) {
+        checkpoint_writer_->wait();
+    }
+}
+
+void PathTracer::fill_checkpoint_header(RenderCheckpoint& checkpoint, int width, int height) const {
+    checkpoint.width = width;
+    checkpoint.height = height;
+    checkpoint.tile_size = tile_scheduler_.tile_size();
+    checkpoint.max_depth = max_depth_;
+    checkpoint.camera_position = camera_.get_position();
+    checkpoint.camera_target = camera_.get_target();
+    checkpoint.camera_up = camera_.get_up();
+    checkpoint.camera_fov = camera_.get_fov();
+    checkpoint.camera_aspect = camera_.get_aspect_ratio();
+    checkpoint.scene_hash = scene_manager_ ? scene_manager_->content_hash() : 0;
+}
+
+void PathTracer::fill_accumulation_header(AccumulationHeader& header, int width, int height, uint64_t seed) const {
+    header.width = width;
+    header.height = height;
+    header.max_depth = max_depth_;
+    header.seed = seed;
+    header.camera_position = camera_.get_position();
+    header.camera_target = camera_.get_target();
+    header.camera_up = camera_.get_up();
+    header.camera_fov = camera_.get_fov();
+    header.camera_aspect = camera_.get_aspect_ratio();
+    header.scene_hash = scene_manager_ ? scene_manager_->content_hash() : 0;
+}
+
+void PathTracer::submit_checkpoint(int width, int height, const ProgressiveConfig& config, uint64_t seed,
+                                   int step, int step_samples, int step_start_samples) {
+    PROFILE_FUNCTION();
+    // Only the copy happens here; encoding and disk I/O run on the writer thread
+    auto checkpoint = std::make_unique<RenderCheckpoint>();
+    fill_checkpoint_header(*checkpoint, width, height);
+    checkpoint->config = config;
+    checkpoint->seed = seed;
+    checkpoint->step = step;
+    checkpoint->step_samples = step_samples;
+    checkpoint->step_start_samples = step_start_samples;
+    checkpoint->accumulation = image_data_;
+    checkpoint->sample_counts.assign(pixel_samples_.begin(), pixel_samples_.end());
+    checkpoint->luminance_sum.assign(luminance_sum_.begin(), luminance_sum_.end());
+    checkpoint->luminance_sq_sum.assign(luminance_sq_sum_.begin(), luminance_sq_sum_.end());
+    checkpoint_writer_->submit(std::move(checkpoint));
+}
+
+bool PathTracer::trace_preview(int width, int height) {
+    PROFILE_FUNCTION();
+    if ((!direct_light_resampling_ && !irradiance_cache_enabled_) || !scene_manager_) {
+        return trace_interruptible(width, height);
+    }
+    
+    if (irradiance_cache_enabled_) {
+        sync_scene_edits();
+    }
+    
+    const int pixel_count = width * height;
+    image_data_.assign(pixel_count, Color(0, 0, 0));
+    std::vector<ResamplingSurface> surfaces(pixel_count);
+    begin_frame_buffers(width, height);
+    CostHeatmap* heatmap = heatmap_target();
+    
+    // With explicit light sampling the bounce must not count the sampled lights again
+    const bool resample = direct_light_resampling_;
+    const bool count_bounce_emission = !resample;
+    
+    DirectLightResampler& resampler = *light_resampler_;
+    if (resample) {
+        resampler.begin_frame(width, height, camera_);
+    }
+    const uint64_t frame_seed = ++preview_frame_;
+    
+    const bool raster = raster_primary_visibility_;
+    if (raster) {
+        primary_visibility_->build(*scene_manager_, camera_, width, height);
+    }
+    
+    // Pass 1: primary hits (and initial candidates plus temporal reuse when
+    // resampling). Sky, emitter and metal pixels are finished here.
+    bool completed = run_tiles(width, height, [&](const RenderTile& tile, int thread_index) {
+        PROFILE_ZONE("preview primary hits");
+        HwStageScope counters("preview primary hits", thread_index);
+        seed_thread_rng(mix_seed(frame_seed, static_cast<uint64_t>(tile.index)));
+        std::vector<uint32_t> candidates;
+        const bool binned = raster && primary_visibility_->bin_tile(tile, candidates);
+        
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                int index = y * width + x;
+                PixelCostScope cost(heatmap, index);
+                Ray ray = camera_ray((x + 0.5f) / float(width), (y + 0.5f) / float(height));
+                
+                HitRecord hit;
+                bool hit_anything = binned
+                    ? primary_visibility_->hit(candidates, x, y, ray, 0.001f, hit)
+                    : scene_manager_->hit_scene(ray, 0.001f, std::numeric_limits<float>::infinity(), hit);
+                if (hit_anything && !hit.material.is_emissive() && hit.material.metallic < 0.5f) {
+                    ResamplingSurface& surface = surfaces[index];
+                    surface.position = hit.point;
+                    surface.normal = hit.normal;
+                    surface.albedo = hit.material.albedo;
+                    surface.depth = hit.t;
+                    surface.valid = true;
+                    continue;
+                }
+                
+                // No footprint covers a sky pixel, so its jittered rays miss everything too
+                const bool sky = raster && max_depth_ > 0 && !primary_visibility_->covers(candidates, x, y);
+                Color pixel_color(0, 0, 0);
+                for (int s = 0; s < samples_per_pixel_; ++s) {
+                    float u = (x + random_float()) / float(width);
+                    float v = (y + random_float()) / float(height);
+                    if (sky) {
+                        thread_ray_stats().add(RayCounter::PATHS);
+                        pixel_color = pixel_color + scene_manager_->get_background_color(camera_ray(u, v));
+                    } else {
+                        pixel_color = pixel_color + ray_color(camera_ray(u, v), max_depth_);
+                    }
+                }
+                image_data_[index] = pixel_color / float(samples_per_pixel_);
+            }
+        }
+        
+        if (resample) {
+            resampler.sample_initial(tile, surfaces);
+        }
+    }, &stop_requested_);
+    
+    // Pass 2: spatial reuse reads neighbours from any tile, so it waits for pass 1
+    if (completed && resample) {
+        completed = run_tiles(width, height, [&](const RenderTile& tile, int thread_index) {
+            PROFILE_ZONE("preview spatial reuse");
+            HwStageScope counters("preview spatial reuse", thread_index);
+            resampler.reuse_spatial(tile, surfaces);
+        }, &stop_requested_);
+    }
+    
+    // Pass 3: direct light from the reservoirs plus one cosine-sampled bounce,
+    // finished by an irradiance cache lookup or a full path
+    if (completed) {
+        completed = run_tiles(width, height, [&](const RenderTile& tile, int thread_index) {
+            PROFILE_ZONE("preview shading");
+            HwStageScope counters("preview shading", thread_index);
+            seed_thread_rng(mix_seed(frame_seed ^ 0xA5A5A5A5ull, static_cast<uint64_t>(tile.index)));
+            
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) {
+                    int index = y * width + x;
+                    const ResamplingSurface& surface = surfaces[index];
+                    if (!surface.valid) continue;
+                    PixelCostScope cost(heatmap, index);
+                    
+                    Color indirect(0, 0, 0);
+                    for (int s = 0; s < samples_per_pixel_; ++s) {
+                        Vector3 scatter_direction = surface.normal + random_unit_vector();
+                        if (near_zero(scatter_direction)) {
+                            scatter_direction = surface.normal;
+                        }
+                        Ray bounce(surface.position, scatter_direction);
+                        thread_ray_stats().add(RayCounter::SECONDARY_RAYS);
+                        indirect = indirect + (irradiance_cache_enabled_
+                            ? cached_bounce_color(bounce, count_bounce_emission)
+                            : ray_color(bounce, max_depth_ - 1, count_bounce_emission));
+                    }
+                    
+                    Color direct = resample ? resampler.shade(x, y, surface) : Color(0, 0, 0);
+                    image_data_[index] = direct + surface.albedo * (indirect / float(samples_per_pixel_));
+                }
+            }
+        }, &stop_requested_);
+    }
+    
+    if (!completed) {
+        return false;
+    }
+    
+    if (resample) {
+        resampler.end_frame(surfaces);
+    }
+    
+    // One sample per pixel: the denoiser estimates variance spatially
+    aovs_.fill_sample_count(1);
+    finish_image(width, height, 1, true);
+    return true;
+}
+
+void PathTracer::begin_frame_buffers(int width, int height, bool track_moments) {
+    // GPU frames cast no CPU rays worth counting
+    frame_stats_active_ = track_moments;
+    if (frame_stats_active_) {
+        frame_rays_ = RayStats();
+        frame_start_time_ = std::chrono::steady_clock::now();
+    }
+    
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    if (denoising_enabled_ && track_moments) {
+        luminance_sum_.assign(pixel_count, 0.0f);
+        luminance_sq_sum_.assign(pixel_count, 0.0f);
+    } else {
+        luminance_sum_.clear();
+        luminance_sq_sum_.clear();
+    }
+    
+    // Only CPU frames track per-sample moments, and only they are instrumented
+    if (cost_heatmap_enabled_ && track_moments) {
+        cost_heatmap_.allocate(width, height);
+    } else {
+        cost_heatmap_.clear();
+    }
+    
+    AOVMask mask = requested_aovs_ | (denoising_enabled_ ? AOV_DENOISE_FEATURES : AOV_NONE);
+    aovs_.allocate(mask, width, height);
+    if ((mask & ~aov_bit(AOVType::SAMPLE_COUNT)) != AOV_NONE) {
+        write_first_hit_aovs(width, height);
+    }
+}
+
+void PathTracer::write_first_hit_aovs(int width, int height, const std::vector<uint8_t>* tiles) {
+    PROFILE_FUNCTION();
+    if (!scene_manager_) {
+        return;
+    }
+    
+    // AOVs come from the pixel-centre primary ray so they are noise free
+    const bool want_ids = aovs_.has(AOVType::PRIMITIVE_ID);
+    run_tiles(width, height, [&](const RenderTile& tile, int thread_index) {
+        if (tiles && !(*tiles)[tile.index]) {
+            return;
+        }
+        HwStageScope counters("aov primary hits", thread_index);
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                Ray ray = camera_ray((x + 0.5f) / float(width), (y + 0.5f) / float(height));
+                HitRecord hit;
+                if (scene_manager_->hit_scene(ray, 0.001f, std::numeric_limits<float>::infinity(), hit)) {
+                    uint32_t id = want_ids ? scene_manager_->get_object_id(hit.object_index) : 0u;
+                    aovs_.write_hit(static_cast<size_t>(y) * width + x, hit, id);
+                }
+            }
+        }
+    });
+}
+
+void PathTracer::record_sample_moments(int index, const Color& sample) {
+    if (luminance_sum_.empty()) {
+        return;
+    }
+    float luminance = 0.2126f * sample.r + 0.7152f * sample.g + 0.0722f * sample.b;
+    luminance_sum_[index] += luminance;
+    luminance_sq_sum_[index] += luminance * luminance;
+}
+
+std::vector<float> PathTracer::sample_variance(int samples) const {
+    // Too few samples for a per-pixel estimate; let the denoiser use its neighbours
+    if (samples < 2 || luminance_sum_.empty()) {
+        return std::vector<float>();
+    }
+    
+    std::vector<float> variance(luminance_sum_.size());
+    const float inv = 1.0f / float(samples);
+    for (size_t i = 0; i < variance.size(); ++i) {
+        float mean = luminance_sum_[i] * inv;
+        // Variance of the pixel mean, not of a single sample
+        variance[i] = std::max(0.0f, luminance_sq_sum_[i] * inv - mean * mean) * inv;
+    }
+    return variance;
+}
+
+void PathTracer::publish_frame_stats(int width, int height, int samples) {
+    if (!frame_stats_active_) {
+        return;
+    }
+    
+    FrameStats stats;
+    stats.rays = frame_rays_;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - frame_start_time_).count();
+    stats.samples = static_cast<uint64_t>(width) * height * samples;
+    
+    std::lock_guard<std::mutex> lock(frame_stats_mutex_);
+    frame_stats_ = stats;
+}
+
+bool PathTracer::run_tiles(int width, int height, const TileScheduler::TileFunction& fn,
+                           const std::atomic<bool>* stop_flag) {
+    bool completed = tile_scheduler_.run(width, height, fn, stop_flag);
+    // Workers have joined, so the run's counts are exact here
+    frame_rays_ += tile_scheduler_.last_run_stats().rays;
+    return completed;
+}
+
+FrameStats PathTracer::get_frame_stats() const {
+    std::lock_guard<std::mutex> lock(frame_stats_mutex_);
+    return frame_stats_;
+}
+
+void PathTracer::finish_image(int width, int height, int samples, bool denoise) {
+    publish_frame_stats(width, height, samples);
+    linear_image_.assign(image_data_.begin(), image_data_.end());
+    
+    if (denoise && denoising_enabled_) {
+        denoiser_->denoise(image_data_, width, height, aovs_, sample_variance(samples));
+    }
+    
+    // Gamma correction (gamma=2.0)
+    PROFILE_ZONE("tonemap");
+    {
+        HwStageScope counters("tonemap");
+        for (auto& pixel : image_data_) {
+            pixel = Color(std::sqrt(pixel.r), std::sqrt(pixel.g), std::sqrt(pixel.b));
+        }
+    }
+    hw_stage_flush();
+    
+    if (cost_heatmap_enabled_ && !cost_heatmap_.empty()) {
+        cost_heatmap_.overlay(image_data_, heatmap_metric_);
+    }
+}
+
+void PathTracer::set_irradiance_cache(bool enabled) {
+    irradiance_cache_enabled_ = enabled;
+    if (enabled && scene_manager_) {
+        // Edits made while the cache was off were never applied to it
+        irradiance_cache_->clear();
+        scene_version_ = scene_manager_->get_scene_version();
+    }
+}
+
+void PathTracer::sync_scene_edits() {
+    PROFILE_FUNCTION();
+    std::vector<SceneEdit> edits;
+    if (!scene_manager_->get_edits_since(scene_version_, edits)) {
+        irradiance_cache_->clear();
+    } else {
+        for (const auto& edit : edits) {
+            irradiance_cache_->invalidate_region(edit.old_bounds);
+            irradiance_cache_->invalidate_region(edit.new_bounds);
+        }
+    }
+    scene_version_ = scene_manager_->get_scene_version();
+}
+
+Color PathTracer::cached_bounce_color(const Ray& ray, bool count_emission) const {
+    HitRecord hit;
+    if (!scene_manager_->hit_scene(ray, 0.001f, std::numeric_limits<float>::infinity(), hit)) {
+        return scene_manager_->get_background_color(ray);
+    }
+    if (hit.material.is_emissive()) {
+        return count_emission || !light_resampler_->samples_object(hit.object_index)
+            ? hit.material.albedo * hit.material.emission : Color(0, 0, 0);
+    }
+    if (hit.material.metallic >= 0.5f) {
+        // Glossy paths depend on the view direction; the cache only holds diffuse light
+        return ray_color(ray, max_depth_ - 1, count_emission);
+    }
+    
+    // Jitter the lookup inside the cell neighbourhood to hide the grid
+    const float cell = irradiance_cache_->config().cell_size;
+    Vector3 jitter = Vector3(random_float() - 0.5f, random_float() - 0.5f, random_float() - 0.5f) * cell;
+    Vector3 lookup_point = hit.point + jitter;
+    
+    Color incoming;
+    int sample_count = 0;
+    bool found = irradiance_cache_->lookup(lookup_point, hit.normal, incoming, sample_count);
+    if (!found || !irradiance_cache_->is_converged(sample_count)) {
+        // Lazy fill: every visit to an unconverged cell contributes one full path
+        Vector3 scatter_direction = hit.normal + random_unit_vector();
+        if (near_zero(scatter_direction)) {
+            scatter_direction = hit.normal;
+        }
+        thread_ray_stats().add(RayCounter::SECONDARY_RAYS);
+        Color sample = ray_color(Ray(hit.point, scatter_direction), std::max(1, max_depth_ - 2));
+        incoming = irradiance_cache_->add_sample(lookup_point, hit.normal, sample);
+    }
+    return hit.material.albedo * incoming;
+}
+
 #ifdef USE_GPU
 bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveConfig& config, ProgressiveCallback callback) {
+    PROFILE_FUNCTION();
     if (!isGPUAvailable()) {
         // Fallback to CPU progressive rendering
         return trace_progressive(width, height, config, callback);
     }
+    linear_image_.clear();
     
     image_data_.clear();
     image_data_.resize(width * height);
     
     // Initialize with black image
     std::fill(image_data_.begin(), image_data_.end(), Color(0, 0, 0));
+    // Samples come back from the GPU already averaged, so no per-sample moments
+    begin_frame_buffers(width, height, false);
     
     int current_samples = config.initialSamples;
     int total_samples = 0;
@@ -309,7 +1213,7 @@ bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveC
         // Use GPU for this progressive step with linear output
         set_samples_per_pixel(current_samples);
         
-        std::cout << "Attempting GPU rendering for progressive step " << step << " with " << current_samples << " samples" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Attempting GPU rendering for progressive step " << step << " with " << current_samples << " samples");
         
         // Use chunked GPU rendering to prevent UI hanging with large sample counts
         const int max_samples_per_chunk = 50; // Limit GPU chunks to prevent hanging
@@ -320,11 +1224,11 @@ bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveC
             int chunk_samples = std::min(samples_remaining, max_samples_per_chunk);
             set_samples_per_pixel(chunk_samples);
             
-            std::cout << "GPU chunk: " << chunk_samples << " samples (" << samples_remaining << " remaining)" << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "GPU chunk: " << chunk_samples << " samples (" << samples_remaining << " remaining)");
             
             // Use async GPU rendering for this chunk
             if (!start_gpu_async(width, height)) {
-                std::cerr << "GPU chunk failed to start, falling back to CPU" << std::endl;
+                LOG_WARN(LogChannel::GPU, "GPU chunk failed to start, falling back to CPU");
                 return trace_progressive(width, height, config, callback);
             }
             
@@ -338,7 +1242,7 @@ bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveC
                 
                 // Timeout check
                 if (now - chunk_start_time > max_wait_time) {
-                    std::cerr << "GPU chunk timed out, falling back to CPU" << std::endl;
+                    LOG_WARN(LogChannel::GPU, "GPU chunk timed out, falling back to CPU");
                     return trace_progressive(width, height, config, callback);
                 }
                 
@@ -348,7 +1252,7 @@ bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveC
             
             // Finalize the chunk result
             if (!finalize_gpu_result(width, height)) {
-                std::cerr << "GPU chunk failed to finalize, falling back to CPU" << std::endl;
+                LOG_WARN(LogChannel::GPU, "GPU chunk failed to finalize, falling back to CPU");
                 return trace_progressive(width, height, config, callback);
             }
             
@@ -364,7 +1268,7 @@ bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveC
         
         if (stop_requested_) break;
         
-        std::cout << "GPU progressive step " << step << " completed successfully" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "GPU progressive step " << step << " completed successfully");
         
         // Accumulate the step result directly (step_accumulation already contains total contribution)
         for (int i = 0; i < width * height; ++i) {
@@ -374,17 +1278,23 @@ bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveC
         if (stop_requested_) break;
         
         total_samples += current_samples;
+        aovs_.fill_sample_count(static_cast<uint32_t>(total_samples));
         
         // Check if enough time has passed for callback
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration<float>(now - last_update).count();
         
         if (elapsed >= config.updateInterval || step == config.progressiveSteps - 1) {
-            // Normalize and gamma-correct for display
+            // Normalize, denoise and gamma-correct for display
             std::vector<Color> display_image(width * height);
             for (int i = 0; i < width * height; ++i) {
-                Color normalized = image_data_[i] / float(total_samples);
-                display_image[i] = Color(std::sqrt(normalized.r), std::sqrt(normalized.g), std::sqrt(normalized.b));
+                display_image[i] = image_data_[i] / float(total_samples);
+            }
+            if (denoising_enabled_) {
+                denoiser_->denoise(display_image, width, height, aovs_, sample_variance(total_samples));
+            }
+            for (auto& pixel : display_image) {
+                pixel = Color(std::sqrt(pixel.r), std::sqrt(pixel.g), std::sqrt(pixel.b));
             }
             
             callback(display_image, width, height, total_samples, config.targetSamples);
@@ -406,23 +1316,73 @@ bool PathTracer::trace_progressive_gpu(int width, int height, const ProgressiveC
     // Final normalization
     for (int i = 0; i < width * height; ++i) {
         image_data_[i] = image_data_[i] / float(total_samples);
-        image_data_[i] = Color(std::sqrt(image_data_[i].r), std::sqrt(image_data_[i].g), std::sqrt(image_data_[i].b));
     }
+    finish_image(width, height, total_samples, !stop_requested_);
     
     return !stop_requested_;
 }
 #endif
 
-Color PathTracer::ray_color(const Ray& ray, int depth) const {
+Color PathTracer::ray_color(const Ray& ray, int depth, bool count_emission, int* hit_object,
+                            PathVertexSpan cached) const {
+    RayStatsSlot& stats = thread_ray_stats();
+    PathVertex* vertex = cached.count > 0 ? cached.vertices : nullptr;
+    // Vertices past the end of the path must be traced if a material edit lets it go further
+    auto end_path = [&](int from) {
+        for (int i = from; i < cached.count; ++i) {
+            cached.vertices[i].object = PathVertex::NOT_TRACED;
+        }
+    };
     if (depth <= 0) {
+        end_path(0);
+        stats.add(RayCounter::PATHS);
         return Color(0, 0, 0);
     }
     
     HitRecord hit;
-    if (scene_manager_->hit_scene(ray, 0.001f, std::numeric_limits<float>::infinity(), hit)) {
+    bool hit_anything = false;
+    // A vertex answers only the ray that found it: earlier samples of the tile
+    // consume a different number of random numbers once a material scatters
+    // differently, and every later ray of the pass moves with them
+    const bool reuse = vertex && cached.reuse && vertex->object != PathVertex::NOT_TRACED &&
+                       vertex->object < static_cast<int32_t>(scene_manager_->get_objects().size()) &&
+                       same_direction(vertex->direction, ray.direction);
+    if (reuse) {
+        // Geometry is as it was when recorded; only the material is looked up again
+        stats.add(RayCounter::CACHED_HITS);
+        hit_anything = vertex->object != PathVertex::MISS;
+        if (hit_anything) {
+            hit.t = vertex->t;
+            hit.point = ray.at(vertex->t);
+            hit.normal = vertex->normal;
+            hit.front_face = true;
+            hit.object_index = vertex->object;
+            hit.material = scene_manager_->get_objects()[vertex->object]->material();
+        }
+    } else {
+        hit_anything = scene_manager_->hit_scene(ray, 0.001f, std::numeric_limits<float>::infinity(), hit);
+        if (vertex) {
+            vertex->direction = ray.direction;
+            vertex->object = hit_anything ? hit.object_index : PathVertex::MISS;
+            vertex->t = hit.t;
+            vertex->normal = hit.normal;
+        }
+    }
+    // Deeper vertices start where this one is, so they need it unchanged
+    const PathVertexSpan next = vertex ? PathVertexSpan{vertex + 1, cached.count - 1, reuse} : PathVertexSpan();
+    
+    if (hit_anything) {
+        stats.add(RayCounter::PATH_VERTICES);
+        if (hit_object) {
+            *hit_object = hit.object_index;
+        }
+        
         // Check for emissive materials first (light sources)
         if (hit.material.emission > 0.0f) {
-            return hit.material.albedo * hit.material.emission;
+            end_path(1);
+            stats.add(RayCounter::PATHS);
+            return count_emission || !light_resampler_->samples_object(hit.object_index)
+                ? hit.material.albedo * hit.material.emission : Color(0, 0, 0);
         }
         
         // Material properties
@@ -435,8 +1395,10 @@ Color PathTracer::ray_color(const Ray& ray, int depth) const {
                 scatter_direction = hit.normal;
             }
             
+            // At the depth limit the scattered ray is never traced
             Ray scattered(hit.point, scatter_direction);
-            return albedo * ray_color(scattered, depth - 1);
+            stats.add(RayCounter::SECONDARY_RAYS, depth > 1 ? 1 : 0);
+            return albedo * ray_color(scattered, depth - 1, true, nullptr, next);
         } else {
             // Metal reflection
             Vector3 reflected = reflect(ray.direction.normalized(), hit.normal);
@@ -444,21 +1406,38 @@ Color PathTracer::ray_color(const Ray& ray, int depth) const {
             
             if (reflected.dot(hit.normal) > 0) {
                 Ray scattered(hit.point, reflected);
-                return albedo * ray_color(scattered, depth - 1);
+                stats.add(RayCounter::SECONDARY_RAYS, depth > 1 ? 1 : 0);
+                return albedo * ray_color(scattered, depth - 1, true, nullptr, next);
             } else {
+                end_path(1);
+                stats.add(RayCounter::PATHS);
                 return Color(0, 0, 0);
             }
         }
     }
     
     // Use scene manager's background color
+    stats.add(RayCounter::PATHS);
     return scene_manager_->get_background_color(ray);
 }
 
+Ray PathTracer::camera_ray(float u, float v) const {
+    thread_ray_stats().add(RayCounter::PRIMARY_RAYS);
+    return camera_.get_ray(u, v);
+}
+
+float PathTracer::random_float() const {
+    return std::uniform_real_distribution<float>(0.0f, 1.0f)(thread_rng());
+}
+
+void PathTracer::seed_thread_rng(uint64_t seed) {
+    thread_rng().seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32)));
+}
+
 Vector3 PathTracer::random_in_unit_sphere() const {
     Vector3 p;
     do {
-        p = Vector3(uniform_dist_(rng_), uniform_dist_(rng_), uniform_dist_(rng_)) * 2.0f - Vector3(1, 1, 1);
+        p = Vector3(random_float(), random_float(), random_float()) * 2.0f - Vector3(1, 1, 1);
     } while (p.dot(p) >= 1.0f);
     return p;
 }
@@ -493,7 +1472,7 @@ bool PathTracer::initializeGPU() {
         return true; // Already initialized
     }
     
-    std::cout << "Initializing GPU compute pipeline for path tracing..." << std::endl;
+    LOG_INFO(LogChannel::GPU, "Initializing GPU compute pipeline for path tracing...");
     
     // Capture current OpenGL context for GPU operations
     captureOpenGLContext();
@@ -501,7 +1480,7 @@ bool PathTracer::initializeGPU() {
     // Initialize GPU compute pipeline
     gpuPipeline_ = std::make_shared<GPUComputePipeline>();
     if (!gpuPipeline_->initialize()) {
-        std::cerr << "Failed to initialize GPU compute pipeline: " << gpuPipeline_->getErrorMessage() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to initialize GPU compute pipeline: " << gpuPipeline_->getErrorMessage());
         return false;
     }
     
@@ -509,7 +1488,7 @@ bool PathTracer::initializeGPU() {
     gpuMemory_ = std::make_shared<GPUMemoryManager>();
     gpuMemory_->enableProfiling(true); // Enable profiling for debugging
     if (!gpuMemory_->initialize()) {
-        std::cerr << "Failed to initialize GPU memory manager: " << gpuMemory_->getErrorMessage() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to initialize GPU memory manager: " << gpuMemory_->getErrorMessage());
         return false;
     }
     
@@ -518,53 +1497,53 @@ bool PathTracer::initializeGPU() {
     
     // Pre-allocate RNG buffers in main thread (where OpenGL context is current)
     // to avoid threading issues during rendering
-    std::cout << "Pre-allocating GPU RNG buffers in main thread..." << std::endl;
+    LOG_INFO(LogChannel::GPU, "Pre-allocating GPU RNG buffers in main thread...");
     if (!gpuRNG_->initialize(800, 600, gpuMemory_)) { // Use default size, will resize as needed
-        std::cerr << "Failed to pre-initialize GPU RNG" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to pre-initialize GPU RNG");
         return false;
     }
     
     // Force buffer allocation now while context is current
     if (!gpuRNG_->ensureBuffersAllocated()) {
-        std::cerr << "Failed to pre-allocate GPU RNG buffers" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to pre-allocate GPU RNG buffers");
         return false;
     }
-    std::cout << "GPU RNG buffers pre-allocated successfully" << std::endl;
+    LOG_INFO(LogChannel::GPU, "GPU RNG buffers pre-allocated successfully");
     
     // Pre-allocate scene buffers to avoid context issues in worker threads
-    std::cout << "Pre-allocating GPU scene buffers..." << std::endl;
+    LOG_INFO(LogChannel::GPU, "Pre-allocating GPU scene buffers...");
     if (!prepareGPUScene()) {
-        std::cerr << "Failed to pre-allocate GPU scene buffers" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to pre-allocate GPU scene buffers");
         return false;
     }
-    std::cout << "GPU scene buffers pre-allocated successfully" << std::endl;
+    LOG_INFO(LogChannel::GPU, "GPU scene buffers pre-allocated successfully");
     
     // Load texture OpenGL functions in main thread where context is current
     if (!loadTextureOpenGLFunctions()) {
-        std::cerr << "Failed to load texture OpenGL functions during GPU initialization" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to load texture OpenGL functions during GPU initialization");
         return false;
     }
-    std::cout << "Texture OpenGL functions loaded in main thread" << std::endl;
+    LOG_INFO(LogChannel::GPU, "Texture OpenGL functions loaded in main thread");
     
     // Pre-create output texture to avoid context issues in worker threads
-    std::cout << "Pre-creating GPU output texture..." << std::endl;
+    LOG_INFO(LogChannel::GPU, "Pre-creating GPU output texture...");
     glGenTextures(1, &outputTexture_);
-    std::cout << "Generated texture ID: " << outputTexture_ << std::endl;
+    LOG_DEBUG(LogChannel::GPU, "Generated texture ID: " << outputTexture_);
     
     if (outputTexture_ == 0) {
-        std::cerr << "Failed to pre-create output texture" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to pre-create output texture");
         return false;
     }
-    std::cout << "GPU output texture pre-created with ID: " << outputTexture_ << std::endl;
+    LOG_INFO(LogChannel::GPU, "GPU output texture pre-created with ID: " << outputTexture_);
     
     // Compile ray tracing shader
     if (!compileRayTracingShader()) {
-        std::cerr << "Failed to compile ray tracing shader" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to compile ray tracing shader");
         return false;
     }
     
-    std::cout << "GPU path tracing initialized successfully" << std::endl;
-    std::cout << "GPU Info: " << gpuPipeline_->getDriverInfo() << std::endl;
+    LOG_INFO(LogChannel::GPU, "GPU path tracing initialized successfully");
+    LOG_INFO(LogChannel::GPU, "GPU Info: " << gpuPipeline_->getDriverInfo());
     return true;
 }
 
@@ -588,6 +1567,11 @@ void PathTracer::cleanupGPU() {
         gpuRNG_.reset();
     }
     
+    reservoirBuffers_[0].reset();
+    reservoirBuffers_[1].reset();
+    reservoirWidth_ = reservoirHeight_ = 0;
+    reservoirHistoryValid_ = false;
+    
     if (gpuMemory_) {
         gpuMemory_->cleanup();
         gpuMemory_.reset();
@@ -609,7 +1593,7 @@ bool PathTracer::compileRayTracingShader() {
     // Shader loading logging removed for cleaner output
     std::ifstream shaderFile(shaderPath);
     if (!shaderFile.is_open()) {
-        std::cerr << "Failed to open ray tracing shader file: " << shaderPath << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to open ray tracing shader file: " << shaderPath);
         return false;
     }
     
@@ -623,13 +1607,13 @@ bool PathTracer::compileRayTracingShader() {
     
     // Compile shader
     if (!gpuPipeline_->compileShader(shaderSource)) {
-        std::cerr << "Failed to compile ray tracing shader: " << gpuPipeline_->getErrorMessage() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to compile ray tracing shader: " << gpuPipeline_->getErrorMessage());
         return false;
     }
     
     // Link program
     if (!gpuPipeline_->linkProgram()) {
-        std::cerr << "Failed to link ray tracing program: " << gpuPipeline_->getErrorMessage() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to link ray tracing program: " << gpuPipeline_->getErrorMessage());
         return false;
     }
     
@@ -641,6 +1625,8 @@ bool PathTracer::compileRayTracingShader() {
 }
 
 bool PathTracer::trace_gpu(int width, int height) {
+    PROFILE_FUNCTION();
+    linear_image_.clear();
     // Use async approach for better responsiveness
     if (!start_gpu_async(width, height)) {
         return false;
@@ -663,46 +1649,51 @@ bool PathTracer::trace_gpu(int width, int height) {
     }
     
     if (waited_ms >= MAX_WAIT_MS) {
-        std::cerr << "GPU rendering timed out after " << MAX_WAIT_MS << "ms" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU rendering timed out after " << MAX_WAIT_MS << "ms");
         async_gpu_state_.active = false;
         return false;
     }
     
-    return finalize_gpu_result(width, height);
+    if (!finalize_gpu_result(width, height)) {
+        return false;
+    }
+    write_gpu_aovs(width, height);
+    return true;
 }
 
 bool PathTracer::trace_gpu_progressive(int width, int height) {
+    linear_image_.clear();
     // Similar to trace_gpu but with linear output for progressive accumulation
     if (!isGPUAvailable()) {
-        std::cerr << "GPU not available for progressive ray tracing" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU not available for progressive ray tracing");
         return false;
     }
     
     SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
     if (!currentContext) {
-        std::cerr << "ERROR: GPU progressive operations require OpenGL context" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU progressive operations require OpenGL context");
         return false;
     }
     
     // Prepare for rendering with linear output
     if (!compileRayTracingShader()) {
-        std::cerr << "Failed to compile shader for progressive rendering" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to compile shader for progressive rendering");
         return false;
     }
     
     if (!gpuRNG_->isInitialized()) {
-        std::cerr << "GPU RNG not initialized for progressive rendering" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU RNG not initialized for progressive rendering");
         return false;
     }
     
     if (!prepareGPUScene()) {
-        std::cerr << "Failed to prepare scene for progressive rendering" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to prepare scene for progressive rendering");
         return false;
     }
     
     // Dispatch with linear output enabled
     if (!dispatchGPUComputeProgressive(width, height, samples_per_pixel_)) {
-        std::cerr << "Failed to dispatch progressive GPU compute" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to dispatch progressive GPU compute");
         return false;
     }
     
@@ -713,40 +1704,40 @@ bool PathTracer::trace_gpu_progressive(int width, int height) {
 bool PathTracer::start_gpu_async(int width, int height) {
 #ifdef USE_GPU
     if (!isGPUAvailable()) {
-        std::cerr << "GPU not available for ray tracing" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU not available for ray tracing");
         return false;
     }
     
     if (async_gpu_state_.active) {
-        std::cerr << "GPU async operation already in progress" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU async operation already in progress");
         return false;
     }
     
     SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
     if (!currentContext) {
-        std::cerr << "ERROR: GPU operations require OpenGL context" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU operations require OpenGL context");
         return false;
     }
     
     // Prepare for async operation
     if (!compileRayTracingShader()) {
-        std::cerr << "Failed to compile shader" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to compile shader");
         return false;
     }
     
     if (!gpuRNG_->isInitialized()) {
-        std::cerr << "GPU RNG not initialized" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU RNG not initialized");
         return false;
     }
     
     if (!prepareGPUScene()) {
-        std::cerr << "Failed to prepare scene" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to prepare scene");
         return false;
     }
     
     // Start async GPU work
     if (!dispatchGPUComputeAsync(width, height, samples_per_pixel_)) {
-        std::cerr << "Failed to dispatch async GPU compute" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to dispatch async GPU compute");
         return false;
     }
     
@@ -776,15 +1767,16 @@ bool PathTracer::is_gpu_complete() {
 }
 
 bool PathTracer::finalize_gpu_result(int width, int height) {
+    PROFILE_FUNCTION();
 #ifdef USE_GPU
     if (!async_gpu_state_.active) {
-        std::cerr << "No async GPU operation to finalize" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No async GPU operation to finalize");
         return false;
     }
     
     // Ensure the operation is complete
     if (!is_gpu_complete()) {
-        std::cerr << "Attempting to finalize incomplete GPU operation" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Attempting to finalize incomplete GPU operation");
         return false;
     }
     
@@ -819,23 +1811,23 @@ bool PathTracer::trace_hybrid(int width, int height, RenderMode mode) {
 #ifdef USE_GPU
             SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
             if (currentContext) {
-                std::cout << "Hybrid mode: Attempting GPU rendering (OpenGL context available)" << std::endl;
+                LOG_DEBUG(LogChannel::GPU, "Hybrid mode: Attempting GPU rendering (OpenGL context available)");
                 if (trace_gpu(width, height)) {
                     return true;
                 } else {
-                    std::cout << "GPU rendering failed, falling back to CPU" << std::endl;
+                    LOG_WARN(LogChannel::GPU, "GPU rendering failed, falling back to CPU");
                     return trace_interruptible(width, height);
                 }
             } else {
-                std::cout << "Hybrid mode: GPU selected but no OpenGL context (background thread) - using CPU" << std::endl;
+                LOG_DEBUG(LogChannel::GPU, "Hybrid mode: GPU selected but no OpenGL context (background thread) - using CPU");
                 return trace_interruptible(width, height);
             }
 #else
-            std::cout << "Hybrid mode: GPU selected but GPU support not compiled - using CPU" << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "Hybrid mode: GPU selected but GPU support not compiled - using CPU");
             return trace_interruptible(width, height);
 #endif
         } else {
-            std::cout << "Hybrid mode: Using CPU for rendering" << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "Hybrid mode: Using CPU for rendering");
             return trace_interruptible(width, height);
         }
     }
@@ -850,18 +1842,19 @@ bool PathTracer::shouldUseGPU(int width, int height, int samples) const {
     int totalWork = width * height * samples;
     const int GPU_THRESHOLD = 50000; // Adjusted for reduced sample counts - GPU worthwhile for medium+ workloads
     
-    std::cout << "GPU heuristic: totalWork=" << totalWork << ", threshold=" << GPU_THRESHOLD << std::endl;
+    LOG_DEBUG(LogChannel::GPU, "GPU heuristic: totalWork=" << totalWork << ", threshold=" << GPU_THRESHOLD);
     
     bool useGPU = totalWork > GPU_THRESHOLD;
     if (useGPU) {
-        std::cout << "Hybrid mode: Workload exceeds threshold - attempting GPU" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Hybrid mode: Workload exceeds threshold - attempting GPU");
     } else {
-        std::cout << "Hybrid mode: Small workload - using CPU" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Hybrid mode: Small workload - using CPU");
     }
     return useGPU;
 }
 
 bool PathTracer::prepareGPUScene() {
+    PROFILE_FUNCTION();
     if (!scene_manager_ || !gpuMemory_) {
         return false;
     }
@@ -875,12 +1868,21 @@ bool PathTracer::prepareGPUScene() {
     // primitive_type: 1.0=sphere, 2.0=cube, 3.0=torus, 4.0=pyramid
     // Each primitive now uses 3 vec4s (12 floats) for alignment
     
+    gpuLightIndices_.clear();
+    
     for (const auto& object : objects) {
         if (!object) continue;
         
         Vector3 pos = object->position();
         Material mat = object->material();
         
+        // Emissive spheres are the light list for resampled direct lighting
+        int primitiveIndex = static_cast<int>(sceneData.size() / 12);
+        if (mat.is_emissive() && std::dynamic_pointer_cast<Sphere>(object) &&
+            gpuLightIndices_.size() < static_cast<size_t>(MAX_GPU_LIGHTS)) {
+            gpuLightIndices_.push_back(primitiveIndex);
+        }
+        
         // Determine primitive type and size
         float size = 0.5f;  // default
         float primitiveType = 1.0f;  // sphere by default (matching PrimitiveType::SPHERE)
@@ -921,13 +1923,13 @@ bool PathTracer::prepareGPUScene() {
     );
     
     if (!sceneBuffer_) {
-        std::cerr << "Failed to allocate scene buffer" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to allocate scene buffer");
         return false;
     }
     
     // Transfer scene data to GPU
     if (!gpuMemory_->transferToGPU(sceneBuffer_, sceneData.data(), sceneBufferSize)) {
-        std::cerr << "Failed to transfer scene data to GPU" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to transfer scene data to GPU");
         return false;
     }
     
@@ -936,13 +1938,14 @@ bool PathTracer::prepareGPUScene() {
 }
 
 bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
+    PROFILE_FUNCTION();
     if (!gpuPipeline_ || !sceneBuffer_ || !gpuRNG_) {
         return false;
     }
     
     // Texture functions should already be loaded in main thread
     if (!glGenTextures_ptr || !glBindTexture_ptr || !glGetTexImage_ptr) {
-        std::cerr << "Texture OpenGL functions not loaded" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Texture OpenGL functions not loaded");
         return false;
     }
     
@@ -960,13 +1963,13 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
         if (SDL_GL_MakeCurrent(gl_window_, gl_context_) == 0) {
             // Context activation success logging removed for cleaner output
         } else {
-            std::cout << "Context activation failed: " << SDL_GetError() << std::endl;
-            std::cout << "Proceeding anyway - may work if context is implicitly available" << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "Context activation failed: " << SDL_GetError());
+            LOG_DEBUG(LogChannel::GPU, "Proceeding anyway - may work if context is implicitly available");
         }
     } else if (currentContext) {
         // Context current status logging removed for cleaner output
     } else {
-        std::cout << "No stored context available, proceeding with current state" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "No stored context available, proceeding with current state");
     }
     
     // Create texture fresh for this render to avoid context issues
@@ -981,7 +1984,7 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     // Create texture in current context
     glGenTextures(1, &outputTexture_);
     if (outputTexture_ == 0) {
-        std::cerr << "ERROR: Failed to create fresh texture!" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to create fresh texture!");
         return false;
     }
     // Texture ID logging removed for cleaner output
@@ -1000,7 +2003,7 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     // Texture validation logging removed for cleaner output
     
     if (!isValid) {
-        std::cerr << "ERROR: Fresh texture creation failed!" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Fresh texture creation failed!");
         return false;
     }
     
@@ -1011,7 +2014,7 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     
     // Simple validation - check if program ID is valid
     if (rayTracingProgram_ == 0) {
-        std::cerr << "ERROR: Shader program ID is 0 (invalid)!" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Shader program ID is 0 (invalid)!");
         return false;
     }
     
@@ -1022,8 +2025,8 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     // Check for errors after shader activation
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error after glUseProgram: " << error << std::endl;
-        std::cerr << "This likely means the shader program is invalid or not linked properly" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error after glUseProgram: " << error);
+        LOG_ERROR(LogChannel::GPU, "This likely means the shader program is invalid or not linked properly");
         return false;
     }
     
@@ -1039,7 +2042,7 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     // Check for OpenGL errors after image binding
     error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error after binding image texture: " << error << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error after binding image texture: " << error);
         return false;
     }
     // Image texture bind success logging removed for cleaner output
@@ -1050,6 +2053,11 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     // Bind RNG buffer
     gpuMemory_->bindBuffer(gpuRNG_->getRNGBuffer(), 2);
     
+    // Reservoir history/output for resampled preview lighting
+    if (gpuResamplingActive_ && !bindReservoirBuffers(width, height)) {
+        gpuResamplingActive_ = false;
+    }
+    
     // Set uniforms
     updateGPUUniforms(width, height, samples);
     
@@ -1064,19 +2072,19 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     // Check for errors before dispatch
     error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error before dispatch: " << error << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error before dispatch: " << error);
         return false;
     }
     
     if (!gpuPipeline_->dispatch(workGroupsX, workGroupsY, 1)) {
-        std::cerr << "Failed to dispatch GPU compute: " << gpuPipeline_->getErrorMessage() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to dispatch GPU compute: " << gpuPipeline_->getErrorMessage());
         return false;
     }
     
     // Check for errors after dispatch
     error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error after dispatch: " << error << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error after dispatch: " << error);
         return false;
     }
     
@@ -1089,11 +2097,16 @@ bool PathTracer::dispatchGPUCompute(int width, int height, int samples) {
     // Additional sync
     glFinish();
     
+    if (gpuResamplingActive_) {
+        finishReservoirFrame();
+    }
+    
     // GPU dispatch completion logging removed for cleaner output
     return true;
 }
 
 bool PathTracer::dispatchGPUComputeAsync(int width, int height, int samples) {
+    PROFILE_FUNCTION();
 #ifdef USE_GPU
     if (!gpuPipeline_ || !sceneBuffer_ || !gpuRNG_) {
         return false;
@@ -1101,14 +2114,14 @@ bool PathTracer::dispatchGPUComputeAsync(int width, int height, int samples) {
     
     // Texture functions should already be loaded in main thread
     if (!glGenTextures_ptr || !glBindTexture_ptr || !glGetTexImage_ptr) {
-        std::cerr << "Texture OpenGL functions not loaded" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Texture OpenGL functions not loaded");
         return false;
     }
     
     // Ensure OpenGL context is current before texture operations
     SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
     if (!currentContext) {
-        std::cerr << "No OpenGL context for async GPU dispatch" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No OpenGL context for async GPU dispatch");
         return false;
     }
     
@@ -1122,7 +2135,7 @@ bool PathTracer::dispatchGPUComputeAsync(int width, int height, int samples) {
     // Create texture in current context - SAME FORMAT AS SYNC VERSION
     safe_glGenTextures(1, &outputTexture_);
     if (outputTexture_ == 0) {
-        std::cerr << "ERROR: Failed to create fresh texture for async!" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to create fresh texture for async!");
         return false;
     }
     
@@ -1137,7 +2150,7 @@ bool PathTracer::dispatchGPUComputeAsync(int width, int height, int samples) {
     
     unsigned int error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error setting up texture: " << error << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error setting up texture: " << error);
         return false;
     }
     
@@ -1168,14 +2181,14 @@ bool PathTracer::dispatchGPUComputeAsync(int width, int height, int samples) {
     
     // Dispatch asynchronously - this is the key difference!
     if (!gpuPipeline_->dispatchAsync(num_groups_x, num_groups_y, 1)) {
-        std::cerr << "Failed to dispatch GPU compute async: " << gpuPipeline_->getErrorMessage() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to dispatch GPU compute async: " << gpuPipeline_->getErrorMessage());
         return false;
     }
     
     // Check for errors after dispatch
     error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error after async dispatch: " << error << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error after async dispatch: " << error);
         return false;
     }
     
@@ -1190,6 +2203,7 @@ bool PathTracer::dispatchGPUComputeAsync(int width, int height, int samples) {
 }
 
 bool PathTracer::dispatchGPUComputeProgressive(int width, int height, int samples) {
+    PROFILE_FUNCTION();
     // Same as dispatchGPUCompute but with linear output for progressive accumulation
     if (!gpuPipeline_ || !sceneBuffer_ || !gpuRNG_) {
         return false;
@@ -1198,7 +2212,7 @@ bool PathTracer::dispatchGPUComputeProgressive(int width, int height, int sample
     // Ensure OpenGL context is current
     SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
     if (!currentContext) {
-        std::cerr << "No OpenGL context for progressive GPU dispatch" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No OpenGL context for progressive GPU dispatch");
         return false;
     }
     
@@ -1211,7 +2225,7 @@ bool PathTracer::dispatchGPUComputeProgressive(int width, int height, int sample
     // Create texture in current context
     safe_glGenTextures(1, &outputTexture_);
     if (outputTexture_ == 0) {
-        std::cerr << "ERROR: Failed to create texture for progressive rendering!" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to create texture for progressive rendering!");
         return false;
     }
     
@@ -1228,7 +2242,7 @@ bool PathTracer::dispatchGPUComputeProgressive(int width, int height, int sample
     // Check for errors after shader activation
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error after glUseProgram in progressive: " << error << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error after glUseProgram in progressive: " << error);
         return false;
     }
     
@@ -1251,14 +2265,14 @@ bool PathTracer::dispatchGPUComputeProgressive(int width, int height, int sample
     
     // Dispatch compute shader
     if (!gpuPipeline_->dispatch(workGroupsX, workGroupsY, 1)) {
-        std::cerr << "Failed to dispatch progressive GPU compute: " << gpuPipeline_->getErrorMessage() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to dispatch progressive GPU compute: " << gpuPipeline_->getErrorMessage());
         return false;
     }
     
     // Check for errors after dispatch
     error = glGetError();
     if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL error after progressive dispatch: " << error << std::endl;
+        LOG_ERROR(LogChannel::GPU, "OpenGL error after progressive dispatch: " << error);
         return false;
     }
     
@@ -1300,6 +2314,76 @@ void PathTracer::updateGPUUniforms(int width, int height, int samples, bool outp
     glUniform3f(glGetUniformLocation(rayTracingProgram_, "cameraLowerLeft"), lower_left.x, lower_left.y, lower_left.z);
     glUniform3f(glGetUniformLocation(rayTracingProgram_, "cameraHorizontal"), horizontal.x, horizontal.y, horizontal.z);
     glUniform3f(glGetUniformLocation(rayTracingProgram_, "cameraVertical"), vertical.x, vertical.y, vertical.z);
+    
+    // Resampled direct lighting (trace_gpu_preview only)
+    glUniform1i(glGetUniformLocation(rayTracingProgram_, "useResampledLighting"), gpuResamplingActive_ ? 1 : 0);
+    if (gpuResamplingActive_) {
+        const ResamplingConfig& config = light_resampler_->config();
+        glUniform1i(glGetUniformLocation(rayTracingProgram_, "resamplingCandidates"), config.initial_candidates);
+        glUniform1i(glGetUniformLocation(rayTracingProgram_, "spatialSamples"), config.spatial_reuse ? config.spatial_samples : 0);
+        glUniform1f(glGetUniformLocation(rayTracingProgram_, "spatialRadius"), config.spatial_radius);
+        glUniform1f(glGetUniformLocation(rayTracingProgram_, "historyLimit"), config.history_limit);
+        glUniform1f(glGetUniformLocation(rayTracingProgram_, "normalThreshold"), config.normal_threshold);
+        glUniform1f(glGetUniformLocation(rayTracingProgram_, "depthThreshold"), config.depth_threshold);
+        glUniform1i(glGetUniformLocation(rayTracingProgram_, "historyValid"),
+                    (config.temporal_reuse && reservoirHistoryValid_) ? 1 : 0);
+        
+        glUniform1i(glGetUniformLocation(rayTracingProgram_, "lightCount"), static_cast<int>(gpuLightIndices_.size()));
+        if (!gpuLightIndices_.empty()) {
+            glUniform1iv(glGetUniformLocation(rayTracingProgram_, "lightIndices"),
+                         static_cast<int>(gpuLightIndices_.size()), gpuLightIndices_.data());
+        }
+        
+        Vector3 prevPos = reservoirHistoryCamera_.get_position();
+        Vector3 prevLowerLeft = reservoirHistoryCamera_.get_lower_left_corner();
+        Vector3 prevHorizontal = reservoirHistoryCamera_.get_horizontal();
+        Vector3 prevVertical = reservoirHistoryCamera_.get_vertical();
+        glUniform3f(glGetUniformLocation(rayTracingProgram_, "prevCameraPosition"), prevPos.x, prevPos.y, prevPos.z);
+        glUniform3f(glGetUniformLocation(rayTracingProgram_, "prevCameraLowerLeft"), prevLowerLeft.x, prevLowerLeft.y, prevLowerLeft.z);
+        glUniform3f(glGetUniformLocation(rayTracingProgram_, "prevCameraHorizontal"), prevHorizontal.x, prevHorizontal.y, prevHorizontal.z);
+        glUniform3f(glGetUniformLocation(rayTracingProgram_, "prevCameraVertical"), prevVertical.x, prevVertical.y, prevVertical.z);
+    }
+}
+
+bool PathTracer::bindReservoirBuffers(int width, int height) {
+    if (!gpuMemory_) {
+        return false;
+    }
+    
+    // 4 vec4 per pixel: light sample, reservoir weights, surface position, surface normal
+    if (width != reservoirWidth_ || height != reservoirHeight_ || !reservoirBuffers_[0] || !reservoirBuffers_[1]) {
+        size_t bufferSize = static_cast<size_t>(width) * height * 16 * sizeof(float);
+        for (int i = 0; i < 2; ++i) {
+            if (reservoirBuffers_[i]) {
+                gpuMemory_->deallocateBuffer(reservoirBuffers_[i]);
+            }
+            reservoirBuffers_[i] = gpuMemory_->allocateBuffer(
+                bufferSize,
+                GPUBufferType::SHADER_STORAGE,
+                GPUUsagePattern::DYNAMIC,
+                i == 0 ? "reservoirs_a" : "reservoirs_b"
+            );
+            if (!reservoirBuffers_[i]) {
+                LOG_ERROR(LogChannel::GPU, "Failed to allocate reservoir buffer");
+                reservoirWidth_ = reservoirHeight_ = 0;
+                return false;
+            }
+        }
+        reservoirWidth_ = width;
+        reservoirHeight_ = height;
+        reservoirHistoryValid_ = false;
+    }
+    
+    gpuMemory_->bindBuffer(reservoirBuffers_[reservoirHistoryIndex_], 3);
+    gpuMemory_->bindBuffer(reservoirBuffers_[1 - reservoirHistoryIndex_], 4);
+    return true;
+}
+
+void PathTracer::finishReservoirFrame() {
+    // This frame's output becomes next frame's history
+    reservoirHistoryIndex_ = 1 - reservoirHistoryIndex_;
+    reservoirHistoryValid_ = true;
+    reservoirHistoryCamera_ = camera_;
 }
 
 void PathTracer::forceGPUShaderRecompilation() {
@@ -1324,6 +2408,8 @@ void PathTracer::forceGPUBufferRebind() {
 }
 
 bool PathTracer::trace_gpu_sync(int width, int height) {
+    PROFILE_FUNCTION();
+    linear_image_.clear();
 #ifdef USE_GPU
     // Completely synchronous GPU rendering bypassing async system
     if (!isGPUAvailable()) {
@@ -1332,7 +2418,7 @@ bool PathTracer::trace_gpu_sync(int width, int height) {
     
     SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
     if (!currentContext) {
-        std::cerr << "No OpenGL context for sync GPU rendering" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No OpenGL context for sync GPU rendering");
         return false;
     }
     
@@ -1355,15 +2441,43 @@ bool PathTracer::trace_gpu_sync(int width, int height) {
     }
     
     // Read back results
-    return readbackGPUResult(width, height);
+    if (!readbackGPUResult(width, height)) {
+        return false;
+    }
+    write_gpu_aovs(width, height);
+    return true;
 #else
     return false;
 #endif
 }
 
+void PathTracer::write_gpu_aovs(int width, int height) {
+    // The compute shader only writes colour; first-hit AOVs are traced on the
+    // CPU with the same camera, which costs one primary ray per pixel
+    if (requested_aovs_ == AOV_NONE) {
+        return;
+    }
+    begin_frame_buffers(width, height, false);
+    aovs_.fill_sample_count(static_cast<uint32_t>(samples_per_pixel_));
+}
+
+bool PathTracer::trace_gpu_preview(int width, int height) {
+    PROFILE_FUNCTION();
+    linear_image_.clear();
+    if (!direct_light_resampling_) {
+        return trace_gpu_sync(width, height);
+    }
+    
+    gpuResamplingActive_ = true;
+    bool success = trace_gpu_sync(width, height);
+    gpuResamplingActive_ = false;
+    return success;
+}
+
 bool PathTracer::readbackGPUResult(int width, int height) {
+    PROFILE_FUNCTION();
     if (outputTexture_ == 0) {
-        std::cerr << "ERROR: No output texture for readback" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No output texture for readback");
         return false;
     }
     
@@ -1411,30 +2525,30 @@ PerformanceMetrics PathTracer::benchmarkGPUvsCPU(int width, int height) {
     metrics.samplesPerPixel = samples_per_pixel_;
     
     // Benchmark CPU
-    std::cout << "Benchmarking CPU performance..." << std::endl;
+    LOG_INFO(LogChannel::PERF, "Benchmarking CPU performance...");
     auto cpuStart = std::chrono::high_resolution_clock::now();
     bool cpuSuccess = trace_interruptible(width, height);
     auto cpuEnd = std::chrono::high_resolution_clock::now();
     
     if (cpuSuccess) {
         metrics.cpuTime = std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count();
-        std::cout << "CPU time: " << metrics.cpuTime << " ms" << std::endl;
+        LOG_INFO(LogChannel::PERF, "CPU time: " << metrics.cpuTime << " ms");
     }
     
     // Benchmark GPU
     if (isGPUAvailable()) {
-        std::cout << "Benchmarking GPU performance..." << std::endl;
+        LOG_INFO(LogChannel::PERF, "Benchmarking GPU performance...");
         auto gpuStart = std::chrono::high_resolution_clock::now();
         bool gpuSuccess = trace_gpu(width, height);
         auto gpuEnd = std::chrono::high_resolution_clock::now();
         
         if (gpuSuccess) {
             metrics.gpuTime = std::chrono::duration<double, std::milli>(gpuEnd - gpuStart).count();
-            std::cout << "GPU time: " << metrics.gpuTime << " ms" << std::endl;
+            LOG_INFO(LogChannel::PERF, "GPU time: " << metrics.gpuTime << " ms");
             
             if (metrics.cpuTime > 0 && metrics.gpuTime > 0) {
                 metrics.speedupFactor = metrics.cpuTime / metrics.gpuTime;
-                std::cout << "GPU speedup: " << metrics.speedupFactor << "x" << std::endl;
+                LOG_INFO(LogChannel::PERF, "GPU speedup: " << metrics.speedupFactor << "x");
             }
         }
     }
@@ -1444,7 +2558,7 @@ PerformanceMetrics PathTracer::benchmarkGPUvsCPU(int width, int height) {
 
 bool PathTracer::validateGPUAccuracy(const std::vector<Color>& cpuResult, const std::vector<Color>& gpuResult, float tolerance) {
     if (cpuResult.size() != gpuResult.size()) {
-        std::cerr << "GPU accuracy validation failed: result sizes don't match" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU accuracy validation failed: result sizes don't match");
         return false;
     }
     
@@ -1468,17 +2582,17 @@ bool PathTracer::validateGPUAccuracy(const std::vector<Color>& cpuResult, const
     double averageError = totalError / pixelCount;
     double errorRate = static_cast<double>(errorPixels) / pixelCount;
     
-    std::cout << "GPU accuracy validation:" << std::endl;
-    std::cout << "  Average error: " << averageError << std::endl;
-    std::cout << "  Error pixels: " << errorPixels << "/" << pixelCount << " (" << (errorRate * 100) << "%)" << std::endl;
+    LOG_INFO(LogChannel::GPU, "GPU accuracy validation:");
+    LOG_INFO(LogChannel::GPU, "  Average error: " << averageError);
+    LOG_INFO(LogChannel::GPU, "  Error pixels: " << errorPixels << "/" << pixelCount << " (" << (errorRate * 100) << "%)");
     
     // Pass if average error is within tolerance and error rate is low
     bool passed = (averageError <= tolerance) && (errorRate <= 0.05); // Allow 5% error pixels
     
     if (passed) {
-        std::cout << "  Result: PASSED" << std::endl;
+        LOG_INFO(LogChannel::GPU, "  Result: PASSED");
     } else {
-        std::cout << "  Result: FAILED" << std::endl;
+        LOG_INFO(LogChannel::GPU, "  Result: FAILED");
     }
     
     return passed;
@@ -1486,17 +2600,17 @@ bool PathTracer::validateGPUAccuracy(const std::vector<Color>& cpuResult, const
 
 bool PathTracer::activateGPUContext() {
     if (!gl_window_ || !gl_context_) {
-        std::cerr << "No captured OpenGL context to activate" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No captured OpenGL context to activate");
         return false;
     }
     
-    std::cout << "Activating captured GPU context: " << gl_context_ << std::endl;
+    LOG_DEBUG(LogChannel::GPU, "Activating captured GPU context: " << gl_context_);
     
     if (SDL_GL_MakeCurrent(gl_window_, gl_context_) == 0) {
-        std::cout << "Successfully switched to GPU context: " << SDL_GL_GetCurrentContext() << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Successfully switched to GPU context: " << SDL_GL_GetCurrentContext());
         return true;
     } else {
-        std::cerr << "Failed to activate GPU context: " << SDL_GetError() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to activate GPU context: " << SDL_GetError());
         return false;
     }
 }
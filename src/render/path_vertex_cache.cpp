@@ -0,0 +1,98 @@
+#include "render/path_vertex_cache.h"
+#include <algorithm>
+
+namespace {
+
+bool same_vector(const Vector3& a, const Vector3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+} // namespace
+
+bool PathVertexFrame::same_rays(const PathVertexFrame& other, bool any_seed) const {
+    return width == other.width && height == other.height && tile_size == other.tile_size &&
+           (any_seed || seed == other.seed) &&
+           same_vector(camera_position, other.camera_position) &&
+           same_vector(camera_target, other.camera_target) &&
+           same_vector(camera_up, other.camera_up) &&
+           camera_fov == other.camera_fov && camera_aspect == other.camera_aspect &&
+           geometry == other.geometry;
+}
+
+PathVertexCache::PathVertexCache(const PathVertexCacheConfig& config)
+    : passes_(0), depth_(0), pixel_count_(0), recorded_passes_(0), reused_passes_(0), invalidations_(0) {
+    set_config(config);
+}
+
+void PathVertexCache::set_config(const PathVertexCacheConfig& config) {
+    config_ = config;
+    config_.passes = std::max(0, config_.passes);
+    config_.depth = std::clamp(config_.depth, 0, 2);
+    release();
+}
+
+bool PathVertexCache::begin_frame(const PathVertexFrame& frame, int tile_count) {
+    const size_t pixel_count = static_cast<size_t>(frame.width) * frame.height;
+    const size_t tile_slots = static_cast<size_t>(tile_count) * config_.passes;
+    if (!vertices_.empty() && frame_.same_rays(frame, false) && passes_ == config_.passes &&
+        depth_ == config_.depth && recorded_.size() == tile_slots) {
+        return true;
+    }
+    if (any_recorded()) {
+        invalidations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    frame_ = frame;
+    passes_ = config_.passes;
+    depth_ = config_.depth;
+    pixel_count_ = pixel_count;
+    vertices_.assign(pixel_count * passes_ * depth_, PathVertex());
+    recorded_.assign(tile_slots, 0);
+    return false;
+}
+
+bool PathVertexCache::holds(const PathVertexFrame& frame, bool any_seed) const {
+    return frame_.same_rays(frame, any_seed) && any_recorded();
+}
+
+void PathVertexCache::invalidate() {
+    if (any_recorded()) {
+        invalidations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::fill(recorded_.begin(), recorded_.end(), 0);
+}
+
+void PathVertexCache::release() {
+    vertices_.clear();
+    vertices_.shrink_to_fit();
+    recorded_.clear();
+    passes_ = 0;
+    depth_ = 0;
+    pixel_count_ = 0;
+    frame_ = PathVertexFrame();
+}
+
+bool PathVertexCache::any_recorded() const {
+    return std::find(recorded_.begin(), recorded_.end(), 1) != recorded_.end();
+}
+
+PathVertexSpan PathVertexCache::sample(int tile_index, size_t pixel, uint32_t pass) {
+    PathVertexSpan span;
+    span.vertices = &vertices_[(static_cast<size_t>(pass) * pixel_count_ + pixel) * depth_];
+    span.count = depth_;
+    span.reuse = is_recorded(tile_index, pass);
+    return span;
+}
+
+void PathVertexCache::finish_tile_pass(int tile_index, uint32_t pass, bool reused) {
+    recorded_[tile_slot(tile_index, pass)] = 1;
+    (reused ? reused_passes_ : recorded_passes_).fetch_add(1, std::memory_order_relaxed);
+}
+
+PathVertexCacheStats PathVertexCache::get_stats() const {
+    PathVertexCacheStats stats;
+    stats.bytes = vertices_.size() * sizeof(PathVertex);
+    stats.recorded_passes = recorded_passes_.load(std::memory_order_relaxed);
+    stats.reused_passes = reused_passes_.load(std::memory_order_relaxed);
+    stats.invalidations = invalidations_.load(std::memory_order_relaxed);
+    return stats;
+}
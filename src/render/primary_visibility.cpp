@@ -0,0 +1,147 @@
+#include "render/primary_visibility.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool project_bounds(const Camera& camera, const AABB& bounds, int width, int height, PixelRect& rect) {
+    if (bounds.empty()) {
+        return false;
+    }
+    const Vector3 origin = camera.get_position();
+    const Vector3 corner = camera.get_lower_left_corner();
+    const Vector3 horizontal = camera.get_horizontal();
+    const Vector3 vertical = camera.get_vertical();
+    // The image plane is perpendicular to the ray through its centre
+    const Vector3 forward = corner + horizontal * 0.5f + vertical * 0.5f - origin;
+    const float forward_sq = forward.dot(forward);
+
+    float u0 = std::numeric_limits<float>::max(), v0 = u0;
+    float u1 = -u0, v1 = -u0;
+    bool whole_frame = false;
+    int behind = 0;
+    for (int i = 0; i < 8; ++i) {
+        Vector3 p((i & 1) ? bounds.upper.x : bounds.lower.x,
+                  (i & 2) ? bounds.upper.y : bounds.lower.y,
+                  (i & 4) ? bounds.upper.z : bounds.lower.z);
+        Vector3 d = p - origin;
+        float depth = d.dot(forward);
+        if (!std::isfinite(depth)) {
+            whole_frame = true;
+            break;
+        }
+        if (depth <= 1e-6f * forward_sq) {
+            ++behind;
+            continue;
+        }
+        Vector3 on_plane = origin + d * (forward_sq / depth) - corner;
+        float u = on_plane.dot(horizontal) / horizontal.dot(horizontal);
+        float v = on_plane.dot(vertical) / vertical.dot(vertical);
+        u0 = std::min(u0, u);
+        u1 = std::max(u1, u);
+        v0 = std::min(v0, v);
+        v1 = std::max(v1, v);
+    }
+
+    if (behind == 8) {
+        return false;
+    }
+    if (whole_frame || behind > 0) {
+        rect = PixelRect{0, 0, width, height};
+        return true;
+    }
+    // One pixel of margin for rays jittered across pixel edges
+    rect.x0 = std::max(0, static_cast<int>(std::floor(std::max(u0, -1.0f) * width)) - 1);
+    rect.y0 = std::max(0, static_cast<int>(std::floor(std::max(v0, -1.0f) * height)) - 1);
+    rect.x1 = std::min(width, static_cast<int>(std::ceil(std::min(u1, 2.0f) * width)) + 1);
+    rect.y1 = std::min(height, static_cast<int>(std::ceil(std::min(v1, 2.0f) * height)) + 1);
+    return rect.x0 < rect.x1 && rect.y0 < rect.y1;
+}
+
+namespace {
+
+// Distance from point to the nearest point of bounds, 0 inside them
+float distance_to_bounds(const Vector3& point, const AABB& bounds) {
+    Vector3 nearest(std::clamp(point.x, bounds.lower.x, bounds.upper.x),
+                    std::clamp(point.y, bounds.lower.y, bounds.upper.y),
+                    std::clamp(point.z, bounds.lower.z, bounds.upper.z));
+    float distance = (nearest - point).length();
+    return std::isfinite(distance) ? distance : 0.0f;
+}
+
+} // namespace
+
+void PrimaryVisibility::build(const SceneManager& scene, const Camera& camera, int width, int height) {
+    footprints_.clear();
+    const auto& objects = scene.get_objects();
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const AABB bounds = objects[i]->bounding_box();
+        PixelRect rect;
+        if (!project_bounds(camera, bounds, width, height, rect)) {
+            continue;
+        }
+        footprints_.push_back(Footprint{rect, distance_to_bounds(camera.get_position(), bounds),
+                                        static_cast<int>(i), objects[i].get(),
+                                        dynamic_cast<const Torus*>(objects[i].get()) != nullptr});
+    }
+    std::sort(footprints_.begin(), footprints_.end(), [](const Footprint& a, const Footprint& b) {
+        return a.near_distance != b.near_distance ? a.near_distance < b.near_distance : a.object < b.object;
+    });
+}
+
+void PrimaryVisibility::clear() {
+    footprints_.clear();
+    footprints_.shrink_to_fit();
+}
+
+bool PrimaryVisibility::bin_tile(const RenderTile& tile, std::vector<uint32_t>& candidates) const {
+    candidates.clear();
+    bool nearest_first = true;
+    for (size_t i = 0; i < footprints_.size(); ++i) {
+        if (footprints_[i].rect.overlaps(tile)) {
+            candidates.push_back(static_cast<uint32_t>(i));
+            nearest_first = nearest_first && !footprints_[i].order_dependent;
+        }
+    }
+    return nearest_first;
+}
+
+bool PrimaryVisibility::covers(const std::vector<uint32_t>& candidates, int x, int y) const {
+    for (uint32_t candidate : candidates) {
+        if (footprints_[candidate].rect.contains(x, y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PrimaryVisibility::hit(const std::vector<uint32_t>& candidates, int x, int y, const Ray& ray,
+                            float t_min, HitRecord& rec) const {
+    // Camera rays are not normalized, so distances along them are t * length
+    const float ray_length = ray.direction.length();
+    float closest = std::numeric_limits<float>::infinity();
+    int closest_object = -1;
+    HitRecord temp_rec;
+    for (uint32_t candidate : candidates) {
+        const Footprint& footprint = footprints_[candidate];
+        // Every later footprint starts further away; the margin absorbs rounding in t
+        if (footprint.near_distance > closest * ray_length * 1.001f + 1e-4f) {
+            break;
+        }
+        if (!footprint.rect.contains(x, y)) {
+            continue;
+        }
+        // hit_scene accepts t == t_max, so equal distances go to the higher
+        // object index: a lower index must be strictly nearer to replace it
+        float t_max = footprint.object < closest_object ? std::nextafter(closest, -std::numeric_limits<float>::infinity())
+                                                        : closest;
+        if (footprint.primitive->hit(ray, t_min, t_max, temp_rec)) {
+            closest = temp_rec.t;
+            closest_object = footprint.object;
+            rec = temp_rec;
+            rec.object_index = footprint.object;
+        }
+    }
+    return closest_object >= 0;
+}
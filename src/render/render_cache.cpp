@@ -0,0 +1,219 @@
+#include "render/render_cache.h"
+#include "core/logger.h"
+#include "code_version.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+constexpr const char* ENTRY_EXTENSION = ".accum";
+
+void hash_bytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+template <typename T>
+void hash_value(uint64_t& hash, const T& value) {
+    hash_bytes(hash, &value, sizeof(value));
+}
+
+void hash_vector(uint64_t& hash, const Vector3& v) {
+    hash_value(hash, v.x);
+    hash_value(hash, v.y);
+    hash_value(hash, v.z);
+}
+
+// Passes of an entry, 0 unless it is the single range [0, n)
+uint32_t leading_passes(const AccumulationHeader& header) {
+    if (header.ranges.size() != 1 || header.ranges[0].first != 0) {
+        return 0;
+    }
+    return header.ranges[0].count;
+}
+
+bool parse_key(const std::string& stem, uint64_t& key) {
+    if (stem.size() != 16 || stem.find_first_not_of("0123456789abcdef") != std::string::npos) {
+        return false;
+    }
+    key = std::stoull(stem, nullptr, 16);
+    return true;
+}
+
+} // namespace
+
+uint64_t render_cache_key(const AccumulationHeader& identity, int tile_size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const char* code_version = PATHTRACER_CODE_VERSION;
+    hash_bytes(hash, code_version, std::strlen(code_version));
+    hash_value(hash, RenderCache::KEY_VERSION);
+    hash_value(hash, identity.width);
+    hash_value(hash, identity.height);
+    hash_value(hash, identity.max_depth);
+    hash_value(hash, identity.seed);
+    hash_value(hash, tile_size);
+    hash_vector(hash, identity.camera_position);
+    hash_vector(hash, identity.camera_target);
+    hash_vector(hash, identity.camera_up);
+    hash_value(hash, identity.camera_fov);
+    hash_value(hash, identity.camera_aspect);
+    hash_value(hash, identity.scene_hash);
+    return hash;
+}
+
+RenderCache::RenderCache(const Config& config) : config_(config) {}
+
+std::string RenderCache::path(uint64_t key) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(config_.directory) / (std::string(name) + ENTRY_EXTENSION)).string();
+}
+
+bool RenderCache::open() {
+    std::error_code error;
+    std::filesystem::create_directories(config_.directory, error);
+    if (!std::filesystem::is_directory(config_.directory, error)) {
+        LOG_ERROR(LogChannel::RENDER, "Render cache directory " << config_.directory << " is not usable");
+        return false;
+    }
+
+    // Index what earlier runs left, oldest modification first
+    std::vector<std::pair<std::filesystem::file_time_type, uint64_t>> order;
+    std::map<uint64_t, Entry> entries;
+    for (const auto& file : std::filesystem::directory_iterator(config_.directory, error)) {
+        uint64_t key = 0;
+        AccumulationHeader header;
+        if (file.path().extension() != ENTRY_EXTENSION || !parse_key(file.path().stem().string(), key) ||
+            !AccumulationFile::read_header(file.path().string(), header) || leading_passes(header) == 0) {
+            continue;
+        }
+        Entry entry;
+        entry.bytes = file.file_size(error);
+        entry.passes = leading_passes(header);
+        entries[key] = entry;
+        order.emplace_back(file.last_write_time(error), key);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_ = std::move(entries);
+    for (const auto& item : order) {
+        entries_[item.second].last_used = ++clock_;
+    }
+    evict_locked(0);
+    LOG_INFO(LogChannel::RENDER, "Render cache " << config_.directory << ": " << entries_.size() << " entries");
+    return true;
+}
+
+bool RenderCache::lookup(uint64_t key, uint32_t max_passes, bool need_variance, AccumulationFile& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.passes > max_passes) {
+        ++stats_.misses;
+        return false;
+    }
+    if (!AccumulationFile::load(path(key), entry) || leading_passes(entry.header) != it->second.passes) {
+        LOG_WARN(LogChannel::RENDER, "Dropping unreadable render cache entry " << path(key));
+        std::error_code error;
+        std::filesystem::remove(path(key), error);
+        entries_.erase(it);
+        ++stats_.misses;
+        return false;
+    }
+    if (need_variance && !entry.header.has_variance) {
+        ++stats_.misses;
+        return false;
+    }
+    touch(key, it->second);
+    if (it->second.passes == max_passes) {
+        ++stats_.hits;
+    } else {
+        ++stats_.partial_hits;
+    }
+    return true;
+}
+
+bool RenderCache::store(uint64_t key, const AccumulationFile& file) {
+    const uint32_t passes = leading_passes(file.header);
+    if (passes == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end() && it->second.passes >= passes &&
+        (it->second.passes > passes || !file.header.has_variance)) {
+        return true;
+    }
+    const std::string filename = path(key);
+    if (!file.save(filename)) {
+        return false;
+    }
+    std::error_code error;
+    Entry& entry = entries_[key];
+    entry.bytes = std::filesystem::file_size(filename, error);
+    entry.passes = passes;
+    ++stats_.stores;
+    touch(key, entry);
+    evict_locked(key);
+    if (entry.bytes > config_.max_bytes) {
+        std::filesystem::remove(filename, error);
+        entries_.erase(key);
+        return false;
+    }
+    return true;
+}
+
+void RenderCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code error;
+    for (const auto& item : entries_) {
+        std::filesystem::remove(path(item.first), error);
+    }
+    entries_.clear();
+}
+
+RenderCache::Stats RenderCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.entries = entries_.size();
+    for (const auto& item : entries_) {
+        stats.bytes += item.second.bytes;
+    }
+    return stats;
+}
+
+void RenderCache::touch(uint64_t key, Entry& entry) {
+    entry.last_used = ++clock_;
+    std::error_code error;
+    std::filesystem::last_write_time(path(key), std::filesystem::file_time_type::clock::now(), error);
+}
+
+void RenderCache::evict_locked(uint64_t keep) {
+    uint64_t total = 0;
+    for (const auto& item : entries_) {
+        total += item.second.bytes;
+    }
+    while (total > config_.max_bytes) {
+        auto oldest = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first != keep && (oldest == entries_.end() || it->second.last_used < oldest->second.last_used)) {
+                oldest = it;
+            }
+        }
+        if (oldest == entries_.end()) {
+            break;
+        }
+        std::error_code error;
+        std::filesystem::remove(path(oldest->first), error);
+        total -= oldest->second.bytes;
+        entries_.erase(oldest);
+        ++stats_.evictions;
+    }
+}
@@ -0,0 +1,309 @@
+#include "render/render_checkpoint.h"
+#include "core/logger.h"
+#include "core/profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+namespace {
+
+const char MAGIC[8] = {'P', 'T', 'C', 'K', 'P', 'T', '\0', '\0'};
+
+uint64_t fnv1a(const char* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+class Writer {
+public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "raw writes need trivially copyable types");
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void put(const Vector3& v) {
+        put(v.x);
+        put(v.y);
+        put(v.z);
+    }
+    template <typename T>
+    void put_array(const T* values, size_t count) {
+        bytes.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+    }
+
+    std::string bytes;
+};
+
+class Reader {
+public:
+    Reader(const std::string& bytes, size_t size) : data_(bytes.data()), size_(size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        return get_array(&value, 1);
+    }
+    bool get(Vector3& v) {
+        return get(v.x) && get(v.y) && get(v.z);
+    }
+    template <typename T>
+    bool get_array(T* values, size_t count) {
+        if (count > (size_ - offset_) / sizeof(T)) {
+            return false;
+        }
+        std::memcpy(values, data_ + offset_, count * sizeof(T));
+        offset_ += count * sizeof(T);
+        return true;
+    }
+    bool at_end() const { return offset_ == size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+bool same_vector(const Vector3& a, const Vector3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+} // namespace
+
+bool RenderCheckpoint::same_render(const RenderCheckpoint& other) const {
+    return width == other.width && height == other.height && max_depth == other.max_depth &&
+           same_vector(camera_position, other.camera_position) &&
+           same_vector(camera_target, other.camera_target) &&
+           same_vector(camera_up, other.camera_up) &&
+           camera_fov == other.camera_fov && camera_aspect == other.camera_aspect &&
+           scene_hash == other.scene_hash;
+}
+
+uint32_t RenderCheckpoint::min_samples() const {
+    if (sample_counts.empty()) {
+        return 0;
+    }
+    return *std::min_element(sample_counts.begin(), sample_counts.end());
+}
+
+bool RenderCheckpoint::save(const std::string& filename) const {
+    PROFILE_FUNCTION();
+    const uint64_t pixel_count = static_cast<uint64_t>(width) * height;
+    if (accumulation.size() != pixel_count || sample_counts.size() != pixel_count) {
+        return false;
+    }
+    const uint32_t has_moments = luminance_sum.size() == pixel_count && luminance_sq_sum.size() == pixel_count;
+
+    Writer out;
+    out.bytes.reserve(pixel_count * (3 + 2 * has_moments) * sizeof(float) + 256);
+    out.put_array(MAGIC, sizeof(MAGIC));
+    out.put(VERSION);
+    out.put(width);
+    out.put(height);
+    out.put(tile_size);
+    out.put(max_depth);
+    out.put(config.initialSamples);
+    out.put(config.targetSamples);
+    out.put(config.progressiveSteps);
+    out.put(config.updateInterval);
+    out.put(seed);
+    out.put(step);
+    out.put(step_samples);
+    out.put(step_start_samples);
+    out.put(camera_position);
+    out.put(camera_target);
+    out.put(camera_up);
+    out.put(camera_fov);
+    out.put(camera_aspect);
+    out.put(scene_hash);
+    out.put(has_moments);
+
+    // Alpha is always 1 in the accumulator, so only RGB is stored
+    for (const Color& sum : accumulation) {
+        out.put(sum.r);
+        out.put(sum.g);
+        out.put(sum.b);
+    }
+
+    // Counts differ by at most one pass between tiles, so runs are long
+    std::vector<uint32_t> runs;
+    for (size_t i = 0; i < sample_counts.size();) {
+        size_t end = i + 1;
+        while (end < sample_counts.size() && sample_counts[end] == sample_counts[i]) {
+            ++end;
+        }
+        runs.push_back(sample_counts[i]);
+        runs.push_back(static_cast<uint32_t>(end - i));
+        i = end;
+    }
+    out.put(static_cast<uint64_t>(runs.size() / 2));
+    out.put_array(runs.data(), runs.size());
+
+    if (has_moments) {
+        out.put_array(luminance_sum.data(), luminance_sum.size());
+        out.put_array(luminance_sq_sum.data(), luminance_sq_sum.size());
+    }
+    out.put(fnv1a(out.bytes.data(), out.bytes.size()));
+
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(out.bytes.data(), static_cast<std::streamsize>(out.bytes.size())) || !file.flush()) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool RenderCheckpoint::load(const std::string& filename, RenderCheckpoint& checkpoint) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < sizeof(MAGIC) + sizeof(uint64_t) || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    const size_t payload = bytes.size() - sizeof(uint64_t);
+    uint64_t checksum;
+    std::memcpy(&checksum, bytes.data() + payload, sizeof(checksum));
+    if (checksum != fnv1a(bytes.data(), payload)) {
+        return false;
+    }
+
+    Reader in(bytes, payload);
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    uint32_t has_moments = 0;
+    RenderCheckpoint loaded;
+    bool ok = in.get_array(magic, sizeof(magic)) && in.get(version) && version == VERSION &&
+              in.get(loaded.width) && in.get(loaded.height) && in.get(loaded.tile_size) && in.get(loaded.max_depth) &&
+              in.get(loaded.config.initialSamples) && in.get(loaded.config.targetSamples) &&
+              in.get(loaded.config.progressiveSteps) && in.get(loaded.config.updateInterval) &&
+              in.get(loaded.seed) && in.get(loaded.step) && in.get(loaded.step_samples) &&
+              in.get(loaded.step_start_samples) &&
+              in.get(loaded.camera_position) && in.get(loaded.camera_target) && in.get(loaded.camera_up) &&
+              in.get(loaded.camera_fov) && in.get(loaded.camera_aspect) &&
+              in.get(loaded.scene_hash) && in.get(has_moments);
+    if (!ok || loaded.width <= 0 || loaded.height <= 0) {
+        return false;
+    }
+
+    const size_t pixel_count = static_cast<size_t>(loaded.width) * loaded.height;
+    std::vector<float> rgb(pixel_count * 3);
+    if (!in.get_array(rgb.data(), rgb.size())) {
+        return false;
+    }
+    loaded.accumulation.resize(pixel_count);
+    for (size_t i = 0; i < pixel_count; ++i) {
+        loaded.accumulation[i] = Color(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+    }
+
+    uint64_t run_count = 0;
+    if (!in.get(run_count)) {
+        return false;
+    }
+    loaded.sample_counts.reserve(pixel_count);
+    for (uint64_t r = 0; r < run_count; ++r) {
+        uint32_t value = 0;
+        uint32_t length = 0;
+        if (!in.get(value) || !in.get(length) || length > pixel_count - loaded.sample_counts.size()) {
+            return false;
+        }
+        loaded.sample_counts.insert(loaded.sample_counts.end(), length, value);
+    }
+    if (loaded.sample_counts.size() != pixel_count) {
+        return false;
+    }
+
+    if (has_moments) {
+        loaded.luminance_sum.resize(pixel_count);
+        loaded.luminance_sq_sum.resize(pixel_count);
+        if (!in.get_array(loaded.luminance_sum.data(), pixel_count) ||
+            !in.get_array(loaded.luminance_sq_sum.data(), pixel_count)) {
+            return false;
+        }
+    }
+    if (!in.at_end()) {
+        return false;
+    }
+    checkpoint = std::move(loaded);
+    return true;
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& filename)
+    : filename_(filename), thread_(&CheckpointWriter::run, this) {
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_all();
+    thread_.join();
+}
+
+void CheckpointWriter::submit(std::unique_ptr<RenderCheckpoint> checkpoint) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = std::move(checkpoint);
+    }
+    wakeup_.notify_all();
+}
+
+void CheckpointWriter::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return !pending_ && !writing_; });
+}
+
+uint64_t CheckpointWriter::written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+uint64_t CheckpointWriter::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+void CheckpointWriter::run() {
+    PROFILE_THREAD_NAME("Checkpoint writer");
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wakeup_.wait(lock, [this]() { return pending_ || stop_; });
+        // Pending work is finished even when stopping, so the last checkpoint is never lost
+        if (!pending_) {
+            break;
+        }
+        std::unique_ptr<RenderCheckpoint> checkpoint = std::move(pending_);
+        writing_ = true;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        bool saved = checkpoint->save(filename_);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (saved) {
+            LOG_INFO(LogChannel::RENDER, "Checkpoint at " << checkpoint->min_samples() << " spp written to "
+                     << filename_ << " in " << ms << " ms");
+        } else {
+            LOG_WARN(LogChannel::RENDER, "Failed to write checkpoint " << filename_);
+        }
+
+        lock.lock();
+        writing_ = false;
+        ++(saved ? written_ : failed_);
+        idle_.notify_all();
+    }
+}
@@ -1,7 +1,13 @@
 #include "render/render_engine.h"
 #include "render/path_tracer.h"
+#include "render/metrics_exporter.h"
+#include "render/shared_framebuffer.h"
+#include "render/render_checkpoint.h"
 #include "core/scene_manager.h"
 #include "core/camera.h"
+#include "core/profiler.h"
+#include "core/logger.h"
+#include "core/resource_monitor.h"
 #include "image_output.h"
 #include <iostream>
 #include <thread>
@@ -10,6 +16,7 @@
 #ifdef USE_GPU
 #include "gpu_compute.h"
 #include "gpu_memory.h"
+#include "render/gpu_performance.h"
 #include <SDL.h>
 #endif
 
@@ -59,22 +66,23 @@ void RenderEngine::initialize() {
     // Initialize GPU acceleration if available - AFTER display initialization
     // to ensure OpenGL context is available
     if (initialize_gpu()) {
-        std::cout << "GPU acceleration initialized successfully" << std::endl;
+        LOG_INFO(LogChannel::GPU, "GPU acceleration initialized successfully");
     } else {
-        std::cout << "GPU acceleration unavailable, falling back to CPU" << std::endl;
+        LOG_INFO(LogChannel::GPU, "GPU acceleration unavailable, falling back to CPU");
     }
     
     initialized_ = true;
-    std::cout << "RenderEngine initialized with path tracing support" << std::endl;
+    LOG_INFO(LogChannel::RENDER, "RenderEngine initialized with path tracing support");
 }
 
 void RenderEngine::render() {
+    PROFILE_FUNCTION();
     if (!initialized_) {
-        std::cerr << "RenderEngine not initialized!" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "RenderEngine not initialized!");
         return;
     }
     
-    std::cout << "Starting render (" << render_width_ << "x" << render_height_ << ")" << std::endl;
+    LOG_INFO(LogChannel::RENDER, "Starting render (" << render_width_ << "x" << render_height_ << ")");
     
     // Sync scene changes to GPU if auto-sync is enabled
     if (auto_gpu_sync_enabled_) {
@@ -95,8 +103,9 @@ void RenderEngine::render() {
     // Get the rendered image data and pass it to image output
     const auto& image_data = path_tracer_->get_image_data();
     image_output_->set_image_data(image_data, render_width_, render_height_);
+    publish_frame(image_data, render_width_, render_height_, 0, 0);
     
-    std::cout << "Render completed successfully" << std::endl;
+    LOG_INFO(LogChannel::RENDER, "Render completed successfully");
 }
 
 void RenderEngine::shutdown() {
@@ -113,7 +122,7 @@ void RenderEngine::shutdown() {
     scene_manager_.reset();
     image_output_.reset();
     initialized_ = false;
-    std::cout << "RenderEngine shutdown" << std::endl;
+    LOG_INFO(LogChannel::RENDER, "RenderEngine shutdown");
 }
 
 void RenderEngine::set_scene_manager(std::shared_ptr<SceneManager> scene_manager) {
@@ -162,6 +171,115 @@ void RenderEngine::set_samples_per_pixel(int samples) {
     }
 }
 
+void RenderEngine::set_direct_light_resampling(bool enabled) {
+    if (path_tracer_) {
+        path_tracer_->set_direct_light_resampling(enabled);
+    }
+}
+
+bool RenderEngine::is_direct_light_resampling_enabled() const {
+    return path_tracer_ && path_tracer_->is_direct_light_resampling_enabled();
+}
+
+void RenderEngine::set_irradiance_cache(bool enabled) {
+    if (path_tracer_) {
+        path_tracer_->set_irradiance_cache(enabled);
+    }
+}
+
+bool RenderEngine::is_irradiance_cache_enabled() const {
+    return path_tracer_ && path_tracer_->is_irradiance_cache_enabled();
+}
+
+void RenderEngine::set_raster_primary_visibility(bool enabled) {
+    if (path_tracer_) {
+        path_tracer_->set_raster_primary_visibility(enabled);
+    }
+}
+
+bool RenderEngine::is_raster_primary_visibility_enabled() const {
+    return path_tracer_ && path_tracer_->is_raster_primary_visibility_enabled();
+}
+
+void RenderEngine::set_denoising(bool enabled) {
+    if (path_tracer_) {
+        path_tracer_->set_denoising(enabled);
+    }
+}
+
+bool RenderEngine::is_denoising_enabled() const {
+    return path_tracer_ && path_tracer_->is_denoising_enabled();
+}
+
+void RenderEngine::set_aovs(AOVMask mask) {
+    if (path_tracer_) {
+        path_tracer_->set_aovs(mask);
+    }
+}
+
+bool RenderEngine::save_aovs(const std::string& base_filename) {
+    if (!path_tracer_) {
+        return false;
+    }
+    
+    const AOVBuffers& aovs = path_tracer_->get_aovs();
+    if (aovs.mask == AOV_NONE) {
+        LOG_ERROR(LogChannel::RENDER, "No AOVs were rendered");
+        return false;
+    }
+    
+    bool success = true;
+    for (AOVMask bit = 1; bit & AOV_ALL; bit <<= 1) {
+        AOVType type = static_cast<AOVType>(bit);
+        if (!aovs.has(type)) continue;
+        std::string filename = base_filename + "_" + aov_name(type) + ".pfm";
+        if (ImageOutput::save_aov(filename, aovs, type)) {
+            LOG_INFO(LogChannel::RENDER, "Saved AOV: " << filename);
+        } else {
+            success = false;
+        }
+    }
+    return success;
+}
+
+void RenderEngine::set_cost_heatmap(bool enabled, HeatmapMetric metric) {
+    if (path_tracer_) {
+        path_tracer_->set_cost_heatmap(enabled);
+        path_tracer_->set_heatmap_metric(metric);
+    }
+}
+
+bool RenderEngine::is_cost_heatmap_enabled() const {
+    return path_tracer_ && path_tracer_->is_cost_heatmap_enabled();
+}
+
+HeatmapMetric RenderEngine::get_heatmap_metric() const {
+    return path_tracer_ ? path_tracer_->get_heatmap_metric() : HeatmapMetric::CYCLES;
+}
+
+bool RenderEngine::save_cost_heatmap(const std::string& base_filename) {
+    if (!path_tracer_) {
+        return false;
+    }
+    
+    const CostHeatmap& heatmap = path_tracer_->get_cost_heatmap();
+    if (heatmap.empty()) {
+        LOG_ERROR(LogChannel::RENDER, "No cost heatmap was recorded");
+        return false;
+    }
+    
+    bool success = true;
+    for (HeatmapMetric metric : {HeatmapMetric::CYCLES, HeatmapMetric::INTERSECTION_TESTS, HeatmapMetric::BOUNCES}) {
+        std::string filename = base_filename + "_" + heatmap_metric_name(metric) + ".pfm";
+        if (heatmap.save(filename, metric)) {
+            LOG_INFO(LogChannel::RENDER, "Saved cost heatmap: " << filename);
+        } else {
+            success = false;
+        }
+    }
+    return success;
+}
+
 void RenderEngine::set_camera_position(const Vector3& position, const Vector3& target, const Vector3& up) {
     if (scene_manager_) {
         // Update the camera in scene manager
@@ -177,18 +295,20 @@ void RenderEngine::set_camera_position(const Vector3& position, const Vector3& t
 }
 
 void RenderEngine::save_image(const std::string& filename) {
+    PROFILE_FUNCTION();
     if (image_output_) {
         image_output_->save_to_file(filename);
     } else {
-        std::cerr << "No image output component available" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "No image output component available");
     }
 }
 
 void RenderEngine::display_image() {
+    PROFILE_FUNCTION();
     if (image_output_) {
         image_output_->display_to_screen();
     } else {
-        std::cerr << "No image output component available" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "No image output component available");
     }
 }
 
@@ -231,9 +351,9 @@ void RenderEngine::update_camera_preview(const Vector3& camera_pos, const Vector
         // Try GPU first since camera movement is in main thread with OpenGL context
         if (gpu_initialized_ && path_tracer_->isGPUAvailable()) {
             // Use synchronous GPU rendering for camera preview to avoid async corruption
-            success = path_tracer_->trace_gpu_sync(render_width_, render_height_);
+            success = path_tracer_->trace_gpu_preview(render_width_, render_height_);
             if (success) {
-                std::cout << "Camera preview: GPU render completed (SYNC)" << std::endl;
+                LOG_DEBUG(LogChannel::GPU, "Camera preview: GPU render completed (SYNC)");
             }
         }
         
@@ -242,9 +362,9 @@ void RenderEngine::update_camera_preview(const Vector3& camera_pos, const Vector
             // Use half resolution for CPU fallback
             int preview_width = render_width_ / 2;
             int preview_height = render_height_ / 2;
-            success = path_tracer_->trace_interruptible(preview_width, preview_height);
+            success = path_tracer_->trace_preview(preview_width, preview_height);
             if (success) {
-                std::cout << "Camera preview: CPU render completed at " << preview_width << "x" << preview_height << std::endl;
+                LOG_DEBUG(LogChannel::RENDER, "Camera preview: CPU render completed at " << preview_width << "x" << preview_height);
             }
         }
         
@@ -256,6 +376,8 @@ void RenderEngine::update_camera_preview(const Vector3& camera_pos, const Vector
             int display_height = (gpu_initialized_ && path_tracer_->isGPUAvailable()) ? render_height_ : render_height_ / 2;
             image_output_->set_image_data(image_data, display_width, display_height);
             image_output_->display_to_screen();
+            const int preview_samples = path_tracer_->get_samples_per_pixel();
+            publish_frame(image_data, display_width, display_height, preview_samples, preview_samples);
         }
     }
 }
@@ -281,7 +403,7 @@ void RenderEngine::stop_camera_movement() {
 
 void RenderEngine::start_render() {
     if (render_state_ == RenderState::RENDERING) {
-        std::cerr << "Cannot start render: already in progress" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Cannot start render: already in progress");
         return;
     }
     
@@ -291,7 +413,7 @@ void RenderEngine::start_render() {
     }
     
     if (!initialized_) {
-        std::cerr << "RenderEngine not initialized!" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "RenderEngine not initialized!");
         set_render_state(RenderState::ERROR);
         return;
     }
@@ -327,12 +449,12 @@ void RenderEngine::stop_render() {
 
 void RenderEngine::start_progressive_render(const ProgressiveConfig& config) {
     if (render_state_ == RenderState::RENDERING) {
-        std::cerr << "Cannot start progressive render: already in progress" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Cannot start progressive render: already in progress");
         return;
     }
     
     if (!initialized_) {
-        std::cerr << "RenderEngine not initialized!" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "RenderEngine not initialized!");
         set_render_state(RenderState::ERROR);
         return;
     }
@@ -344,7 +466,7 @@ void RenderEngine::start_progressive_render(const ProgressiveConfig& config) {
     
     // If GPU is available, use main thread GPU progressive for live updates
     if (gpu_initialized_ && path_tracer_ && path_tracer_->isGPUAvailable()) {
-        std::cout << "Using GPU progressive rendering in main thread for live updates..." << std::endl;
+        LOG_INFO(LogChannel::GPU, "Using GPU progressive rendering in main thread for live updates...");
         
         bool success = start_progressive_gpu_main_thread(config);
         progressive_mode_ = false;
@@ -352,9 +474,9 @@ void RenderEngine::start_progressive_render(const ProgressiveConfig& config) {
         
         if (success) {
             set_render_state(RenderState::COMPLETED);
-            std::cout << "GPU progressive render completed successfully" << std::endl;
+            LOG_INFO(LogChannel::GPU, "GPU progressive render completed successfully");
         } else {
-            std::cout << "GPU progressive render failed, falling back to CPU worker thread..." << std::endl;
+            LOG_INFO(LogChannel::GPU, "GPU progressive render failed, falling back to CPU worker thread...");
             // Fall through to worker thread CPU rendering
         }
     }
@@ -366,7 +488,7 @@ void RenderEngine::start_progressive_render(const ProgressiveConfig& config) {
         }
         
         render_thread_ = std::thread(&RenderEngine::progressive_render_worker, this, config);
-        std::cout << "Progressive render started in worker thread (CPU)" << std::endl;
+        LOG_INFO(LogChannel::RENDER, "Progressive render started in worker thread (CPU)");
     }
 }
 
@@ -392,14 +514,16 @@ void RenderEngine::set_state_change_callback(std::function<void(RenderState)> ca
 }
 
 void RenderEngine::render_worker() {
+    PROFILE_THREAD_NAME("Render");
+    PROFILE_FUNCTION();
     try {
-        std::cout << "Starting render orchestration (" << render_width_ << "x" << render_height_ << ")" << std::endl;
+        LOG_INFO(LogChannel::RENDER, "Starting render orchestration (" << render_width_ << "x" << render_height_ << ")");
         
         // GPU buffers should be pre-allocated in main thread
         // Skip context management since no new allocations needed
 #ifdef USE_GPU
         if (gpu_initialized_) {
-            std::cout << "Using pre-allocated GPU buffers for rendering..." << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "Using pre-allocated GPU buffers for rendering...");
         }
 #endif
         
@@ -416,15 +540,15 @@ void RenderEngine::render_worker() {
         path_tracer_->reset_stop_request();
         
         // Execute path tracing with interruption support
-        std::cout << "Executing PathTracer with current scene configuration..." << std::endl;
+        LOG_DEBUG(LogChannel::RENDER, "Executing PathTracer with current scene configuration...");
         
         // CRITICAL: GPU operations must happen in main thread where OpenGL context is current
         // Worker threads cannot access OpenGL context, so we force CPU rendering here
 #ifdef USE_GPU
         bool completed;
         if (gpu_initialized_ && path_tracer_->isGPUAvailable()) {
-            std::cout << "GPU available but worker thread cannot access OpenGL context" << std::endl;
-            std::cout << "Using CPU rendering in worker thread" << std::endl;
+            LOG_INFO(LogChannel::GPU, "GPU available but worker thread cannot access OpenGL context");
+            LOG_INFO(LogChannel::RENDER, "Using CPU rendering in worker thread");
             completed = path_tracer_->trace_interruptible(render_width_, render_height_);
         } else {
             completed = path_tracer_->trace_interruptible(render_width_, render_height_);
@@ -444,24 +568,26 @@ void RenderEngine::render_worker() {
         process_render_completion();
         
         set_render_state(RenderState::COMPLETED);
-        std::cout << "Render orchestration completed successfully" << std::endl;
+        LOG_INFO(LogChannel::RENDER, "Render orchestration completed successfully");
         
     } catch (const std::exception& e) {
-        std::cerr << "Render orchestration error: " << e.what() << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Render orchestration error: " << e.what());
         cleanup_partial_render();
         set_render_state(RenderState::ERROR);
     }
 }
 
 void RenderEngine::progressive_render_worker(const ProgressiveConfig& config) {
+    PROFILE_THREAD_NAME("Render");
+    PROFILE_FUNCTION();
     try {
-        std::cout << "Starting progressive render orchestration (" << render_width_ << "x" << render_height_ << ")" << std::endl;
+        LOG_INFO(LogChannel::RENDER, "Starting progressive render orchestration (" << render_width_ << "x" << render_height_ << ")");
         
         // GPU buffers should be pre-allocated in main thread
         // Skip context management since no new allocations needed
 #ifdef USE_GPU
         if (gpu_initialized_) {
-            std::cout << "Using pre-allocated GPU buffers for progressive rendering..." << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "Using pre-allocated GPU buffers for progressive rendering...");
         }
 #endif
         
@@ -495,8 +621,8 @@ void RenderEngine::progressive_render_worker(const ProgressiveConfig& config) {
                     
                     // Only log if optimization takes significant time (>1ms)
                     if (opt_time > 1.0) {
-                        std::cout << "GPU memory optimized during progressive render: " 
-                                  << opt_time << "ms" << std::endl;
+                        LOG_DEBUG(LogChannel::GPU, "GPU memory optimized during progressive render: " 
+                                  << opt_time << "ms");
                     }
                 }
                 
@@ -513,28 +639,30 @@ void RenderEngine::progressive_render_worker(const ProgressiveConfig& config) {
             if (image_output_) {
                 image_output_->update_progressive_display(data, width, height, current_samples, target_samples);
             }
+            publish_frame(data, width, height, current_samples, target_samples);
             // Also update UI progress
             if (progress_callback_) {
                 progress_callback_(width, height, current_samples, target_samples);
             }
+            publish_metrics();
         };
         
         // Execute progressive path tracing with GPU support
-        std::cout << "Executing progressive PathTracer with current scene configuration..." << std::endl;
+        LOG_DEBUG(LogChannel::RENDER, "Executing progressive PathTracer with current scene configuration...");
 #ifdef USE_GPU
         bool completed;
         if (gpu_initialized_ && path_tracer_->isGPUAvailable()) {
-            std::cout << "Attempting GPU-accelerated progressive rendering..." << std::endl;
+            LOG_INFO(LogChannel::GPU, "Attempting GPU-accelerated progressive rendering...");
             
             // GPU operations must run in main thread, so we do progressive GPU renders step by step
-            std::cout << "GPU progressive rendering requires main thread context - using CPU fallback" << std::endl;
-            std::cout << "Note: Use 'U' key for single-shot main thread GPU rendering" << std::endl;
+            LOG_INFO(LogChannel::GPU, "GPU progressive rendering requires main thread context - using CPU fallback");
+            LOG_INFO(LogChannel::GPU, "Note: Use 'U' key for single-shot main thread GPU rendering");
             
             // Fallback to CPU progressive rendering
-            std::cout << "Using CPU progressive rendering" << std::endl;
+            LOG_INFO(LogChannel::RENDER, "Using CPU progressive rendering");
             completed = path_tracer_->trace_progressive(render_width_, render_height_, config, progressive_callback);
         } else {
-            std::cout << "Using CPU progressive rendering" << std::endl;
+            LOG_INFO(LogChannel::RENDER, "Using CPU progressive rendering");
             completed = path_tracer_->trace_progressive(render_width_, render_height_, config, progressive_callback);
         }
 #else
@@ -556,10 +684,10 @@ void RenderEngine::progressive_render_worker(const ProgressiveConfig& config) {
         progressive_mode_ = false;
         manual_progressive_mode_ = false;
         set_render_state(RenderState::COMPLETED);
-        std::cout << "Progressive render orchestration completed successfully" << std::endl;
+        LOG_INFO(LogChannel::RENDER, "Progressive render orchestration completed successfully");
         
     } catch (const std::exception& e) {
-        std::cerr << "Progressive render orchestration error: " << e.what() << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Progressive render orchestration error: " << e.what());
         cleanup_partial_render();
         progressive_mode_ = false;
         manual_progressive_mode_ = false;
@@ -569,46 +697,91 @@ void RenderEngine::progressive_render_worker(const ProgressiveConfig& config) {
 
 void RenderEngine::set_render_state(RenderState state) {
     render_state_ = state;
+    publish_metrics();
     if (state_change_callback_) {
         state_change_callback_(state);
     }
 }
 
+void RenderEngine::set_checkpointing(const std::string& filename, std::chrono::seconds interval) {
+    checkpoint_filename_ = filename;
+    if (path_tracer_) {
+        path_tracer_->set_checkpointing(filename, interval);
+    }
+}
+
+void RenderEngine::set_render_cache(std::shared_ptr<RenderCache> cache) {
+    if (path_tracer_) {
+        path_tracer_->set_render_cache(cache);
+    }
+}
+
+void RenderEngine::set_edit_invalidation(EditInvalidation mode, int bleed_tiles) {
+    if (path_tracer_) {
+        path_tracer_->set_edit_invalidation(mode, bleed_tiles);
+    }
+}
+
 void RenderEngine::save_render_state() {
-    // For basic persistence, we'll reset to IDLE on restart
-    // In a full implementation, this could save to file
-    std::cout << "Render state saved (currently: " << static_cast<int>(render_state_.load()) << ")" << std::endl;
+    // Stopping a progressive render makes the path tracer checkpoint it
+    if (path_tracer_ && path_tracer_->is_checkpointing()) {
+        if (is_progressive_rendering()) {
+            stop_render();
+        }
+        path_tracer_->wait_for_checkpoints();
+    }
+    LOG_DEBUG(LogChannel::RENDER, "Render state saved (currently: " << static_cast<int>(render_state_.load()) << ")");
 }
 
-void RenderEngine::restore_render_state() {
+bool RenderEngine::restore_render_state() {
     // On startup/recovery, always start in IDLE state
     set_render_state(RenderState::IDLE);
     stop_requested_ = false;
-    std::cout << "Render state restored to IDLE" << std::endl;
+    LOG_DEBUG(LogChannel::RENDER, "Render state restored to IDLE");
+    
+    if (checkpoint_filename_.empty() || !path_tracer_) {
+        return false;
+    }
+    auto checkpoint = std::make_unique<RenderCheckpoint>();
+    if (!RenderCheckpoint::load(checkpoint_filename_, *checkpoint)) {
+        return false;
+    }
+    
+    // Put back what the image depends on; the path tracer verifies it again before resuming
+    set_render_size(checkpoint->width, checkpoint->height);
+    set_max_depth(checkpoint->max_depth);
+    set_camera_position(checkpoint->camera_position, checkpoint->camera_target, checkpoint->camera_up);
+    if (scene_manager_ && scene_manager_->content_hash() != checkpoint->scene_hash) {
+        LOG_WARN(LogChannel::RENDER, "Checkpoint " << checkpoint_filename_ << " was rendered from a different scene");
+    }
+    LOG_INFO(LogChannel::RENDER, "Loaded checkpoint " << checkpoint_filename_ << " (" << checkpoint->width << "x"
+             << checkpoint->height << ", " << checkpoint->min_samples() << " spp)");
+    path_tracer_->set_resume_checkpoint(std::move(checkpoint));
+    return true;
 }
 
 bool RenderEngine::validate_render_components() {
     if (!path_tracer_) {
-        std::cerr << "Render validation failed: No PathTracer available" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Render validation failed: No PathTracer available");
         return false;
     }
     
     if (!scene_manager_) {
-        std::cerr << "Render validation failed: No SceneManager available" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Render validation failed: No SceneManager available");
         return false;
     }
     
     if (!image_output_) {
-        std::cerr << "Render validation failed: No ImageOutput available" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Render validation failed: No ImageOutput available");
         return false;
     }
     
     if (render_width_ <= 0 || render_height_ <= 0) {
-        std::cerr << "Render validation failed: Invalid render dimensions" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Render validation failed: Invalid render dimensions");
         return false;
     }
     
-    std::cout << "Render components validated successfully" << std::endl;
+    LOG_DEBUG(LogChannel::RENDER, "Render components validated successfully");
     return true;
 }
 
@@ -616,13 +789,13 @@ void RenderEngine::synchronize_render_components() {
     // Ensure PathTracer has the latest scene data
     if (path_tracer_ && scene_manager_) {
         path_tracer_->set_scene_manager(scene_manager_);
-        std::cout << "PathTracer synchronized with SceneManager" << std::endl;
+        LOG_DEBUG(LogChannel::RENDER, "PathTracer synchronized with SceneManager");
     }
     
     // Ensure camera is synchronized
     if (scene_manager_ && scene_manager_->get_camera() && path_tracer_) {
         path_tracer_->set_camera(*scene_manager_->get_camera());
-        std::cout << "Camera synchronized with PathTracer" << std::endl;
+        LOG_DEBUG(LogChannel::RENDER, "Camera synchronized with PathTracer");
     }
     
     // Synchronize scene data to GPU if GPU acceleration is available
@@ -634,27 +807,28 @@ void RenderEngine::synchronize_render_components() {
             auto end_time = std::chrono::high_resolution_clock::now();
             
             auto sync_time = std::chrono::duration<double, std::milli>(end_time - start_time).count();
-            std::cout << "GPU scene synchronization completed in " << sync_time << "ms" << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "GPU scene synchronization completed in " << sync_time << "ms");
         } else {
-            std::cout << "Scene already synchronized with GPU" << std::endl;
+            LOG_DEBUG(LogChannel::GPU, "Scene already synchronized with GPU");
         }
     }
 #endif
     
-    std::cout << "Render components synchronized" << std::endl;
+    LOG_DEBUG(LogChannel::RENDER, "Render components synchronized");
 }
 
 void RenderEngine::process_render_completion() {
     // Get the rendered image data and pass it to image output
     const auto& image_data = path_tracer_->get_image_data();
     image_output_->set_image_data(image_data, render_width_, render_height_);
+    publish_frame(image_data, render_width_, render_height_, 0, 0);
     
-    std::cout << "Render output processed and connected to Image Output module" << std::endl;
+    LOG_DEBUG(LogChannel::RENDER, "Render output processed and connected to Image Output module");
 }
 
 void RenderEngine::cleanup_partial_render() {
     // Clean up any partial render state
-    std::cout << "Cleaning up partial render state" << std::endl;
+    LOG_DEBUG(LogChannel::RENDER, "Cleaning up partial render state");
     
     // Preserve the current image data from PathTracer when stopped
     // This allows saving partial renders
@@ -662,7 +836,8 @@ void RenderEngine::cleanup_partial_render() {
         const auto& image_data = path_tracer_->get_image_data();
         if (!image_data.empty()) {
             image_output_->set_image_data(image_data, render_width_, render_height_);
-            std::cout << "Partial render image data preserved for saving" << std::endl;
+            publish_frame(image_data, render_width_, render_height_, 0, 0);
+            LOG_DEBUG(LogChannel::RENDER, "Partial render image data preserved for saving");
         }
     }
     
@@ -703,7 +878,7 @@ bool RenderEngine::initialize_gpu() {
         // Create GPU compute pipeline
         gpu_pipeline_ = std::make_shared<GPUComputePipeline>();
         if (!gpu_pipeline_->initialize()) {
-            std::cerr << "Failed to initialize GPU compute pipeline: " << gpu_pipeline_->getErrorMessage() << std::endl;
+            LOG_ERROR(LogChannel::GPU, "Failed to initialize GPU compute pipeline: " << gpu_pipeline_->getErrorMessage());
             gpu_pipeline_.reset();
             return false;
         }
@@ -712,7 +887,7 @@ bool RenderEngine::initialize_gpu() {
         gpu_memory_ = std::make_shared<GPUMemoryManager>();
         gpu_memory_->enableProfiling(true); // Enable debug output
         if (!gpu_memory_->initialize()) {
-            std::cerr << "Failed to initialize GPU memory manager: " << gpu_memory_->getErrorMessage() << std::endl;
+            LOG_ERROR(LogChannel::GPU, "Failed to initialize GPU memory manager: " << gpu_memory_->getErrorMessage());
             gpu_memory_.reset();
             gpu_pipeline_.reset();
             return false;
@@ -721,32 +896,32 @@ bool RenderEngine::initialize_gpu() {
         // Connect GPU memory manager to scene manager for coordination
         if (scene_manager_) {
             scene_manager_->setGPUMemoryManager(gpu_memory_);
-            std::cout << "GPU memory manager connected to scene manager" << std::endl;
+            LOG_INFO(LogChannel::GPU, "GPU memory manager connected to scene manager");
         }
         
         // Initialize PathTracer GPU components
         if (path_tracer_) {
-            std::cout << "Initializing PathTracer GPU components..." << std::endl;
+            LOG_INFO(LogChannel::GPU, "Initializing PathTracer GPU components...");
             if (!path_tracer_->initializeGPU()) {
-                std::cerr << "Failed to initialize PathTracer GPU components" << std::endl;
+                LOG_ERROR(LogChannel::GPU, "Failed to initialize PathTracer GPU components");
                 cleanup_gpu();
                 return false;
             }
-            std::cout << "PathTracer GPU components initialized successfully" << std::endl;
+            LOG_INFO(LogChannel::GPU, "PathTracer GPU components initialized successfully");
         }
         
         gpu_initialized_ = true;
-        std::cout << "GPU acceleration initialized: " << gpu_pipeline_->getDriverInfo() << std::endl;
+        LOG_INFO(LogChannel::GPU, "GPU acceleration initialized: " << gpu_pipeline_->getDriverInfo());
         
         return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "GPU initialization failed with exception: " << e.what() << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU initialization failed with exception: " << e.what());
         cleanup_gpu();
         return false;
     }
 #else
-    std::cout << "GPU support not compiled in (USE_GPU not defined)" << std::endl;
+    LOG_INFO(LogChannel::GPU, "GPU support not compiled in (USE_GPU not defined)");
     return false;
 #endif
 }
@@ -764,7 +939,7 @@ void RenderEngine::cleanup_gpu() {
     }
     
     gpu_initialized_ = false;
-    std::cout << "GPU resources cleaned up" << std::endl;
+    LOG_INFO(LogChannel::GPU, "GPU resources cleaned up");
 #endif
 }
 
@@ -774,17 +949,83 @@ RenderMetrics RenderEngine::get_render_metrics() const {
 #ifdef USE_GPU
     if (gpu_initialized_ && gpu_memory_) {
         auto gpu_stats = gpu_memory_->getMemoryStats();
-        metrics.memory_usage_mb = static_cast<float>(gpu_stats.total_used) / (1024.0f * 1024.0f);
-        metrics.gpu_utilization = gpu_stats.fragmentation_ratio < 0.5f ? 75.0f : 50.0f; // Simple heuristic
+        metrics.gpu_memory_mb = static_cast<float>(gpu_stats.total_used) / (1024.0f * 1024.0f);
+        metrics.gpu_peak_memory_mb = static_cast<float>(gpu_stats.peak_usage) / (1024.0f * 1024.0f);
+    }
+    if (gpu_performance_monitor_) {
+        GPUPerformanceMonitor::PerformanceMetrics gpu = gpu_performance_monitor_->getMetrics();
+        metrics.gpu_utilization = static_cast<float>(gpu.gpuUtilization);
+        metrics.gpu_compute_ms = gpu.gpuComputeTime;
+        metrics.gpu_transfer_ms = gpu.gpuMemoryTransferTime;
     }
 #endif
     
-    // CPU utilization and other metrics would be calculated based on actual rendering
-    metrics.cpu_utilization = render_state_ == RenderState::RENDERING ? 80.0f : 10.0f;
+    // Measured by the resource monitor's sampler, or on the spot when it is not running
+    ResourceSample resources = resource_monitor_latest();
+    metrics.cpu_utilization = static_cast<float>(resources.cpu_utilization);
+    metrics.memory_usage_mb = static_cast<float>(resources.memory.rss_mb);
+    metrics.peak_memory_mb = static_cast<float>(resources.memory.peak_rss_mb);
+    metrics.process_cpu_seconds = resources.process_cpu_seconds;
+    metrics.imageWidth = render_width_;
+    metrics.imageHeight = render_height_;
+    
+    if (path_tracer_) {
+        for (double seconds : path_tracer_->get_tile_stats().thread_cpu_seconds) {
+            metrics.render_cpu_seconds += seconds;
+        }
+        FrameStats frame = path_tracer_->get_frame_stats();
+        metrics.render_time_ms = static_cast<float>(frame.seconds * 1000.0);
+        metrics.samples_per_second = static_cast<int>(frame.samples_per_second());
+        metrics.primary_rays = frame.rays[RayCounter::PRIMARY_RAYS];
+        metrics.secondary_rays = frame.rays[RayCounter::SECONDARY_RAYS];
+        metrics.shadow_rays = frame.rays[RayCounter::SHADOW_RAYS];
+        metrics.intersection_tests = frame.rays.intersection_tests();
+        metrics.mrays_per_second = frame.mrays_per_second();
+        metrics.tests_per_ray = frame.rays.tests_per_ray();
+        metrics.mean_path_length = frame.rays.mean_path_length();
+    }
     
     return metrics;
 }
 
+void RenderEngine::set_gpu_performance_monitor(std::shared_ptr<GPUPerformanceMonitor> monitor) {
+#ifdef USE_GPU
+    gpu_performance_monitor_ = monitor;
+#else
+    (void)monitor;
+#endif
+}
+
+void RenderEngine::set_metrics_exporter(std::shared_ptr<MetricsExporter> exporter) {
+    metrics_exporter_ = exporter;
+}
+
+void RenderEngine::publish_metrics() {
+    if (metrics_exporter_) {
+        metrics_exporter_->publish(get_render_metrics(), render_state_.load());
+    }
+}
+
+void RenderEngine::set_shared_framebuffer(std::shared_ptr<SharedFramebuffer> framebuffer) {
+    shared_framebuffer_ = framebuffer;
+}
+
+// samples 0 takes the samples per pixel of the tracer's last frame
+void RenderEngine::publish_frame(const std::vector<Color>& display, int width, int height, int samples,
+                                 int target_samples) {
+    if (!shared_framebuffer_) {
+        return;
+    }
+    if (samples == 0 && width > 0 && height > 0) {
+        samples = static_cast<int>(path_tracer_->get_frame_stats().samples / (static_cast<uint64_t>(width) * height));
+        target_samples = samples;
+    }
+    // GPU frames leave no linear image, so they are published as display pixels only
+    const std::vector<Color>& linear = path_tracer_->get_linear_image();
+    const bool has_linear = linear.size() == static_cast<size_t>(width) * height;
+    shared_framebuffer_->publish(display, width, height, samples, target_samples, has_linear ? &linear : nullptr);
+}
+
 // Dynamic scene synchronization methods
 void RenderEngine::sync_scene_changes_to_gpu() {
 #ifdef USE_GPU
@@ -800,7 +1041,7 @@ void RenderEngine::sync_scene_changes_to_gpu() {
     bool scene_changed = (current_object_count != last_scene_object_count_);
     
     if (scene_changed || !scene_manager_->isGPUSynced()) {
-        std::cout << "Scene changes detected, syncing to GPU..." << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Scene changes detected, syncing to GPU...");
         
         // Sync legacy scene data
         scene_manager_->syncSceneToGPU();
@@ -811,7 +1052,7 @@ void RenderEngine::sync_scene_changes_to_gpu() {
         last_scene_sync_ = current_time;
         last_scene_object_count_ = current_object_count;
         
-        std::cout << "Scene synchronized to GPU (" << current_object_count << " objects)" << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "Scene synchronized to GPU (" << current_object_count << " objects)");
         
         // Note: Path tracer will automatically detect scene changes during next render
     }
@@ -821,9 +1062,9 @@ void RenderEngine::sync_scene_changes_to_gpu() {
 void RenderEngine::set_auto_gpu_sync(bool enabled) {
     auto_gpu_sync_enabled_ = enabled;
     if (enabled) {
-        std::cout << "Auto GPU sync enabled" << std::endl;
+        LOG_INFO(LogChannel::GPU, "Auto GPU sync enabled");
     } else {
-        std::cout << "Auto GPU sync disabled" << std::endl;
+        LOG_INFO(LogChannel::GPU, "Auto GPU sync disabled");
     }
 }
 
@@ -832,39 +1073,40 @@ bool RenderEngine::is_auto_gpu_sync_enabled() const {
 }
 
 bool RenderEngine::render_gpu_main_thread() {
+    PROFILE_FUNCTION();
 #ifdef USE_GPU
     if (!gpu_initialized_ || !path_tracer_ || !path_tracer_->isGPUAvailable()) {
-        std::cerr << "GPU not available for main thread rendering" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU not available for main thread rendering");
         return false;
     }
     
-    std::cout << "=== GPU RENDERING IN MAIN THREAD ===" << std::endl;
+    LOG_INFO(LogChannel::GPU, "=== GPU RENDERING IN MAIN THREAD ===");
     
     // Ensure OpenGL context is current by asking image_output to make it current
     if (image_output_ && !image_output_->make_context_current()) {
-        std::cerr << "ERROR: Failed to make OpenGL context current" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to make OpenGL context current");
         return false;
     }
     
     // Validate that we now have an OpenGL context
     SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
     if (!currentContext) {
-        std::cerr << "ERROR: No OpenGL context in main thread after making current" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No OpenGL context in main thread after making current");
         return false;
     }
     
-    std::cout << "Main thread has OpenGL context: " << currentContext << std::endl;
+    LOG_INFO(LogChannel::GPU, "Main thread has OpenGL context: " << currentContext);
     
     // CRITICAL: Ensure we're using the SAME context where resources were created
     // This completely solves the multi-context issue by forcing single-context operation
     
     // Capture the current context as the GPU context to ensure consistency
-    std::cout << "Capturing current context for GPU operations..." << std::endl;
+    LOG_INFO(LogChannel::GPU, "Capturing current context for GPU operations...");
     path_tracer_->captureOpenGLContext();
     
     // Validate render components
     if (!validate_render_components()) {
-        std::cerr << "Render components validation failed" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Render components validation failed");
         return false;
     }
     
@@ -875,20 +1117,20 @@ bool RenderEngine::render_gpu_main_thread() {
     path_tracer_->reset_stop_request();
     
     // Perform GPU rendering - resources and operations all in same context now
-    std::cout << "Executing single-context GPU path tracing in main thread..." << std::endl;
+    LOG_INFO(LogChannel::GPU, "Executing single-context GPU path tracing in main thread...");
     bool success = path_tracer_->trace_gpu(render_width_, render_height_);
     
     if (success) {
         // Process completion
         process_render_completion();
-        std::cout << "GPU rendering completed successfully in main thread" << std::endl;
+        LOG_INFO(LogChannel::GPU, "GPU rendering completed successfully in main thread");
     } else {
-        std::cerr << "GPU rendering failed in main thread" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU rendering failed in main thread");
     }
     
     return success;
 #else
-    std::cerr << "GPU support not compiled in" << std::endl;
+    LOG_ERROR(LogChannel::GPU, "GPU support not compiled in");
     return false;
 #endif
 }
@@ -896,10 +1138,10 @@ bool RenderEngine::render_gpu_main_thread() {
 bool RenderEngine::start_progressive_gpu_main_thread(const ProgressiveConfig& config) {
 #ifdef USE_GPU
     // Deprecated: Use start_progressive_gpu_non_blocking for responsive UI
-    std::cout << "Warning: start_progressive_gpu_main_thread blocks UI. Use start_progressive_gpu_non_blocking instead." << std::endl;
+    LOG_WARN(LogChannel::RENDER, "start_progressive_gpu_main_thread blocks UI. Use start_progressive_gpu_non_blocking instead.");
     return start_progressive_gpu_non_blocking(config);
 #else
-    std::cerr << "GPU support not compiled in" << std::endl;
+    LOG_ERROR(LogChannel::GPU, "GPU support not compiled in");
     return false;
 #endif
 }
@@ -907,27 +1149,27 @@ bool RenderEngine::start_progressive_gpu_main_thread(const ProgressiveConfig& co
 bool RenderEngine::start_progressive_gpu_non_blocking(const ProgressiveConfig& config) {
 #ifdef USE_GPU
     if (!gpu_initialized_ || !path_tracer_ || !path_tracer_->isGPUAvailable()) {
-        std::cerr << "GPU not available for progressive rendering" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "GPU not available for progressive rendering");
         return false;
     }
     
     if (progressive_gpu_state_.active) {
-        std::cerr << "Progressive GPU rendering already active" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Progressive GPU rendering already active");
         return false;
     }
     
-    std::cout << "=== NON-BLOCKING GPU PROGRESSIVE RENDERING ===" << std::endl;
+    LOG_INFO(LogChannel::GPU, "=== NON-BLOCKING GPU PROGRESSIVE RENDERING ===");
     
     // Validate that we have an OpenGL context
     SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
     if (!currentContext) {
-        std::cerr << "ERROR: No OpenGL context in main thread" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "No OpenGL context in main thread");
         return false;
     }
     
     // Validate render components
     if (!validate_render_components()) {
-        std::cerr << "Render components validation failed" << std::endl;
+        LOG_ERROR(LogChannel::RENDER, "Render components validation failed");
         return false;
     }
     
@@ -953,16 +1195,17 @@ bool RenderEngine::start_progressive_gpu_non_blocking(const ProgressiveConfig& c
     manual_progressive_mode_ = true;
     set_render_state(RenderState::RENDERING);
     
-    std::cout << "Progressive GPU rendering initialized (non-blocking mode)" << std::endl;
+    LOG_INFO(LogChannel::GPU, "Progressive GPU rendering initialized (non-blocking mode)");
     return true;
     
 #else
-    std::cerr << "GPU support not compiled in" << std::endl;
+    LOG_ERROR(LogChannel::GPU, "GPU support not compiled in");
     return false;
 #endif
 }
 
 bool RenderEngine::step_progressive_gpu() {
+    PROFILE_FUNCTION();
 #ifdef USE_GPU
     if (!progressive_gpu_state_.active) {
         return false; // No progressive rendering active
@@ -1002,7 +1245,7 @@ bool RenderEngine::step_progressive_gpu() {
                 }
                 progressive_gpu_state_.last_step_time = std::chrono::steady_clock::now();
             } else {
-                std::cerr << "GPU async operation failed" << std::endl;
+                LOG_ERROR(LogChannel::GPU, "GPU async operation failed");
                 cancel_progressive_gpu();
                 return false;
             }
@@ -1021,7 +1264,7 @@ bool RenderEngine::step_progressive_gpu() {
         progressive_mode_ = false;
         manual_progressive_mode_ = false;
         set_render_state(RenderState::COMPLETED);
-        std::cout << "Progressive GPU rendering completed" << std::endl;
+        LOG_INFO(LogChannel::GPU, "Progressive GPU rendering completed");
         return false; // No more steps
     }
     
@@ -1035,9 +1278,9 @@ bool RenderEngine::step_progressive_gpu() {
     }
     
     // Start next progressive step
-    std::cout << "Progressive GPU step " << (progressive_gpu_state_.current_step + 1) 
+    LOG_DEBUG(LogChannel::GPU, "Progressive GPU step " << (progressive_gpu_state_.current_step + 1) 
               << "/" << progressive_gpu_state_.total_steps 
-              << " (samples: " << progressive_gpu_state_.current_samples << ")" << std::endl;
+              << " (samples: " << progressive_gpu_state_.current_samples << ")");
     
     // Set sample count for this step
     path_tracer_->set_samples_per_pixel(progressive_gpu_state_.current_samples);
@@ -1045,9 +1288,9 @@ bool RenderEngine::step_progressive_gpu() {
     // Start async GPU work (non-blocking)
     if (path_tracer_->start_gpu_async(render_width_, render_height_)) {
         progressive_gpu_state_.waiting_for_async_completion = true;
-        std::cout << "GPU async work started for step " << (progressive_gpu_state_.current_step + 1) << std::endl;
+        LOG_DEBUG(LogChannel::GPU, "GPU async work started for step " << (progressive_gpu_state_.current_step + 1));
     } else {
-        std::cerr << "Failed to start async GPU work" << std::endl;
+        LOG_ERROR(LogChannel::GPU, "Failed to start async GPU work");
         cancel_progressive_gpu();
         return false;
     }
@@ -1066,7 +1309,7 @@ void RenderEngine::cancel_progressive_gpu() {
         progressive_mode_ = false;
         manual_progressive_mode_ = false;
         set_render_state(RenderState::STOPPED);
-        std::cout << "Progressive GPU rendering cancelled" << std::endl;
+        LOG_INFO(LogChannel::GPU, "Progressive GPU rendering cancelled");
     }
 }
 
@@ -0,0 +1,684 @@
+#include "render/render_server.h"
+#include "render/path_tracer.h"
+#include "render/socket_messages.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+#include "core/logger.h"
+#include "core/profiler.h"
+#include "core/resource_monitor.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define RENDER_SERVER_SOCKETS 1
+#endif
+
+struct RenderServer::Job {
+    uint64_t id = 0;
+    RenderJobRequest request;
+    uint64_t turn = 0;                  // Submission or last pass, whichever is later; lowest runs first on ties
+    std::shared_ptr<SceneManager> scene;
+    PathTracer tracer;                  // Holds the job's accumulated sums between passes
+    uint32_t passes = 0;
+    std::chrono::steady_clock::time_point last_preview;
+    std::atomic<bool> cancel_requested{false};
+
+    // Published for the owning session; version changes with every preview and on finishing
+    std::mutex mutex;
+    std::vector<uint8_t> preview;
+    uint32_t preview_samples = 0;
+    uint64_t version = 0;
+    bool finished = false;
+    RenderJobStatus status = RenderJobStatus::COMPLETED;
+
+    void cancel() {
+        cancel_requested = true;
+        tracer.request_stop();
+    }
+};
+
+struct RenderServer::Session {
+    // A job as this client last saw it
+    struct Stream {
+        std::shared_ptr<Job> job;
+        std::vector<uint8_t> sent;
+        uint64_t version = 0;
+    };
+
+    int fd = -1;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+    std::vector<Stream> streams;
+};
+
+namespace {
+
+constexpr int POLL_INTERVAL_MS = 200;       // How quickly stop() is noticed by the listener
+constexpr int SESSION_POLL_MS = 5;          // Upper bound on the delay of a preview
+constexpr uint32_t MAX_REQUEST_BYTES = 64u << 20;
+
+uint8_t display_byte(float sum, float inverse_samples) {
+    float value = std::sqrt(std::max(0.0f, sum * inverse_samples));
+    return static_cast<uint8_t>(std::min(1.0f, value) * 255.0f + 0.5f);
+}
+
+// Copies a tile out of (or, with to_image, into) an RGB8 image
+void copy_tile(std::vector<uint8_t>& image, int width, const RenderTile& tile, uint8_t* bytes, bool to_image) {
+    const size_t row = static_cast<size_t>(tile.width()) * 3;
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        uint8_t* pixels = image.data() + (static_cast<size_t>(y) * width + tile.x0) * 3;
+        uint8_t* tile_row = bytes + (y - tile.y0) * row;
+        if (to_image) {
+            std::memcpy(pixels, tile_row, row);
+        } else {
+            std::memcpy(tile_row, pixels, row);
+        }
+    }
+}
+
+template <typename T>
+void append(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+TileEncoding encode_tile_delta(const uint8_t* previous, const uint8_t* current, size_t size, std::string& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < size && out.size() < size) {
+        size_t run = 1;
+        if (previous[i] == current[i]) {
+            while (i + run < size && run < 128 && previous[i + run] == current[i + run]) {
+                ++run;
+            }
+            out.push_back(static_cast<char>(0x80 | (run - 1)));
+        } else {
+            // Literals stop where two unchanged bytes make a zero run pay off
+            while (i + run < size && run < 128 &&
+                   !(i + run + 1 < size && previous[i + run] == current[i + run] &&
+                     previous[i + run + 1] == current[i + run + 1])) {
+                ++run;
+            }
+            out.push_back(static_cast<char>(run - 1));
+            for (size_t k = 0; k < run; ++k) {
+                out.push_back(static_cast<char>(previous[i + k] ^ current[i + k]));
+            }
+        }
+        i += run;
+    }
+    if (i < size || out.size() >= size) {
+        out.assign(reinterpret_cast<const char*>(current), size);
+        return TileEncoding::RAW;
+    }
+    return TileEncoding::XOR_RLE;
+}
+
+bool decode_tile_delta(TileEncoding encoding, const char* data, size_t data_size, uint8_t* tile, size_t size) {
+    if (encoding == TileEncoding::RAW) {
+        if (data_size != size) {
+            return false;
+        }
+        std::memcpy(tile, data, size);
+        return true;
+    }
+    if (encoding != TileEncoding::XOR_RLE) {
+        return false;
+    }
+    size_t position = 0;
+    size_t read = 0;
+    while (read < data_size) {
+        const uint8_t control = static_cast<uint8_t>(data[read++]);
+        const size_t run = static_cast<size_t>(control & 0x7f) + 1;
+        if (position + run > size) {
+            return false;
+        }
+        if (control < 0x80) {
+            if (read + run > data_size) {
+                return false;
+            }
+            for (size_t k = 0; k < run; ++k) {
+                tile[position + k] ^= static_cast<uint8_t>(data[read + k]);
+            }
+            read += run;
+        }
+        position += run;
+    }
+    return position == size;
+}
+
+RenderServer::RenderServer() : RenderServer(Config{}) {}
+
+RenderServer::RenderServer(const Config& config) : config_(config) {}
+
+RenderServer::~RenderServer() {
+    stop();
+}
+
+void RenderServer::set_default_scene(const SceneManager& scene) {
+    default_scene_ = scene.serialize();
+}
+
+size_t RenderServer::job_count() const {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    return jobs_.size();
+}
+
+void RenderServer::render_loop() {
+    PROFILE_THREAD_NAME("Render server");
+    ResourceThreadScope resources("render server");
+    while (std::shared_ptr<Job> job = next_job()) {
+        if (job->cancel_requested) {
+            finish_job(*job, RenderJobStatus::CANCELLED);
+            continue;
+        }
+        const RenderJobRequest& request = job->request;
+        if (!job->tracer.accumulate_passes(request.width, request.height, 1, job->passes == 0)) {
+            finish_job(*job, job->cancel_requested ? RenderJobStatus::CANCELLED : RenderJobStatus::FAILED);
+            continue;
+        }
+        ++job->passes;
+
+        const bool last = job->passes >= static_cast<uint32_t>(request.samples_per_pixel);
+        const auto now = std::chrono::steady_clock::now();
+        if (last || now - job->last_preview >= std::chrono::milliseconds(request.update_interval_ms)) {
+            const std::vector<Color>& sums = job->tracer.get_image_data();
+            std::vector<uint8_t> preview(sums.size() * 3);
+            const float inverse = 1.0f / static_cast<float>(job->passes);
+            for (size_t i = 0; i < sums.size(); ++i) {
+                preview[3 * i + 0] = display_byte(sums[i].r, inverse);
+                preview[3 * i + 1] = display_byte(sums[i].g, inverse);
+                preview[3 * i + 2] = display_byte(sums[i].b, inverse);
+            }
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->preview.swap(preview);
+            job->preview_samples = job->passes;
+            ++job->version;
+            job->last_preview = now;
+        }
+        if (last) {
+            finish_job(*job, RenderJobStatus::COMPLETED);
+        }
+    }
+}
+
+std::shared_ptr<RenderServer::Job> RenderServer::next_job() {
+    std::unique_lock<std::mutex> lock(jobs_mutex_);
+    jobs_changed_.wait(lock, [this] { return stop_requested_ || !jobs_.empty(); });
+    if (stop_requested_) {
+        return nullptr;
+    }
+    auto best = std::min_element(jobs_.begin(), jobs_.end(),
+                                 [](const std::shared_ptr<Job>& a, const std::shared_ptr<Job>& b) {
+                                     if (a->request.priority != b->request.priority) {
+                                         return a->request.priority > b->request.priority;
+                                     }
+                                     return a->turn < b->turn;
+                                 });
+    (*best)->turn = ++turn_;
+    return *best;
+}
+
+void RenderServer::finish_job(Job& job, RenderJobStatus status) {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(),
+                                   [&](const std::shared_ptr<Job>& queued) { return queued.get() == &job; }),
+                    jobs_.end());
+    }
+    {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.finished = true;
+        job.status = status;
+        ++job.version;
+    }
+    if (status == RenderJobStatus::COMPLETED) {
+        ++completed_jobs_;
+    }
+    LOG_DEBUG(LogChannel::RENDER, "Render job " << job.id << " finished after " << job.passes << " passes, status "
+                                                << static_cast<uint32_t>(status));
+}
+
+#ifdef RENDER_SERVER_SOCKETS
+
+bool RenderServer::start() {
+    if (running_) {
+        return true;
+    }
+    sockaddr_un address{};
+    if (config_.socket_path.empty() || config_.socket_path.size() >= sizeof(address.sun_path)) {
+        LOG_ERROR(LogChannel::RENDER, "Invalid render server socket path: '" << config_.socket_path << "'");
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, config_.socket_path.c_str(), sizeof(address.sun_path) - 1);
+    // A stale socket from a crashed run would make bind fail
+    unlink(config_.socket_path.c_str());
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 8) != 0) {
+        LOG_ERROR(LogChannel::RENDER, "Cannot listen on " << config_.socket_path << ": " << std::strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    stop_requested_ = false;
+    running_ = true;
+    renderer_ = std::thread(&RenderServer::render_loop, this);
+    acceptor_ = std::thread(&RenderServer::accept_loop, this);
+    LOG_INFO(LogChannel::RENDER, "Render server listening on unix:" << config_.socket_path);
+    return true;
+}
+
+void RenderServer::stop() {
+    if (!acceptor_.joinable()) {
+        return;
+    }
+    stop_requested_ = true;
+    acceptor_.join();
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(config_.socket_path.c_str());
+
+    // Sessions cancel their own jobs on the way out
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        for (const std::unique_ptr<Session>& session : sessions_) {
+            shutdown(session->fd, SHUT_RDWR);
+        }
+        for (const std::unique_ptr<Session>& session : sessions_) {
+            session->thread.join();
+            close(session->fd);
+        }
+        sessions_.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        for (const std::shared_ptr<Job>& job : jobs_) {
+            job->cancel();
+        }
+    }
+    jobs_changed_.notify_all();
+    renderer_.join();
+    jobs_.clear();
+    running_ = false;
+}
+
+void RenderServer::accept_loop() {
+    PROFILE_THREAD_NAME("Render server listener");
+    while (!stop_requested_) {
+        pollfd listener{listen_fd_, POLLIN, 0};
+        const bool ready = poll(&listener, 1, POLL_INTERVAL_MS) > 0;
+
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        for (auto it = sessions_.begin(); it != sessions_.end();) {
+            if ((*it)->finished) {
+                (*it)->thread.join();
+                close((*it)->fd);
+                it = sessions_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (!ready) {
+            continue;
+        }
+        int client = accept(listen_fd_, nullptr, nullptr);
+        if (client >= 0) {
+            auto session = std::make_unique<Session>();
+            session->fd = client;
+            session->thread = std::thread(&RenderServer::serve_session, this, session.get());
+            sessions_.push_back(std::move(session));
+        }
+    }
+}
+
+void RenderServer::serve_session(Session* session) {
+    PROFILE_THREAD_NAME("Render server session");
+    bool failed = false;
+    while (!stop_requested_ && !failed) {
+        pollfd client{session->fd, POLLIN, 0};
+        int ready = poll(&client, 1, SESSION_POLL_MS);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        if (ready > 0) {
+            uint32_t type = 0;
+            std::string payload;
+            if (!receive_message(session->fd, type, payload, MAX_REQUEST_BYTES)) {
+                break;
+            }
+            if (type == static_cast<uint32_t>(RenderServerMessage::SUBMIT)) {
+                failed = !handle_submit(*session, payload);
+            } else if (type == static_cast<uint32_t>(RenderServerMessage::CANCEL) && payload.size() == sizeof(uint64_t)) {
+                uint64_t id = 0;
+                std::memcpy(&id, payload.data(), sizeof(id));
+                for (Session::Stream& stream : session->streams) {
+                    if (stream.job->id == id) {
+                        stream.job->cancel();
+                        jobs_changed_.notify_all();
+                    }
+                }
+            } else {
+                LOG_WARN(LogChannel::RENDER, "Render server dropping a client after unexpected message " << type);
+                break;
+            }
+        }
+        for (size_t i = 0; i < session->streams.size() && !failed;) {
+            if (send_updates(*session, i, failed)) {
+                session->streams.erase(session->streams.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    for (Session::Stream& stream : session->streams) {
+        stream.job->cancel();
+    }
+    session->streams.clear();
+    jobs_changed_.notify_all();
+    session->finished = true;
+}
+
+bool RenderServer::handle_submit(Session& session, const std::string& payload) {
+    auto reject = [&](const std::string& reason) {
+        LOG_WARN(LogChannel::RENDER, "Render job rejected: " << reason);
+        return send_message(session.fd, static_cast<uint32_t>(RenderServerMessage::REJECTED), reason.data(),
+                            reason.size());
+    };
+    RenderJobRequest request;
+    if (payload.size() < sizeof(request)) {
+        return reject("truncated request");
+    }
+    std::memcpy(&request, payload.data(), sizeof(request));
+    if (request.width <= 0 || request.height <= 0 ||
+        static_cast<int64_t>(request.width) * request.height > config_.max_pixels) {
+        return reject("invalid image size");
+    }
+    if (request.samples_per_pixel <= 0 || request.samples_per_pixel > config_.max_samples) {
+        return reject("invalid sample count");
+    }
+    if (request.tile_size <= 0 || request.tile_size > config_.max_tile_size) {
+        return reject("invalid tile size");
+    }
+    if (request.max_depth <= 0 || request.max_depth > config_.max_depth) {
+        return reject("invalid depth");
+    }
+
+    auto scene = std::make_shared<SceneManager>();
+    const std::string scene_bytes = payload.size() > sizeof(request) ? payload.substr(sizeof(request)) : default_scene_;
+    if (scene_bytes.empty()) {
+        scene->initialize();
+    } else if (!scene->deserialize(scene_bytes)) {
+        return reject("invalid scene");
+    }
+
+    auto job = std::make_shared<Job>();
+    job->request = request;
+    job->scene = scene;
+    job->last_preview = std::chrono::steady_clock::now();
+    const float aspect = request.camera_aspect > 0.0f ? request.camera_aspect
+                                                      : float(request.width) / float(request.height);
+    job->tracer.set_scene_manager(scene);
+    job->tracer.set_camera(Camera(request.camera_position, request.camera_target, request.camera_up,
+                                  request.camera_fov, aspect));
+    job->tracer.set_max_depth(request.max_depth);
+    job->tracer.set_thread_count(config_.render_threads);
+    // 0 lets accumulate_passes draw one seed for the whole job
+    job->tracer.set_random_seed(request.seed);
+
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        if (jobs_.size() >= static_cast<size_t>(config_.max_jobs)) {
+            return reject("server busy");
+        }
+        job->id = next_job_id_++;
+        job->turn = ++turn_;
+        jobs_.push_back(job);
+    }
+    Session::Stream stream;
+    stream.job = job;
+    stream.sent.assign(static_cast<size_t>(request.width) * request.height * 3, 0);
+    session.streams.push_back(std::move(stream));
+    LOG_DEBUG(LogChannel::RENDER, "Render job " << job->id << ": " << request.width << "x" << request.height << " at "
+                                                << request.samples_per_pixel << " spp, priority " << request.priority);
+    jobs_changed_.notify_all();
+    return send_message(session.fd, static_cast<uint32_t>(RenderServerMessage::ACCEPTED), &job->id, sizeof(job->id));
+}
+
+bool RenderServer::send_updates(Session& session, size_t index, bool& failed) {
+    Session::Stream& stream = session.streams[index];
+    Job& job = *stream.job;
+    std::vector<uint8_t> preview;
+    uint32_t samples = 0;
+    bool finished = false;
+    RenderJobStatus status = RenderJobStatus::COMPLETED;
+    {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (job.version == stream.version) {
+            return false;
+        }
+        stream.version = job.version;
+        preview = job.preview;
+        samples = job.preview_samples;
+        finished = job.finished;
+        status = job.status;
+    }
+
+    const RenderJobRequest& request = job.request;
+    if (!preview.empty()) {
+        TileUpdateHeader header;
+        header.job_id = job.id;
+        header.samples = samples;
+        header.target_samples = static_cast<uint32_t>(request.samples_per_pixel);
+        header.width = request.width;
+        header.height = request.height;
+        std::string tiles;
+        std::string encoded;
+        std::vector<uint8_t> previous;
+        std::vector<uint8_t> current;
+        for (const RenderTile& tile : TileScheduler(1, request.tile_size).make_tiles(request.width, request.height)) {
+            const size_t size = static_cast<size_t>(tile.pixel_count()) * 3;
+            previous.resize(size);
+            current.resize(size);
+            copy_tile(stream.sent, request.width, tile, previous.data(), false);
+            copy_tile(preview, request.width, tile, current.data(), false);
+            if (previous == current) {
+                continue;
+            }
+            TileUpdateEntry entry;
+            entry.x0 = tile.x0;
+            entry.y0 = tile.y0;
+            entry.x1 = tile.x1;
+            entry.y1 = tile.y1;
+            entry.encoding = static_cast<uint32_t>(encode_tile_delta(previous.data(), current.data(), size, encoded));
+            entry.size = static_cast<uint32_t>(encoded.size());
+            append(tiles, entry);
+            tiles += encoded;
+            ++header.tile_count;
+        }
+        std::string message;
+        append(message, header);
+        message += tiles;
+        if (!send_message(session.fd, static_cast<uint32_t>(RenderServerMessage::TILES), message.data(), message.size())) {
+            failed = true;
+            return false;
+        }
+        stream.sent.swap(preview);
+    }
+    if (!finished) {
+        return false;
+    }
+    JobDoneMessage done;
+    done.job_id = job.id;
+    done.samples = samples;
+    done.status = static_cast<uint32_t>(status);
+    failed = !send_message(session.fd, static_cast<uint32_t>(RenderServerMessage::DONE), &done, sizeof(done));
+    return !failed;
+}
+
+RenderClient::~RenderClient() {
+    disconnect();
+}
+
+bool RenderClient::connect(const std::string& socket_path) {
+    disconnect();
+    sockaddr_un address{};
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        LOG_WARN(LogChannel::RENDER, "Cannot connect to render server at " << socket_path << ": " << std::strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    fd_ = fd;
+    return true;
+}
+
+void RenderClient::disconnect() {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    pending_.clear();
+}
+
+#else
+
+bool RenderServer::start() {
+    LOG_WARN(LogChannel::RENDER, "Render server needs Unix domain sockets; not available on this platform");
+    return false;
+}
+
+void RenderServer::stop() {}
+void RenderServer::accept_loop() {}
+void RenderServer::serve_session(Session*) {}
+bool RenderServer::handle_submit(Session&, const std::string&) { return false; }
+bool RenderServer::send_updates(Session&, size_t, bool&) { return false; }
+
+RenderClient::~RenderClient() {}
+bool RenderClient::connect(const std::string&) { return false; }
+void RenderClient::disconnect() {}
+
+#endif
+
+uint64_t RenderClient::submit(const RenderJobRequest& request, const SceneManager* scene, std::string* error) {
+    std::string payload(reinterpret_cast<const char*>(&request), sizeof(request));
+    if (scene) {
+        payload += scene->serialize();
+    }
+    if (fd_ < 0 || !send_message(fd_, static_cast<uint32_t>(RenderServerMessage::SUBMIT), payload.data(), payload.size())) {
+        if (error) *error = "not connected";
+        return 0;
+    }
+    Message message;
+    while (receive_message(fd_, message.type, message.payload)) {
+        if (message.type == static_cast<uint32_t>(RenderServerMessage::ACCEPTED) &&
+            message.payload.size() == sizeof(uint64_t)) {
+            uint64_t id = 0;
+            std::memcpy(&id, message.payload.data(), sizeof(id));
+            images_[id].clear();
+            return id;
+        }
+        if (message.type == static_cast<uint32_t>(RenderServerMessage::REJECTED)) {
+            if (error) *error = message.payload;
+            return 0;
+        }
+        pending_.push_back(std::move(message));
+        message = Message{};
+    }
+    if (error) *error = "connection lost";
+    return 0;
+}
+
+bool RenderClient::cancel(uint64_t job_id) {
+    return fd_ >= 0 && send_message(fd_, static_cast<uint32_t>(RenderServerMessage::CANCEL), &job_id, sizeof(job_id));
+}
+
+bool RenderClient::next_update(Update& update) {
+    while (true) {
+        Message message;
+        if (!pending_.empty()) {
+            message = std::move(pending_.front());
+            pending_.pop_front();
+        } else if (fd_ < 0 || !receive_message(fd_, message.type, message.payload)) {
+            return false;
+        }
+        update = Update{};
+        if (apply(message, update)) {
+            return true;
+        }
+    }
+}
+
+const std::vector<uint8_t>& RenderClient::image(uint64_t job_id) const {
+    static const std::vector<uint8_t> empty;
+    auto it = images_.find(job_id);
+    return it != images_.end() ? it->second : empty;
+}
+
+bool RenderClient::apply(const Message& message, Update& update) {
+    const std::string& payload = message.payload;
+    if (message.type == static_cast<uint32_t>(RenderServerMessage::DONE) && payload.size() == sizeof(JobDoneMessage)) {
+        JobDoneMessage done;
+        std::memcpy(&done, payload.data(), sizeof(done));
+        update.job_id = done.job_id;
+        update.samples = done.samples;
+        update.done = true;
+        update.status = static_cast<RenderJobStatus>(done.status);
+        return true;
+    }
+    if (message.type != static_cast<uint32_t>(RenderServerMessage::TILES) || payload.size() < sizeof(TileUpdateHeader)) {
+        return false;
+    }
+    TileUpdateHeader header;
+    std::memcpy(&header, payload.data(), sizeof(header));
+    update.job_id = header.job_id;
+    update.samples = header.samples;
+    update.target_samples = header.target_samples;
+    std::vector<uint8_t>& image = images_[header.job_id];
+    image.resize(static_cast<size_t>(header.width) * header.height * 3, 0);
+
+    size_t offset = sizeof(header);
+    std::vector<uint8_t> bytes;
+    for (uint32_t i = 0; i < header.tile_count; ++i) {
+        TileUpdateEntry entry;
+        if (offset + sizeof(entry) > payload.size()) {
+            return false;
+        }
+        std::memcpy(&entry, payload.data() + offset, sizeof(entry));
+        offset += sizeof(entry);
+        RenderTile tile;
+        tile.x0 = entry.x0;
+        tile.y0 = entry.y0;
+        tile.x1 = entry.x1;
+        tile.y1 = entry.y1;
+        if (tile.x0 < 0 || tile.y0 < 0 || tile.x1 > header.width || tile.y1 > header.height || tile.width() <= 0 ||
+            tile.height() <= 0 || offset + entry.size > payload.size()) {
+            return false;
+        }
+        bytes.resize(static_cast<size_t>(tile.pixel_count()) * 3);
+        copy_tile(image, header.width, tile, bytes.data(), false);
+        if (!decode_tile_delta(static_cast<TileEncoding>(entry.encoding), payload.data() + offset, entry.size,
+                               bytes.data(), bytes.size())) {
+            return false;
+        }
+        copy_tile(image, header.width, tile, bytes.data(), true);
+        offset += entry.size;
+        update.tiles.push_back(tile);
+    }
+    return true;
+}
@@ -0,0 +1,320 @@
+#include "render/shared_framebuffer.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHARED_FRAMEBUFFER_POSIX 1
+#endif
+
+namespace {
+
+constexpr char MAGIC[8] = "PTSHMFB";
+constexpr size_t CACHE_LINE = 64;
+constexpr size_t PAGE = 4096;
+constexpr int READ_ATTEMPTS = 8;
+
+size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+const SharedFrameSlot* slot_at(const void* base, uint64_t frame) {
+    const auto* header = static_cast<const SharedFramebufferHeader*>(base);
+    const char* bytes = static_cast<const char*>(base);
+    return reinterpret_cast<const SharedFrameSlot*>(bytes + header->slots_offset +
+                                                    (frame % header->slot_count) * header->slot_stride);
+}
+
+uint8_t to_byte(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+} // namespace
+
+SharedFramebuffer::~SharedFramebuffer() {
+    close();
+}
+
+SharedFramebufferReader::~SharedFramebufferReader() {
+    close();
+}
+
+#ifdef SHARED_FRAMEBUFFER_POSIX
+
+bool SharedFramebuffer::create(const Config& config) {
+    close();
+    if (config.name.size() < 2 || config.name[0] != '/' || config.name.find('/', 1) != std::string::npos) {
+        LOG_ERROR(LogChannel::RENDER, "Shared framebuffer name must look like /name, got '" << config.name << "'");
+        return false;
+    }
+    if (config.max_width <= 0 || config.max_height <= 0 || config.slots < 2) {
+        LOG_ERROR(LogChannel::RENDER, "Shared framebuffer needs a positive size and at least two slots");
+        return false;
+    }
+
+    const size_t pixels = static_cast<size_t>(config.max_width) * config.max_height;
+    const size_t display_offset = align_up(sizeof(SharedFrameSlot), CACHE_LINE);
+    const size_t linear_offset = display_offset + align_up(pixels * 4, CACHE_LINE);
+    const size_t slot_stride = align_up(linear_offset + pixels * 3 * sizeof(float), PAGE);
+    const size_t slots_offset = align_up(sizeof(SharedFramebufferHeader), PAGE);
+    const size_t size = slots_offset + slot_stride * static_cast<size_t>(config.slots);
+
+    // A fresh segment: readers still mapping an older one keep it, rather than faulting on a resize
+    shm_unlink(config.name.c_str());
+    int fd = shm_open(config.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOG_ERROR(LogChannel::RENDER, "Cannot create shared framebuffer " << config.name << ": " << std::strerror(errno));
+        if (fd >= 0) {
+            ::close(fd);
+            shm_unlink(config.name.c_str());
+        }
+        return false;
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(LogChannel::RENDER, "Cannot map shared framebuffer " << config.name << ": " << std::strerror(errno));
+        shm_unlink(config.name.c_str());
+        return false;
+    }
+
+    auto* header = new (base) SharedFramebufferHeader;
+    header->version = SharedFramebufferHeader::VERSION;
+    header->slot_count = static_cast<uint32_t>(config.slots);
+    header->max_width = static_cast<uint32_t>(config.max_width);
+    header->max_height = static_cast<uint32_t>(config.max_height);
+    header->slots_offset = slots_offset;
+    header->slot_stride = slot_stride;
+    header->latest_frame.store(0, std::memory_order_relaxed);
+    header->writer_pid.store(static_cast<uint32_t>(getpid()), std::memory_order_relaxed);
+    for (int i = 0; i < config.slots; ++i) {
+        auto* slot = new (static_cast<char*>(base) + slots_offset + i * slot_stride) SharedFrameSlot;
+        slot->sequence.store(0, std::memory_order_relaxed);
+        slot->frame = 0;
+        slot->display_offset = display_offset;
+        slot->linear_offset = linear_offset;
+    }
+    // Readers check the magic first; everything above is visible once they see it
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    base_ = base;
+    size_ = size;
+    frame_ = 0;
+    warned_size_ = false;
+    LOG_INFO(LogChannel::RENDER, "Publishing frames to shared memory " << config.name << " (" << config.slots
+             << " slots of up to " << config.max_width << "x" << config.max_height << ")");
+    return true;
+}
+
+void SharedFramebuffer::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!base_) {
+        return;
+    }
+    static_cast<SharedFramebufferHeader*>(base_)->writer_pid.store(0, std::memory_order_release);
+    munmap(base_, size_);
+    shm_unlink(config_.name.c_str());
+    base_ = nullptr;
+    size_ = 0;
+}
+
+bool SharedFramebuffer::publish(const std::vector<Color>& display, int width, int height, int samples,
+                                int target_samples, const std::vector<Color>* linear_pixels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!base_ || width <= 0 || height <= 0 || display.size() < static_cast<size_t>(width) * height) {
+        return false;
+    }
+    if (width > config_.max_width || height > config_.max_height) {
+        if (!warned_size_) {
+            LOG_WARN(LogChannel::RENDER, "Frame of " << width << "x" << height << " exceeds the shared framebuffer's "
+                     << config_.max_width << "x" << config_.max_height << "; not publishing it");
+            warned_size_ = true;
+        }
+        return false;
+    }
+
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    const bool has_linear = linear_pixels && linear_pixels->size() >= pixel_count;
+
+    auto* header = static_cast<SharedFramebufferHeader*>(base_);
+    const uint64_t frame = ++frame_;
+    auto* slot = const_cast<SharedFrameSlot*>(slot_at(base_, frame));
+    const uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->format = SHARED_FRAME_DISPLAY_RGBA8 | (has_linear ? SHARED_FRAME_LINEAR_RGB32F : 0u);
+    slot->width = static_cast<uint32_t>(width);
+    slot->height = static_cast<uint32_t>(height);
+    slot->frame = frame;
+    slot->samples = static_cast<uint32_t>(std::max(0, samples));
+    slot->target_samples = static_cast<uint32_t>(std::max(0, target_samples));
+    slot->timestamp = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    uint8_t* rgba = reinterpret_cast<uint8_t*>(slot) + slot->display_offset;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        const Color& pixel = display[i];
+        rgba[4 * i + 0] = to_byte(pixel.r);
+        rgba[4 * i + 1] = to_byte(pixel.g);
+        rgba[4 * i + 2] = to_byte(pixel.b);
+        rgba[4 * i + 3] = 255;
+    }
+    if (has_linear) {
+        float* linear = reinterpret_cast<float*>(reinterpret_cast<char*>(slot) + slot->linear_offset);
+        for (size_t i = 0; i < pixel_count; ++i) {
+            const Color& pixel = (*linear_pixels)[i];
+            linear[3 * i + 0] = pixel.r;
+            linear[3 * i + 1] = pixel.g;
+            linear[3 * i + 2] = pixel.b;
+        }
+    }
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    header->latest_frame.store(frame, std::memory_order_release);
+    return true;
+}
+
+bool SharedFramebufferReader::open(const std::string& name) {
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedFramebufferHeader)) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    const auto* header = static_cast<const SharedFramebufferHeader*>(base);
+    bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && header->version == SharedFramebufferHeader::VERSION && header->slot_count >= 2 &&
+            header->slots_offset + header->slot_count * header->slot_stride <= size;
+    if (!valid) {
+        munmap(base, size);
+        return false;
+    }
+    base_ = base;
+    size_ = size;
+    return true;
+}
+
+void SharedFramebufferReader::close() {
+    if (base_) {
+        munmap(const_cast<void*>(base_), size_);
+        base_ = nullptr;
+        size_ = 0;
+    }
+}
+
+#else
+
+bool SharedFramebuffer::create(const Config&) {
+    LOG_WARN(LogChannel::RENDER, "Shared framebuffer needs POSIX shared memory; not available on this platform");
+    return false;
+}
+
+void SharedFramebuffer::close() {}
+bool SharedFramebuffer::publish(const std::vector<Color>&, int, int, int, int, const std::vector<Color>*) {
+    return false;
+}
+bool SharedFramebufferReader::open(const std::string&) { return false; }
+void SharedFramebufferReader::close() {}
+
+#endif
+
+uint64_t SharedFramebufferReader::latest_frame() const {
+    if (!base_) {
+        return 0;
+    }
+    return static_cast<const SharedFramebufferHeader*>(base_)->latest_frame.load(std::memory_order_acquire);
+}
+
+bool SharedFramebufferReader::acquire(SharedFrameView& view) const {
+    if (!base_) {
+        return false;
+    }
+    const auto* header = static_cast<const SharedFramebufferHeader*>(base_);
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+        const uint64_t frame = header->latest_frame.load(std::memory_order_acquire);
+        if (frame == 0) {
+            return false;
+        }
+        const SharedFrameSlot* slot = slot_at(base_, frame);
+        const uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence & 1u) {
+            continue;
+        }
+        SharedFrameView candidate;
+        candidate.frame = slot->frame;
+        candidate.format = slot->format;
+        candidate.width = static_cast<int>(slot->width);
+        candidate.height = static_cast<int>(slot->height);
+        candidate.samples = static_cast<int>(slot->samples);
+        candidate.target_samples = static_cast<int>(slot->target_samples);
+        candidate.timestamp = slot->timestamp;
+        const uint64_t display_offset = slot->display_offset;
+        const uint64_t linear_offset = slot->linear_offset;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != sequence || candidate.frame != frame) {
+            continue;
+        }
+        if (candidate.width > static_cast<int>(header->max_width) ||
+            candidate.height > static_cast<int>(header->max_height)) {
+            return false;
+        }
+        candidate.display = reinterpret_cast<const uint8_t*>(slot) + display_offset;
+        if (candidate.format & SHARED_FRAME_LINEAR_RGB32F) {
+            candidate.linear = reinterpret_cast<const float*>(reinterpret_cast<const char*>(slot) + linear_offset);
+        }
+        candidate.sequence = sequence;
+        candidate.slot = slot;
+        view = candidate;
+        return true;
+    }
+    return false;
+}
+
+bool SharedFramebufferReader::validate(const SharedFrameView& view) const {
+    if (!view.slot) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.slot->sequence.load(std::memory_order_relaxed) == view.sequence;
+}
+
+bool SharedFramebufferReader::read(SharedFrameView& view, std::vector<uint8_t>& display,
+                                   std::vector<float>& linear) const {
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+        if (!acquire(view)) {
+            return false;
+        }
+        const size_t pixel_count = static_cast<size_t>(view.width) * view.height;
+        display.assign(view.display, view.display + pixel_count * 4);
+        if (view.linear) {
+            linear.assign(view.linear, view.linear + pixel_count * 3);
+        } else {
+            linear.clear();
+        }
+        if (validate(view)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+#include "render/socket_messages.h"
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/types.h>
+#define SOCKET_MESSAGES_POSIX 1
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#ifdef SOCKET_MESSAGES_POSIX
+
+namespace {
+
+struct MessageHeader {
+    uint32_t type;
+    uint32_t size;
+};
+
+bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool read_all(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+bool send_message(int fd, uint32_t type, const void* payload, size_t size) {
+    MessageHeader header{type, static_cast<uint32_t>(size)};
+    return write_all(fd, &header, sizeof(header)) && write_all(fd, payload, size);
+}
+
+bool receive_message(int fd, uint32_t& type, std::string& payload, uint32_t max_size) {
+    MessageHeader header;
+    if (!read_all(fd, &header, sizeof(header)) || header.size > max_size) {
+        return false;
+    }
+    type = header.type;
+    payload.resize(header.size);
+    return header.size == 0 || read_all(fd, &payload[0], header.size);
+}
+
+#else
+
+bool send_message(int, uint32_t, const void*, size_t) {
+    return false;
+}
+
+bool receive_message(int, uint32_t&, std::string&, uint32_t) {
+    return false;
+}
+
+#endif
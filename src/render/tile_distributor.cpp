@@ -0,0 +1,531 @@
+#include "render/tile_distributor.h"
+#include "render/path_tracer.h"
+#include "render/socket_messages.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+#include "core/logger.h"
+#include "core/profiler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define TILE_DISTRIBUTOR_PROCESSES 1
+extern char** environ;
+#endif
+
+struct TileDistributor::Worker {
+    struct Assignment {
+        int index = -1;
+        bool started = false;       // The worker has reported beginning this tile
+        std::chrono::steady_clock::time_point started_at;
+    };
+
+    int pid = -1;
+    int fd = -1;
+    // Assigned tiles without a result yet, oldest first
+    std::deque<Assignment> in_flight;
+    // Last message from the worker, or the assignment that ended its idling
+    std::chrono::steady_clock::time_point last_progress;
+};
+
+#ifdef TILE_DISTRIBUTOR_PROCESSES
+
+namespace {
+
+// Message types of the worker protocol; framing is in socket_messages.h
+enum class MessageType : uint32_t {
+    SCENE = 1,          // SceneManager::serialize() bytes
+    FRAME = 2,          // FrameMessage
+    TILE = 3,           // TileMessage
+    TILE_RESULT = 4,    // TileMessage, then RGB floats of the tile's pixels
+    TILE_STARTED = 5    // TileMessage, sent as the worker begins tracing a tile
+};
+
+struct FrameMessage {
+    uint64_t frame_id;
+    DistributedFrame frame;
+};
+
+struct TileMessage {
+    uint64_t frame_id;
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+    int32_t index;
+};
+
+static_assert(std::is_trivially_copyable<FrameMessage>::value, "frames are sent as raw bytes");
+
+constexpr int POLL_INTERVAL_MS = 20;                  // How often stragglers are looked for
+constexpr auto STOP_GRACE = std::chrono::seconds(2);  // For a worker to finish its tile and exit
+
+bool send_to(int fd, MessageType type, const void* payload, size_t size) {
+    return send_message(fd, static_cast<uint32_t>(type), payload, size);
+}
+
+bool receive_from(int fd, MessageType& type, std::string& payload) {
+    uint32_t raw = 0;
+    bool ok = receive_message(fd, raw, payload);
+    type = static_cast<MessageType>(raw);
+    return ok;
+}
+
+// The running executable, which then has to handle --worker-fd itself
+std::string current_executable() {
+#ifdef __linux__
+    char path[4096];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length > 0) {
+        return std::string(path, static_cast<size_t>(length));
+    }
+#endif
+    return std::string();
+}
+
+double median_of(std::vector<double> values) {
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+TileDistributor::TileDistributor() : TileDistributor(Config()) {
+}
+
+TileDistributor::TileDistributor(const Config& config) : config_(config) {
+}
+
+TileDistributor::~TileDistributor() {
+    stop();
+}
+
+int TileDistributor::worker_count() const {
+    return static_cast<int>(std::count_if(workers_.begin(), workers_.end(),
+                                          [](const std::unique_ptr<Worker>& worker) { return worker != nullptr; }));
+}
+
+std::vector<int> TileDistributor::worker_pids() const {
+    std::vector<int> pids;
+    for (const auto& worker : workers_) {
+        pids.push_back(worker ? worker->pid : -1);
+    }
+    return pids;
+}
+
+bool TileDistributor::start(const SceneManager& scene) {
+    stop();
+    scene_bytes_ = scene.serialize();
+    int count = config_.workers > 0 ? config_.workers
+                                    : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    workers_.resize(static_cast<size_t>(count));
+    for (size_t slot = 0; slot < workers_.size(); ++slot) {
+        spawn(slot, false);
+    }
+    LOG_INFO(LogChannel::RENDER, "Started " << worker_count() << " of " << count << " tile worker processes");
+    return is_running();
+}
+
+void TileDistributor::stop() {
+    // Closing the socket is the shutdown request; a worker exits after its current tile
+    for (auto& worker : workers_) {
+        if (worker) {
+            close(worker->fd);
+            worker->fd = -1;
+        }
+    }
+    auto deadline = std::chrono::steady_clock::now() + STOP_GRACE;
+    for (auto& worker : workers_) {
+        if (!worker) {
+            continue;
+        }
+        while (waitpid(worker->pid, nullptr, WNOHANG) == 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                kill(worker->pid, SIGKILL);
+                waitpid(worker->pid, nullptr, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    workers_.clear();
+}
+
+bool TileDistributor::set_scene(const SceneManager& scene) {
+    scene_bytes_ = scene.serialize();
+    bool ok = is_running();
+    for (size_t slot = 0; slot < workers_.size(); ++slot) {
+        if (workers_[slot] && !send_to(workers_[slot]->fd, MessageType::SCENE, scene_bytes_.data(), scene_bytes_.size())) {
+            retire(slot);
+            ok = spawn(slot, false) && ok;
+        }
+    }
+    return ok;
+}
+
+bool TileDistributor::spawn(size_t slot, bool rendering) {
+    const std::string executable = config_.worker_executable.empty() ? current_executable() : config_.worker_executable;
+    if (executable.empty()) {
+        LOG_ERROR(LogChannel::RENDER, "No tile worker executable configured");
+        return false;
+    }
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        LOG_ERROR(LogChannel::RENDER, "socketpair failed: " << std::strerror(errno));
+        return false;
+    }
+    // Only the worker's own end survives the exec, so every worker sees EOF
+    // when the coordinator goes away
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+    // A fresh process image: a forked copy of this multithreaded process
+    // could inherit a lock some other thread held at the time
+    std::string fd_arg = std::to_string(fds[1]);
+    char* argv[] = {const_cast<char*>(executable.c_str()), const_cast<char*>("--worker-fd"), &fd_arg[0], nullptr};
+    pid_t pid = -1;
+    int error = posix_spawn(&pid, executable.c_str(), nullptr, nullptr, argv, environ);
+    close(fds[1]);
+    if (error != 0) {
+        LOG_ERROR(LogChannel::RENDER, "Could not spawn tile worker " << executable << ": " << std::strerror(error));
+        close(fds[0]);
+        return false;
+    }
+
+    auto worker = std::make_unique<Worker>();
+    worker->pid = pid;
+    worker->fd = fds[0];
+    workers_[slot] = std::move(worker);
+    bool ok = send_to(fds[0], MessageType::SCENE, scene_bytes_.data(), scene_bytes_.size());
+    if (ok && rendering) {
+        FrameMessage message{frame_id_, frame_};
+        ok = send_to(fds[0], MessageType::FRAME, &message, sizeof(message));
+    }
+    if (!ok) {
+        retire(slot);
+    }
+    return ok;
+}
+
+void TileDistributor::retire(size_t slot) {
+    std::unique_ptr<Worker> worker = std::move(workers_[slot]);
+    if (worker) {
+        close(worker->fd);
+        kill(worker->pid, SIGKILL);
+        waitpid(worker->pid, nullptr, 0);
+    }
+}
+
+bool TileDistributor::render(const DistributedFrame& frame, std::vector<Color>& image, const TileCallback& on_tile) {
+    PROFILE_FUNCTION();
+    auto start = std::chrono::steady_clock::now();
+    stats_ = DistributionStats();
+    stats_.tiles_per_worker.assign(workers_.size(), 0);
+    ++frame_id_;
+    frame_ = frame;
+
+    TileScheduler layout(1, frame.tile_size);
+    const std::vector<RenderTile> tiles = layout.make_tiles(frame.width, frame.height);
+    image.assign(static_cast<size_t>(frame.width) * frame.height, Color(0, 0, 0));
+    std::vector<char> done(tiles.size(), 0);
+    std::vector<char> speculated(tiles.size(), 0);
+    std::deque<int> pending;
+    for (const RenderTile& tile : tiles) {
+        pending.push_back(tile.index);
+    }
+    size_t remaining = tiles.size();
+    std::vector<double> tile_seconds;
+
+    // Requeues what the worker held and puts a fresh process in its slot
+    auto replace = [&](size_t slot) {
+        for (const auto& assigned : workers_[slot]->in_flight) {
+            if (!done[assigned.index]) {
+                pending.push_front(assigned.index);
+                ++stats_.requeued_tiles;
+            }
+        }
+        LOG_WARN(LogChannel::RENDER, "Tile worker " << slot << " (pid " << workers_[slot]->pid << ") died; requeued "
+                 << workers_[slot]->in_flight.size() << " tiles");
+        retire(slot);
+        if (stats_.worker_restarts < static_cast<uint64_t>(config_.max_restarts)) {
+            ++stats_.worker_restarts;
+            spawn(slot, true);
+        }
+    };
+    auto assign = [&](size_t slot, int index) {
+        const RenderTile& tile = tiles[index];
+        TileMessage message{frame_id_, tile.x0, tile.y0, tile.x1, tile.y1, tile.index};
+        Worker::Assignment assignment;
+        assignment.index = index;
+        if (workers_[slot]->in_flight.empty()) {
+            workers_[slot]->last_progress = std::chrono::steady_clock::now();
+        }
+        workers_[slot]->in_flight.push_back(assignment);
+        return send_to(workers_[slot]->fd, MessageType::TILE, &message, sizeof(message));
+    };
+
+    for (size_t slot = 0; slot < workers_.size(); ++slot) {
+        if (!workers_[slot]) {
+            continue;
+        }
+        // Results of an earlier frame that are still on their way are dropped by frame id
+        workers_[slot]->in_flight.clear();
+        FrameMessage message{frame_id_, frame_};
+        if (!send_to(workers_[slot]->fd, MessageType::FRAME, &message, sizeof(message))) {
+            replace(slot);
+        }
+    }
+
+    std::vector<pollfd> polls;
+    std::vector<size_t> poll_slots;
+    std::string payload;
+    std::vector<Color> tile_pixels;
+    while (remaining > 0) {
+        if (!is_running()) {
+            LOG_ERROR(LogChannel::RENDER, "No tile workers left; " << remaining << " tiles not rendered");
+            return false;
+        }
+
+        // Keep every worker's queue full, then hand idle workers copies of straggling tiles
+        for (size_t slot = 0; slot < workers_.size(); ++slot) {
+            while (workers_[slot] && static_cast<int>(workers_[slot]->in_flight.size()) < config_.tiles_in_flight &&
+                   !pending.empty()) {
+                int index = pending.front();
+                pending.pop_front();
+                if (!done[index] && !assign(slot, index)) {
+                    replace(slot);
+                }
+            }
+        }
+        if (pending.empty() && !tile_seconds.empty()) {
+            const auto now = std::chrono::steady_clock::now();
+            const auto limit = std::max<std::chrono::steady_clock::duration>(
+                config_.min_straggler_time,
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(median_of(tile_seconds) * config_.straggler_factor)));
+            for (size_t idle = 0; idle < workers_.size(); ++idle) {
+                if (!workers_[idle] || !workers_[idle]->in_flight.empty()) {
+                    continue;
+                }
+                // A busy worker reports every tile it starts and finishes, so
+                // only one silent for too long is straggling; tiles merely
+                // queued behind a healthy worker's current tile are not late.
+                // A stalled worker holds up its whole queue.
+                int straggler = -1;
+                for (const auto& worker : workers_) {
+                    if (!worker || worker->in_flight.empty() || now - worker->last_progress <= limit) {
+                        continue;
+                    }
+                    for (size_t k = 0; k < worker->in_flight.size() && straggler < 0; ++k) {
+                        const Worker::Assignment& assigned = worker->in_flight[k];
+                        if (!done[assigned.index] && !speculated[assigned.index]) {
+                            straggler = assigned.index;
+                        }
+                    }
+                }
+                if (straggler < 0) {
+                    break;
+                }
+                speculated[straggler] = 1;
+                ++stats_.speculative_tiles;
+                if (!assign(idle, straggler)) {
+                    replace(idle);
+                }
+            }
+        }
+
+        polls.clear();
+        poll_slots.clear();
+        for (size_t slot = 0; slot < workers_.size(); ++slot) {
+            if (workers_[slot]) {
+                polls.push_back(pollfd{workers_[slot]->fd, POLLIN, 0});
+                poll_slots.push_back(slot);
+            }
+        }
+        if (poll(polls.data(), polls.size(), POLL_INTERVAL_MS) < 0 && errno != EINTR) {
+            LOG_ERROR(LogChannel::RENDER, "poll failed: " << std::strerror(errno));
+            return false;
+        }
+
+        for (size_t p = 0; p < polls.size(); ++p) {
+            if (polls[p].revents == 0) {
+                continue;
+            }
+            const size_t slot = poll_slots[p];
+            MessageType type;
+            TileMessage result;
+            if (!receive_from(workers_[slot]->fd, type, payload) ||
+                (type != MessageType::TILE_RESULT && type != MessageType::TILE_STARTED) ||
+                payload.size() < sizeof(result)) {
+                replace(slot);
+                continue;
+            }
+            std::memcpy(&result, payload.data(), sizeof(result));
+            workers_[slot]->last_progress = std::chrono::steady_clock::now();
+            if (result.frame_id != frame_id_) {
+                continue;
+            }
+
+            auto& in_flight = workers_[slot]->in_flight;
+            auto assigned = std::find_if(in_flight.begin(), in_flight.end(),
+                                         [&](const Worker::Assignment& entry) { return entry.index == result.index; });
+            if (type == MessageType::TILE_STARTED) {
+                if (assigned != in_flight.end()) {
+                    assigned->started = true;
+                    assigned->started_at = std::chrono::steady_clock::now();
+                }
+                continue;
+            }
+            const bool valid = result.index >= 0 && static_cast<size_t>(result.index) < tiles.size() &&
+                payload.size() == sizeof(result) + static_cast<size_t>(tiles[result.index].pixel_count()) * 3 * sizeof(float);
+            if (!valid) {
+                replace(slot);
+                continue;
+            }
+
+            if (assigned != in_flight.end()) {
+                if (assigned->started) {
+                    tile_seconds.push_back(
+                        std::chrono::duration<double>(std::chrono::steady_clock::now() - assigned->started_at).count());
+                }
+                in_flight.erase(assigned);
+            }
+            // A straggler's copy may already have been delivered
+            if (done[result.index]) {
+                continue;
+            }
+
+            const RenderTile& tile = tiles[result.index];
+            const float* rgb = reinterpret_cast<const float*>(payload.data() + sizeof(result));
+            tile_pixels.resize(static_cast<size_t>(tile.pixel_count()));
+            for (size_t i = 0; i < tile_pixels.size(); ++i) {
+                tile_pixels[i] = Color(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+            }
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                std::copy(tile_pixels.begin() + static_cast<size_t>(y - tile.y0) * tile.width(),
+                          tile_pixels.begin() + static_cast<size_t>(y - tile.y0 + 1) * tile.width(),
+                          image.begin() + static_cast<size_t>(y) * frame.width + tile.x0);
+            }
+            done[result.index] = 1;
+            --remaining;
+            ++stats_.tiles;
+            ++stats_.tiles_per_worker[slot];
+            if (on_tile) {
+                on_tile(tile, tile_pixels);
+            }
+        }
+    }
+
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO(LogChannel::RENDER, "Distributed frame of " << tiles.size() << " tiles over " << worker_count()
+             << " workers in " << stats_.seconds * 1000.0 << " ms (" << stats_.speculative_tiles
+             << " speculative, " << stats_.requeued_tiles << " requeued, " << stats_.worker_restarts << " restarts)");
+    return true;
+}
+
+int run_tile_worker(int fd) {
+    // A lost coordinator must show up as a failed send, also where MSG_NOSIGNAL is missing
+    signal(SIGPIPE, SIG_IGN);
+    auto scene = std::make_shared<SceneManager>();
+    PathTracer tracer;
+    tracer.set_thread_count(1);
+    bool have_frame = false;
+    DistributedFrame frame;
+    MessageType type;
+    std::string payload;
+    std::string result;
+    std::vector<Color> pixels;
+
+    while (receive_from(fd, type, payload)) {
+        switch (type) {
+            case MessageType::SCENE:
+                if (!scene->deserialize(payload)) {
+                    return 1;
+                }
+                tracer.set_scene_manager(scene);
+                break;
+            case MessageType::FRAME: {
+                FrameMessage message;
+                if (payload.size() != sizeof(message)) {
+                    return 1;
+                }
+                std::memcpy(&message, payload.data(), sizeof(message));
+                frame = message.frame;
+                tracer.set_camera(Camera(frame.camera_position, frame.camera_target, frame.camera_up,
+                                         frame.camera_fov, frame.camera_aspect));
+                tracer.set_max_depth(frame.max_depth);
+                tracer.set_samples_per_pixel(frame.samples_per_pixel);
+                tracer.set_random_seed(frame.seed);
+                have_frame = true;
+                break;
+            }
+            case MessageType::TILE: {
+                TileMessage message;
+                if (!have_frame || payload.size() != sizeof(message)) {
+                    return 1;
+                }
+                std::memcpy(&message, payload.data(), sizeof(message));
+                RenderTile tile;
+                tile.x0 = message.x0;
+                tile.y0 = message.y0;
+                tile.x1 = message.x1;
+                tile.y1 = message.y1;
+                tile.index = message.index;
+                // Tile times start here, not when the tile was queued
+                if (!send_to(fd, MessageType::TILE_STARTED, &message, sizeof(message))) {
+                    return 0;
+                }
+                tracer.trace_tile(frame.width, frame.height, tile, pixels);
+
+                result.assign(reinterpret_cast<const char*>(&message), sizeof(message));
+                for (const Color& pixel : pixels) {
+                    result.append(reinterpret_cast<const char*>(&pixel.r), sizeof(float));
+                    result.append(reinterpret_cast<const char*>(&pixel.g), sizeof(float));
+                    result.append(reinterpret_cast<const char*>(&pixel.b), sizeof(float));
+                }
+                if (!send_to(fd, MessageType::TILE_RESULT, result.data(), result.size())) {
+                    return 0;
+                }
+                break;
+            }
+            default:
+                return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+TileDistributor::TileDistributor() : TileDistributor(Config()) {}
+TileDistributor::TileDistributor(const Config& config) : config_(config) {}
+TileDistributor::~TileDistributor() {}
+int TileDistributor::worker_count() const { return 0; }
+std::vector<int> TileDistributor::worker_pids() const { return std::vector<int>(); }
+
+bool TileDistributor::start(const SceneManager&) {
+    LOG_WARN(LogChannel::RENDER, "Tile worker processes need posix_spawn and Unix sockets; not available on this platform");
+    return false;
+}
+
+void TileDistributor::stop() {}
+bool TileDistributor::set_scene(const SceneManager&) { return false; }
+bool TileDistributor::render(const DistributedFrame&, std::vector<Color>&, const TileCallback&) { return false; }
+bool TileDistributor::spawn(size_t, bool) { return false; }
+void TileDistributor::retire(size_t) {}
+
+int run_tile_worker(int) {
+    return 1;
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include "render/tile_scheduler.h"
+#include "core/profiler.h"
+#include "core/resource_monitor.h"
+#include "performance/hw_counters.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Each claim is one relaxed decrement, next to the fetch_add that claims the tile
+std::atomic<int64_t> g_pending_tiles{0};
+
+} // namespace
+
+int64_t tile_scheduler_pending_tiles() {
+    return g_pending_tiles.load(std::memory_order_relaxed);
+}
+
+double TileRunStats::busy_seconds() const {
+    double total = 0.0;
+    for (double seconds : thread_busy_seconds) {
+        total += seconds;
+    }
+    return total;
+}
+
+double TileRunStats::imbalance() const {
+    if (thread_busy_seconds.empty()) {
+        return 1.0;
+    }
+    double mean = busy_seconds() / thread_busy_seconds.size();
+    double slowest = *std::max_element(thread_busy_seconds.begin(), thread_busy_seconds.end());
+    return mean > 0.0 ? slowest / mean : 1.0;
+}
+
+TileScheduler::TileScheduler(int thread_count, int tile_size)
+    : thread_count_(1), tile_size_(DEFAULT_TILE_SIZE) {
+    set_thread_count(thread_count);
+    set_tile_size(tile_size);
+}
+
+void TileScheduler::set_thread_count(int count) {
+    if (count <= 0) {
+        count = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    thread_count_ = std::max(1, count);
+}
+
+void TileScheduler::set_tile_size(int size) {
+    tile_size_ = std::max(1, size);
+}
+
+std::vector<RenderTile> TileScheduler::make_tiles(int width, int height) const {
+    std::vector<RenderTile> tiles;
+    if (width <= 0 || height <= 0) {
+        return tiles;
+    }
+
+    int tiles_x = (width + tile_size_ - 1) / tile_size_;
+    int tiles_y = (height + tile_size_ - 1) / tile_size_;
+    tiles.reserve(static_cast<size_t>(tiles_x) * tiles_y);
+
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            RenderTile tile;
+            tile.x0 = tx * tile_size_;
+            tile.y0 = ty * tile_size_;
+            tile.x1 = std::min(width, tile.x0 + tile_size_);
+            tile.y1 = std::min(height, tile.y0 + tile_size_);
+            tile.index = static_cast<int>(tiles.size());
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+bool TileScheduler::run(int width, int height, const TileFunction& fn,
+                        const std::atomic<bool>* stop_flag) const {
+    using Clock = std::chrono::steady_clock;
+    const auto run_start = Clock::now();
+    const std::vector<RenderTile> tiles = make_tiles(width, height);
+    TileRunStats& stats = last_run_stats_;
+    stats.wall_seconds = 0.0;
+    stats.thread_busy_seconds.assign(thread_count_, 0.0);
+    stats.thread_cpu_seconds.assign(thread_count_, 0.0);
+    stats.thread_tiles.assign(thread_count_, 0);
+    stats.tile_seconds.assign(tiles.size(), 0.0);
+    stats.rays = RayStats();
+    if (tiles.empty()) {
+        return true;
+    }
+
+    g_pending_tiles.fetch_add(static_cast<int64_t>(tiles.size()), std::memory_order_relaxed);
+    std::atomic<size_t> next_tile(0);
+    std::atomic<size_t> finished_tiles(0);
+    std::vector<RayStats> thread_rays(thread_count_);
+    auto stopped = [stop_flag]() {
+        return stop_flag && stop_flag->load(std::memory_order_relaxed);
+    };
+
+    auto worker = [&](int thread_index) {
+        if (thread_index > 0) {
+            PROFILE_THREAD_NAME("Tile worker " + std::to_string(thread_index));
+        }
+        // Totals stay local until the end so workers don't share cache lines
+        double busy = 0.0;
+        int claimed = 0;
+        const double cpu_start = thread_cpu_seconds();
+        // A worker's slot only counts this run between the snapshots
+        const RayStats rays_start = thread_ray_stats().snapshot();
+        while (!stopped()) {
+            size_t index = next_tile.fetch_add(1, std::memory_order_relaxed);
+            if (index >= tiles.size()) {
+                break;
+            }
+            g_pending_tiles.fetch_sub(1, std::memory_order_relaxed);
+            auto tile_start = Clock::now();
+            fn(tiles[index], thread_index);
+            double seconds = std::chrono::duration<double>(Clock::now() - tile_start).count();
+            stats.tile_seconds[index] = seconds;
+            busy += seconds;
+            ++claimed;
+            finished_tiles.fetch_add(1, std::memory_order_relaxed);
+        }
+        stats.thread_busy_seconds[thread_index] = busy;
+        stats.thread_cpu_seconds[thread_index] = thread_cpu_seconds() - cpu_start;
+        stats.thread_tiles[thread_index] = claimed;
+        thread_rays[thread_index] = thread_ray_stats().snapshot() - rays_start;
+        // One locked merge per worker and run, not one per tile
+        hw_stage_flush();
+    };
+
+    // The calling thread works as thread 0 so small images don't pay for a spawn
+    int worker_count = std::min<int>(thread_count_, static_cast<int>(tiles.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(worker_count > 0 ? worker_count - 1 : 0);
+    for (int t = 1; t < worker_count; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    stats.wall_seconds = std::chrono::duration<double>(Clock::now() - run_start).count();
+    for (const RayStats& rays : thread_rays) {
+        stats.rays += rays;
+    }
+    // Tiles a stop request left unclaimed
+    size_t claimed = std::min(next_tile.load(), tiles.size());
+    g_pending_tiles.fetch_sub(static_cast<int64_t>(tiles.size() - claimed), std::memory_order_relaxed);
+
+    return finished_tiles.load() == tiles.size() && !stopped();
+}
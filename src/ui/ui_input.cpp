@@ -3,12 +3,14 @@
 #include "core/scene_manager.h"
 #include "render/render_engine.h"
 #include "render/path_tracer.h"
+#include "core/profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <cmath>
 #include <chrono>
 #include <random>
+#include <ctime>
 
 #ifdef USE_SDL
 #include <SDL.h>
@@ -383,6 +385,68 @@ void UIInput::handle_realtime_camera_input(int keycode) {
                 std::cout << "X key pressed - No progressive rendering to cancel" << std::endl;
             }
             break;
+        case SDLK_j:
+            if (render_engine_) {
+                bool enabled = !render_engine_->is_direct_light_resampling_enabled();
+                render_engine_->set_direct_light_resampling(enabled);
+                std::cout << "Resampled direct lighting in preview: " << (enabled ? "ON" : "OFF") << std::endl;
+            }
+            break;
+        case SDLK_k:
+            if (render_engine_) {
+                bool enabled = !render_engine_->is_irradiance_cache_enabled();
+                render_engine_->set_irradiance_cache(enabled);
+                std::cout << "Irradiance cache in preview: " << (enabled ? "ON" : "OFF") << std::endl;
+            }
+            break;
+        case SDLK_b:
+            if (render_engine_) {
+                bool enabled = !render_engine_->is_raster_primary_visibility_enabled();
+                render_engine_->set_raster_primary_visibility(enabled);
+                std::cout << "Raster primary visibility in preview: " << (enabled ? "ON" : "OFF") << std::endl;
+            }
+            break;
+        case SDLK_n:
+            if (render_engine_) {
+                bool enabled = !render_engine_->is_denoising_enabled();
+                render_engine_->set_denoising(enabled);
+                std::cout << "Denoiser: " << (enabled ? "ON" : "OFF") << std::endl;
+            }
+            break;
+        case SDLK_c:
+            if (render_engine_) {
+                // Cycle off -> cycles -> intersection tests -> bounces -> off
+                if (!render_engine_->is_cost_heatmap_enabled()) {
+                    render_engine_->set_cost_heatmap(true, HeatmapMetric::CYCLES);
+                } else if (render_engine_->get_heatmap_metric() == HeatmapMetric::CYCLES) {
+                    render_engine_->set_cost_heatmap(true, HeatmapMetric::INTERSECTION_TESTS);
+                } else if (render_engine_->get_heatmap_metric() == HeatmapMetric::INTERSECTION_TESTS) {
+                    render_engine_->set_cost_heatmap(true, HeatmapMetric::BOUNCES);
+                } else {
+                    render_engine_->set_cost_heatmap(false);
+                }
+                if (render_engine_->is_cost_heatmap_enabled()) {
+                    std::cout << "Cost heatmap: " << heatmap_metric_name(render_engine_->get_heatmap_metric()) << std::endl;
+                } else {
+                    std::cout << "Cost heatmap: OFF" << std::endl;
+                }
+            }
+            break;
+        case SDLK_y:
+            // Start a trace capture, or stop it and write the Chrome trace
+            if (!profiler_enabled()) {
+                profiler_clear();
+                profiler_set_enabled(true);
+#ifdef ENABLE_PROFILING
+                std::cout << "Profiler capture started" << std::endl;
+#else
+                std::cout << "Built without ENABLE_PROFILING - no zones will be recorded" << std::endl;
+#endif
+            } else {
+                profiler_set_enabled(false);
+                profiler_export_chrome_trace("profile_" + std::to_string(std::time(nullptr)) + ".json");
+            }
+            break;
         case SDLK_v:
             std::cout << "V key pressed - Save Image!" << std::endl;
             if (save_callback_) {
@@ -654,6 +718,12 @@ void UIInput::print_camera_controls() const {
     std::cout << "M   - Progressive high-quality render (1->2000 samples)" << std::endl;
     std::cout << "T   - Stop/cancel rendering" << std::endl;
     std::cout << "X   - Cancel progressive rendering" << std::endl;
+    std::cout << "J   - Toggle resampled direct lighting in previews" << std::endl;
+    std::cout << "K   - Toggle irradiance cache in previews" << std::endl;
+    std::cout << "B   - Toggle raster primary visibility in previews" << std::endl;
+    std::cout << "N   - Toggle denoiser for CPU renders and previews" << std::endl;
+    std::cout << "C   - Cycle per-pixel cost heatmap (cycles, tests, bounces, off)" << std::endl;
+    std::cout << "Y   - Start/stop profiler capture (writes a Chrome trace JSON)" << std::endl;
     std::cout << "V   - Save rendered image (after completion)" << std::endl;
     std::cout << "\nAdd primitives with 1-4, then use G for quick render, M for quality!" << std::endl;
     std::cout << "==================================" << std::endl;
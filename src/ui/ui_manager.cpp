@@ -3,6 +3,7 @@
 #include "core/scene_manager.h"
 #include "render/render_engine.h"
 #include "render/image_output.h"
+#include "core/profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -46,12 +47,14 @@ void UIManager::setup_primitive_management() {
 }
 
 void UIManager::update() {
+    PROFILE_FUNCTION();
     if (ui_input_) {
         ui_input_->processEvents();
     }
 }
 
 void UIManager::render() {
+    PROFILE_FUNCTION();
     // Process any pending progressive display updates (must happen on main thread)
     if (image_output_) {
         image_output_->process_pending_progressive_updates();
@@ -225,6 +228,22 @@ void UIManager::render_progress_display() {
     std::cout << "Speed: " << progress_data_.samples_per_second 
               << " samples/sec" << std::endl;
     
+    // Ray throughput of the CPU tracer (zero for GPU renders)
+    RenderMetrics metrics = render_engine_ ? render_engine_->get_render_metrics() : RenderMetrics();
+    if (metrics.mrays_per_second > 0.0) {
+        std::cout << "Rays: " << metrics.mrays_per_second << " Mrays/s, "
+                  << metrics.tests_per_ray << " tests/ray, "
+                  << metrics.mean_path_length << " vertices/path" << std::endl;
+    }
+    
+    // Measured process resources; GPU memory only when the GPU path has allocated any
+    std::cout << "Resources: " << metrics.memory_usage_mb << " MB RSS (peak "
+              << metrics.peak_memory_mb << " MB), CPU " << metrics.cpu_utilization << "%";
+    if (metrics.gpu_memory_mb > 0.0f) {
+        std::cout << ", GPU " << metrics.gpu_memory_mb << " MB";
+    }
+    std::cout << std::endl;
+    
     // Time estimation
     std::cout << "ETA: " << format_time(progress_data_.estimated_time_remaining) << std::endl;
     
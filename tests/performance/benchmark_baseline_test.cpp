@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "performance/benchmark_baseline.h"
+
+class BenchmarkBaselineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = testing::TempDir() + "benchmark_baseline_test.baseline";
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    std::string path_;
+};
+
+TEST_F(BenchmarkBaselineTest, StudentTMatchesTables) {
+    EXPECT_NEAR(studentTUpperTail(0.0, 5.0), 0.5, 1e-9);
+    // t(0.975, 4) = 2.776 and t(0.995, 10) = 3.169
+    EXPECT_NEAR(studentTUpperTail(2.776, 4.0), 0.025, 1e-4);
+    EXPECT_NEAR(studentTUpperTail(3.169, 10.0), 0.005, 1e-4);
+    EXPECT_NEAR(studentTUpperTail(-2.776, 4.0), 0.975, 1e-4);
+}
+
+TEST_F(BenchmarkBaselineTest, ConfidenceIntervalOfMean) {
+    SampleStats stats = computeSampleStats({10.0, 12.0, 11.0, 9.0, 13.0});
+    EXPECT_EQ(stats.count, 5);
+    EXPECT_DOUBLE_EQ(stats.mean, 11.0);
+    EXPECT_DOUBLE_EQ(stats.median, 11.0);
+    EXPECT_NEAR(stats.stddev, 1.5811, 1e-4);
+    // 2.776 * 1.5811 / sqrt(5)
+    EXPECT_NEAR(stats.ciHigh - stats.mean, 1.963, 1e-3);
+    EXPECT_NEAR(stats.mean - stats.ciLow, 1.963, 1e-3);
+}
+
+TEST_F(BenchmarkBaselineTest, WelchTestSeparatesNoiseFromSlowdown) {
+    std::vector<double> baseline = {100.0, 101.0, 99.0, 100.5, 99.5};
+    std::vector<double> noise = {100.2, 99.1, 100.9, 99.8, 100.4};
+    std::vector<double> slower = {110.0, 111.0, 109.0, 110.5, 109.5};
+    std::vector<double> faster = {90.0, 91.0, 89.0, 90.5, 89.5};
+
+    RegressionCheck same = compareSamples("noise", baseline, noise);
+    EXPECT_FALSE(same.regression);
+    EXPECT_FALSE(same.improvement);
+    EXPECT_GT(same.pValue, 0.1);
+
+    RegressionCheck slow = compareSamples("slow", baseline, slower);
+    EXPECT_TRUE(slow.regression);
+    EXPECT_NEAR(slow.relativeChange, 0.1, 1e-9);
+    EXPECT_LT(slow.pValue, 1e-6);
+
+    RegressionCheck fast = compareSamples("fast", baseline, faster);
+    EXPECT_FALSE(fast.regression);
+    EXPECT_TRUE(fast.improvement);
+
+    // Significant but below the noise floor is not reported
+    std::vector<double> slightly = {101.0, 102.0, 100.0, 101.5, 100.5};
+    EXPECT_FALSE(compareSamples("slightly", baseline, slightly).regression);
+}
+
+TEST_F(BenchmarkBaselineTest, SaveLoadRoundTrip) {
+    MachineFingerprint fingerprint = MachineFingerprint::current();
+    EXPECT_EQ(fingerprint.key.size(), 12u);
+    EXPECT_EQ(fingerprint.key, MachineFingerprint::current().key);
+
+    BenchmarkBaseline baseline;
+    baseline.suite = "cpu";
+    baseline.fingerprint = fingerprint;
+    baseline.samples["simple.wall_ms"] = {70.125, 70.5, 69.875};
+    baseline.samples["torus_heavy.wall_ms"] = {1234.5};
+    ASSERT_TRUE(baseline.save(path_));
+
+    BenchmarkBaseline loaded;
+    ASSERT_TRUE(BenchmarkBaseline::load(path_, loaded));
+    EXPECT_EQ(loaded.suite, "cpu");
+    EXPECT_EQ(loaded.fingerprint.key, fingerprint.key);
+    EXPECT_EQ(loaded.fingerprint.description(), fingerprint.description());
+    EXPECT_FALSE(loaded.created.empty());
+    EXPECT_EQ(loaded.samples, baseline.samples);
+
+    std::map<std::string, std::vector<double>> current;
+    current["simple.wall_ms"] = {90.0, 91.0, 90.5};
+    current["new_scenario.wall_ms"] = {1.0};
+    auto checks = loaded.compare(current);
+    ASSERT_EQ(checks.size(), 1u);
+    EXPECT_EQ(checks[0].name, "simple.wall_ms");
+    EXPECT_TRUE(checks[0].regression);
+
+    EXPECT_FALSE(BenchmarkBaseline::load(path_ + ".missing", loaded));
+}
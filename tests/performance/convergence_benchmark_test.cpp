@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include "performance/convergence_benchmark.h"
+
+class ConvergenceBenchmarkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ConvergenceBenchmark::Configuration config;
+        config.resolutionScale = 0.1;
+        config.referenceSamples = 64;
+        config.maxSamples = 4;
+        config.threadCount = 2;
+        config.referenceDir = testing::TempDir();
+        benchmark_.setConfiguration(config);
+        scenario_ = CPUBenchmarkSuite::standardScenarios().front();
+    }
+
+    ConvergenceBenchmark benchmark_;
+    CPUBenchmarkSuite::Scenario scenario_;
+};
+
+TEST_F(ConvergenceBenchmarkTest, ErrorMetricsOfKnownImages) {
+    const int width = 40;
+    const int height = 24;
+    std::vector<Color> reference(width * height, Color(0.5f, 0.5f, 0.5f));
+
+    auto same = ConvergenceBenchmark::measureError(reference, reference, width, height, 3);
+    EXPECT_DOUBLE_EQ(same.rmse, 0.0);
+    EXPECT_DOUBLE_EQ(same.relMSE, 0.0);
+    EXPECT_NEAR(same.ssim, 1.0, 1e-9);
+
+    // Display 0.6 vs 0.5 is linear 0.36 vs 0.25 in every channel
+    std::vector<Color> brighter(width * height, Color(0.6f, 0.6f, 0.6f));
+    auto error = ConvergenceBenchmark::measureError(brighter, reference, width, height, 3);
+    EXPECT_NEAR(error.rmse, 0.11, 1e-5);
+    EXPECT_NEAR(error.relMSE, 0.0121 / (0.0625 + 0.01), 1e-5);
+    EXPECT_LT(error.ssim, 1.0);
+
+    // Thread count must not change the result
+    auto single = ConvergenceBenchmark::measureError(brighter, reference, width, height, 1);
+    EXPECT_DOUBLE_EQ(single.rmse, error.rmse);
+    EXPECT_DOUBLE_EQ(single.ssim, error.ssim);
+}
+
+TEST_F(ConvergenceBenchmarkTest, TimeToErrorInterpolatesLogLog) {
+    ConvergenceBenchmark::Curve curve;
+    for (int i = 0; i < 3; ++i) {
+        ConvergenceBenchmark::CurvePoint point;
+        point.seconds = std::pow(10.0, i);        // 1, 10, 100 s
+        point.error.rmse = std::pow(10.0, -i);    // 1, 0.1, 0.01
+        curve.points.push_back(point);
+    }
+    using Metric = ConvergenceBenchmark::ErrorMetric;
+    EXPECT_DOUBLE_EQ(curve.timeToError(2.0, Metric::RMSE), 1.0);
+    EXPECT_NEAR(curve.timeToError(0.1, Metric::RMSE), 10.0, 1e-9);
+    EXPECT_NEAR(curve.timeToError(std::sqrt(0.1) * 0.1, Metric::RMSE), std::sqrt(10.0) * 10.0, 1e-6);
+    EXPECT_LT(curve.timeToError(0.001, Metric::RMSE), 0.0);
+}
+
+TEST_F(ConvergenceBenchmarkTest, ReferenceIsCachedAndPathConverges) {
+    int width = 0;
+    int height = 0;
+    std::vector<Color> reference = benchmark_.reference(scenario_, width, height);
+    ASSERT_EQ(reference.size(), static_cast<size_t>(width) * height);
+    const std::string path = benchmark_.referencePath(scenario_, width, height);
+
+    int cached_width = 0;
+    int cached_height = 0;
+    std::vector<Color> cached = benchmark_.reference(scenario_, cached_width, cached_height);
+    ASSERT_EQ(cached.size(), reference.size());
+    EXPECT_FLOAT_EQ(cached[width + 3].g, reference[width + 3].g);
+
+    auto curve = benchmark_.runTechnique(scenario_, ConvergenceBenchmark::Technique::PATH, reference, width, height);
+    ASSERT_EQ(curve.points.size(), 3u);   // 1, 2 and 4 spp
+    EXPECT_EQ(curve.points.back().samplesPerPixel, 4);
+    EXPECT_LT(curve.points.back().error.rmse, curve.points.front().error.rmse);
+    EXPECT_GT(curve.points.back().error.ssim, curve.points.front().error.ssim);
+
+    std::ostringstream csv;
+    benchmark_.writeCSV(csv, {curve});
+    EXPECT_NE(csv.str().find("simple,path,"), std::string::npos);
+    std::remove(path.c_str());
+}
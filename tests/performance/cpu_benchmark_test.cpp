@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "performance/cpu_benchmark.h"
+
+class CPUBenchmarkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        CPUBenchmarkSuite::Configuration config;
+        config.warmupIterations = 0;
+        config.iterations = 2;
+        config.threadCount = 2;
+        config.resolutionScale = 0.1;
+        config.enableHardwareCounters = false;
+        suite_.setConfiguration(config);
+    }
+
+    CPUBenchmarkSuite suite_;
+};
+
+TEST_F(CPUBenchmarkTest, StandardScenariosCoverRequiredScenes) {
+    std::vector<std::string> names;
+    for (const auto& scenario : CPUBenchmarkSuite::standardScenarios()) {
+        names.push_back(scenario.name);
+        EXPECT_TRUE(static_cast<bool>(scenario.buildScene));
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"simple", "metal_heavy", "torus_heavy",
+                                               "many_primitives", "high_resolution"}));
+}
+
+TEST_F(CPUBenchmarkTest, ScenarioReportsThroughput) {
+    std::vector<CPUBenchmarkSuite::Result> results = suite_.runScenarios({"many_primitives"});
+    ASSERT_EQ(results.size(), 1u);
+    const auto& result = results[0];
+    EXPECT_EQ(result.imageWidth, 32);
+    EXPECT_EQ(result.imageHeight, 24);
+    EXPECT_GT(result.primitiveCount, 200);
+    EXPECT_EQ(result.iterations, 2);
+    EXPECT_GT(result.rays, 0u);
+    EXPECT_GT(result.mraysPerSecond, 0.0);
+    EXPECT_GT(result.samplesPerSecond, 0.0);
+    EXPECT_LE(result.minWallTimeMs, result.wallTimeMs);
+    EXPECT_GE(result.maxWallTimeMs, result.wallTimeMs);
+    EXPECT_GT(result.peakMemoryMB, 0.0);
+}
+
+TEST_F(CPUBenchmarkTest, FixedSeedGivesIdenticalImages) {
+    auto scenario = CPUBenchmarkSuite::standardScenarios()[1];
+    auto first = suite_.runScenario(scenario);
+    auto second = suite_.runScenario(scenario);
+    EXPECT_EQ(first.imageChecksum, second.imageChecksum);
+    EXPECT_EQ(first.rays, second.rays);
+
+    scenario.seed += 1;
+    EXPECT_NE(suite_.runScenario(scenario).imageChecksum, first.imageChecksum);
+}
+
+TEST_F(CPUBenchmarkTest, JsonListsEveryResult) {
+    std::vector<CPUBenchmarkSuite::Result> results = suite_.runScenarios({"simple", "torus_heavy"});
+    std::ostringstream json;
+    suite_.writeJSON(json, results);
+    const std::string text = json.str();
+    EXPECT_EQ(text.find("{\n  \"suite\": \"cpu\""), 0u);
+    EXPECT_NE(text.find("\"scenario\": \"simple\""), std::string::npos);
+    EXPECT_NE(text.find("\"scenario\": \"torus_heavy\""), std::string::npos);
+    EXPECT_NE(text.find("\"mrays_per_second\": "), std::string::npos);
+    EXPECT_NE(text.find("\"peak_memory_mb\": "), std::string::npos);
+    EXPECT_EQ(text.substr(text.size() - 4), "]\n}\n");
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include "performance/hw_counters.h"
+#include "core/ray_stats.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+
+class HwCountersTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hw_stage_stats_reset();
+    }
+
+    void TearDown() override {
+        hw_counters_set_enabled(false);
+        hw_stage_stats_reset();
+    }
+
+    static HwCounterValues make_values(uint64_t cycles, uint64_t instructions, uint64_t cache_misses) {
+        HwCounterValues values;
+        values.values[static_cast<int>(HwCounter::CYCLES)] = cycles;
+        values.values[static_cast<int>(HwCounter::INSTRUCTIONS)] = instructions;
+        values.values[static_cast<int>(HwCounter::CACHE_MISSES)] = cache_misses;
+        values.available = (1u << static_cast<int>(HwCounter::CYCLES)) |
+                           (1u << static_cast<int>(HwCounter::INSTRUCTIONS)) |
+                           (1u << static_cast<int>(HwCounter::CACHE_MISSES));
+        return values;
+    }
+};
+
+TEST_F(HwCountersTest, DerivedRatios) {
+    HwCounterValues values = make_values(1000, 2500, 40);
+    EXPECT_DOUBLE_EQ(values.ipc(), 2.5);
+    EXPECT_DOUBLE_EQ(values.per_ray(HwCounter::CACHE_MISSES, 20), 2.0);
+    EXPECT_DOUBLE_EQ(values.per_ray(HwCounter::CACHE_MISSES, 0), 0.0);
+    // Branch misses were not counted
+    EXPECT_FALSE(values.has(HwCounter::BRANCH_MISSES));
+    EXPECT_DOUBLE_EQ(values.per_ray(HwCounter::BRANCH_MISSES, 20), 0.0);
+    EXPECT_DOUBLE_EQ(HwCounterValues().ipc(), 0.0);
+}
+
+TEST_F(HwCountersTest, DeltaClampsAndSumsMerge) {
+    HwCounterValues start = make_values(100, 300, 10);
+    HwCounterValues end = make_values(400, 900, 5);
+    HwCounterValues delta = end - start;
+    EXPECT_EQ(delta[HwCounter::CYCLES], 300u);
+    EXPECT_EQ(delta[HwCounter::INSTRUCTIONS], 600u);
+    EXPECT_EQ(delta[HwCounter::CACHE_MISSES], 0u);
+
+    delta += start;
+    EXPECT_EQ(delta[HwCounter::CYCLES], 400u);
+    EXPECT_TRUE(delta.has(HwCounter::INSTRUCTIONS));
+}
+
+TEST_F(HwCountersTest, UnsupportedIsCleanNoOp) {
+    EXPECT_FALSE(hw_counters_status().empty());
+    hw_counters_set_enabled(true);
+    EXPECT_EQ(hw_counters_enabled(), hw_counters_supported());
+    {
+        HwStageScope scope("no-op");
+    }
+    if (!hw_counters_supported()) {
+        EXPECT_TRUE(hw_stage_stats().empty());
+        std::ostringstream report;
+        hw_counters_report(report);
+        EXPECT_NE(report.str().find(hw_counters_status()), std::string::npos);
+    }
+}
+
+TEST_F(HwCountersTest, RenderStagesAreSampledPerThread) {
+    if (!hw_counters_supported()) {
+        GTEST_SKIP() << hw_counters_status();
+    }
+    hw_counters_set_enabled(true);
+
+    auto scene_manager = std::make_shared<SceneManager>();
+    scene_manager->initialize();
+    PathTracer path_tracer;
+    path_tracer.set_scene_manager(scene_manager);
+    path_tracer.set_camera(*scene_manager->get_camera());
+    path_tracer.set_max_depth(2);
+    path_tracer.set_samples_per_pixel(1);
+    path_tracer.set_thread_count(2);
+    ASSERT_TRUE(path_tracer.trace_preview(64, 48));
+
+    HwCounterValues shading = hw_stage_total("preview shading");
+    EXPECT_GT(shading[HwCounter::CYCLES], 0u);
+    EXPECT_GT(shading.ipc(), 0.0);
+    EXPECT_EQ(hw_stage_total("tonemap").available & 1u, 1u);
+
+    // Each stage counts only the rays it traced itself
+    uint64_t stage_rays = hw_stage_rays("preview primary hits") + hw_stage_rays("preview spatial reuse") +
+                          hw_stage_rays("preview shading");
+    EXPECT_GT(hw_stage_rays("preview shading"), 0u);
+    EXPECT_EQ(hw_stage_rays("tonemap"), 0u);
+    EXPECT_EQ(stage_rays, path_tracer.get_frame_stats().rays.rays());
+
+    std::ostringstream report;
+    hw_counters_report(report);
+    EXPECT_NE(report.str().find("preview shading"), std::string::npos);
+}
+
+TEST_F(HwCountersTest, ScopesMergeWhenTheirThreadFlushes) {
+    if (!hw_counters_supported()) {
+        GTEST_SKIP() << hw_counters_status();
+    }
+    hw_counters_set_enabled(true);
+
+    std::thread worker([]() {
+        for (int i = 0; i < 3; ++i) {
+            HwStageScope scope("merge", 1);
+        }
+        thread_ray_stats().add(RayCounter::PRIMARY_RAYS, 5);  // Outside any scope
+    });
+    worker.join();
+
+    // Thread exit flushed the pending totals in one merge
+    std::vector<HwStageStats> stats = hw_stage_stats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].stage, "merge");
+    EXPECT_EQ(stats[0].thread_index, 1);
+    EXPECT_EQ(stats[0].calls, 3u);
+    EXPECT_EQ(stats[0].rays, 0u);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "performance/intersection_benchmark.h"
+#include "core/primitives.h"
+#include "core/scene_manager.h"
+
+class IntersectionBenchmarkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        IntersectionBenchmark::Configuration config;
+        config.raysPerBatch = 256;
+        config.warmupRepetitions = 0;
+        config.repetitions = 3;
+        config.minRepetitionMs = 0.0;
+        config.sceneSizes = {4, 16};
+        benchmark_.setConfiguration(config);
+    }
+
+    IntersectionBenchmark benchmark_;
+};
+
+TEST_F(IntersectionBenchmarkTest, BatchesHitOrMissAsLabelled) {
+    Sphere sphere(Vector3(0, 0, 0), 0.5f);
+    Cube cube(Vector3(1, 2, 3), 1.0f);
+    for (const Primitive* primitive : {static_cast<const Primitive*>(&sphere), static_cast<const Primitive*>(&cube)}) {
+        auto coherent_hit = benchmark_.benchmarkPrimitive("p", *primitive, IntersectionBenchmark::RayBatchKind::COHERENT_HIT);
+        auto incoherent_hit = benchmark_.benchmarkPrimitive("p", *primitive, IntersectionBenchmark::RayBatchKind::INCOHERENT_HIT);
+        auto coherent_miss = benchmark_.benchmarkPrimitive("p", *primitive, IntersectionBenchmark::RayBatchKind::COHERENT_MISS);
+        auto incoherent_miss = benchmark_.benchmarkPrimitive("p", *primitive, IntersectionBenchmark::RayBatchKind::INCOHERENT_MISS);
+        EXPECT_DOUBLE_EQ(coherent_hit.hitRate, 1.0);
+        EXPECT_DOUBLE_EQ(incoherent_hit.hitRate, 1.0);
+        EXPECT_DOUBLE_EQ(coherent_miss.hitRate, 0.0);
+        EXPECT_DOUBLE_EQ(incoherent_miss.hitRate, 0.0);
+        EXPECT_EQ(coherent_miss.raysPerBatch, 256);
+    }
+}
+
+TEST_F(IntersectionBenchmarkTest, RayBatchesAreDeterministic) {
+    AABB bounds(Vector3(-1, -1, -1), Vector3(1, 1, 1));
+    auto first = IntersectionBenchmark::generateRays(bounds, IntersectionBenchmark::RayBatchKind::INCOHERENT_MISS, 64, 7);
+    auto second = IntersectionBenchmark::generateRays(bounds, IntersectionBenchmark::RayBatchKind::INCOHERENT_MISS, 64, 7);
+    ASSERT_EQ(first.size(), 64u);
+    for (size_t i = 0; i < first.size(); ++i) {
+        EXPECT_FLOAT_EQ(first[i].origin.x, second[i].origin.x);
+        EXPECT_FLOAT_EQ(first[i].direction.z, second[i].direction.z);
+    }
+}
+
+TEST_F(IntersectionBenchmarkTest, RunAllCoversKernelsAndSceneSizes) {
+    auto results = benchmark_.runAll();
+    ASSERT_EQ(results.size(), 4u * 4u + 2u * 4u);
+    EXPECT_EQ(results.front().kernel, "sphere");
+    EXPECT_EQ(results.back().kernel, "hit_scene");
+    EXPECT_EQ(results.back().primitiveCount, 16);
+    for (const auto& result : results) {
+        EXPECT_GT(result.nsPerRay, 0.0);
+        EXPECT_GE(result.nsPerRay, result.nsPerRayMin);
+        EXPECT_EQ(result.repetitions, 3);
+    }
+
+    std::ostringstream json;
+    benchmark_.writeJSON(json, results);
+    EXPECT_NE(json.str().find("\"kernel\": \"torus\", \"batch\": \"incoherent_miss\""), std::string::npos);
+}
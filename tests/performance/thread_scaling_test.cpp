@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "performance/thread_scaling.h"
+
+class ThreadScalingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ThreadScalingBenchmark::Configuration config;
+        config.threadCounts = {1, 2, 4};
+        config.warmupIterations = 0;
+        config.iterations = 1;
+        config.resolutionScale = 0.2;
+        benchmark_.setConfiguration(config);
+        scenario_ = CPUBenchmarkSuite::standardScenarios().front();
+    }
+
+    ThreadScalingBenchmark benchmark_;
+    CPUBenchmarkSuite::Scenario scenario_;
+};
+
+TEST_F(ThreadScalingTest, DefaultThreadCountsArePowersOfTwoPlusMax) {
+    ThreadScalingBenchmark::Configuration config;
+    config.maxThreads = 6;
+    ThreadScalingBenchmark benchmark;
+    benchmark.setConfiguration(config);
+    EXPECT_EQ(benchmark.threadCounts(), (std::vector<int>{1, 2, 4, 6}));
+}
+
+TEST_F(ThreadScalingTest, StrongScalingKeepsImageAndReportsWorkers) {
+    auto points = benchmark_.runScenario(scenario_, ThreadScalingBenchmark::Mode::STRONG);
+    ASSERT_EQ(points.size(), 3u);
+    EXPECT_DOUBLE_EQ(points[0].speedup, 1.0);
+    EXPECT_DOUBLE_EQ(points[0].efficiency, 1.0);
+    for (const auto& point : points) {
+        EXPECT_EQ(point.imageWidth, points[0].imageWidth);
+        // Per-tile seeding makes the image independent of the thread count
+        EXPECT_EQ(point.imageChecksum, points[0].imageChecksum);
+        ASSERT_EQ(point.threadBusyMs.size(), static_cast<size_t>(point.threads));
+        EXPECT_GT(point.meanBusyMs, 0.0);
+        EXPECT_GE(point.tileImbalance, 1.0);
+        EXPECT_NEAR(point.efficiency, point.speedup / point.threads, 1e-9);
+    }
+}
+
+TEST_F(ThreadScalingTest, WeakScalingGrowsPixelsWithThreads) {
+    auto points = benchmark_.runScenario(scenario_, ThreadScalingBenchmark::Mode::WEAK);
+    ASSERT_EQ(points.size(), 3u);
+    double base_pixels = double(points[0].imageWidth) * points[0].imageHeight;
+    double quad_pixels = double(points[2].imageWidth) * points[2].imageHeight;
+    EXPECT_NEAR(quad_pixels / base_pixels, 4.0, 0.1);
+    EXPECT_EQ(points[2].mode, "weak");
+
+    std::ostringstream csv;
+    benchmark_.writeCSV(csv, points);
+    EXPECT_EQ(csv.str().find("scenario,mode,threads"), 0u);
+    EXPECT_NE(csv.str().find("simple,weak,4,"), std::string::npos);
+}
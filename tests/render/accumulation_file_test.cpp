@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "render/accumulation_file.h"
+#include "render/path_tracer.h"
+#include "render/image_output.h"
+#include "core/scene_manager.h"
+
+class AccumulationFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        directory_ = testing::TempDir();
+    }
+
+    void TearDown() override {
+        for (const std::string& file : files_) {
+            std::remove(file.c_str());
+        }
+    }
+
+    std::string temp_file(const std::string& name) {
+        files_.push_back(directory_ + "accumulation_file_test_" + name);
+        return files_.back();
+    }
+
+    // Renders one job of the distributed render into a file
+    std::string render_range(uint32_t first, uint32_t count, int threads, const std::string& name) {
+        PathTracer tracer;
+        tracer.set_scene_manager(scene_manager_);
+        tracer.set_camera(*scene_manager_->get_camera());
+        tracer.set_max_depth(3);
+        tracer.set_thread_count(threads);
+        tracer.set_random_seed(77);
+        AccumulationFile file;
+        EXPECT_TRUE(tracer.trace_sample_range(WIDTH, HEIGHT, first, count, true, file));
+        const std::string filename = temp_file(name);
+        EXPECT_TRUE(file.save(filename));
+        return filename;
+    }
+
+    static constexpr int WIDTH = 36;
+    static constexpr int HEIGHT = 20;
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::string directory_;
+    std::vector<std::string> files_;
+};
+
+TEST_F(AccumulationFileTest, SaveLoadRoundTrip) {
+    AccumulationFile file;
+    file.header.width = 3;
+    file.header.height = 2;
+    file.header.max_depth = 5;
+    file.header.seed = 9;
+    file.header.camera_fov = 40.0f;
+    file.header.has_variance = true;
+    file.header.ranges = {SampleRange{4, 6}};
+    for (int i = 0; i < 6; ++i) {
+        file.sums.push_back(Color(float(i), 2.0f, 0.5f * i));
+        file.sample_counts.push_back(6);
+        file.luminance_sum.push_back(0.1f * i);
+        file.luminance_sq_sum.push_back(0.01f * i);
+    }
+    const std::string filename = temp_file("roundtrip.accum");
+    ASSERT_TRUE(file.save(filename));
+
+    AccumulationFile loaded;
+    ASSERT_TRUE(AccumulationFile::load(filename, loaded));
+    EXPECT_TRUE(loaded.header.same_render(file.header));
+    ASSERT_EQ(loaded.header.ranges.size(), 1u);
+    EXPECT_EQ(loaded.header.ranges[0].end(), 10u);
+    EXPECT_EQ(loaded.sample_counts, file.sample_counts);
+    EXPECT_FLOAT_EQ(loaded.sums[5].b, 2.5f);
+    EXPECT_FLOAT_EQ(loaded.luminance_sq_sum[3], 0.03f);
+
+    // Truncation is detected
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 4);
+    EXPECT_FALSE(AccumulationFile::load(filename, loaded));
+}
+
+TEST_F(AccumulationFileTest, MergedRangesMatchSingleRender) {
+    const std::string whole = render_range(0, 7, 2, "whole.accum");
+    std::vector<std::string> jobs = {
+        render_range(4, 3, 1, "job_c.accum"),
+        render_range(0, 2, 3, "job_a.accum"),
+        render_range(2, 2, 2, "job_b.accum"),
+    };
+
+    AccumulationMergeOptions options;
+    options.threads = 3;
+    options.band_rows = 3;
+    options.output = temp_file("merged.accum");
+    options.image = temp_file("merged.pfm");
+    AccumulationHeader merged;
+    ASSERT_TRUE(merge_accumulation_files(jobs, options, &merged));
+    ASSERT_EQ(merged.ranges.size(), 1u);
+    EXPECT_EQ(merged.ranges[0].first, 0u);
+    EXPECT_EQ(merged.ranges[0].count, 7u);
+    EXPECT_TRUE(merged.has_variance);
+
+    AccumulationFile expected;
+    AccumulationFile actual;
+    ASSERT_TRUE(AccumulationFile::load(whole, expected));
+    ASSERT_TRUE(AccumulationFile::load(options.output, actual));
+    EXPECT_TRUE(actual.header.same_render(expected.header));
+    EXPECT_EQ(actual.sample_counts, expected.sample_counts);
+    int width = 0;
+    int height = 0;
+    std::vector<float> rgb;
+    ASSERT_TRUE(ImageOutput::read_pfm(options.image, width, height, rgb));
+    ASSERT_EQ(width, WIDTH);
+    ASSERT_EQ(height, HEIGHT);
+
+    // Same samples; only the order of the additions differs
+    for (size_t i = 0; i < expected.sums.size(); ++i) {
+        const float tolerance = 1e-4f * (1.0f + expected.sums[i].g);
+        ASSERT_NEAR(actual.sums[i].r, expected.sums[i].r, tolerance) << "pixel " << i;
+        ASSERT_NEAR(actual.sums[i].g, expected.sums[i].g, tolerance) << "pixel " << i;
+        ASSERT_NEAR(actual.sums[i].b, expected.sums[i].b, tolerance) << "pixel " << i;
+        ASSERT_NEAR(actual.luminance_sum[i], expected.luminance_sum[i], 1e-4f * (1.0f + expected.luminance_sum[i]));
+        ASSERT_NEAR(rgb[3 * i + 1], expected.sums[i].g / 7.0f, tolerance) << "pixel " << i;
+    }
+}
+
+TEST_F(AccumulationFileTest, AccumulatedPassesMatchSampleRange) {
+    PathTracer tracer;
+    tracer.set_scene_manager(scene_manager_);
+    tracer.set_camera(*scene_manager_->get_camera());
+    tracer.set_max_depth(3);
+    tracer.set_thread_count(2);
+    tracer.set_random_seed(77);
+    AccumulationFile whole;
+    ASSERT_TRUE(tracer.trace_sample_range(WIDTH, HEIGHT, 0, 5, false, whole));
+
+    // Passes added a few at a time continue the same sample sequence
+    ASSERT_TRUE(tracer.accumulate_passes(WIDTH, HEIGHT, 2, true));
+    ASSERT_TRUE(tracer.accumulate_passes(WIDTH, HEIGHT, 1));
+    ASSERT_TRUE(tracer.accumulate_passes(WIDTH, HEIGHT, 2));
+    EXPECT_EQ(tracer.get_accumulated_passes(), 5u);
+    const std::vector<Color>& sums = tracer.get_image_data();
+    ASSERT_EQ(sums.size(), whole.sums.size());
+    for (size_t i = 0; i < sums.size(); ++i) {
+        ASSERT_EQ(sums[i].r, whole.sums[i].r) << "pixel " << i;
+        ASSERT_EQ(sums[i].g, whole.sums[i].g) << "pixel " << i;
+        ASSERT_EQ(sums[i].b, whole.sums[i].b) << "pixel " << i;
+    }
+}
+
+TEST_F(AccumulationFileTest, RejectsOverlappingAndMismatchedInputs) {
+    std::vector<std::string> overlapping = {
+        render_range(0, 3, 2, "first.accum"),
+        render_range(2, 2, 2, "second.accum"),
+    };
+    AccumulationMergeOptions options;
+    options.image = temp_file("rejected.pfm");
+    std::string error;
+    EXPECT_FALSE(merge_accumulation_files(overlapping, options, nullptr, &error));
+    EXPECT_NE(error.find("overlap"), std::string::npos);
+    EXPECT_FALSE(std::ifstream(options.image).good());
+
+    // A scene edit between jobs makes their samples incompatible
+    const std::string before = render_range(0, 1, 2, "before.accum");
+    scene_manager_->add_light(Vector3(0, 4, 0), Color(1, 1, 1), 2.0f);
+    const std::string after = render_range(1, 1, 2, "after.accum");
+    EXPECT_FALSE(merge_accumulation_files({before, after}, options, nullptr, &error));
+    EXPECT_NE(error.find("different render"), std::string::npos);
+}
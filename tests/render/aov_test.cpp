@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include "render/aov.h"
+#include "render/image_output.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+
+class AOVTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+
+        path_tracer_ = std::make_unique<PathTracer>();
+        path_tracer_->set_scene_manager(scene_manager_);
+        path_tracer_->set_camera(*scene_manager_->get_camera());
+        path_tracer_->set_max_depth(2);
+        path_tracer_->set_samples_per_pixel(2);
+    }
+
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::unique_ptr<PathTracer> path_tracer_;
+};
+
+TEST_F(AOVTest, OnlyRequestedBuffersAreAllocated) {
+    AOVBuffers aovs;
+    aovs.allocate(aov_bit(AOVType::DEPTH) | aov_bit(AOVType::SAMPLE_COUNT), 8, 4);
+
+    EXPECT_EQ(aovs.depth.size(), 32u);
+    EXPECT_EQ(aovs.sample_count.size(), 32u);
+    EXPECT_TRUE(aovs.normal.empty());
+    EXPECT_TRUE(aovs.albedo.empty());
+    EXPECT_TRUE(aovs.primitive_id.empty());
+
+    aovs.allocate(AOV_NONE, 8, 4);
+    EXPECT_TRUE(aovs.depth.empty());
+    EXPECT_EQ(aovs.depth.capacity(), 0u);
+}
+
+TEST_F(AOVTest, NoAOVsByDefault) {
+    path_tracer_->trace(16, 12);
+    EXPECT_EQ(path_tracer_->get_aovs().mask, AOV_NONE);
+}
+
+TEST_F(AOVTest, MaterialIdMatchesForEqualMaterials) {
+    Material a(Color(0.5f, 0.5f, 0.5f), 1.0f, 0.0f, 0.0f);
+    Material b(Color(0.5f, 0.5f, 0.5f), 1.0f, 0.0f, 0.0f);
+    Material c(Color(0.5f, 0.5f, 0.5f), 0.2f, 0.0f, 0.0f);
+
+    EXPECT_EQ(AOVBuffers::material_id_for(a), AOVBuffers::material_id_for(b));
+    EXPECT_NE(AOVBuffers::material_id_for(a), AOVBuffers::material_id_for(c));
+    EXPECT_NE(AOVBuffers::material_id_for(a), 0u);
+    EXPECT_LE(AOVBuffers::material_id_for(a), 0xFFFFFFu);
+}
+
+TEST_F(AOVTest, FirstHitAOVsFromRender) {
+    path_tracer_->set_aovs(AOV_ALL);
+    const int width = 32, height = 24;
+    path_tracer_->trace(width, height);
+
+    const AOVBuffers& aovs = path_tracer_->get_aovs();
+    ASSERT_TRUE(aovs.matches(width, height));
+    ASSERT_TRUE(aovs.has_all(AOV_ALL));
+
+    // The centre pixel sees the centre sphere of the default scene
+    size_t centre = static_cast<size_t>(height / 2) * width + width / 2;
+    EXPECT_GT(aovs.depth[centre], 0.0f);
+    EXPECT_NEAR(aovs.normal[centre].length(), 1.0f, 1e-3f);
+    EXPECT_NE(aovs.primitive_id[centre], INVALID_PRIMITIVE_ID);
+    EXPECT_NE(aovs.material_id[centre], 0u);
+    EXPECT_EQ(scene_manager_->getPrimitive(aovs.primitive_id[centre])->material().albedo.r,
+              aovs.albedo[centre].r);
+
+    std::set<uint32_t> ids(aovs.primitive_id.begin(), aovs.primitive_id.end());
+    EXPECT_GT(ids.size(), 2u);
+    for (uint32_t count : aovs.sample_count) {
+        EXPECT_EQ(count, 2u);
+    }
+}
+
+TEST_F(AOVTest, ClearedObjectIdsAreRejected) {
+    scene_manager_->add_light(Vector3(0, 2, 0), Color(1, 1, 1), 3.0f);
+    const int count = static_cast<int>(scene_manager_->get_objects().size());
+    const PrimitiveID object_id = scene_manager_->get_object_id(0);
+    const PrimitiveID light_id = scene_manager_->get_object_id(count - 1);
+    ASSERT_NE(object_id, INVALID_PRIMITIVE_ID);
+    ASSERT_NE(light_id, INVALID_PRIMITIVE_ID);
+
+    // Clearing the lights also takes their spheres out of the scene
+    scene_manager_->clear_lights();
+    EXPECT_EQ(scene_manager_->getPrimitive(light_id), nullptr);
+    EXPECT_FALSE(scene_manager_->move_object(light_id, Vector3(1, 1, 1)));
+    EXPECT_EQ(static_cast<int>(scene_manager_->get_objects().size()), count - 2);
+
+    const uint64_t version = scene_manager_->get_scene_version();
+    scene_manager_->clear_objects();
+    EXPECT_EQ(scene_manager_->getPrimitive(object_id), nullptr);
+    EXPECT_FALSE(scene_manager_->set_object_material(object_id, Material(Color(1, 0, 0))));
+    EXPECT_FALSE(scene_manager_->move_object(object_id, Vector3(0, 0, 0)));
+    // Only the clear itself was recorded
+    EXPECT_EQ(scene_manager_->get_scene_version(), version + 1);
+}
+
+TEST_F(AOVTest, SavesAOVAsPFM) {
+    path_tracer_->set_aovs(aov_bit(AOVType::NORMAL));
+    path_tracer_->trace(8, 6);
+
+    const std::string filename = "aov_test_normal.pfm";
+    ASSERT_TRUE(ImageOutput::save_aov(filename, path_tracer_->get_aovs(), AOVType::NORMAL));
+    EXPECT_FALSE(ImageOutput::save_aov("aov_test_depth.pfm", path_tracer_->get_aovs(), AOVType::DEPTH));
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    ASSERT_TRUE(file.is_open());
+    std::string header = "PF\n8 6\n-1.0\n";
+    EXPECT_EQ(static_cast<size_t>(file.tellg()), header.size() + 8 * 6 * 3 * sizeof(float));
+    file.close();
+    std::remove(filename.c_str());
+}
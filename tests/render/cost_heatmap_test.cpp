@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include "render/cost_heatmap.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+
+class CostHeatmapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+
+        path_tracer_ = std::make_unique<PathTracer>();
+        path_tracer_->set_scene_manager(scene_manager_);
+        path_tracer_->set_camera(*scene_manager_->get_camera());
+        path_tracer_->set_max_depth(3);
+        path_tracer_->set_samples_per_pixel(2);
+    }
+
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::unique_ptr<PathTracer> path_tracer_;
+};
+
+TEST_F(CostHeatmapTest, AccumulatesPerPixel) {
+    CostHeatmap heatmap;
+    heatmap.allocate(4, 2);
+    heatmap.add(3, 100, 5, 1);
+    heatmap.add(3, 50, 2, 0);
+    heatmap.add(7, 10, 1, 2);
+
+    EXPECT_FLOAT_EQ(heatmap.value(HeatmapMetric::CYCLES, 3), 150.0f);
+    EXPECT_FLOAT_EQ(heatmap.value(HeatmapMetric::INTERSECTION_TESTS, 3), 7.0f);
+    EXPECT_DOUBLE_EQ(heatmap.total(HeatmapMetric::BOUNCES), 3.0);
+    EXPECT_FLOAT_EQ(heatmap.value(HeatmapMetric::CYCLES, 0), 0.0f);
+}
+
+TEST_F(CostHeatmapTest, FalseColorSpansColormap) {
+    CostHeatmap heatmap;
+    heatmap.allocate(10, 10);
+    for (int i = 0; i < 100; ++i) {
+        heatmap.add(i, 0, static_cast<uint64_t>(i), 0);
+    }
+
+    std::vector<Color> image = heatmap.false_color(HeatmapMetric::INTERSECTION_TESTS);
+    ASSERT_EQ(image.size(), 100u);
+    // Cheapest pixel is dark blue, the 99th percentile and above saturate to red
+    EXPECT_GT(image[0].b, image[0].r);
+    EXPECT_GT(image[99].r, 0.9f);
+    EXPECT_LT(image[99].b, 0.1f);
+}
+
+TEST_F(CostHeatmapTest, ScopeCountsSceneIntersections) {
+    CostHeatmap heatmap;
+    heatmap.allocate(1, 1);
+    {
+        PixelCostScope scope(&heatmap, 0);
+        Ray ray(Vector3(0, 0, 5), Vector3(0, 0, -1));
+        HitRecord hit;
+        scene_manager_->hit_scene(ray, 0.001f, std::numeric_limits<float>::infinity(), hit);
+    }
+
+    EXPECT_FLOAT_EQ(heatmap.value(HeatmapMetric::INTERSECTION_TESTS, 0),
+                    static_cast<float>(scene_manager_->get_objects().size()));
+    EXPECT_GT(heatmap.value(HeatmapMetric::CYCLES, 0), 0.0f);
+}
+
+TEST_F(CostHeatmapTest, RenderRecordsCostWhenEnabled) {
+    const int width = 32, height = 24;
+    path_tracer_->trace(width, height);
+    EXPECT_TRUE(path_tracer_->get_cost_heatmap().empty());
+
+    path_tracer_->set_cost_heatmap(true);
+    path_tracer_->set_heatmap_metric(HeatmapMetric::BOUNCES);
+    path_tracer_->trace(width, height);
+
+    const CostHeatmap& heatmap = path_tracer_->get_cost_heatmap();
+    ASSERT_EQ(heatmap.width(), width);
+    ASSERT_EQ(heatmap.height(), height);
+
+    // Every primary ray is tested against the scene at least once
+    const float per_ray = static_cast<float>(scene_manager_->get_objects().size());
+    for (float tests : heatmap.values(HeatmapMetric::INTERSECTION_TESTS)) {
+        EXPECT_GE(tests, 2.0f * per_ray);
+    }
+    EXPECT_GT(heatmap.total(HeatmapMetric::BOUNCES), 0.0);
+    EXPECT_GT(heatmap.total(HeatmapMetric::CYCLES), 0.0);
+}
+
+TEST_F(CostHeatmapTest, SavesMetricAsPFM) {
+    path_tracer_->set_cost_heatmap(true);
+    path_tracer_->trace(8, 6);
+
+    const std::string filename = "cost_heatmap_test.pfm";
+    ASSERT_TRUE(path_tracer_->get_cost_heatmap().save(filename, HeatmapMetric::INTERSECTION_TESTS));
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    ASSERT_TRUE(file.is_open());
+    std::string header = "PF\n8 6\n-1.0\n";
+    EXPECT_EQ(static_cast<size_t>(file.tellg()), header.size() + 8 * 6 * 3 * sizeof(float));
+    file.close();
+    std::remove(filename.c_str());
+}
+
+TEST_F(CostHeatmapTest, LinearImageIgnoresOverlay) {
+    const int width = 32, height = 24;
+    path_tracer_->set_random_seed(3);
+    path_tracer_->trace(width, height);
+    const std::vector<Color> radiance = path_tracer_->get_linear_image();
+    ASSERT_EQ(radiance.size(), static_cast<size_t>(width * height));
+
+    // External viewers read radiance, never heatmap colours
+    path_tracer_->set_cost_heatmap(true);
+    path_tracer_->trace(width, height);
+    const std::vector<Color>& linear = path_tracer_->get_linear_image();
+    ASSERT_EQ(linear.size(), radiance.size());
+    for (size_t i = 0; i < linear.size(); ++i) {
+        ASSERT_EQ(linear[i].r, radiance[i].r) << "pixel " << i;
+        ASSERT_EQ(linear[i].g, radiance[i].g) << "pixel " << i;
+        ASSERT_EQ(linear[i].b, radiance[i].b) << "pixel " << i;
+    }
+}
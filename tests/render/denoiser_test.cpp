@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "render/denoiser.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+
+class DenoiserTest : public ::testing::Test {
+protected:
+    static constexpr int WIDTH = 64;
+    static constexpr int HEIGHT = 48;
+
+    void SetUp() override {
+        // Flat wall facing the camera at depth 5
+        features_.allocate(AOV_DENOISE_FEATURES, WIDTH, HEIGHT);
+        for (size_t i = 0; i < features_.depth.size(); ++i) {
+            features_.albedo[i] = Color(1, 1, 1);
+            features_.normal[i] = Vector3(0, 0, 1);
+            features_.depth[i] = 5.0f;
+        }
+    }
+
+    static float mean_error(const std::vector<Color>& a, const std::vector<Color>& b) {
+        float total = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i) {
+            total += std::abs(a[i].r - b[i].r) + std::abs(a[i].g - b[i].g) + std::abs(a[i].b - b[i].b);
+        }
+        return total / float(a.size());
+    }
+
+    AOVBuffers features_;
+};
+
+TEST_F(DenoiserTest, RejectsMismatchedBuffers) {
+    Denoiser denoiser;
+    std::vector<Color> color(10);
+    EXPECT_FALSE(denoiser.denoise(color, WIDTH, HEIGHT, features_));
+
+    color.assign(WIDTH * HEIGHT, Color(0.5f, 0.5f, 0.5f));
+    std::vector<float> variance(3, 0.0f);
+    EXPECT_FALSE(denoiser.denoise(color, WIDTH, HEIGHT, features_, variance));
+}
+
+TEST_F(DenoiserTest, RequiresFeatureAOVs) {
+    Denoiser denoiser;
+    AOVBuffers depth_only;
+    depth_only.allocate(aov_bit(AOVType::DEPTH), WIDTH, HEIGHT);
+    std::vector<Color> color(WIDTH * HEIGHT, Color(0.5f, 0.5f, 0.5f));
+    EXPECT_FALSE(denoiser.denoise(color, WIDTH, HEIGHT, depth_only));
+}
+
+TEST_F(DenoiserTest, ConstantImageIsUnchanged) {
+    Denoiser denoiser;
+    std::vector<Color> color(WIDTH * HEIGHT, Color(0.3f, 0.6f, 0.9f));
+    ASSERT_TRUE(denoiser.denoise(color, WIDTH, HEIGHT, features_));
+
+    for (const auto& pixel : color) {
+        EXPECT_NEAR(pixel.r, 0.3f, 1e-4f);
+        EXPECT_NEAR(pixel.g, 0.6f, 1e-4f);
+        EXPECT_NEAR(pixel.b, 0.9f, 1e-4f);
+    }
+}
+
+TEST_F(DenoiserTest, ReducesNoiseOnFlatSurface) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 0.15f);
+
+    std::vector<Color> truth(WIDTH * HEIGHT, Color(0.5f, 0.5f, 0.5f));
+    std::vector<Color> noisy(truth.size());
+    for (size_t i = 0; i < noisy.size(); ++i) {
+        float n = noise(rng);
+        noisy[i] = Color(0.5f + n, 0.5f + n, 0.5f + n);
+    }
+
+    std::vector<Color> filtered = noisy;
+    Denoiser denoiser;
+    ASSERT_TRUE(denoiser.denoise(filtered, WIDTH, HEIGHT, features_));
+
+    EXPECT_LT(mean_error(filtered, truth), 0.3f * mean_error(noisy, truth));
+}
+
+TEST_F(DenoiserTest, PreservesGeometricEdges) {
+    // Left half faces the camera, right half faces up and is brighter
+    std::vector<Color> color(WIDTH * HEIGHT);
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            int i = y * WIDTH + x;
+            bool right = x >= WIDTH / 2;
+            features_.normal[i] = right ? Vector3(0, 1, 0) : Vector3(0, 0, 1);
+            color[i] = right ? Color(1, 1, 1) : Color(0.1f, 0.1f, 0.1f);
+        }
+    }
+
+    Denoiser denoiser;
+    ASSERT_TRUE(denoiser.denoise(color, WIDTH, HEIGHT, features_));
+
+    int y = HEIGHT / 2;
+    EXPECT_NEAR(color[y * WIDTH + WIDTH / 2 - 1].r, 0.1f, 0.01f);
+    EXPECT_NEAR(color[y * WIDTH + WIDTH / 2].r, 1.0f, 0.01f);
+}
+
+TEST_F(DenoiserTest, AlbedoDemodulationKeepsTexture) {
+    // Uniform lighting on a checkerboard texture must come back unchanged
+    std::vector<Color> color(WIDTH * HEIGHT);
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            int i = y * WIDTH + x;
+            float albedo = ((x / 4 + y / 4) % 2) ? 0.9f : 0.2f;
+            features_.albedo[i] = Color(albedo, albedo, albedo);
+            color[i] = Color(albedo * 0.8f, albedo * 0.8f, albedo * 0.8f);
+        }
+    }
+    std::vector<Color> original = color;
+
+    Denoiser denoiser;
+    ASSERT_TRUE(denoiser.denoise(color, WIDTH, HEIGHT, features_));
+    EXPECT_LT(mean_error(color, original), 1e-3f);
+}
+
+TEST_F(DenoiserTest, LowSampleRenderMovesTowardsReference) {
+    auto scene_manager = std::make_shared<SceneManager>();
+    scene_manager->initialize();
+
+    PathTracer path_tracer;
+    path_tracer.set_scene_manager(scene_manager);
+    path_tracer.set_camera(*scene_manager->get_camera());
+    path_tracer.set_max_depth(4);
+
+    const int width = 32, height = 24;
+    path_tracer.set_samples_per_pixel(256);
+    path_tracer.trace(width, height);
+    std::vector<Color> reference = path_tracer.get_image_data();
+
+    path_tracer.set_samples_per_pixel(4);
+    path_tracer.trace(width, height);
+    std::vector<Color> raw = path_tracer.get_image_data();
+
+    path_tracer.set_denoising(true);
+    path_tracer.trace(width, height);
+    std::vector<Color> denoised = path_tracer.get_image_data();
+    ASSERT_TRUE(path_tracer.get_aovs().has_all(AOV_DENOISE_FEATURES));
+
+    EXPECT_LT(mean_error(denoised, reference), mean_error(raw, reference));
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "render/direct_light_resampler.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+
+class DirectLightResamplerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        
+        path_tracer_ = std::make_unique<PathTracer>();
+        path_tracer_->set_scene_manager(scene_manager_);
+        path_tracer_->set_camera(*scene_manager_->get_camera());
+        path_tracer_->set_max_depth(4);
+        path_tracer_->set_samples_per_pixel(1);
+    }
+    
+    // Mean absolute difference between two renders of the same frame
+    static float frame_difference(const std::vector<Color>& a, const std::vector<Color>& b) {
+        float total = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i) {
+            total += std::abs(a[i].r - b[i].r) + std::abs(a[i].g - b[i].g) + std::abs(a[i].b - b[i].b);
+        }
+        return total / float(a.size());
+    }
+    
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::unique_ptr<PathTracer> path_tracer_;
+};
+
+TEST_F(DirectLightResamplerTest, SingleCandidateReservoirWeight) {
+    Reservoir reservoir;
+    LightSample sample;
+    sample.light_index = 0;
+    
+    EXPECT_TRUE(reservoir.update(sample, 4.0f, 2.0f, 0.5f));
+    reservoir.finalize();
+    
+    EXPECT_FLOAT_EQ(reservoir.M, 1.0f);
+    EXPECT_FLOAT_EQ(reservoir.weight_sum, 4.0f);
+    // W = weight_sum / (M * p_hat)
+    EXPECT_FLOAT_EQ(reservoir.W, 2.0f);
+}
+
+TEST_F(DirectLightResamplerTest, ZeroWeightCandidateOnlyCountsTowardsM) {
+    Reservoir reservoir;
+    LightSample sample;
+    
+    EXPECT_FALSE(reservoir.update(sample, 0.0f, 0.0f, 0.1f));
+    reservoir.finalize();
+    
+    EXPECT_FLOAT_EQ(reservoir.M, 1.0f);
+    EXPECT_FLOAT_EQ(reservoir.W, 0.0f);
+}
+
+TEST_F(DirectLightResamplerTest, FindsDefaultSceneLight) {
+    DirectLightResampler resampler;
+    resampler.set_scene_manager(scene_manager_);
+    resampler.begin_frame(8, 8, *scene_manager_->get_camera());
+    
+    EXPECT_EQ(resampler.light_count(), 1u);
+    EXPECT_EQ(resampler.frame_index(), 1u);
+}
+
+TEST_F(DirectLightResamplerTest, BouncesStillSeeEmittersThatAreNotSampled) {
+    // Only spheres are sampled as lights; an emissive cube lights the preview through bounces alone
+    auto panel = std::make_shared<Cube>(Vector3(0, 0.6f, -0.5f), 0.3f, Color(1, 1, 1), Material(Color(1, 1, 1)));
+    scene_manager_->add_object(panel);
+    const int panel_index = static_cast<int>(scene_manager_->get_objects().size()) - 1;
+    auto mean_brightness = [&] {
+        const int width = 48, height = 32;
+        path_tracer_->set_random_seed(7);
+        EXPECT_TRUE(path_tracer_->trace_preview(width, height));
+        float total = 0.0f;
+        for (const auto& pixel : path_tracer_->get_image_data()) {
+            total += pixel.r + pixel.g + pixel.b;
+        }
+        return total / float(width * height);
+    };
+    const float unlit = mean_brightness();
+
+    ASSERT_TRUE(scene_manager_->set_object_material(scene_manager_->get_object_id(panel_index),
+                                                     Material(Color(1, 1, 1), 1.0f, 0.0f, 20.0f)));
+    DirectLightResampler resampler;
+    resampler.set_scene_manager(scene_manager_);
+    resampler.begin_frame(8, 8, *scene_manager_->get_camera());
+    EXPECT_EQ(resampler.light_count(), 1u);
+    EXPECT_FALSE(resampler.samples_object(panel_index));
+    EXPECT_TRUE(resampler.samples_object(panel_index - 1));
+
+    EXPECT_GT(mean_brightness(), unlit * 1.05f);
+}
+
+TEST_F(DirectLightResamplerTest, PreviewProducesFiniteImage) {
+    const int width = 32, height = 18;
+    ASSERT_TRUE(path_tracer_->trace_preview(width, height));
+    
+    const auto& image = path_tracer_->get_image_data();
+    ASSERT_EQ(image.size(), static_cast<size_t>(width * height));
+    for (const auto& pixel : image) {
+        EXPECT_TRUE(std::isfinite(pixel.r) && std::isfinite(pixel.g) && std::isfinite(pixel.b));
+        EXPECT_GE(pixel.r, 0.0f);
+    }
+}
+
+TEST_F(DirectLightResamplerTest, TemporalReuseKeepsReservoirsOnStaticCamera) {
+    const int width = 32, height = 18;
+    ASSERT_TRUE(path_tracer_->trace_preview(width, height));
+    ASSERT_TRUE(path_tracer_->trace_preview(width, height));
+    
+    // Lit pixels should have accumulated more candidates than one frame draws
+    auto& resampler = path_tracer_->get_direct_light_resampler();
+    float max_m = 0.0f;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            max_m = std::max(max_m, resampler.reservoir(x, y).M);
+        }
+    }
+    EXPECT_GT(max_m, float(resampler.config().initial_candidates));
+}
+
+TEST_F(DirectLightResamplerTest, ResamplingReducesPreviewNoise) {
+    const int width = 48, height = 27;
+    
+    // Noise estimate: difference between two independent 1 spp frames.
+    // The irradiance cache is off so only the direct light path differs.
+    path_tracer_->set_irradiance_cache(false);
+    path_tracer_->set_direct_light_resampling(false);
+    path_tracer_->trace_preview(width, height);
+    auto plain_a = path_tracer_->get_image_data();
+    path_tracer_->trace_preview(width, height);
+    auto plain_b = path_tracer_->get_image_data();
+    
+    path_tracer_->set_direct_light_resampling(true);
+    for (int warmup = 0; warmup < 3; ++warmup) {
+        path_tracer_->trace_preview(width, height);
+    }
+    auto resampled_a = path_tracer_->get_image_data();
+    path_tracer_->trace_preview(width, height);
+    auto resampled_b = path_tracer_->get_image_data();
+    
+    EXPECT_LT(frame_difference(resampled_a, resampled_b), frame_difference(plain_a, plain_b));
+}
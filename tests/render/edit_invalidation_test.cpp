@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+#include "progressive_edit_helpers.h"
+
+class EditInvalidationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        // Small enough to cover a couple of the 4x3 tiles
+        marble_ = std::make_shared<Sphere>(Vector3(0.8f, 0.5f, 0.0f), 0.1f, Color(0.9f, 0.2f, 0.2f),
+                                           Material(Color(0.9f, 0.2f, 0.2f)));
+        scene_manager_->add_object(marble_);
+        marble_id_ = scene_manager_->get_object_id(static_cast<int>(scene_manager_->get_objects().size()) - 1);
+    }
+
+    void move_marble(const Vector3& position) {
+        ASSERT_TRUE(scene_manager_->move_object(marble_id_, position));
+    }
+
+    std::vector<Color> render(EditInvalidation mode, int depth, const std::function<void()>& edit,
+                              size_t* invalidated = nullptr) {
+        PathTracer tracer;
+        tracer.set_scene_manager(scene_manager_);
+        tracer.set_camera(*scene_manager_->get_camera());
+        tracer.set_max_depth(depth);
+        tracer.set_thread_count(2);
+        tracer.set_random_seed(11);
+        tracer.set_edit_invalidation(mode);
+        std::vector<Color> image = render_with_edit(tracer, WIDTH, HEIGHT, edit);
+        if (invalidated) {
+            *invalidated = tracer.get_invalidated_tiles();
+        }
+        return image;
+    }
+
+    static constexpr int WIDTH = 128;
+    static constexpr int HEIGHT = 72;
+    static constexpr size_t TILES = 12;     // 32-pixel tiles
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::shared_ptr<Sphere> marble_;
+    PrimitiveID marble_id_ = INVALID_PRIMITIVE_ID;
+};
+
+TEST_F(EditInvalidationTest, PrimaryVisibilityEditMatchesFreshRender) {
+    // With one bounce an image is primary visibility only, so resetting the
+    // tiles that saw the marble before or after the move must be exact
+    size_t invalidated = 0;
+    const std::vector<Color> edited = render(EditInvalidation::PRIMARY, 1,
+                                             [&] { move_marble(Vector3(1.0f, 0.5f, 0.0f)); }, &invalidated);
+    EXPECT_GT(invalidated, 0u);
+    EXPECT_LT(invalidated, TILES / 2);
+    expect_same_image(edited, render(EditInvalidation::OFF, 1, nullptr));
+
+    // Removal finds the tiles through the primitive IDs they recorded
+    const std::vector<Color> removed = render(EditInvalidation::PRIMARY, 1,
+                                              [&] { scene_manager_->remove_object(marble_); }, &invalidated);
+    EXPECT_GT(invalidated, 0u);
+    EXPECT_LT(invalidated, TILES / 2);
+    expect_same_image(removed, render(EditInvalidation::OFF, 1, nullptr));
+    EXPECT_FALSE(scene_manager_->move_object(marble_id_, Vector3(0.8f, 0.5f, 0.0f)));
+}
+
+TEST_F(EditInvalidationTest, FullFrameReplaysEveryTile) {
+    size_t invalidated = 0;
+    const std::vector<Color> edited = render(EditInvalidation::FULL_FRAME, 3,
+                                             [&] { move_marble(Vector3(1.0f, 0.5f, 0.0f)); }, &invalidated);
+    EXPECT_EQ(invalidated, TILES);
+    // Reset tiles replay the same passes, so the frame is the fresh render of the edited scene
+    expect_same_image(edited, render(EditInvalidation::OFF, 3, nullptr));
+}
+
+TEST_F(EditInvalidationTest, PoliciesBoundTheResetTiles) {
+    auto edit = [&] { move_marble(marble_->position() + Vector3(0.2f, 0.0f, 0.0f)); };
+    size_t primary = 0, padded = 0, off = 0;
+    render(EditInvalidation::PRIMARY, 2, edit, &primary);
+    render(EditInvalidation::PADDED, 2, edit, &padded);
+    render(EditInvalidation::OFF, 2, edit, &off);
+    EXPECT_GT(primary, 0u);
+    EXPECT_GT(padded, primary);
+    EXPECT_EQ(off, 0u);
+
+    // Nothing on screen changes when a primitive appears behind the camera
+    size_t behind = 0;
+    render(EditInvalidation::PRIMARY, 2, [&] {
+        scene_manager_->add_object(std::make_shared<Sphere>(Vector3(0, 0, 6), 0.5f, Color(1, 1, 1), Material(Color(1, 1, 1))));
+    }, &behind);
+    EXPECT_EQ(behind, 0u);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "render/irradiance_cache.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+
+class IrradianceCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        IrradianceCacheConfig config;
+        config.cell_size = 0.5f;
+        config.max_samples_per_entry = 4;
+        config.invalidation_margin = 0.0f;
+        cache_ = std::make_unique<IrradianceCache>(config);
+    }
+
+    std::unique_ptr<IrradianceCache> cache_;
+};
+
+TEST_F(IrradianceCacheTest, SamplesInSameCellShareEntry) {
+    Vector3 up(0, 1, 0);
+    cache_->add_sample(Vector3(0.1f, 0.1f, 0.1f), up, Color(1, 0, 0));
+    Color mean = cache_->add_sample(Vector3(0.4f, 0.2f, 0.3f), up, Color(0, 0, 1));
+
+    EXPECT_EQ(cache_->size(), 1u);
+    EXPECT_FLOAT_EQ(mean.r, 0.5f);
+    EXPECT_FLOAT_EQ(mean.b, 0.5f);
+
+    Color radiance;
+    int count = 0;
+    EXPECT_TRUE(cache_->lookup(Vector3(0.25f, 0.25f, 0.25f), up, radiance, count));
+    EXPECT_EQ(count, 2);
+    EXPECT_FLOAT_EQ(radiance.r, 0.5f);
+}
+
+TEST_F(IrradianceCacheTest, OpposingNormalsUseSeparateEntries) {
+    cache_->add_sample(Vector3(0.1f, 0.1f, 0.1f), Vector3(0, 1, 0), Color(1, 1, 1));
+    cache_->add_sample(Vector3(0.1f, 0.1f, 0.1f), Vector3(0, -1, 0), Color(0, 0, 0));
+
+    EXPECT_EQ(cache_->size(), 2u);
+
+    Color radiance;
+    int count = 0;
+    ASSERT_TRUE(cache_->lookup(Vector3(0.1f, 0.1f, 0.1f), Vector3(0, 1, 0), radiance, count));
+    EXPECT_FLOAT_EQ(radiance.g, 1.0f);
+}
+
+TEST_F(IrradianceCacheTest, ConvergedEntryStopsRefining) {
+    Vector3 p(1, 1, 1), n(0, 0, 1);
+    for (int i = 0; i < 4; ++i) {
+        cache_->add_sample(p, n, Color(1, 1, 1));
+    }
+    Color mean = cache_->add_sample(p, n, Color(100, 100, 100));
+    EXPECT_FLOAT_EQ(mean.r, 1.0f);
+
+    Color radiance;
+    int count = 0;
+    ASSERT_TRUE(cache_->lookup(p, n, radiance, count));
+    EXPECT_TRUE(cache_->is_converged(count));
+    EXPECT_EQ(cache_->get_stats().hits, 1u);
+}
+
+TEST_F(IrradianceCacheTest, InvalidateRegionKeepsDistantEntries) {
+    Vector3 n(0, 1, 0);
+    cache_->add_sample(Vector3(0, 0, 0), n, Color(1, 1, 1));
+    cache_->add_sample(Vector3(10, 0, 0), n, Color(1, 1, 1));
+
+    AABB edit;
+    edit.expand(Vector3(-0.5f, -0.5f, -0.5f));
+    edit.expand(Vector3(0.5f, 0.5f, 0.5f));
+    cache_->invalidate_region(edit);
+
+    Color radiance;
+    int count = 0;
+    EXPECT_FALSE(cache_->lookup(Vector3(0, 0, 0), n, radiance, count));
+    EXPECT_TRUE(cache_->lookup(Vector3(10, 0, 0), n, radiance, count));
+    EXPECT_EQ(cache_->get_stats().invalidated, 1u);
+}
+
+TEST_F(IrradianceCacheTest, SceneManagerRecordsEdits) {
+    SceneManager scene_manager;
+    uint64_t version = scene_manager.get_scene_version();
+
+    auto sphere = std::make_shared<Sphere>(Vector3(2, 0, 0), 0.5f);
+    scene_manager.add_object(sphere);
+    scene_manager.remove_object(sphere);
+
+    std::vector<SceneEdit> edits;
+    ASSERT_TRUE(scene_manager.get_edits_since(version, edits));
+    ASSERT_EQ(edits.size(), 2u);
+    EXPECT_EQ(edits[0].kind, SceneEditKind::ADDED);
+    EXPECT_EQ(edits[1].kind, SceneEditKind::REMOVED);
+    EXPECT_TRUE(edits[1].old_bounds.contains(Vector3(2.4f, 0, 0)));
+    EXPECT_FALSE(edits[1].old_bounds.contains(Vector3(0, 0, 0)));
+    EXPECT_GT(scene_manager.get_scene_version(), version);
+}
+
+TEST_F(IrradianceCacheTest, PreviewFillsCacheAndStaysFinite) {
+    auto scene_manager = std::make_shared<SceneManager>();
+    scene_manager->initialize();
+
+    PathTracer path_tracer;
+    path_tracer.set_scene_manager(scene_manager);
+    path_tracer.set_camera(*scene_manager->get_camera());
+    path_tracer.set_max_depth(4);
+    path_tracer.set_samples_per_pixel(1);
+    path_tracer.set_thread_count(2);
+    ASSERT_TRUE(path_tracer.is_irradiance_cache_enabled());
+
+    ASSERT_TRUE(path_tracer.trace_preview(32, 24));
+    EXPECT_GT(path_tracer.get_irradiance_cache().size(), 0u);
+
+    for (const auto& pixel : path_tracer.get_image_data()) {
+        EXPECT_TRUE(std::isfinite(pixel.r) && std::isfinite(pixel.g) && std::isfinite(pixel.b));
+    }
+
+    // An edit far from every cached surface must not flush the cache
+    size_t before = path_tracer.get_irradiance_cache().size();
+    scene_manager->add_object(std::make_shared<Sphere>(Vector3(500, 500, 500), 0.1f));
+    ASSERT_TRUE(path_tracer.trace_preview(32, 24));
+    EXPECT_GE(path_tracer.get_irradiance_cache().size(), before);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/logger.h"
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::remove(filename_.c_str());
+        ASSERT_TRUE(logger_set_output_file(filename_));
+        logger_set_level(LogLevel::INFO);
+        logger_set_rate_limit(0);
+    }
+
+    void TearDown() override {
+        logger_flush();
+        logger_set_output_file("");
+        logger_set_format(LogFormat::TEXT);
+        logger_set_level(LogLevel::INFO);
+        logger_set_rate_limit(20);
+        std::remove(filename_.c_str());
+    }
+
+    std::vector<std::string> read_lines() {
+        logger_flush();
+        std::ifstream file(filename_);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    const std::string filename_ = "logger_test.log";
+};
+
+TEST_F(LoggerTest, WritesTextRecords) {
+    LOG_INFO(LogChannel::RENDER, "Rendered " << 42 << " tiles");
+    LOG_ERROR(LogChannel::GPU, "Dispatch failed");
+
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_NE(lines[0].find("info  render  Rendered 42 tiles"), std::string::npos);
+    EXPECT_NE(lines[1].find("error gpu     Dispatch failed"), std::string::npos);
+}
+
+TEST_F(LoggerTest, ChannelFiltersApply) {
+    ASSERT_TRUE(logger_configure("warn,gpu=info"));
+    EXPECT_EQ(logger_level(LogChannel::RENDER), LogLevel::WARN);
+    EXPECT_EQ(logger_level(LogChannel::GPU), LogLevel::INFO);
+
+    LOG_INFO(LogChannel::RENDER, "filtered");
+    LOG_INFO(LogChannel::GPU, "kept");
+    LOG_WARN(LogChannel::RENDER, "kept too");
+    EXPECT_EQ(read_lines().size(), 2u);
+
+    EXPECT_FALSE(logger_configure("info,shader=debug"));
+    EXPECT_FALSE(logger_configure("loud"));
+    EXPECT_EQ(logger_level(LogChannel::RENDER), LogLevel::WARN);
+}
+
+TEST_F(LoggerTest, DebugLogsCompileAway) {
+    logger_set_level(LogLevel::DEBUG);
+    int evaluations = 0;
+    LOG_DEBUG(LogChannel::RENDER, "evaluated " << ++evaluations);
+#ifdef ENABLE_DEBUG_LOGS
+    EXPECT_EQ(evaluations, 1);
+    EXPECT_EQ(read_lines().size(), 1u);
+#else
+    EXPECT_EQ(evaluations, 0);
+    EXPECT_TRUE(read_lines().empty());
+#endif
+}
+
+TEST_F(LoggerTest, CallSitesAreRateLimited) {
+    logger_set_rate_limit(3);
+    for (int i = 0; i < 10; ++i) {
+        LOG_INFO(LogChannel::RENDER, "frame " << i);
+    }
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_NE(lines[2].find("frame 2"), std::string::npos);
+}
+
+TEST_F(LoggerTest, JsonFormatEscapesMessages) {
+    logger_set_format(LogFormat::JSON);
+    LOG_WARN(LogChannel::SCENE, "path \"a\\b\"");
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("\"level\":\"warn\",\"channel\":\"scene\""), std::string::npos);
+    EXPECT_NE(lines[0].find("\"message\":\"path \\\"a\\\\b\\\"\""), std::string::npos);
+}
+
+TEST_F(LoggerTest, LongMessagesAreTruncated) {
+    LOG_INFO(LogChannel::GENERAL, std::string(LOG_MESSAGE_CAPACITY * 2, 'x'));
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0].size() - lines[0].find("xxx"), LOG_MESSAGE_CAPACITY);
+    EXPECT_EQ(lines[0].substr(lines[0].size() - 3), "...");
+}
+
+TEST_F(LoggerTest, ConcurrentProducersLoseNothingOrCountDrops) {
+    const int threads = 4;
+    const int messages = 500;
+    uint64_t dropped_before = logger_dropped_count();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t]() {
+            for (int i = 0; i < messages; ++i) {
+                LOG_INFO(LogChannel::RENDER, "worker " << t << " message " << i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    size_t records = 0;
+    for (const auto& line : read_lines()) {
+        if (line.find("worker ") != std::string::npos) {
+            ++records;
+        }
+    }
+    EXPECT_EQ(records + (logger_dropped_count() - dropped_before), static_cast<size_t>(threads * messages));
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <sstream>
+#include "render/metrics_exporter.h"
+
+namespace {
+
+std::string http_get(int fd, const std::string& path) {
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    return response;
+}
+
+std::string get_tcp(int port, const std::string& path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return "";
+    }
+    return http_get(fd, path);
+}
+
+std::string get_unix(const std::string& socket_path, const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return "";
+    }
+    return http_get(fd, path);
+}
+
+} // namespace
+
+class MetricsExporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        metrics_.imageWidth = 320;
+        metrics_.imageHeight = 240;
+        metrics_.mrays_per_second = 12.5;
+        metrics_.memory_usage_mb = 2.0f;
+    }
+
+    MetricsExporter exporter_;
+    RenderMetrics metrics_;
+};
+
+TEST_F(MetricsExporterTest, ParsesEndpoints) {
+    MetricsExporter::Config config;
+    EXPECT_TRUE(MetricsExporter::parse_endpoint("9100", config));
+    EXPECT_EQ(config.port, 9100);
+    EXPECT_TRUE(MetricsExporter::parse_endpoint("port:0", config));
+    EXPECT_EQ(config.port, 0);
+    EXPECT_TRUE(MetricsExporter::parse_endpoint("unix:/tmp/pathtracer.sock", config));
+    EXPECT_EQ(config.unix_socket, "/tmp/pathtracer.sock");
+    EXPECT_FALSE(MetricsExporter::parse_endpoint("70000", config));
+    EXPECT_FALSE(MetricsExporter::parse_endpoint("unix:", config));
+    EXPECT_FALSE(MetricsExporter::parse_endpoint("metrics", config));
+}
+
+TEST_F(MetricsExporterTest, ScrapeShowsLatestSnapshot) {
+    std::ostringstream before;
+    exporter_.scrape(before);
+    EXPECT_NE(before.str().find("pathtracer_rays_total{kind=\"primary\"}"), std::string::npos);
+    EXPECT_NE(before.str().find("pathtracer_snapshots_published_total 0"), std::string::npos);
+    EXPECT_EQ(before.str().find("pathtracer_image_width_pixels"), std::string::npos);
+
+    exporter_.publish(metrics_, RenderState::RENDERING);
+    metrics_.imageWidth = 640;
+    exporter_.publish(metrics_, RenderState::COMPLETED);
+
+    std::ostringstream after;
+    exporter_.scrape(after);
+    const std::string text = after.str();
+    EXPECT_NE(text.find("pathtracer_snapshots_published_total 2"), std::string::npos);
+    EXPECT_NE(text.find("pathtracer_image_width_pixels 640"), std::string::npos);
+    EXPECT_NE(text.find("pathtracer_frame_mrays_per_second 12.5"), std::string::npos);
+    EXPECT_NE(text.find("pathtracer_render_state{state=\"completed\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("pathtracer_render_state{state=\"rendering\"} 0"), std::string::npos);
+    EXPECT_NE(text.find("pathtracer_resident_memory_bytes 2097152"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE pathtracer_tile_queue_depth gauge"), std::string::npos);
+}
+
+TEST_F(MetricsExporterTest, ServesOverTcpAndUnixSocket) {
+    MetricsExporter::Config config;
+    config.port = 0;
+    ASSERT_TRUE(exporter_.start(config));
+    ASSERT_GT(exporter_.port(), 0);
+    exporter_.publish(metrics_, RenderState::COMPLETED);
+
+    std::string response = get_tcp(exporter_.port(), "/metrics");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK", 0), 0u);
+    EXPECT_NE(response.find("text/plain; version=0.0.4"), std::string::npos);
+    EXPECT_NE(response.find("pathtracer_image_width_pixels 320"), std::string::npos);
+    EXPECT_EQ(get_tcp(exporter_.port(), "/other").rfind("HTTP/1.1 404", 0), 0u);
+    exporter_.stop();
+    EXPECT_FALSE(exporter_.is_running());
+
+    config.unix_socket = testing::TempDir() + "metrics_exporter_test.sock";
+    ASSERT_TRUE(exporter_.start(config));
+    response = get_unix(config.unix_socket, "/metrics");
+    EXPECT_NE(response.find("pathtracer_snapshots_published_total 1"), std::string::npos);
+    exporter_.stop();
+    EXPECT_NE(access(config.unix_socket.c_str(), F_OK), 0);
+}
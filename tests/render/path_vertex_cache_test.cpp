@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "render/path_vertex_cache.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+#include "progressive_edit_helpers.h"
+
+class PathVertexCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        marble_ = std::make_shared<Sphere>(Vector3(0.8f, 0.5f, 0.0f), 0.3f, Color(0.9f, 0.2f, 0.2f),
+                                           Material(Color(0.9f, 0.2f, 0.2f)));
+        scene_manager_->add_object(marble_);
+        marble_id_ = scene_manager_->get_object_id(static_cast<int>(scene_manager_->get_objects().size()) - 1);
+        tracer_.set_scene_manager(scene_manager_);
+        tracer_.set_camera(*scene_manager_->get_camera());
+        tracer_.set_max_depth(3);
+        tracer_.set_thread_count(2);
+        tracer_.set_random_seed(5);
+        tracer_.set_edit_invalidation(EditInvalidation::FULL_FRAME);
+        PathVertexCacheConfig config;
+        config.passes = 6;
+        config.depth = 2;
+        tracer_.set_path_vertex_cache(config);
+    }
+
+    std::vector<Color> render(PathTracer& tracer, const std::function<void()>& edit = nullptr) {
+        return render_with_edit(tracer, WIDTH, HEIGHT, edit);
+    }
+
+    void set_marble_material(const Material& material) {
+        ASSERT_TRUE(scene_manager_->set_object_material(marble_id_, material));
+    }
+
+    // The same scene rendered from scratch without the cache
+    std::vector<Color> fresh_render() {
+        PathTracer tracer;
+        tracer.set_scene_manager(scene_manager_);
+        tracer.set_camera(*scene_manager_->get_camera());
+        tracer.set_max_depth(3);
+        tracer.set_thread_count(2);
+        tracer.set_random_seed(5);
+        return render(tracer);
+    }
+
+    static constexpr int WIDTH = 96;
+    static constexpr int HEIGHT = 64;
+    static constexpr uint64_t TILES = 6;     // 32-pixel tiles
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::shared_ptr<Sphere> marble_;
+    PrimitiveID marble_id_ = INVALID_PRIMITIVE_ID;
+    PathTracer tracer_;
+};
+
+TEST_F(PathVertexCacheTest, MaterialEditReplaysFromCachedHits) {
+    const RayStats before = ray_stats_total();
+    const std::vector<Color> edited = render(tracer_, [&] {
+        set_marble_material(Material(Color(0.2f, 0.3f, 0.9f), 0.4f));
+    });
+    const RayStats reuse = ray_stats_total() - before;
+
+    // The first step's passes are replayed from the cache, bit for bit what a fresh trace gives
+    PathVertexCacheStats stats = tracer_.get_path_vertex_cache().get_stats();
+    EXPECT_EQ(stats.reused_passes, TILES);
+    EXPECT_EQ(stats.invalidations, 0u);
+    EXPECT_GT(reuse[RayCounter::CACHED_HITS], 0u);
+    expect_same_image(edited, fresh_render());
+
+    // Metal draws other random numbers than diffuse, so rays after it in a tile no longer match and are traced again
+    const std::vector<Color> metal = render(tracer_, [&] {
+        set_marble_material(Material(Color(0.9f, 0.9f, 0.9f), 0.1f, 1.0f));
+    });
+    expect_same_image(metal, fresh_render());
+}
+
+TEST_F(PathVertexCacheTest, NextRenderOfTheSameViewReusesHits) {
+    tracer_.set_random_seed(0);
+    render(tracer_);
+    const uint64_t recorded = tracer_.get_path_vertex_cache().get_stats().recorded_passes;
+    EXPECT_EQ(recorded, TILES * 6);
+    const uint64_t seed = tracer_.get_path_vertex_cache().frame().seed;
+
+    // With a random seed the next render adopts the cached one and replays every cached pass
+    set_marble_material(Material(Color(0.1f, 0.8f, 0.1f)));
+    render(tracer_);
+    PathVertexCacheStats stats = tracer_.get_path_vertex_cache().get_stats();
+    EXPECT_EQ(stats.reused_passes, TILES * 6);
+    EXPECT_EQ(stats.recorded_passes, recorded);
+    EXPECT_EQ(tracer_.get_path_vertex_cache().frame().seed, seed);
+
+    // Geometry edits drop the cache
+    ASSERT_TRUE(scene_manager_->move_object(marble_id_, Vector3(0.6f, 0.5f, 0.0f)));
+    render(tracer_);
+    stats = tracer_.get_path_vertex_cache().get_stats();
+    EXPECT_EQ(stats.reused_passes, TILES * 6);
+    EXPECT_EQ(stats.invalidations, 1u);
+
+    // So does geometry changed in place without an edit record
+    marble_->set_position(Vector3(0.8f, 0.5f, 0.0f));
+    render(tracer_);
+    stats = tracer_.get_path_vertex_cache().get_stats();
+    EXPECT_EQ(stats.reused_passes, TILES * 6);
+    EXPECT_EQ(stats.invalidations, 2u);
+}
+
+TEST_F(PathVertexCacheTest, FrameIdentityAndLimits) {
+    PathVertexCache cache(PathVertexCacheConfig{2, 5});
+    EXPECT_EQ(cache.config().depth, 2);
+    EXPECT_TRUE(cache.enabled());
+
+    PathVertexFrame frame;
+    frame.width = 4;
+    frame.height = 2;
+    frame.seed = 9;
+    EXPECT_FALSE(cache.begin_frame(frame, 1));
+    EXPECT_TRUE(cache.covers(1));
+    EXPECT_FALSE(cache.covers(2));
+    EXPECT_EQ(cache.get_stats().bytes, 4u * 2u * 2u * 2u * sizeof(PathVertex));
+
+    PathVertexSpan span = cache.sample(0, 3, 1);
+    EXPECT_EQ(span.count, 2);
+    EXPECT_FALSE(span.reuse);
+    cache.finish_tile_pass(0, 1, false);
+    EXPECT_TRUE(cache.sample(0, 3, 1).reuse);
+    EXPECT_TRUE(cache.holds(frame, false));
+
+    PathVertexFrame other_seed = frame;
+    other_seed.seed = 10;
+    EXPECT_FALSE(cache.holds(other_seed, false));
+    EXPECT_TRUE(cache.holds(other_seed, true));
+    EXPECT_TRUE(cache.begin_frame(frame, 1));
+    EXPECT_FALSE(cache.begin_frame(other_seed, 1));
+    EXPECT_FALSE(cache.sample(0, 3, 1).reuse);
+
+    cache.set_config(PathVertexCacheConfig{0, 1});
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_EQ(cache.get_stats().bytes, 0u);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "render/primary_visibility.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+#include "core/ray_stats.h"
+#include <limits>
+
+class PrimaryVisibilityTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        // A row of small marbles so most pixels are covered by few footprints
+        for (int i = 0; i < 8; ++i) {
+            scene_manager_->add_object(std::make_shared<Sphere>(Vector3(-1.4f + 0.4f * i, 0.9f, -0.5f), 0.12f,
+                                                                Color(0.8f, 0.8f, 0.8f), Material(Color(0.8f, 0.8f, 0.8f))));
+        }
+    }
+
+    std::vector<Color> preview(bool raster, RayStats* stats = nullptr) {
+        PathTracer tracer;
+        tracer.set_scene_manager(scene_manager_);
+        tracer.set_camera(*scene_manager_->get_camera());
+        tracer.set_max_depth(3);
+        tracer.set_samples_per_pixel(2);
+        tracer.set_thread_count(2);
+        tracer.set_irradiance_cache(false);
+        tracer.set_raster_primary_visibility(raster);
+        const RayStats before = ray_stats_total();
+        EXPECT_TRUE(tracer.trace_preview(WIDTH, HEIGHT));
+        if (stats) {
+            *stats = ray_stats_total() - before;
+        }
+        return tracer.get_image_data();
+    }
+
+    // Checks every pixel-centre camera ray against hit_scene, going through
+    // hit() wherever bin_tile allows it. Returns the tiles that did not.
+    int expect_hits_match() {
+        const Camera& camera = *scene_manager_->get_camera();
+        PrimaryVisibility visibility;
+        visibility.build(*scene_manager_, camera, WIDTH, HEIGHT);
+
+        TileScheduler scheduler;
+        std::vector<uint32_t> candidates;
+        int unbinned = 0;
+        for (const RenderTile& tile : scheduler.make_tiles(WIDTH, HEIGHT)) {
+            const bool binned = visibility.bin_tile(tile, candidates);
+            unbinned += binned ? 0 : 1;
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) {
+                    Ray ray = camera.get_ray((x + 0.5f) / float(WIDTH), (y + 0.5f) / float(HEIGHT));
+                    HitRecord expected, actual;
+                    const float t_max = std::numeric_limits<float>::infinity();
+                    bool expected_hit = scene_manager_->hit_scene(ray, 0.001f, t_max, expected);
+                    bool actual_hit = binned ? visibility.hit(candidates, x, y, ray, 0.001f, actual)
+                                             : scene_manager_->hit_scene(ray, 0.001f, t_max, actual);
+                    EXPECT_EQ(actual_hit, expected_hit) << x << ", " << y;
+                    if (expected_hit && actual_hit) {
+                        EXPECT_TRUE(visibility.covers(candidates, x, y)) << x << ", " << y;
+                        EXPECT_EQ(actual.object_index, expected.object_index) << x << ", " << y;
+                        EXPECT_EQ(actual.t, expected.t) << x << ", " << y;
+                    }
+                }
+            }
+        }
+        return unbinned;
+    }
+
+    static constexpr int WIDTH = 96;
+    static constexpr int HEIGHT = 64;
+    std::shared_ptr<SceneManager> scene_manager_;
+};
+
+TEST_F(PrimaryVisibilityTest, HitsMatchSceneIntersection) {
+    // Same bounds twice: equal distances must resolve to the higher object index, as in hit_scene
+    const Vector3 twin = scene_manager_->get_objects().back()->position();
+    scene_manager_->add_object(std::make_shared<Sphere>(twin, 0.12f, Color(1, 0, 0), Material(Color(1, 0, 0))));
+    expect_hits_match();
+}
+
+TEST_F(PrimaryVisibilityTest, CubeTiesMatchSceneIntersection) {
+    // Overlapping unit cubes whose front faces share a plane
+    scene_manager_->clear_objects();
+    scene_manager_->add_object(std::make_shared<Cube>(Vector3(0.75f, 0, 0), 1.0f, Color(1, 0, 0), Material(Color(1, 0, 0))));
+    scene_manager_->add_object(std::make_shared<Cube>(Vector3(0, 0, 0), 1.0f, Color(0, 1, 0), Material(Color(0, 1, 0))));
+    EXPECT_EQ(expect_hits_match(), 0);
+}
+
+TEST_F(PrimaryVisibilityTest, TorusTilesMatchSceneIntersection) {
+    // The sphere comes first in scene order, so hit_scene hands the torus a finite t_max
+    scene_manager_->clear_objects();
+    scene_manager_->add_object(std::make_shared<Sphere>(Vector3(0, 0, -4), 1.5f, Color(1, 0, 0), Material(Color(1, 0, 0))));
+    scene_manager_->add_object(std::make_shared<Torus>(Vector3(0, 0, -1), 0.8f, 0.25f, Color(0, 1, 0), Material(Color(0, 1, 0))));
+    EXPECT_GT(expect_hits_match(), 0);
+}
+
+TEST_F(PrimaryVisibilityTest, SkipsObjectsOffScreen) {
+    const Camera& camera = *scene_manager_->get_camera();
+    PrimaryVisibility visibility;
+    visibility.build(*scene_manager_, camera, WIDTH, HEIGHT);
+    const size_t on_screen = visibility.footprint_count();
+    EXPECT_GT(on_screen, 0u);
+
+    // Behind the camera, so no pixel can see it
+    const Vector3 behind = camera.get_position() + (camera.get_position() - camera.get_target()) * 2.0f;
+    scene_manager_->add_object(std::make_shared<Sphere>(behind, 0.5f, Color(1, 1, 1), Material(Color(1, 1, 1))));
+    visibility.build(*scene_manager_, camera, WIDTH, HEIGHT);
+    EXPECT_EQ(visibility.footprint_count(), on_screen);
+}
+
+TEST_F(PrimaryVisibilityTest, PreviewImageUnchangedWithFewerTests) {
+    RayStats raster_stats, traced_stats;
+    const std::vector<Color> raster = preview(true, &raster_stats);
+    const std::vector<Color> traced = preview(false, &traced_stats);
+    ASSERT_EQ(raster.size(), traced.size());
+    for (size_t i = 0; i < raster.size(); ++i) {
+        ASSERT_EQ(raster[i].r, traced[i].r) << "pixel " << i;
+        ASSERT_EQ(raster[i].g, traced[i].g) << "pixel " << i;
+        ASSERT_EQ(raster[i].b, traced[i].b) << "pixel " << i;
+    }
+    EXPECT_EQ(raster_stats[RayCounter::PRIMARY_RAYS], traced_stats[RayCounter::PRIMARY_RAYS]);
+    EXPECT_LT(raster_stats.intersection_tests(), traced_stats.intersection_tests());
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "core/profiler.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        profiler_clear();
+        profiler_set_enabled(true);
+    }
+
+    void TearDown() override {
+        profiler_set_enabled(false);
+        profiler_clear();
+    }
+
+    static size_t count_named(const std::vector<ProfileEvent>& events, const std::string& name) {
+        size_t count = 0;
+        for (const auto& event : events) {
+            if (event.name && name == event.name) {
+                ++count;
+            }
+        }
+        return count;
+    }
+};
+
+TEST_F(ProfilerTest, NestedZonesAreContained) {
+    {
+        ProfileZone outer("outer");
+        ProfileZone inner("inner");
+    }
+
+    std::vector<ProfileEvent> events;
+    ASSERT_EQ(profiler_collect(events), 2u);
+    EXPECT_STREQ(events[0].name, "outer");
+    EXPECT_STREQ(events[1].name, "inner");
+    EXPECT_LE(events[0].start_ns, events[1].start_ns);
+    EXPECT_GE(events[0].end_ns, events[1].end_ns);
+    EXPECT_EQ(events[0].thread_id, events[1].thread_id);
+}
+
+TEST_F(ProfilerTest, DisabledCaptureRecordsNothing) {
+    profiler_set_enabled(false);
+    {
+        ProfileZone zone("ignored");
+    }
+    std::vector<ProfileEvent> events;
+    EXPECT_EQ(profiler_collect(events), 0u);
+}
+
+TEST_F(ProfilerTest, RingKeepsNewestEvents) {
+    for (size_t i = 0; i < PROFILE_RING_CAPACITY + 10; ++i) {
+        ProfileZone zone("spin");
+    }
+    std::vector<ProfileEvent> events;
+    EXPECT_EQ(profiler_collect(events), PROFILE_RING_CAPACITY);
+}
+
+TEST_F(ProfilerTest, ThreadsGetSeparateTracks) {
+    std::thread worker([]() {
+        profiler_set_thread_name("profiler test worker");
+        ProfileZone zone("worker zone");
+    });
+    worker.join();
+    {
+        ProfileZone zone("main zone");
+    }
+
+    std::vector<ProfileEvent> events;
+    ASSERT_EQ(profiler_collect(events), 2u);
+    EXPECT_NE(events[0].thread_id, events[1].thread_id);
+}
+
+#ifdef ENABLE_PROFILING
+TEST_F(ProfilerTest, RenderStagesAppearInChromeTrace) {
+    auto scene_manager = std::make_shared<SceneManager>();
+    scene_manager->initialize();
+    PathTracer path_tracer;
+    path_tracer.set_scene_manager(scene_manager);
+    path_tracer.set_camera(*scene_manager->get_camera());
+    path_tracer.set_max_depth(2);
+    path_tracer.set_samples_per_pixel(1);
+    path_tracer.set_thread_count(2);
+    ASSERT_TRUE(path_tracer.trace_preview(64, 48));
+
+    std::vector<ProfileEvent> events;
+    profiler_collect(events);
+    EXPECT_EQ(count_named(events, "trace_preview"), 1u);
+    EXPECT_GT(count_named(events, "preview shading"), 0u);
+    EXPECT_EQ(count_named(events, "tonemap"), 1u);
+
+    const std::string filename = "profiler_test_trace.json";
+    ASSERT_TRUE(profiler_export_chrome_trace(filename));
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(content.str().rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(content.str().find("\"name\":\"trace_preview\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(content.str().find("\"thread_name\""), std::string::npos);
+    file.close();
+    std::remove(filename.c_str());
+}
+#endif
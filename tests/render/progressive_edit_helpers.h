@@ -0,0 +1,33 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "render/path_tracer.h"
+#include <functional>
+#include <vector>
+
+// Progressive render of 6 samples in 3 steps that calls edit once, after its first step
+inline std::vector<Color> render_with_edit(PathTracer& tracer, int width, int height,
+                                           const std::function<void()>& edit = nullptr) {
+    ProgressiveConfig config;
+    config.targetSamples = 6;
+    config.progressiveSteps = 3;
+    config.updateInterval = 0.0f;
+    bool edited = false;
+    EXPECT_TRUE(tracer.trace_progressive(width, height, config,
+                                         [&](const std::vector<Color>&, int, int, int, int) {
+                                             if (!edited && edit) {
+                                                 edit();
+                                             }
+                                             edited = true;
+                                         }));
+    return tracer.get_image_data();
+}
+
+inline void expect_same_image(const std::vector<Color>& actual, const std::vector<Color>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i].r, expected[i].r) << "pixel " << i;
+        ASSERT_EQ(actual[i].g, expected[i].g) << "pixel " << i;
+        ASSERT_EQ(actual[i].b, expected[i].b) << "pixel " << i;
+    }
+}
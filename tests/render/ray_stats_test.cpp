@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "core/ray_stats.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+
+class RayStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+
+        path_tracer_ = std::make_unique<PathTracer>();
+        path_tracer_->set_scene_manager(scene_manager_);
+        path_tracer_->set_camera(*scene_manager_->get_camera());
+        path_tracer_->set_samples_per_pixel(2);
+    }
+
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::unique_ptr<PathTracer> path_tracer_;
+};
+
+TEST_F(RayStatsTest, SlotsArePaddedToCacheLines) {
+    EXPECT_EQ(alignof(RayStatsSlot), 64u);
+    EXPECT_EQ(sizeof(RayStatsSlot) % 64, 0u);
+}
+
+TEST_F(RayStatsTest, TotalsIncludeExitedThreads) {
+    RayStats before = ray_stats_total();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 1000; ++i) {
+                thread_ray_stats().add(RayCounter::SHADOW_RAYS);
+            }
+            thread_ray_stats().add(RayCounter::CUBE_TESTS, 5);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    RayStats delta = ray_stats_total() - before;
+    EXPECT_EQ(delta[RayCounter::SHADOW_RAYS], 8000u);
+    EXPECT_EQ(delta.intersection_tests(), 40u);
+    EXPECT_EQ(delta.rays(), 8000u);
+}
+
+TEST_F(RayStatsTest, FrameCountsPrimaryRaysAndTests) {
+    // Depth 1: every camera ray is tested once against every object
+    path_tracer_->set_max_depth(1);
+    const int width = 16, height = 12;
+    path_tracer_->trace(width, height);
+
+    FrameStats frame = path_tracer_->get_frame_stats();
+    const uint64_t primary = static_cast<uint64_t>(width) * height * 2;
+    EXPECT_EQ(frame.rays[RayCounter::PRIMARY_RAYS], primary);
+    EXPECT_EQ(frame.rays[RayCounter::SECONDARY_RAYS], 0u);
+    EXPECT_EQ(frame.rays[RayCounter::PATHS], primary);
+    EXPECT_DOUBLE_EQ(frame.rays.tests_per_ray(), static_cast<double>(scene_manager_->get_objects().size()));
+    EXPECT_EQ(frame.samples, primary);
+    EXPECT_GT(frame.mrays_per_second(), 0.0);
+}
+
+TEST_F(RayStatsTest, DeeperPathsAddSecondaryRays) {
+    path_tracer_->set_max_depth(1);
+    path_tracer_->trace(16, 12);
+    // Sky pixels end with no vertex, so a single bounce averages below one
+    double single_bounce = path_tracer_->get_frame_stats().rays.mean_path_length();
+    EXPECT_LT(single_bounce, 1.0);
+
+    path_tracer_->set_max_depth(4);
+    path_tracer_->trace(16, 12);
+
+    FrameStats frame = path_tracer_->get_frame_stats();
+    EXPECT_GT(frame.rays[RayCounter::SECONDARY_RAYS], 0u);
+    EXPECT_GT(frame.rays.mean_path_length(), single_bounce);
+    EXPECT_LE(frame.rays.mean_path_length(), 4.0);
+}
+
+TEST_F(RayStatsTest, PreviewCountsShadowRays) {
+    path_tracer_->set_max_depth(3);
+    path_tracer_->set_thread_count(4);
+    ASSERT_TRUE(path_tracer_->trace_preview(32, 24));
+
+    FrameStats frame = path_tracer_->get_frame_stats();
+    EXPECT_GT(frame.rays[RayCounter::SHADOW_RAYS], 0u);
+    EXPECT_GT(frame.rays[RayCounter::PRIMARY_RAYS], 0u);
+}
+
+TEST_F(RayStatsTest, ConcurrentTracersCountOnlyTheirOwnRays) {
+    path_tracer_->set_max_depth(1);
+    path_tracer_->set_thread_count(2);
+    PathTracer other;
+    other.set_scene_manager(scene_manager_);
+    other.set_camera(*scene_manager_->get_camera());
+    other.set_max_depth(1);
+    other.set_samples_per_pixel(4);
+    other.set_thread_count(2);
+
+    // The other tracer keeps counting on its own threads throughout
+    std::thread background([&other]() {
+        for (int i = 0; i < 5; ++i) {
+            other.trace(48, 32);
+        }
+    });
+    for (int i = 0; i < 5; ++i) {
+        path_tracer_->trace(16, 12);
+        EXPECT_EQ(path_tracer_->get_frame_stats().rays[RayCounter::PRIMARY_RAYS], 16u * 12u * 2u);
+    }
+    background.join();
+    EXPECT_EQ(other.get_frame_stats().rays[RayCounter::PRIMARY_RAYS], 48u * 32u * 4u);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <functional>
+#include <unistd.h>
+#include "render/render_cache.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/primitives.h"
+
+class RenderCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        config_.directory = testing::TempDir() + "render_cache_test_" + std::to_string(getpid());
+        std::filesystem::remove_all(config_.directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(config_.directory);
+    }
+
+    // Renders progressively and returns the final image; updates counts the callbacks.
+    // edit, if given, runs once after the first step.
+    std::vector<Color> render(const std::shared_ptr<RenderCache>& cache, int samples, uint64_t seed, int& updates,
+                              const std::function<void()>& edit = nullptr) {
+        PathTracer tracer;
+        tracer.set_scene_manager(scene_manager_);
+        tracer.set_camera(*scene_manager_->get_camera());
+        tracer.set_max_depth(3);
+        tracer.set_thread_count(2);
+        tracer.set_random_seed(seed);
+        tracer.set_render_cache(cache);
+        ProgressiveConfig config;
+        config.targetSamples = samples;
+        config.progressiveSteps = 3;
+        config.updateInterval = 0.0f;
+        updates = 0;
+        int final_samples = 0;
+        EXPECT_TRUE(tracer.trace_progressive(WIDTH, HEIGHT, config,
+                                             [&](const std::vector<Color>&, int, int, int current, int) {
+                                                 if (updates == 0 && edit) {
+                                                     edit();
+                                                 }
+                                                 ++updates;
+                                                 final_samples = current;
+                                             }));
+        EXPECT_EQ(final_samples, samples);
+        return tracer.get_image_data();
+    }
+
+    static AccumulationFile entry(uint32_t passes) {
+        AccumulationFile file;
+        file.header.width = 64;
+        file.header.height = 64;
+        file.header.seed = 3;
+        file.header.ranges = {SampleRange{0, passes}};
+        file.sums.assign(64 * 64, Color(1, 1, 1));
+        file.sample_counts.assign(64 * 64, passes);
+        return file;
+    }
+
+    static void expect_same_image(const std::vector<Color>& actual, const std::vector<Color>& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            ASSERT_EQ(actual[i].r, expected[i].r) << "pixel " << i;
+            ASSERT_EQ(actual[i].g, expected[i].g) << "pixel " << i;
+            ASSERT_EQ(actual[i].b, expected[i].b) << "pixel " << i;
+        }
+    }
+
+    static constexpr int WIDTH = 32;
+    static constexpr int HEIGHT = 20;
+    std::shared_ptr<SceneManager> scene_manager_;
+    RenderCache::Config config_;
+};
+
+TEST_F(RenderCacheTest, IdenticalRenderReturnsCachedImage) {
+    auto cache = std::make_shared<RenderCache>(config_);
+    ASSERT_TRUE(cache->open());
+    int updates = 0;
+    // A random seed is recorded with the entry and reused on a hit
+    const std::vector<Color> first = render(cache, 6, 0, updates);
+    EXPECT_EQ(updates, 3);
+    EXPECT_EQ(cache->stats().stores, 1u);
+
+    const std::vector<Color> second = render(cache, 6, 0, updates);
+    EXPECT_EQ(updates, 1);
+    EXPECT_EQ(cache->stats().hits, 1u);
+    expect_same_image(second, first);
+
+    // Anything the image depends on changes the key
+    scene_manager_->add_light(Vector3(0, 3, 0), Color(1, 1, 1), 2.0f);
+    render(cache, 6, 0, updates);
+    EXPECT_EQ(updates, 3);
+    EXPECT_EQ(cache->stats().misses, 2u);
+    EXPECT_EQ(cache->stats().entries, 2u);
+}
+
+TEST_F(RenderCacheTest, RenderEditedMidwayIsNotStored) {
+    auto cache = std::make_shared<RenderCache>(config_);
+    ASSERT_TRUE(cache->open());
+    auto marble = std::make_shared<Sphere>(Vector3(0.5f, 0.3f, 0.0f), 0.2f, Color(0.9f, 0.2f, 0.2f),
+                                           Material(Color(0.9f, 0.2f, 0.2f)));
+    scene_manager_->add_object(marble);
+    const PrimitiveID marble_id =
+        scene_manager_->get_object_id(static_cast<int>(scene_manager_->get_objects().size()) - 1);
+    const Vector3 start = marble->position();
+
+    // Edit invalidation is off by default, so the edit resets no tiles
+    int updates = 0;
+    render(cache, 6, 5, updates, [&] { ASSERT_TRUE(scene_manager_->move_object(marble_id, Vector3(-0.5f, 0.3f, 0.0f))); });
+    EXPECT_EQ(cache->stats().stores, 0u);
+
+    // The original scene must render from scratch, not from the mixed passes
+    ASSERT_TRUE(scene_manager_->move_object(marble_id, start));
+    render(cache, 6, 5, updates);
+    EXPECT_EQ(updates, 3);
+    EXPECT_EQ(cache->stats().hits, 0u);
+    EXPECT_EQ(cache->stats().misses, 2u);
+    EXPECT_EQ(cache->stats().stores, 1u);
+}
+
+TEST_F(RenderCacheTest, MoreSamplesResumeFromCachedAccumulation) {
+    int updates = 0;
+    const std::vector<Color> uncached = render(nullptr, 8, 17, updates);
+
+    auto cache = std::make_shared<RenderCache>(config_);
+    ASSERT_TRUE(cache->open());
+    render(cache, 4, 17, updates);
+    const std::vector<Color> resumed = render(cache, 8, 17, updates);
+    EXPECT_EQ(cache->stats().partial_hits, 1u);
+    expect_same_image(resumed, uncached);
+
+    // A cache opened later finds the longer entry; fewer samples cannot use it
+    RenderCache reopened(config_);
+    ASSERT_TRUE(reopened.open());
+    EXPECT_EQ(reopened.stats().entries, 1u);
+    render(std::shared_ptr<RenderCache>(&reopened, [](RenderCache*) {}), 4, 17, updates);
+    EXPECT_EQ(reopened.stats().misses, 1u);
+}
+
+TEST_F(RenderCacheTest, EvictsLeastRecentlyUsed) {
+    RenderCache probe(config_);
+    ASSERT_TRUE(probe.open());
+    ASSERT_TRUE(probe.store(1, entry(2)));
+    const uint64_t entry_bytes = probe.stats().bytes;
+    probe.clear();
+
+    config_.max_bytes = 1;
+    RenderCache tiny(config_);
+    ASSERT_TRUE(tiny.open());
+    EXPECT_FALSE(tiny.store(1, entry(2)));      // Larger than the whole cache
+    EXPECT_EQ(tiny.stats().entries, 0u);
+
+    config_.max_bytes = entry_bytes * 2 + entry_bytes / 2;      // Room for two entries
+    RenderCache cache(config_);
+    ASSERT_TRUE(cache.open());
+    ASSERT_TRUE(cache.store(1, entry(2)));
+    ASSERT_TRUE(cache.store(2, entry(2)));
+    AccumulationFile found;
+    ASSERT_TRUE(cache.lookup(1, 2, false, found));
+    ASSERT_TRUE(cache.store(3, entry(2)));
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_TRUE(cache.lookup(1, 2, false, found));
+    EXPECT_FALSE(cache.lookup(2, 2, false, found));
+    EXPECT_TRUE(cache.lookup(3, 4, false, found));
+    EXPECT_FALSE(cache.lookup(3, 2, true, found));      // No moments stored
+    EXPECT_FALSE(cache.lookup(3, 1, false, found));     // More passes than asked for
+
+    // Keys are stable and depend on what the image depends on
+    AccumulationHeader identity = entry(1).header;
+    const uint64_t key = render_cache_key(identity, 32);
+    EXPECT_EQ(render_cache_key(identity, 32), key);
+    EXPECT_NE(render_cache_key(identity, 16), key);
+    identity.camera_fov += 1.0f;
+    EXPECT_NE(render_cache_key(identity, 32), key);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include "render/render_checkpoint.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+
+class RenderCheckpointTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        filename_ = testing::TempDir() + "render_checkpoint_test.ckpt";
+        std::remove(filename_.c_str());
+
+        config_.initialSamples = 1;
+        config_.targetSamples = 8;
+        config_.progressiveSteps = 4;
+        config_.updateInterval = 0.0f;
+    }
+
+    void TearDown() override {
+        std::remove(filename_.c_str());
+    }
+
+    std::unique_ptr<PathTracer> make_tracer(int threads) {
+        auto tracer = std::make_unique<PathTracer>();
+        tracer->set_scene_manager(scene_manager_);
+        tracer->set_camera(*scene_manager_->get_camera());
+        tracer->set_max_depth(3);
+        tracer->set_thread_count(threads);
+        tracer->set_random_seed(1234);
+        tracer->set_denoising(true);
+        return tracer;
+    }
+
+    static constexpr int WIDTH = 40;
+    static constexpr int HEIGHT = 24;
+    std::shared_ptr<SceneManager> scene_manager_;
+    std::string filename_;
+    ProgressiveConfig config_;
+};
+
+TEST_F(RenderCheckpointTest, SaveLoadRoundTrip) {
+    RenderCheckpoint checkpoint;
+    checkpoint.width = 3;
+    checkpoint.height = 2;
+    checkpoint.tile_size = 16;
+    checkpoint.max_depth = 4;
+    checkpoint.config = config_;
+    checkpoint.seed = 0x0123456789abcdefull;
+    checkpoint.step = 2;
+    checkpoint.step_samples = 3;
+    checkpoint.step_start_samples = 5;
+    checkpoint.camera_position = Vector3(1, 2, 3);
+    checkpoint.camera_fov = 45.0f;
+    checkpoint.scene_hash = scene_manager_->content_hash();
+    for (int i = 0; i < 6; ++i) {
+        checkpoint.accumulation.push_back(Color(0.5f * i, 0.25f, 1.0f + i));
+        checkpoint.sample_counts.push_back(i < 4 ? 6 : 5);
+    }
+    ASSERT_TRUE(checkpoint.save(filename_));
+
+    RenderCheckpoint loaded;
+    ASSERT_TRUE(RenderCheckpoint::load(filename_, loaded));
+    EXPECT_TRUE(loaded.same_render(checkpoint));
+    EXPECT_EQ(loaded.seed, checkpoint.seed);
+    EXPECT_EQ(loaded.step, 2);
+    EXPECT_EQ(loaded.step_start_samples, 5);
+    EXPECT_EQ(loaded.config.targetSamples, config_.targetSamples);
+    EXPECT_EQ(loaded.sample_counts, checkpoint.sample_counts);
+    EXPECT_EQ(loaded.min_samples(), 5u);
+    EXPECT_FLOAT_EQ(loaded.accumulation[5].b, 6.0f);
+    EXPECT_TRUE(loaded.luminance_sum.empty());
+
+    // A flipped byte fails the checksum
+    {
+        std::fstream file(filename_, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(40);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(RenderCheckpoint::load(filename_, loaded));
+}
+
+TEST_F(RenderCheckpointTest, SceneHashFollowsContent) {
+    uint64_t before = scene_manager_->content_hash();
+    EXPECT_EQ(before, scene_manager_->content_hash());
+    scene_manager_->add_light(Vector3(0, 4, 0), Color(1, 1, 1), 2.0f);
+    EXPECT_NE(before, scene_manager_->content_hash());
+}
+
+TEST_F(RenderCheckpointTest, ResumedRenderMatchesUninterrupted) {
+    auto reference_tracer = make_tracer(2);
+    auto ignore = [](const std::vector<Color>&, int, int, int, int) {};
+    ASSERT_TRUE(reference_tracer->trace_progressive(WIDTH, HEIGHT, config_, ignore));
+    const std::vector<Color> reference = reference_tracer->get_image_data();
+
+    // Stop after the second step; the stop writes a checkpoint
+    auto interrupted = make_tracer(3);
+    interrupted->set_checkpointing(filename_, std::chrono::seconds(3600));
+    int steps = 0;
+    EXPECT_FALSE(interrupted->trace_progressive(WIDTH, HEIGHT, config_,
+        [&](const std::vector<Color>&, int, int, int, int) {
+            if (++steps == 2) {
+                interrupted->request_stop();
+            }
+        }));
+    interrupted->wait_for_checkpoints();
+
+    auto checkpoint = std::make_unique<RenderCheckpoint>();
+    ASSERT_TRUE(RenderCheckpoint::load(filename_, *checkpoint));
+    EXPECT_EQ(checkpoint->step, 2);
+    EXPECT_LT(checkpoint->min_samples(), 8u);
+    EXPECT_FALSE(checkpoint->luminance_sum.empty());
+
+    // A different thread count and a default config: the checkpoint supplies the schedule
+    auto resumed = make_tracer(1);
+    resumed->set_resume_checkpoint(std::move(checkpoint));
+    int final_samples = 0;
+    ASSERT_TRUE(resumed->trace_progressive(WIDTH, HEIGHT, ProgressiveConfig(),
+        [&](const std::vector<Color>&, int, int, int samples, int) { final_samples = samples; }));
+    EXPECT_EQ(final_samples, 8);
+
+    const std::vector<Color>& image = resumed->get_image_data();
+    ASSERT_EQ(image.size(), reference.size());
+    for (size_t i = 0; i < image.size(); ++i) {
+        ASSERT_FLOAT_EQ(image[i].r, reference[i].r) << "pixel " << i;
+        ASSERT_FLOAT_EQ(image[i].g, reference[i].g) << "pixel " << i;
+        ASSERT_FLOAT_EQ(image[i].b, reference[i].b) << "pixel " << i;
+    }
+}
+
+TEST_F(RenderCheckpointTest, MismatchedCheckpointStartsOver) {
+    auto tracer = make_tracer(2);
+    tracer->set_checkpointing(filename_, std::chrono::seconds(3600));
+    tracer->request_stop();
+    tracer->trace_progressive(WIDTH, HEIGHT, config_, [](const std::vector<Color>&, int, int, int, int) {});
+    tracer->wait_for_checkpoints();
+
+    auto checkpoint = std::make_unique<RenderCheckpoint>();
+    ASSERT_TRUE(RenderCheckpoint::load(filename_, *checkpoint));
+    checkpoint->camera_position = Vector3(9, 9, 9);
+    checkpoint->accumulation.assign(checkpoint->accumulation.size(), Color(100, 100, 100));
+
+    auto resumed = make_tracer(2);
+    resumed->set_resume_checkpoint(std::move(checkpoint));
+    int calls = 0;
+    ASSERT_TRUE(resumed->trace_progressive(WIDTH, HEIGHT, config_,
+        [&](const std::vector<Color>&, int, int, int, int) { ++calls; }));
+    EXPECT_EQ(calls, config_.progressiveSteps);
+    EXPECT_LT(resumed->get_image_data()[0].r, 10.0f);
+}
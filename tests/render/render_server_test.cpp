@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <unistd.h>
+#include "render/render_server.h"
+#include "render/accumulation_file.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+
+class RenderServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        Camera camera = *scene_manager_->get_camera();
+        request_.width = WIDTH;
+        request_.height = HEIGHT;
+        request_.samples_per_pixel = 3;
+        request_.max_depth = 3;
+        request_.tile_size = 8;
+        request_.update_interval_ms = 0;
+        request_.seed = 31;
+        request_.camera_position = camera.get_position();
+        request_.camera_target = camera.get_target();
+        request_.camera_up = camera.get_up();
+        request_.camera_fov = camera.get_fov();
+
+        config_.socket_path = testing::TempDir() + "render_server_test_" + std::to_string(getpid()) + ".sock";
+        config_.render_threads = 2;
+    }
+
+    // What the streamed image of request_ must end up as
+    std::vector<uint8_t> reference() {
+        PathTracer tracer;
+        tracer.set_scene_manager(scene_manager_);
+        tracer.set_camera(Camera(request_.camera_position, request_.camera_target, request_.camera_up,
+                                 request_.camera_fov, float(WIDTH) / float(HEIGHT)));
+        tracer.set_max_depth(request_.max_depth);
+        tracer.set_random_seed(request_.seed);
+        std::vector<Color> sums(WIDTH * HEIGHT);
+        for (int pass = 0; pass < request_.samples_per_pixel; ++pass) {
+            AccumulationFile file;
+            EXPECT_TRUE(tracer.trace_sample_range(WIDTH, HEIGHT, pass, 1, false, file));
+            for (size_t i = 0; i < sums.size(); ++i) {
+                sums[i].r += file.sums[i].r;
+                sums[i].g += file.sums[i].g;
+                sums[i].b += file.sums[i].b;
+            }
+        }
+        std::vector<uint8_t> image;
+        const float inverse = 1.0f / request_.samples_per_pixel;
+        for (const Color& sum : sums) {
+            for (float value : {sum.r, sum.g, sum.b}) {
+                image.push_back(static_cast<uint8_t>(std::min(1.0f, std::sqrt(std::max(0.0f, value * inverse))) * 255.0f + 0.5f));
+            }
+        }
+        return image;
+    }
+
+    static constexpr int WIDTH = 40;
+    static constexpr int HEIGHT = 24;
+    std::shared_ptr<SceneManager> scene_manager_;
+    RenderJobRequest request_;
+    RenderServer::Config config_;
+};
+
+TEST_F(RenderServerTest, TileDeltaRoundTrip) {
+    std::mt19937 random(5);
+    std::vector<uint8_t> previous(8 * 8 * 3);
+    for (uint8_t& byte : previous) {
+        byte = static_cast<uint8_t>(random());
+    }
+    // A few changed pixels code far smaller than the tile
+    std::vector<uint8_t> current = previous;
+    current[7] ^= 0x11;
+    current[100] += 3;
+    current[101] += 1;
+    std::string encoded;
+    EXPECT_EQ(encode_tile_delta(previous.data(), current.data(), current.size(), encoded), TileEncoding::XOR_RLE);
+    EXPECT_LT(encoded.size(), 16u);
+    std::vector<uint8_t> decoded = previous;
+    ASSERT_TRUE(decode_tile_delta(TileEncoding::XOR_RLE, encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+    EXPECT_EQ(decoded, current);
+
+    // Noise falls back to raw bytes
+    for (uint8_t& byte : current) {
+        byte = static_cast<uint8_t>(random());
+    }
+    EXPECT_EQ(encode_tile_delta(previous.data(), current.data(), current.size(), encoded), TileEncoding::RAW);
+    decoded = previous;
+    ASSERT_TRUE(decode_tile_delta(TileEncoding::RAW, encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+    EXPECT_EQ(decoded, current);
+
+    // Runs past the end of the tile are rejected
+    const char overrun[] = {static_cast<char>(0xff), static_cast<char>(0xff)};
+    EXPECT_FALSE(decode_tile_delta(TileEncoding::XOR_RLE, overrun, sizeof(overrun), decoded.data(), decoded.size()));
+}
+
+TEST_F(RenderServerTest, StreamsProgressiveTilesOfJob) {
+    RenderServer server(config_);
+    ASSERT_TRUE(server.start());
+    RenderClient client;
+    ASSERT_TRUE(client.connect(config_.socket_path));
+
+    std::string error;
+    const uint64_t job = client.submit(request_, scene_manager_.get(), &error);
+    ASSERT_NE(job, 0u) << error;
+    std::vector<uint32_t> samples;
+    RenderClient::Update update;
+    while (client.next_update(update) && !update.done) {
+        EXPECT_EQ(update.job_id, job);
+        EXPECT_EQ(update.target_samples, 3u);
+        samples.push_back(update.samples);
+    }
+    ASSERT_TRUE(update.done);
+    EXPECT_EQ(update.status, RenderJobStatus::COMPLETED);
+    EXPECT_EQ(update.samples, 3u);
+    ASSERT_FALSE(samples.empty());
+    EXPECT_EQ(samples.back(), 3u);
+    EXPECT_EQ(client.image(job), reference());
+
+    RenderJobRequest invalid = request_;
+    invalid.width = 0;
+    EXPECT_EQ(client.submit(invalid, nullptr, &error), 0u);
+    EXPECT_NE(error.find("image size"), std::string::npos);
+    server.stop();
+    EXPECT_EQ(server.completed_jobs(), 1u);
+}
+
+TEST_F(RenderServerTest, HigherPriorityJobFinishesFirst) {
+    config_.render_threads = 1;
+    RenderServer server(config_);
+    ASSERT_TRUE(server.start());
+    RenderClient client;
+    ASSERT_TRUE(client.connect(config_.socket_path));
+
+    RenderJobRequest background = request_;
+    background.samples_per_pixel = 50000;
+    const uint64_t slow = client.submit(background, nullptr);
+    RenderJobRequest urgent = request_;
+    urgent.priority = 5;
+    const uint64_t fast = client.submit(urgent, nullptr);
+    ASSERT_NE(slow, 0u);
+    ASSERT_NE(fast, 0u);
+
+    RenderClient::Update update;
+    while (client.next_update(update) && !update.done) {
+    }
+    EXPECT_EQ(update.job_id, fast);
+    EXPECT_EQ(update.status, RenderJobStatus::COMPLETED);
+
+    // Cancelling the background job ends it early
+    ASSERT_TRUE(client.cancel(slow));
+    while (client.next_update(update) && !update.done) {
+    }
+    EXPECT_EQ(update.job_id, slow);
+    EXPECT_EQ(update.status, RenderJobStatus::CANCELLED);
+    EXPECT_LT(update.samples, 50000u);
+    EXPECT_EQ(server.job_count(), 0u);
+}
+
+TEST_F(RenderServerTest, DisconnectCancelsJobs) {
+    RenderServer server(config_);
+    ASSERT_TRUE(server.start());
+    {
+        RenderClient client;
+        ASSERT_TRUE(client.connect(config_.socket_path));
+        RenderJobRequest endless = request_;
+        endless.samples_per_pixel = 50000;
+        ASSERT_NE(client.submit(endless, nullptr), 0u);
+        EXPECT_EQ(server.job_count(), 1u);
+    }
+    for (int i = 0; i < 200 && server.job_count() > 0; ++i) {
+        usleep(10000);
+    }
+    EXPECT_EQ(server.job_count(), 0u);
+    EXPECT_EQ(server.completed_jobs(), 0u);
+}
+
+TEST_F(RenderServerTest, OversizedRequestsAreRejected) {
+    RenderServer server(config_);
+    ASSERT_TRUE(server.start());
+    RenderClient client;
+    ASSERT_TRUE(client.connect(config_.socket_path));
+
+    // A deep enough path overflows the render thread's stack
+    RenderJobRequest deep = request_;
+    deep.max_depth = config_.max_depth + 1;
+    std::string error;
+    EXPECT_EQ(client.submit(deep, nullptr, &error), 0u);
+    EXPECT_EQ(error, "invalid depth");
+
+    RenderJobRequest huge_tiles = request_;
+    huge_tiles.tile_size = std::numeric_limits<int>::max();
+    EXPECT_EQ(client.submit(huge_tiles, nullptr, &error), 0u);
+    EXPECT_EQ(error, "invalid tile size");
+    EXPECT_EQ(server.job_count(), 0u);
+
+    // The server keeps serving after rejecting them
+    EXPECT_NE(client.submit(request_, nullptr, &error), 0u);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include "core/resource_monitor.h"
+#include "render/tile_scheduler.h"
+
+namespace {
+
+// Burns CPU for roughly the given wall time; the result keeps the loop alive
+double spin(std::chrono::milliseconds duration) {
+    double sum = 0.0;
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+        for (int i = 1; i < 1000; ++i) {
+            sum += std::sqrt(static_cast<double>(i));
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+class ResourceMonitorTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        resource_monitor_stop();
+    }
+};
+
+TEST_F(ResourceMonitorTest, TrackedVectorBooksAllocations) {
+    const MemorySubsystem subsystem = MemorySubsystem::FRAME_BUFFERS;
+    MemoryUsage before = memory_usage(subsystem);
+    {
+        TrackedVector<float, MemorySubsystem::FRAME_BUFFERS> buffer(1 << 16);
+        MemoryUsage during = memory_usage(subsystem);
+        EXPECT_EQ(during.current_bytes - before.current_bytes, static_cast<int64_t>(sizeof(float) << 16));
+        EXPECT_GE(during.peak_bytes, during.current_bytes);
+        EXPECT_GT(during.allocations, before.allocations);
+    }
+    MemoryUsage after = memory_usage(subsystem);
+    EXPECT_EQ(after.current_bytes, before.current_bytes);
+    EXPECT_GE(after.peak_bytes, before.current_bytes + static_cast<int64_t>(sizeof(float) << 16));
+}
+
+TEST_F(ResourceMonitorTest, ProcessCountersAreMeasured) {
+    ProcessMemory memory = process_memory();
+    EXPECT_GT(memory.rss_mb, 0.0);
+    EXPECT_GE(memory.peak_rss_mb, memory.rss_mb);
+
+    double process_before = process_cpu_seconds();
+    double thread_before = thread_cpu_seconds();
+    spin(std::chrono::milliseconds(30));
+    EXPECT_GT(process_cpu_seconds(), process_before);
+    EXPECT_GT(thread_cpu_seconds(), thread_before);
+}
+
+TEST_F(ResourceMonitorTest, SamplerReportsRegisteredThreads) {
+    ResourceThreadScope scope("test main");
+    resource_monitor_start(std::chrono::milliseconds(5));
+    EXPECT_TRUE(resource_monitor_running());
+    spin(std::chrono::milliseconds(50));
+
+    ResourceSample sample = resource_monitor_latest();
+    EXPECT_GT(sample.process_cpu_seconds, 0.0);
+    EXPECT_GT(sample.memory.rss_mb, 0.0);
+    bool found = false;
+    for (const auto& thread : sample.threads) {
+        if (thread.name == "test main") {
+            found = true;
+            EXPECT_GT(thread.cpu_seconds, 0.0);
+        }
+    }
+    EXPECT_TRUE(found);
+    EXPECT_GE(resource_monitor_history().size(), 2u);
+
+    std::ostringstream report;
+    resource_report(report);
+    EXPECT_NE(report.str().find("frame_buffers"), std::string::npos);
+
+    resource_monitor_stop();
+    EXPECT_FALSE(resource_monitor_running());
+}
+
+TEST_F(ResourceMonitorTest, TileRunStatsIncludeWorkerCpuTime) {
+    TileScheduler scheduler(2, 16);
+    scheduler.run(64, 32, [](const RenderTile&, int) {
+        spin(std::chrono::milliseconds(2));
+    });
+
+    const TileRunStats& stats = scheduler.last_run_stats();
+    ASSERT_EQ(stats.thread_cpu_seconds.size(), stats.thread_busy_seconds.size());
+    double cpu = 0.0;
+    for (double seconds : stats.thread_cpu_seconds) {
+        cpu += seconds;
+    }
+    EXPECT_GT(cpu, 0.0);
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include "render/shared_framebuffer.h"
+
+class SharedFramebufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config_.name = "/shared_framebuffer_test_" + std::to_string(getpid());
+        config_.max_width = 16;
+        config_.max_height = 8;
+        config_.slots = 3;
+    }
+
+    static std::vector<Color> solid(int width, int height, float value) {
+        return std::vector<Color>(static_cast<size_t>(width) * height, Color(value, value * 0.5f, 1.0f));
+    }
+
+    SharedFramebuffer::Config config_;
+};
+
+TEST_F(SharedFramebufferTest, PublishedFrameIsReadable) {
+    SharedFramebuffer framebuffer;
+    ASSERT_TRUE(framebuffer.create(config_));
+    SharedFramebufferReader reader;
+    ASSERT_TRUE(reader.open(config_.name));
+    SharedFrameView view;
+    EXPECT_EQ(reader.latest_frame(), 0u);
+    EXPECT_FALSE(reader.acquire(view));
+
+    std::vector<Color> display = solid(8, 4, 0.5f);
+    display[5] = Color(2.0f, -1.0f, 0.25f);
+    // Radiance is published as given, not derived from the display pixels
+    std::vector<Color> radiance = solid(8, 4, 3.0f);
+    radiance[5] = Color(0.1f, 0.2f, 7.5f);
+    ASSERT_TRUE(framebuffer.publish(display, 8, 4, 12, 64, &radiance));
+    std::vector<uint8_t> rgba;
+    std::vector<float> linear;
+    ASSERT_TRUE(reader.read(view, rgba, linear));
+    EXPECT_EQ(view.frame, 1u);
+    EXPECT_EQ(view.width, 8);
+    EXPECT_EQ(view.height, 4);
+    EXPECT_EQ(view.samples, 12);
+    EXPECT_EQ(view.target_samples, 64);
+    EXPECT_EQ(view.format, SHARED_FRAME_DISPLAY_RGBA8 | SHARED_FRAME_LINEAR_RGB32F);
+    ASSERT_EQ(rgba.size(), 8u * 4u * 4u);
+    ASSERT_EQ(linear.size(), 8u * 4u * 3u);
+    EXPECT_EQ(rgba[0], 128);
+    EXPECT_EQ(rgba[1], 64);
+    EXPECT_EQ(rgba[3], 255);
+    EXPECT_EQ(rgba[5 * 4 + 0], 255);
+    EXPECT_EQ(rgba[5 * 4 + 1], 0);
+    EXPECT_FLOAT_EQ(linear[0], 3.0f);
+    EXPECT_FLOAT_EQ(linear[1], 1.5f);
+    EXPECT_FLOAT_EQ(linear[5 * 3 + 2], 7.5f);
+
+    // Without radiance the frame carries display pixels only
+    ASSERT_TRUE(framebuffer.publish(display, 8, 4, 12, 64));
+    ASSERT_TRUE(reader.read(view, rgba, linear));
+    EXPECT_EQ(view.frame, 2u);
+    EXPECT_EQ(view.format, SHARED_FRAME_DISPLAY_RGBA8);
+    EXPECT_EQ(view.linear, nullptr);
+    EXPECT_TRUE(linear.empty());
+    EXPECT_EQ(rgba[0], 128);
+
+    // Frames beyond the configured size are skipped
+    EXPECT_FALSE(framebuffer.publish(solid(32, 4, 0.1f), 32, 4, 1, 1));
+    EXPECT_EQ(reader.latest_frame(), 2u);
+}
+
+TEST_F(SharedFramebufferTest, AcquiredFrameSurvivesUntilItsSlotIsReused) {
+    SharedFramebuffer framebuffer;
+    ASSERT_TRUE(framebuffer.create(config_));
+    SharedFramebufferReader reader;
+    ASSERT_TRUE(reader.open(config_.name));
+
+    ASSERT_TRUE(framebuffer.publish(solid(4, 4, 0.2f), 4, 4, 1, 4));
+    SharedFrameView view;
+    ASSERT_TRUE(reader.acquire(view));
+    EXPECT_EQ(view.frame, 1u);
+    EXPECT_EQ(view.display[0], 51);
+
+    ASSERT_TRUE(framebuffer.publish(solid(4, 4, 0.4f), 4, 4, 2, 4));
+    ASSERT_TRUE(framebuffer.publish(solid(4, 4, 0.6f), 4, 4, 3, 4));
+    EXPECT_TRUE(reader.validate(view));
+    EXPECT_EQ(view.display[0], 51);
+    ASSERT_TRUE(framebuffer.publish(solid(4, 4, 0.8f), 4, 4, 4, 4));
+    EXPECT_FALSE(reader.validate(view));
+
+    ASSERT_TRUE(reader.acquire(view));
+    EXPECT_EQ(view.frame, 4u);
+    EXPECT_EQ(view.samples, 4);
+}
+
+TEST_F(SharedFramebufferTest, ReadersNeverSeeTornFrames) {
+    SharedFramebuffer framebuffer;
+    ASSERT_TRUE(framebuffer.create(config_));
+    const std::vector<Color> first = solid(16, 8, 0.0f);
+    ASSERT_TRUE(framebuffer.publish(first, 16, 8, 0, 0, &first));
+
+    // Another process reads while this one publishes; every frame must be a single value throughout
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 1; !done; ++i) {
+            const std::vector<Color> frame = solid(16, 8, float(i % 256) / 255.0f);
+            framebuffer.publish(frame, 16, 8, i, 0, &frame);
+        }
+    });
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        SharedFramebufferReader reader;
+        if (!reader.open(config_.name)) {
+            _exit(2);
+        }
+        SharedFrameView view;
+        std::vector<uint8_t> rgba;
+        std::vector<float> linear;
+        int frames = 0;
+        for (int i = 0; i < 2000; ++i) {
+            if (!reader.read(view, rgba, linear)) {
+                continue;
+            }
+            ++frames;
+            if (linear.size() * 4 != rgba.size() * 3) {
+                _exit(4);
+            }
+            for (size_t p = 0; p < rgba.size(); p += 4) {
+                if (rgba[p] != rgba[0] || linear[p / 4 * 3] != linear[0]) {
+                    _exit(1);
+                }
+            }
+        }
+        _exit(frames > 0 ? 0 : 3);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    done = true;
+    writer.join();
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_GT(framebuffer.frames_published(), 1u);
+}
+
+TEST_F(SharedFramebufferTest, RejectsBadNamesAndMissingSegments) {
+    SharedFramebuffer framebuffer;
+    config_.name = "no_leading_slash";
+    EXPECT_FALSE(framebuffer.create(config_));
+    EXPECT_FALSE(framebuffer.publish(solid(2, 2, 0.5f), 2, 2, 1, 1));
+
+    SharedFramebufferReader reader;
+    EXPECT_FALSE(reader.open("/shared_framebuffer_test_missing"));
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <signal.h>
+#include <cmath>
+#include "render/tile_distributor.h"
+#include "render/path_tracer.h"
+#include "core/scene_manager.h"
+#include "core/camera.h"
+
+// Workers are spawned from the distributed_render tool, built next to the tests
+#ifndef DISTRIBUTED_RENDER_EXECUTABLE
+#define DISTRIBUTED_RENDER_EXECUTABLE "./distributed_render"
+#endif
+
+class TileDistributorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene_manager_ = std::make_shared<SceneManager>();
+        scene_manager_->initialize();
+        Camera camera = *scene_manager_->get_camera();
+        frame_.width = WIDTH;
+        frame_.height = HEIGHT;
+        frame_.samples_per_pixel = 2;
+        frame_.max_depth = 3;
+        frame_.tile_size = 8;
+        frame_.seed = 4242;
+        frame_.camera_position = camera.get_position();
+        frame_.camera_target = camera.get_target();
+        frame_.camera_up = camera.get_up();
+        frame_.camera_fov = camera.get_fov();
+        frame_.camera_aspect = float(WIDTH) / float(HEIGHT);
+
+        config_.workers = 3;
+        config_.min_straggler_time = std::chrono::milliseconds(30);
+        config_.worker_executable = DISTRIBUTED_RENDER_EXECUTABLE;
+    }
+
+    // The same frame rendered by PathTracer::trace() in this process
+    std::vector<Color> reference() {
+        PathTracer tracer;
+        tracer.set_scene_manager(scene_manager_);
+        tracer.set_camera(Camera(frame_.camera_position, frame_.camera_target, frame_.camera_up,
+                                 frame_.camera_fov, frame_.camera_aspect));
+        tracer.set_max_depth(frame_.max_depth);
+        tracer.set_samples_per_pixel(frame_.samples_per_pixel);
+        tracer.set_random_seed(frame_.seed);
+        std::vector<Color> image(WIDTH * HEIGHT);
+        TileScheduler layout(1, frame_.tile_size);
+        std::vector<Color> pixels;
+        for (const RenderTile& tile : layout.make_tiles(WIDTH, HEIGHT)) {
+            tracer.trace_tile(WIDTH, HEIGHT, tile, pixels);
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) {
+                    image[y * WIDTH + x] = pixels[(y - tile.y0) * tile.width() + (x - tile.x0)];
+                }
+            }
+        }
+        return image;
+    }
+
+    static void expect_same_image(const std::vector<Color>& actual, const std::vector<Color>& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            ASSERT_EQ(actual[i].r, expected[i].r) << "pixel " << i;
+            ASSERT_EQ(actual[i].g, expected[i].g) << "pixel " << i;
+            ASSERT_EQ(actual[i].b, expected[i].b) << "pixel " << i;
+        }
+    }
+
+    static constexpr int WIDTH = 64;
+    static constexpr int HEIGHT = 40;
+    std::shared_ptr<SceneManager> scene_manager_;
+    DistributedFrame frame_;
+    TileDistributor::Config config_;
+};
+
+TEST_F(TileDistributorTest, SceneSurvivesSerialization) {
+    scene_manager_->add_object(std::make_shared<Torus>(Vector3(0, 1, -3), 0.6f, 0.2f, Color(0.2f, 0.4f, 0.6f),
+                                                       Material(Color(0.9f, 0.1f, 0.1f), 0.3f, 0.7f)));
+    SceneManager copy;
+    ASSERT_TRUE(copy.deserialize(scene_manager_->serialize()));
+    EXPECT_EQ(copy.content_hash(), scene_manager_->content_hash());
+    EXPECT_EQ(copy.get_objects().size(), scene_manager_->get_objects().size());
+    EXPECT_EQ(copy.get_lights().size(), scene_manager_->get_lights().size());
+
+    std::string truncated = scene_manager_->serialize();
+    truncated.pop_back();
+    EXPECT_FALSE(copy.deserialize(truncated));
+    EXPECT_EQ(copy.content_hash(), scene_manager_->content_hash());
+}
+
+TEST_F(TileDistributorTest, MatchesSingleProcessRender) {
+    // trace() is trace_tile() per tile of its own layout, plus gamma
+    frame_.tile_size = TileScheduler::DEFAULT_TILE_SIZE;
+    PathTracer tracer;
+    tracer.set_scene_manager(scene_manager_);
+    tracer.set_camera(Camera(frame_.camera_position, frame_.camera_target, frame_.camera_up,
+                             frame_.camera_fov, frame_.camera_aspect));
+    tracer.set_max_depth(frame_.max_depth);
+    tracer.set_samples_per_pixel(frame_.samples_per_pixel);
+    tracer.set_random_seed(frame_.seed);
+    tracer.trace(WIDTH, HEIGHT);
+
+    TileDistributor distributor(config_);
+    ASSERT_TRUE(distributor.start(*scene_manager_));
+    EXPECT_EQ(distributor.worker_count(), 3);
+    int callbacks = 0;
+    std::vector<Color> image;
+    ASSERT_TRUE(distributor.render(frame_, image, [&](const RenderTile&, const std::vector<Color>&) { ++callbacks; }));
+    EXPECT_EQ(callbacks, 4);
+    EXPECT_EQ(distributor.last_stats().tiles, 4u);
+
+    const std::vector<Color>& traced = tracer.get_image_data();
+    ASSERT_EQ(image.size(), traced.size());
+    for (size_t i = 0; i < image.size(); ++i) {
+        ASSERT_EQ(std::sqrt(image[i].r), traced[i].r) << "pixel " << i;
+        ASSERT_EQ(std::sqrt(image[i].g), traced[i].g) << "pixel " << i;
+    }
+
+    // A scene edit reaches the workers
+    frame_.tile_size = 8;
+    scene_manager_->add_light(Vector3(0, 3, -1), Color(1, 0.5f, 0.5f), 4.0f);
+    ASSERT_TRUE(distributor.set_scene(*scene_manager_));
+    ASSERT_TRUE(distributor.render(frame_, image));
+    expect_same_image(image, reference());
+}
+
+TEST_F(TileDistributorTest, ReplacesKilledWorker) {
+    TileDistributor distributor(config_);
+    ASSERT_TRUE(distributor.start(*scene_manager_));
+    const int victim = distributor.worker_pids()[0];
+    bool killed = false;
+    std::vector<Color> image;
+    ASSERT_TRUE(distributor.render(frame_, image, [&](const RenderTile&, const std::vector<Color>&) {
+        if (!killed) {
+            kill(victim, SIGKILL);
+            killed = true;
+        }
+    }));
+    EXPECT_EQ(distributor.last_stats().worker_restarts, 1u);
+    EXPECT_EQ(distributor.worker_count(), 3);
+    EXPECT_NE(distributor.worker_pids()[0], victim);
+    expect_same_image(image, reference());
+}
+
+TEST_F(TileDistributorTest, StragglerTilesGoToIdleWorkers) {
+    TileDistributor distributor(config_);
+    ASSERT_TRUE(distributor.start(*scene_manager_));
+    const int straggler = distributor.worker_pids()[1];
+    bool stopped = false;
+    std::vector<Color> image;
+    ASSERT_TRUE(distributor.render(frame_, image, [&](const RenderTile&, const std::vector<Color>&) {
+        if (!stopped) {
+            kill(straggler, SIGSTOP);
+            stopped = true;
+        }
+    }));
+    kill(straggler, SIGCONT);
+    EXPECT_GT(distributor.last_stats().speculative_tiles, 0u);
+    EXPECT_EQ(distributor.last_stats().worker_restarts, 0u);
+    expect_same_image(image, reference());
+}
+
+TEST_F(TileDistributorTest, QueuedTilesAreNotStragglers) {
+    // Each worker holds half the frame; its last tiles wait far longer than a tile takes
+    config_.workers = 2;
+    config_.tiles_in_flight = 20;
+    frame_.samples_per_pixel = 16;
+    TileDistributor distributor(config_);
+    ASSERT_TRUE(distributor.start(*scene_manager_));
+    std::vector<Color> image;
+    ASSERT_TRUE(distributor.render(frame_, image));
+    EXPECT_EQ(distributor.last_stats().speculative_tiles, 0u);
+    EXPECT_EQ(distributor.last_stats().tiles, 40u);
+}
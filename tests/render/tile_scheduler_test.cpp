@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "render/tile_scheduler.h"
+
+class TileSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scheduler_ = std::make_unique<TileScheduler>(4, 16);
+    }
+    
+    std::unique_ptr<TileScheduler> scheduler_;
+};
+
+TEST_F(TileSchedulerTest, TilesCoverImageWithPartialEdges) {
+    auto tiles = scheduler_->make_tiles(40, 20);
+    
+    // 3 x 2 tiles, the last column and row clipped to the image
+    ASSERT_EQ(tiles.size(), 6u);
+    EXPECT_EQ(tiles[2].x0, 32);
+    EXPECT_EQ(tiles[2].x1, 40);
+    EXPECT_EQ(tiles[5].y1, 20);
+    
+    int covered = 0;
+    for (const auto& tile : tiles) {
+        covered += tile.pixel_count();
+    }
+    EXPECT_EQ(covered, 40 * 20);
+}
+
+TEST_F(TileSchedulerTest, EveryPixelVisitedExactlyOnce) {
+    const int width = 100, height = 37;
+    std::vector<std::atomic<int>> visits(width * height);
+    for (auto& v : visits) v = 0;
+    
+    bool completed = scheduler_->run(width, height, [&](const RenderTile& tile, int thread_index) {
+        EXPECT_GE(thread_index, 0);
+        EXPECT_LT(thread_index, scheduler_->thread_count());
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                visits[y * width + x]++;
+            }
+        }
+    });
+    
+    EXPECT_TRUE(completed);
+    for (const auto& v : visits) {
+        EXPECT_EQ(v.load(), 1);
+    }
+}
+
+TEST_F(TileSchedulerTest, StopFlagInterruptsRun) {
+    std::atomic<bool> stop(false);
+    std::atomic<int> processed(0);
+    int64_t pending = 0;
+    
+    TileScheduler single_thread(1, 8);
+    bool completed = single_thread.run(64, 64, [&](const RenderTile&, int) {
+        if (++processed == 3) {
+            stop = true;
+            pending = tile_scheduler_pending_tiles();
+        }
+    }, &stop);
+    
+    EXPECT_FALSE(completed);
+    EXPECT_EQ(processed.load(), 3);
+    // 64 tiles, three claimed; none left pending once the run is over
+    EXPECT_EQ(pending, 61);
+    EXPECT_EQ(tile_scheduler_pending_tiles(), 0);
+}
+
+TEST_F(TileSchedulerTest, ZeroThreadCountUsesHardwareConcurrency) {
+    scheduler_->set_thread_count(0);
+    EXPECT_GE(scheduler_->thread_count(), 1);
+}
+
+TEST_F(TileSchedulerTest, RunStatsAccountForEveryTile) {
+    scheduler_->run(64, 48, [](const RenderTile&, int) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    
+    const TileRunStats& stats = scheduler_->last_run_stats();
+    ASSERT_EQ(stats.thread_busy_seconds.size(), 4u);
+    ASSERT_EQ(stats.tile_seconds.size(), 12u);
+    
+    int tiles = 0;
+    for (int count : stats.thread_tiles) {
+        tiles += count;
+    }
+    EXPECT_EQ(tiles, 12);
+    for (double seconds : stats.tile_seconds) {
+        EXPECT_GE(seconds, 0.001);
+    }
+    EXPECT_GE(stats.busy_seconds(), 0.012);
+    EXPECT_GE(stats.wall_seconds, 0.003);
+    EXPECT_GE(stats.imbalance(), 1.0);
+}